@@ -6,8 +6,10 @@
 #include "src/thumbnailload.h"
 #include "src/cursortool.h"
 #include "src/dbus/applicationadpator.h"
+#include "src/dbus/metricsadaptor.h"
 #include "src/declarative/mousetrackitem.h"
 #include "src/declarative/pathviewrangehandler.h"
+#include "src/declarative/tiledimageitem.h"
 #include "src/globalcontrol.h"
 #include "src/globalstatus.h"
 #include "src/types.h"
@@ -15,6 +17,7 @@
 #include "src/imagedata/imagesourcemodel.h"
 #include "src/imagedata/imageprovider.h"
 #include "src/utils/filetrashhelper.h"
+#include "src/utils/rotateimagehelper.h"
 #include "src/qmlWidget.h"
 #include "config.h"
 
@@ -28,7 +31,9 @@
 #include "thumbnailview/roles.h"
 #include "thumbnailview/imagedatamodel.h"
 #include "thumbnailview/thumbnailmodel.h"
+#include "thumbnailview/timelinesectionmodel.h"
 #include "thumbnailview/qimageitem.h"
+#include "thumbnailview/thumbnailimageitem.h"
 
 #include <DGuiApplicationHelper>
 #include <DApplication>
@@ -85,6 +90,14 @@ int main(int argc, char *argv[])
         exit(0);
     }
 
+#ifdef ENABLE_PERF_METRICS
+    // 设置 DEEPIN_ALBUM_TRACE 时从启动开始记录耗时区间；退出时写入仍在记录中的追踪（含 D-Bus 开启的）
+    PerfTrace::instance()->start(qEnvironmentVariable("DEEPIN_ALBUM_TRACE"));
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, []() {
+        PerfTrace::instance()->stop();
+    });
+#endif
+
     // 配置文件加载
     qDebug() << "Loading application configuration";
     LibConfigSetter::instance()->loadConfig(imageViewerSpace::ImgViewerTypeAlbum);
@@ -98,6 +111,7 @@ int main(int argc, char *argv[])
     qmlRegisterUncreatableType<PathViewProxyModel>(uri.toUtf8().data(), 1, 0, "PathViewProxyModel", "Use for view data");
     qmlRegisterType<MouseTrackItem>(uri.toUtf8().data(), 1, 0, "MouseTrackItem");
     qmlRegisterType<PathViewRangeHandler>(uri.toUtf8().data(), 1, 0, "PathViewRangeHandler");
+    qmlRegisterType<TiledImageItem>(uri.toUtf8().data(), 1, 0, "TiledImageItem");
     // 文件回收站处理
     qmlRegisterType<FileTrashHelper>(uri.toUtf8().data(), 1, 0, "FileTrashHelper");
 
@@ -154,6 +168,22 @@ int main(int argc, char *argv[])
     QObject::connect(&fileControl, &FileControl::imageFileChanged, [&](const QString &fileName) {
         providerCache->removeImageCache(fileName);
     });
+    // 批量旋转时不逐个响应文件变更，结束后统一移除大图缓存
+    QObject::connect(RotateImageHelper::instance(), &RotateImageHelper::batchRotateFinished, [&](const QStringList &paths) {
+        for (const QString &path : paths) {
+            providerCache->removeImageCache(path);
+        }
+    });
+    // 大图切换时更新缓存中的当前展示区间，区间内的图片最后被淘汰
+    auto updateNeighbourhood = [&]() {
+        providerCache->setNeighbourhood(control.viewModel()->windowPaths());
+    };
+    QObject::connect(control.viewModel(), &PathViewProxyModel::dataChanged, updateNeighbourhood);
+    QObject::connect(control.viewModel(), &PathViewProxyModel::modelReset, updateNeighbourhood);
+    // 大图切换时沿切换方向预加载图片
+    QObject::connect(control.viewModel(), &PathViewProxyModel::prefetchRequested, [&](const QList<QPair<QString, int>> &images) {
+        providerCache->prefetchImages(images);
+    });
 
     // 判断命令行数据，在 QML 前优先加载
     if (!cliParam.isEmpty()) {
@@ -198,6 +228,7 @@ int main(int argc, char *argv[])
 #endif
     qmlRegisterType<ImageDataModel>(uriAlbum, 1, 0, "ImageDataModel");
     qmlRegisterType<ThumbnailModel>(uriAlbum, 1, 0, "ThumbnailModel");
+    qmlRegisterType<TimelineSectionModel>(uriAlbum, 1, 0, "TimelineSectionModel");
     qmlRegisterType<ItemViewAdapter>(uriAlbum, 1, 0, "ItemViewAdapter");
     qmlRegisterType<Positioner>(uriAlbum, 1, 0, "Positioner");
     qmlRegisterType<RubberBand>(uriAlbum, 1, 0, "RubberBand");
@@ -206,6 +237,7 @@ int main(int argc, char *argv[])
     qmlRegisterUncreatableType<Types>(uriAlbum, 1, 0, "Types", "Cannot instantiate the Types class");
     qmlRegisterUncreatableType<Roles>(uriAlbum, 1, 0, "Roles", "Cannot instantiate the Roles class");
     qmlRegisterType<QImageItem>(uriAlbum, 1, 0, "QImageItem");
+    qmlRegisterType<ThumbnailImageItem>(uriAlbum, 1, 0, "ThumbnailImageItem");
     qmlRegisterType<QmlWidget>(uriAlbum, 1, 0, "QmlWidget");
 
     engine.load(QUrl(QStringLiteral("qrc:/qml/main.qml")));
@@ -221,6 +253,14 @@ int main(int argc, char *argv[])
     QDBusConnection::sessionBus().registerService("com.deepin.album");
     QDBusConnection::sessionBus().registerObject("/", &fileControl);
 
+#ifdef ENABLE_PERF_METRICS
+    // 性能指标调试接口及定期快照
+    new MetricsAdaptor(PerfMetrics::instance());
+    QDBusConnection::sessionBus().registerObject("/metrics", PerfMetrics::instance());
+    PerfMetrics::instance()->startPeriodicDump(qEnvironmentVariable("DEEPIN_ALBUM_METRICS_DUMP"),
+                                               qEnvironmentVariableIntValue("DEEPIN_ALBUM_METRICS_INTERVAL"));
+#endif
+
     qInfo() << "Application initialization completed";
     return app.exec();
 }
@@ -37,8 +37,13 @@ BaseView {
     // 监听分类完成信号，刷新数据
     Connections {
         target: albumControl
-        function onSigImageClassifyFinished() {
-            loadClassificationData()
+        function onSigClassificationFinished() {
+            if (visible)
+                loadClassificationData()
+        }
+        function onSigClassificationUpdated() {
+            if (visible)
+                loadClassificationData()
         }
     }
 
@@ -34,6 +34,7 @@ DialogWindow {
     property int pictureQuality: piczSlider.value
     property string saveFolder: ""
     property var messageToId
+    property var pendingJobs: ({})   // 进行中的导出任务及其提示消息的目标
 
     property int labelWidth: 80
     property int lineEditWidth: 300
@@ -274,12 +275,13 @@ DialogWindow {
                 return
             }
 
-            var bRet = albumControl.saveAsImage(filePath , saveName , saveIndex , savefileFormat ,pictureQuality ,saveFolder)
+            // 导出在后台执行，完成后通过 sigExportFinished 提示结果
+            var jobId = albumControl.saveAsImage(filePath , saveName , saveIndex , savefileFormat ,pictureQuality ,saveFolder)
             exportdialog.visible=false
-            if (bRet)
-                DTK.sendMessage(messageToId, qsTr("Export successful"), "notify_checked")
-            else
+            if (jobId < 0)
                 DTK.sendMessage(messageToId, qsTr("Export failed"), "warning")
+            else
+                pendingJobs[jobId] = messageToId
 
         }
     }
@@ -295,6 +297,21 @@ DialogWindow {
         setY(window.y  + window.height / 2 - height / 2)
     }
 
+    Connections {
+        target: albumControl
+        function onSigExportFinished(jobId, succeeded, failed) {
+            if (pendingJobs[jobId] === undefined)
+                return
+
+            var toId = pendingJobs[jobId]
+            delete pendingJobs[jobId]
+            if (failed === 0)
+                DTK.sendMessage(toId, qsTr("Export successful"), "notify_checked")
+            else
+                DTK.sendMessage(toId, qsTr("Export failed"), "warning")
+        }
+    }
+
     function setParameter(path, toId) {
         filePath = path
         messageToId = toId
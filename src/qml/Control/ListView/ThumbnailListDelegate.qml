@@ -43,20 +43,50 @@ Item {
     property Item videoLabel: null
     property int nDuration: GStatus.animationDuration
 
-    // 缩略图本体
-    Album.QImageItem {
+    // 缩略图阴影，使用普通圆角矩形节点代替 DropShadow，不产生离屏图层，可与其它节点合并绘制
+    Rectangle {
+        id: shadowRect
+        anchors.centerIn: parent
+        anchors.horizontalCenterOffset: -0.5
+        anchors.verticalCenterOffset: 1.3
+        width: image.paintedWidth
+        height: image.paintedHeight
+        radius: 10
+        color: "black"
+        opacity: 0.1
+        visible: !image.null
+    }
+
+    // 缩略图本体，圆角由场景图节点几何实现，纹理位于共享图集中，可合并绘制
+    Album.ThumbnailImageItem {
         id: image
         anchors.centerIn: parent
         width: parent.width - 14
         height: parent.height -14
         smooth: true
+        radius: 10
         image: {
             gridView.bRefresh
             modelData.thumbnail
         }
-        fillMode: Album.QImageItem.PreserveAspectFit
-        visible: false
-        layer.enabled: true
+        fillMode: Album.ThumbnailImageItem.PreserveAspectFit
+
+        // 缩放比例变化时图片尺寸随动画变化，阴影和边框跟随 paintedWidth/paintedHeight 变化
+        Behavior on width {
+            enabled: GStatus.enableRatioAnimation
+            NumberAnimation {
+                duration: nDuration
+                easing.type: Easing.OutExpo // 缓动类型
+            }
+        }
+
+        Behavior on height {
+            enabled: GStatus.enableRatioAnimation
+            NumberAnimation {
+                duration: nDuration
+                easing.type: Easing.OutExpo // 缓动类型
+            }
+        }
     }
 
     // 图片保存完成，缩略图区域重新加载当前图片
@@ -69,64 +99,6 @@ Item {
         }
     }
 
-    //圆角遮罩Rectangle
-    Rectangle {
-        id: maskRec
-        anchors.centerIn: parent
-        width: image.width
-        height: image.height
-
-        color:"transparent"
-        Rectangle {
-            anchors.centerIn: parent
-            width: image.paintedWidth
-            height: image.paintedHeight
-            color:"black"
-            radius: 10
-
-            Behavior on width {
-                enabled: GStatus.enableRatioAnimation
-                NumberAnimation {
-                    duration: nDuration
-                    easing.type: Easing.OutExpo // 缓动类型
-                }
-            }
-
-            Behavior on height {
-                enabled: GStatus.enableRatioAnimation
-                NumberAnimation {
-                    duration: nDuration
-                    easing.type: Easing.OutExpo // 缓动类型
-                }
-            }
-        }
-
-        visible: false
-    }
-
-    DropShadow {
-        anchors.fill: opacityMask
-
-        horizontalOffset: -0.5
-        verticalOffset: 1.3
-
-        radius: 1.0
-        samples: radius * 2 + 1
-        spread: 0.01
-
-        smooth: true
-        opacity: 0.1
-
-        source: opacityMask
-    }
-
-    OpacityMask{
-        id: opacityMask
-        anchors.fill: maskRec
-        source: image
-        maskSource: maskRec
-    }
-
     //border and shadow
     Rectangle {
         id: borderRect
@@ -138,22 +110,6 @@ Item {
         border.width: 1
         visible: true
         radius: 10
-
-        Behavior on width {
-            enabled: GStatus.enableRatioAnimation
-            NumberAnimation {
-                duration: nDuration
-                easing.type: Easing.OutExpo // 缓动类型
-            }
-        }
-
-        Behavior on height {
-            enabled: GStatus.enableRatioAnimation
-            NumberAnimation {
-                duration: nDuration
-                easing.type: Easing.OutExpo // 缓动类型
-            }
-        }
     }
 
     MouseArea {
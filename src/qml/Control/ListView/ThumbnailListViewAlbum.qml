@@ -756,7 +756,9 @@ FocusScope {
             adapterView: gridView
             adapterModel: positioner
             adapterIconSize: gridView.iconSize * 2
-            adapterVisibleArea: Qt.rect(gridView.contentX, gridView.contentY, gridView.contentWidth, gridView.contentHeight)
+            // 视口在内容中的区域及网格尺寸，用于向缩略图加载队列提示可见项
+            adapterVisibleArea: Qt.rect(gridView.contentX - gridView.originX, gridView.contentY - gridView.originY, gridView.width, gridView.height)
+            adapterCellSize: Qt.size(gridView.cellWidth, gridView.cellHeight)
 
             Component.onCompleted: {
                 gridView.movementStarted.connect(viewAdapter.viewScrolled);
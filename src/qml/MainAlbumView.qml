@@ -17,6 +17,8 @@ import "./Control/Animation"
 FadeInoutAnimation {
     anchors.fill: parent
     property int lastWidth: 0
+    property string importSpeedText: ""  // 设备导入速度
+    property string exportSpeedText: ""  // 相册导出速度
 
     //rename窗口
     NewAlbumDialog {
@@ -171,6 +173,12 @@ FadeInoutAnimation {
     StandardProgressDialog {
         id: idStandardProgressDialog
         z: leftSidebar.z + 1
+
+        // 目前只有相册导出可以取消
+        onCanceled: {
+            if (leftSidebar.exportJobId > 0)
+                albumControl.cancelExport(leftSidebar.exportJobId)
+        }
     }
 
     //拖拽导入
@@ -230,6 +238,25 @@ FadeInoutAnimation {
             // console.log("MainAlbumView onImageRenamed oldPath:", oldPath, "newPath:", newPath)
             albumControl.updateInfoPath(oldPath, newPath)
         }
+
+        // 收到批量旋转进度消息，多张图片时显示进度
+        function onBatchRotateProgress(finished, total) {
+            if (total < 2)
+                return
+
+            var prevS = qsTr("Rotated:")
+            if (!idStandardProgressDialog.visible)
+                showProgress(qsTr("Rotating..."), prevS + "0")
+            idStandardProgressDialog.setContent(prevS + qsTr("%1/%2").arg(finished).arg(total))
+            idStandardProgressDialog.setProgress(finished * 100 / total, 100)
+            if (finished >= total)
+                delayTimer.start()
+        }
+
+        // 收到批量旋转跳过消息，无法无损旋转的 JPEG 保持原样
+        function onBatchRotateSkipped(count) {
+            DTK.sendMessage(stackControl, qsTr("%1 image(s) were not rotated to keep their quality").arg(count), "warning")
+        }
     }
 
     Connections {
@@ -244,6 +271,7 @@ FadeInoutAnimation {
         function onSigImportStart() {
             var title = qsTr("Importing...")
             var content = qsTr("Imported:") + "0"
+            importSpeedText = ""
             showProgress(title, content)
         }
 
@@ -252,11 +280,18 @@ FadeInoutAnimation {
             var prevS = qsTr("Imported:")
             var suffixS = qsTr("%1/%2").arg(value).arg(max)
             var contentS = prevS + suffixS
+            if (importSpeedText !== "")
+                contentS += "  " + importSpeedText
             var percent = value * 100 / max
             idStandardProgressDialog.setContent(contentS)
             idStandardProgressDialog.setProgress(percent, 100)
         }
 
+        // 收到导入速度消息，从设备导入时上报
+        function onSigImportSpeed(bytesPerSecond) {
+            importSpeedText = (bytesPerSecond / (1024 * 1024)).toFixed(1) + " MB/s"
+        }
+
         // 收到导入完成消息
         function onSigImportFinished() {
             delayTimer.start()
@@ -295,26 +330,44 @@ FadeInoutAnimation {
             }
         }
 
-        // 收到图片分类开始消息
-        function onSigImageClassifyStarted() {
-            var title = qsTr("Classifying images...")
-            var content = qsTr("Classified:") + "0"
-            showProgress(title, content)
-        }
+        // 收到相册导出进度消息，开始导出时 value 为 0
+        function onSigExportProgress(jobId, value, max) {
+            if (jobId !== leftSidebar.exportJobId)
+                return
 
-        // 收到图片分类进度消息
-        function onProgressOfImageClassify(total, value) {
-            var prevS = qsTr("Classified:")
-            var suffixS = qsTr("%1/%2").arg(value).arg(total)
-            var contentS = prevS + suffixS
-            var percent = value * 100 / total
+            var prevS = qsTr("Exported:")
+            if (!idStandardProgressDialog.visible) {
+                exportSpeedText = ""
+                showProgress(qsTr("Exporting..."), prevS + "0")
+                idStandardProgressDialog.cancelable = true
+            }
+            var contentS = prevS + qsTr("%1/%2").arg(value).arg(max)
+            if (exportSpeedText !== "")
+                contentS += "  " + exportSpeedText
             idStandardProgressDialog.setContent(contentS)
-            idStandardProgressDialog.setProgress(percent, 100)
+            idStandardProgressDialog.setProgress(value * 100 / max, 100)
         }
 
-        // 收到图片分类完成消息
-        function onSigImageClassifyFinished() {
+        function onSigExportSpeed(jobId, bytesPerSecond) {
+            if (jobId === leftSidebar.exportJobId)
+                exportSpeedText = (bytesPerSecond / (1024 * 1024)).toFixed(1) + " MB/s"
+        }
+
+        // 收到相册导出完成消息，取消后未导出的文件计为失败
+        function onSigExportFinished(jobId, succeeded, failed) {
+            if (jobId !== leftSidebar.exportJobId)
+                return
+
+            leftSidebar.exportJobId = -1
             delayTimer.start()
+            if (failed === 0)
+                DTK.sendMessage(stackControl, qsTr("Export successful"), "notify_checked")
+            else
+                DTK.sendMessage(stackControl, qsTr("Export failed"), "warning")
+        }
+
+        // 后台分类队列处理完成，分类在空闲时增量进行，不再显示阻塞的进度对话框
+        function onSigClassificationFinished() {
             DTK.sendMessage(stackControl, qsTr("Classification completed"), "notify_checked")
         }
     }
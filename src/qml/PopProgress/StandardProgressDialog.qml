@@ -18,6 +18,8 @@ FloatingPanel {
     //原生属性-结束
 
     //自定义属性-开始
+    property bool cancelable: false   //是否显示取消按钮
+    signal canceled()
     //自定义属性-结束
 
     //窗口布局-开始
@@ -82,6 +84,26 @@ FloatingPanel {
     }
     //窗口布局-结束
 
+    //取消按钮，仅可取消的任务显示
+    ActionButton {
+        visible: idWindow.cancelable
+        z: idMouseArea.z + 1
+        anchors {
+            top: parent.top
+            topMargin: 12
+            right: parent.right
+            rightMargin: 12
+        }
+        width: 24
+        height: 24
+        icon.name: "window_close"
+        icon.width: 12
+        icon.height: 12
+        onClicked: {
+            idWindow.canceled()
+        }
+    }
+
     //事件处理-开始
     MouseArea {
         id: idMouseArea
@@ -148,6 +170,7 @@ FloatingPanel {
     function clear() {
         labelTitle.text = ""
         labelContent.text = ""
+        cancelable = false
         idProgressBar.to = 100
         idProgressBar.value = 0
     }
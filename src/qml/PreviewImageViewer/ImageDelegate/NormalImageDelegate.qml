@@ -56,6 +56,14 @@ BaseImageDelegate {
         }
     }
 
+    // 超大图片放大时分块绘制原图细节
+    IV.TiledImageItem {
+        anchors.fill: parent
+        source: visible ? delegate.source : ""
+        targetImage: image
+        visible: delegate.isCurrentImage && 0 === delegate.frameIndex && Image.Ready === image.status && !rotationRunning
+    }
+
     // 旋转动画效果
     Loader {
         id: rotateAnimationLoader
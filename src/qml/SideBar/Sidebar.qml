@@ -21,7 +21,8 @@ ScrollView {
     property int currentImportCustomIndex: 0 //自动导入相册当前索引值
     property int currentCustomIndex: 0 //自定义相册当前索引值
     property var devicePaths : albumControl.getDevicePaths()
-    property var albumPaths : albumControl.getAlbumPaths(GStatus.currentCustomAlbumUId)
+    // 菜单可见性只需要数量，路径在触发时再取
+    property int albumItemCount : albumControl.getCustomAlbumInfoConut(GStatus.currentCustomAlbumUId)
     property var importAlbumNames : {
         GStatus.albumImportChangeList
         albumControl.getImportAlubumAllNames()
@@ -33,6 +34,7 @@ ScrollView {
     property ListModel deviceListModel: ListModel {}
     property ListModel importListModel: ListModel {}
     property ListModel customListModel: ListModel {}
+    property int exportJobId: -1 //正在导出的相册任务编号，进度和结果由 MainAlbumView 显示
 
     onXChanged: {
         GStatus.sideBarX = x;
@@ -345,7 +347,7 @@ ScrollView {
             }
 
             onItemRightClicked: {
-                if (sidebarScrollView.albumPaths.length > 0) {
+                if (sidebarScrollView.albumItemCount > 0) {
                     systemMenu.popup()
                 }
             }
@@ -470,9 +472,9 @@ ScrollView {
         //显示大图预览
         RightMenuItem {
             text: qsTr("Slide show")
-            visible: albumPaths.length >0
+            visible: albumItemCount > 0
             onTriggered: {
-                stackControl.startMainSliderShow(albumPaths, 0)
+                stackControl.startMainSliderShow(albumControl.getAlbumPaths(GStatus.currentCustomAlbumUId), 0)
             }
         }
 
@@ -481,9 +483,9 @@ ScrollView {
 
         RightMenuItem {
             text: qsTr("Export")
-            visible:  albumPaths.length >0
+            visible:  albumItemCount > 0
             onTriggered: {
-                albumControl.exportFolders(albumPaths,albumControl.getCustomAlbumByUid(GStatus.currentCustomAlbumUId))
+                exportAlbum()
             }
         }
     }
@@ -495,21 +497,21 @@ ScrollView {
         //显示大图预览
         RightMenuItem {
             text: qsTr("Slide show")
-            visible: albumPaths.length > 0
+            visible: albumItemCount > 0
             onTriggered: {
-                stackControl.startMainSliderShow(albumPaths, 0)
+                stackControl.startMainSliderShow(albumControl.getAlbumPaths(GStatus.currentCustomAlbumUId), 0)
             }
         }
 
         MenuSeparator {
-            visible: albumPaths.length > 0
+            visible: albumItemCount > 0
         }
 
         RightMenuItem {
             text: qsTr("Export")
-            visible: albumPaths.length > 0
+            visible: albumItemCount > 0
             onTriggered: {
-                albumControl.exportFolders(albumPaths,albumControl.getCustomAlbumByUid(GStatus.currentCustomAlbumUId))
+                exportAlbum()
             }
         }
 
@@ -527,6 +529,15 @@ ScrollView {
         id: removeAlbumDialog
     }
 
+    //导出当前相册，导出在后台执行
+    function exportAlbum() {
+        var jobId = albumControl.exportFolders(albumControl.getAlbumPaths(GStatus.currentCustomAlbumUId),albumControl.getCustomAlbumByUid(GStatus.currentCustomAlbumUId))
+        if (jobId > 0)
+            exportJobId = jobId
+        else if (jobId < 0)
+            DTK.sendMessage(stackControl, qsTr("Export failed"), "warning")
+    }
+
     //删除相册执行函数
     function doDeleteAlbum(type) {
         if(type === 0) {
@@ -549,9 +560,9 @@ ScrollView {
         // 显示大图预览
         RightMenuItem {
             text: qsTr("Slide show")
-            visible: albumPaths.length > 0
+            visible: albumItemCount > 0
             onTriggered: {
-                stackControl.startMainSliderShow(albumPaths, 0)
+                stackControl.startMainSliderShow(albumControl.getAlbumPaths(GStatus.currentCustomAlbumUId), 0)
             }
         }
 
@@ -582,9 +593,9 @@ ScrollView {
         // 导出相册
         RightMenuItem {
             text: qsTr("Export")
-            visible: albumPaths.length > 0
+            visible: albumItemCount > 0
             onTriggered: {
-                albumControl.exportFolders(albumPaths,albumControl.getCustomAlbumByUid(GStatus.currentCustomAlbumUId))
+                exportAlbum()
             }
         }
 
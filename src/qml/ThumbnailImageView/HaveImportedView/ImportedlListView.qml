@@ -36,39 +36,34 @@ Item {
     property int topDelegateIndexTmp: 0
     property bool checkBoxClicked: false
 
-    //view依赖的model管理器
-    property ListModel importedListModel: ListModel {
+    //view依赖的model管理器，分组及分组数量由后台模型直接提供
+    property Album.TimelineSectionModel importedListModel: Album.TimelineSectionModel {
         id: theModel
+        sectionType: Album.Types.SectionImport
+        filterType: filterCombo.currentIndex
         property var selectedPathObjs: []
         property var dayHeights: []
         function loadImportedInfos() {
-            theModel.clear()
             theModel.selectedPathObjs = []
             theModel.dayHeights = []
             // 从后台获取所有已导入数据,倒序
-            var titleInfos = []
             if (Number(FileControl.getConfigValue("", "loadImport", 1)))
-                titleInfos = albumControl.getAllImportTimelinesTitle(filterCombo.currentIndex);
-            var i = 0
+                theModel.loadData()
+            else
+                theModel.clear()
             var dayHeight = 0
             var listHeight = 0
             theView.listContentHeight = 0
-            var titlePaths
-            for (var j = 0; j < titleInfos.length; j++) {
-                theModel.append({"title": titleInfos[j]})
-
+            for (var j = 0; j < theModel.count; j++) {
                 // 当前标题列表选中数据初始化
-                titlePaths = []
-                var selectedPathObj = {"id": j, "paths": titlePaths}
+                var selectedPathObj = {"id": j, "paths": []}
                 theModel.selectedPathObjs.push(selectedPathObj)
 
                 // 计算每个标题列表高度
-                titlePaths = albumControl.getTimelinesTitlePaths(titleInfos[j], filterCombo.currentIndex)
-                listHeight = Math.abs(Math.ceil(titlePaths.length / Math.floor(importedListView.width / realCellWidth)) * realCellWidth)
+                listHeight = Math.abs(Math.ceil(theModel.itemCountAt(j) / Math.floor(importedListView.width / realCellWidth)) * realCellWidth)
                 dayHeight = listHeight + listMargin * 2 + importCheckboxHeight + (j === 0 ? spaceCtrlHeight : 0)
                 dayHeights.push(dayHeight)
                 theView.listContentHeight += dayHeight
-
             }
         }
     }
@@ -140,7 +135,7 @@ Item {
             target: vbar
             function onTopDelegateIndexChanged(newIndex) {
                 var firstItemIndex = topDelegateIndex; // 使用当前顶部的索引
-                var firstItemLabel = theModel.get(firstItemIndex).title;
+                var firstItemLabel = theModel.titleAt(firstItemIndex);
 
                 var item = theView.itemAtIndex(firstItemIndex);
                 if (item) {
@@ -364,7 +359,7 @@ Item {
             width: theView.width
             height: importedGridView.height + importedListView.listMargin * 2 + importedListView.importCheckboxHeight + spaceRect.height
             property string m_index: index
-            property var theViewTitle: global.objIsEmpty(theModel.get(index)) ? "" : theModel.get(index).title //日期标题文本内容
+            property var theViewTitle: theModel.titleAt(index) //日期标题文本内容
             property alias count: importedGridView.count
 
             Item {
@@ -82,22 +82,6 @@ BaseView {
         return selectedNumText
     }
 
-    // 加载最近删除图片数据
-    function loadRecentDelItems()
-    {
-        console.info("recently delete model has refreshed... filterType:", filterType)
-        theView.thumbnailListModel.clear();
-        var delInfos = albumControl.getTrashAlbumInfos(filterType);
-        console.info("recently delete model has refreshed... filterType:", filterType, " done...")
-        for (var key in delInfos) {
-            var delItems = delInfos[key]
-            for (var i = 0; i < delItems.length; i++) {
-                theView.thumbnailListModel.append(delItems[i])
-            }
-            break;
-        }
-    }
-
     //执行图片删除操作
     function runAllDeleteImg() {
         albumControl.deleteImgFromTrash(theView.allPaths())
@@ -287,6 +271,14 @@ BaseView {
             showAnimation.start()
     }
 
+    // 后台清理到期数据后刷新
+    Connections {
+        target: albumControl
+        function onSigTrashExpired() {
+            flushRecentDelView()
+        }
+    }
+
     Component.onCompleted: {
         GStatus.sigFlushRecentDelView.connect(flushRecentDelView)
         deleteDialog.sigDoAllDeleteImg.connect(runAllDeleteImg)
@@ -8,6 +8,9 @@
 #include "imageengine/imageenginethread.h"
 #include "utils/devicehelper.h"
 #include "utils/classifyutils.h"
+#include "utils/classifyscheduler.h"
+#include "utils/trashexpiryscheduler.h"
+#include "utils/deviceindexer.h"
 
 #include <DDialog>
 #include <DMessageBox>
@@ -21,6 +24,7 @@
 #include <QProcess>
 #include <QRegularExpression>
 #include <QDirIterator>
+#include <QSet>
 #include <QCoreApplication>
 #include <QFuture>
 #include <QtConcurrent>
@@ -140,6 +144,22 @@ AlbumControl::AlbumControl(QObject *parent)
     initDeviceMonitor();
 
     connect(DGuiApplicationHelper::instance(), &DGuiApplicationHelper::newProcessInstance, this, &AlbumControl::onNewAPPOpen);
+    connect(DeviceIndexer::instance(), &DeviceIndexer::filesFound, this, &AlbumControl::onDeviceFilesFound);
+    connect(DeviceIndexer::instance(), &DeviceIndexer::scanFinished, this, &AlbumControl::onDeviceScanFinished);
+
+    // 后台分类结果写入后刷新分类视图，启动时继续处理上次遗留的分类队列
+    connect(ClassifyScheduler::instance(), &ClassifyScheduler::classifyUpdated, this, &AlbumControl::sigClassificationUpdated, Qt::QueuedConnection);
+    connect(ClassifyScheduler::instance(), &ClassifyScheduler::classifyFinished, this, &AlbumControl::sigClassificationFinished, Qt::QueuedConnection);
+    ClassifyScheduler::instance()->wakeUp();
+
+    // 最近删除到期数据在后台定时清理，清理后刷新最近删除视图
+    connect(TrashExpiryScheduler::instance(), &TrashExpiryScheduler::trashPurged, this, &AlbumControl::sigTrashExpired, Qt::QueuedConnection);
+    TrashExpiryScheduler::instance()->start();
+
+    // 退出时停止未完成的导出，删除不完整的目标文件
+    connect(qApp, &QCoreApplication::aboutToQuit, this, [this]() {
+        cancelExport();
+    });
     qDebug() << "AlbumControl initialization completed";
 }
 
@@ -323,6 +343,9 @@ void AlbumControl::unMountDevice(const QString &devicePath)
         // 设备不存在，则卸载成功，否则提示卸载失败
         if (!DeviceHelper::instance()->isExist(deviceId)) {
             qDebug() << "AlbumControl::unMountDevice - Branch: device unmounted successfully";
+            // 卸载成功后再停止扫描和导入；卸载失败时设备仍可用，扫描继续进行，缓存的设备信息保持完整
+            DeviceIndexer::instance()->cancelScan(devicePath);
+            cancelDeviceImport(devicePath);
             m_durlAndNameMap.remove(devicePath);
             m_PhonePicFileMap.remove(devicePath);
         } else {
@@ -476,11 +499,9 @@ bool AlbumControl::classifyOldDBInfo(const DBImgInfoList &infos)
     if (infos.size() == 0)
         return false;
 
-    emit sigImageClassifyStarted();
-
-    ImagesClassifyThread *imagethread = new ImagesClassifyThread;
-    imagethread->setData(infos);
-    QThreadPool::globalInstance()->start(imagethread);
+    // 加入分类队列，由后台调度在空闲时处理
+    DBManager::instance()->enqueueClassifyTasks(infos);
+    ClassifyScheduler::instance()->wakeUp();
 
     return true;
 }
@@ -529,176 +550,24 @@ QStringList AlbumControl::getAllImportTimelinesTitle(const int &filterType)
     return getTimelinesTitle(TimeLineEnum::Import, filterType);
 }
 
-QVariantMap AlbumControl::getTimelinesTitleInfos(const int &filterType)
-{
-    qDebug() << "AlbumControl::getTimelinesTitleInfos - Function entry, filterType:" << filterType;
-    QVariantMap reMap;
-    QStringList alltitles =  getTimelinesTitle(TimeLineEnum::All, filterType);
-    for (QString titleName : alltitles) {
-        QVariantList list;
-        DBImgInfoList dbInfoList = m_timeLinePathsMap.value(titleName);
-        for (DBImgInfo info : dbInfoList) {
-            QVariantMap tmpMap;
-            if (info.itemType == ItemTypePic) {
-                if (filterType == 2) {
-                    // qDebug() << "AlbumControl::getTimelinesTitleInfos - Branch: skipping picture due to video filter";
-                    continue ;
-                }
-                tmpMap.insert("itemType", "pciture");
-            } else if (info.itemType == ItemTypeVideo) {
-                if (filterType == 1) {
-                    // qDebug() << "AlbumControl::getTimelinesTitleInfos - Branch: skipping video due to picture filter";
-                    continue ;
-                }
-                tmpMap.insert("itemType", "video");
-            } else {
-                tmpMap.insert("itemType", "other");
-            }
-            tmpMap.insert("url", "file://" + info.filePath);
-            tmpMap.insert("filePath", info.filePath);
-            tmpMap.insert("pathHash", info.pathHash);
-            tmpMap.insert("remainDays", info.remainDays);
-            list << tmpMap;
-        }
-        if (list.count() > 0) {
-            // qDebug() << "AlbumControl::getTimelinesTitleInfos - Branch: adding title" << titleName << "with" << list.count() << "items";
-            reMap.insert(titleName, list);
-        }
-    }
-    qDebug() << "AlbumControl::getTimelinesTitleInfos - Function exit, returning" << reMap.size() << "title groups";
-    return reMap;
-}
-
-
 QStringList AlbumControl::getYearTimelinesTitle(const int &filterType)
 {
     qDebug() << "AlbumControl::getYearTimelinesTitle - Function entry, filterType:" << filterType;
     return getTimelinesTitle(TimeLineEnum::Year, filterType);
 }
 
-QVariantMap AlbumControl::getYearTimelinesInfos(const int &filterType)
-{
-    qDebug() << "AlbumControl::getYearTimelinesInfos - Function entry, filterType:" << filterType;
-    QVariantMap reMap;
-    QStringList alltitles =  getTimelinesTitle(TimeLineEnum::Year, filterType);
-    for (QString titleName : alltitles) {
-        QVariantList list;
-        DBImgInfoList dbInfoList = m_yearDateMap.value(titleName);
-        for (DBImgInfo info : dbInfoList) {
-            QVariantMap tmpMap;
-            if (info.itemType == ItemTypePic) {
-                if (filterType == 2) {
-                    continue ;
-                }
-                tmpMap.insert("itemType", "pciture");
-            } else if (info.itemType == ItemTypeVideo) {
-                if (filterType == 1) {
-                    continue ;
-                }
-                tmpMap.insert("itemType", "video");
-            } else {
-                tmpMap.insert("itemType", "other");
-            }
-            tmpMap.insert("url", "file://" + info.filePath);
-            tmpMap.insert("filePath", info.filePath);
-            tmpMap.insert("pathHash", info.pathHash);
-            tmpMap.insert("remainDays", info.remainDays);
-            list << tmpMap;
-        }
-        if (list.count() > 0) {
-            reMap.insert(titleName, list);
-        }
-    }
-    qDebug() << "AlbumControl::getYearTimelinesInfos - Function exit, returning" << reMap.size() << "title groups";
-    return reMap;
-}
-
 QStringList AlbumControl::getMonthTimelinesTitle(const int &filterType)
 {
     qDebug() << "AlbumControl::getMonthTimelinesTitle - Function entry, filterType:" << filterType;
     return getTimelinesTitle(TimeLineEnum::Month, filterType);
 }
 
-QVariantMap AlbumControl::getMonthTimelinesInfos(const int &filterType)
-{
-    qDebug() << "AlbumControl::getMonthTimelinesInfos - Function entry, filterType:" << filterType;
-    QVariantMap reMap;
-    QStringList alltitles =  getTimelinesTitle(TimeLineEnum::Month, filterType);
-    for (QString titleName : alltitles) {
-        QVariantList list;
-        DBImgInfoList dbInfoList = m_monthDateMap.value(titleName);
-        for (DBImgInfo info : dbInfoList) {
-            QVariantMap tmpMap;
-            if (info.itemType == ItemTypePic) {
-                if (filterType == 2) {
-                    continue ;
-                }
-                tmpMap.insert("itemType", "pciture");
-            } else if (info.itemType == ItemTypeVideo) {
-                if (filterType == 1) {
-                    continue ;
-                }
-                tmpMap.insert("itemType", "video");
-            } else {
-                tmpMap.insert("itemType", "other");
-            }
-            tmpMap.insert("url", "file://" + info.filePath);
-            tmpMap.insert("filePath", info.filePath);
-            tmpMap.insert("pathHash", info.pathHash);
-            tmpMap.insert("remainDays", info.remainDays);
-            list << tmpMap;
-        }
-        if (list.count() > 0) {
-            reMap.insert(titleName, list);
-        }
-    }
-    qDebug() << "AlbumControl::getMonthTimelinesInfos - Function exit, returning" << reMap.size() << "title groups";
-    return reMap;
-}
-
 QStringList AlbumControl::getDayTimelinesTitle(const int &filterType)
 {
     qDebug() << "AlbumControl::getDayTimelinesTitle - Function entry, filterType:" << filterType;
     return getTimelinesTitle(TimeLineEnum::Day, filterType);
 }
 
-QVariantMap AlbumControl::getDayTimelinesInfos(const int &filterType)
-{
-    qDebug() << "AlbumControl::getDayTimelinesInfos - Function entry, filterType:" << filterType;
-    QVariantMap reMap;
-    QStringList alltitles =  getTimelinesTitle(TimeLineEnum::Day, filterType);
-    for (QString titleName : alltitles) {
-        QVariantList list;
-        DBImgInfoList dbInfoList = m_dayDateMap.value(titleName);
-        for (DBImgInfo info : dbInfoList) {
-            QVariantMap tmpMap;
-            if (info.itemType == ItemTypePic) {
-                if (filterType == 2) {
-                    continue ;
-                }
-                tmpMap.insert("itemType", "pciture");
-            } else if (info.itemType == ItemTypeVideo) {
-                if (filterType == 1) {
-                    continue ;
-                }
-                tmpMap.insert("itemType", "video");
-            } else {
-                tmpMap.insert("itemType", "other");
-            }
-            tmpMap.insert("url", "file://" + info.filePath);
-            tmpMap.insert("filePath", info.filePath);
-            tmpMap.insert("pathHash", info.pathHash);
-            tmpMap.insert("remainDays", info.remainDays);
-            list << tmpMap;
-        }
-        if (list.count() > 0) {
-            reMap.insert(titleName, list);
-        }
-    }
-    qDebug() << "AlbumControl::getDayTimelinesInfos - Function exit, returning" << reMap.size() << "title groups";
-    return reMap;
-}
-
 QStringList AlbumControl::getTimelinesTitle(TimeLineEnum timeEnum, const int &filterType)
 {
     qDebug() << "AlbumControl::getTimelinesTitle - Function entry, filterType:" << filterType;
@@ -801,6 +670,38 @@ QStringList AlbumControl::getTimelinesTitle(TimeLineEnum timeEnum, const int &fi
     return relist;
 }
 
+QList<QPair<QString, DBImgInfoList>> AlbumControl::getTimelineSections(TimeLineEnum timeEnum, const int &filterType)
+{
+    qDebug() << "AlbumControl::getTimelineSections - Function entry, timeEnum:" << timeEnum << "filterType:" << filterType;
+    //getTimelinesTitle 已按 filterType 查询并刷新对应的分组数据
+    const QStringList titles = getTimelinesTitle(timeEnum, filterType);
+    const QMap<QString, DBImgInfoList> *sectionMap = &m_timeLinePathsMap;
+    switch (timeEnum) {
+    case TimeLineEnum::Year:
+        sectionMap = &m_yearDateMap;
+        break;
+    case TimeLineEnum::Month:
+        sectionMap = &m_monthDateMap;
+        break;
+    case TimeLineEnum::Day:
+        sectionMap = &m_dayDateMap;
+        break;
+    case TimeLineEnum::Import:
+        sectionMap = &m_importTimeLinePathsMap;
+        break;
+    default:
+        break;
+    }
+
+    QList<QPair<QString, DBImgInfoList>> sections;
+    sections.reserve(titles.size());
+    for (const QString &title : titles) {
+        sections.append(qMakePair(title, sectionMap->value(title)));
+    }
+    qDebug() << "AlbumControl::getTimelineSections - Function exit, returning" << sections.size() << "sections";
+    return sections;
+}
+
 void AlbumControl::initMonitor()
 {
     qDebug() << "AlbumControl::initMonitor - Function entry";
@@ -1036,6 +937,8 @@ void AlbumControl::onUnMountedExecute(const QString &deviceKey, DeviceType type)
 
     DeviceHelper::instance()->loadAllDeviceInfos();
 
+    DeviceIndexer::instance()->cancelScan(strPath);
+    cancelDeviceImport(strPath);
     if (m_PhonePicFileMap.contains(strPath)) {
         qDebug() << "Removing phone file map for:" << strPath;
         m_PhonePicFileMap.remove(strPath);
@@ -1426,143 +1329,6 @@ QStringList AlbumControl::getImportTimelinesTitlePaths(const QString &titleName,
     return pathsList;
 }
 
-QVariantMap AlbumControl::getImportTimelinesTitleInfos(const int &filterType)
-{
-    qDebug() << "AlbumControl::getImportTimelinesTitleInfos - Function entry, filterType:" << filterType;
-    QVariantMap reMap;
-    QStringList alltitles = getAllImportTimelinesTitle(filterType);
-    for (QString titleName : alltitles) {
-        QVariantList list;
-        DBImgInfoList dbInfoList = m_importTimeLinePathsMap.value(titleName);
-        for (DBImgInfo info : dbInfoList) {
-            QVariantMap tmpMap;
-            if (info.itemType == ItemTypePic) {
-                if (filterType == 2) {
-                    // qDebug() << "AlbumControl::getImportTimelinesTitleInfos - Branch: skipping picture due to video filter";
-                    continue ;
-                }
-                tmpMap.insert("itemType", "pciture");
-            } else if (info.itemType == ItemTypeVideo) {
-                if (filterType == 1) {
-                    // qDebug() << "AlbumControl::getImportTimelinesTitleInfos - Branch: skipping video due to picture filter";
-                    continue ;
-                }
-                tmpMap.insert("itemType", "video");
-            } else {
-                tmpMap.insert("itemType", "other");
-            }
-            tmpMap.insert("url", "file://" + info.filePath);
-            tmpMap.insert("filePath", info.filePath);
-            tmpMap.insert("pathHash", info.pathHash);
-            tmpMap.insert("remainDays", info.remainDays);
-            list << tmpMap;
-        }
-        if (list.count() > 0) {
-            qDebug() << "AlbumControl::getImportTimelinesTitleInfos - Branch: adding title" << titleName << "with" << list.count() << "items";
-            reMap.insert(titleName, list);
-        }
-    }
-
-    qDebug() << "AlbumControl::getImportTimelinesTitleInfos - Function exit, returning" << reMap.size() << "title groups";
-    return reMap;
-}
-
-QVariantList AlbumControl::getImportTimelinesTitleInfosReverse(const int &filterType)
-{
-    qDebug() << "AlbumControl::getImportTimelinesTitleInfosReverse - Function entry, filterType:" << filterType;
-    QVariantMap reMap = getImportTimelinesTitleInfos(filterType);
-
-    QVariantList reList;
-    if (reMap.size()) {
-        qDebug() << "AlbumControl::getImportTimelinesTitleInfosReverse - Branch: reversing" << reMap.size() << "title groups";
-        for (auto it = --reMap.end(); it != --reMap.begin(); it--) {
-            QVariantMap tmpMap;
-            tmpMap.insert(it.key(), it.value());
-            reList.push_back(tmpMap);
-        }
-    }
-
-    qDebug() << "AlbumControl::getImportTimelinesTitleInfosReverse - Function exit, returning" << reList.size() << "items";
-    return reList;
-}
-
-QVariantMap AlbumControl::getAlbumInfos(const int &albumId, const int &filterType)
-{
-    qDebug() << "AlbumControl::getImportTimelinesTitleInfosReverse - Function entry, filterType:" << filterType;
-    QVariantMap reMap;
-
-    QVariantList list;
-    DBImgInfoList dbInfoList = DBManager::instance()->getInfosByAlbum(albumId, false);
-    QString title = DBManager::instance()->getAlbumNameFromUID(albumId);
-    for (DBImgInfo info : dbInfoList) {
-        QVariantMap tmpMap;
-        if (info.itemType == ItemTypePic) {
-            if (filterType == 2) {
-                continue ;
-            }
-            tmpMap.insert("itemType", "pciture");
-        } else if (info.itemType == ItemTypeVideo) {
-            if (filterType == 1) {
-                continue ;
-            }
-            tmpMap.insert("itemType", "video");
-        } else {
-            tmpMap.insert("itemType", "other");
-        }
-        tmpMap.insert("url", "file://" + info.filePath);
-        tmpMap.insert("filePath", info.filePath);
-        tmpMap.insert("pathHash", info.pathHash);
-        tmpMap.insert("remainDays", info.remainDays);
-        list << tmpMap;
-    }
-    if (list.count() > 0) {
-        qDebug() << "AlbumControl::getImportTimelinesTitleInfosReverse - Branch: adding title" << title << "with" << list.count() << "items";
-        reMap.insert(title, list);
-    }
-    qDebug() << "AlbumControl::getImportTimelinesTitleInfosReverse - Function exit, returning" << reMap.size() << "title groups";
-    return reMap;
-}
-
-QVariantMap AlbumControl::getTrashAlbumInfos(const int &filterType)
-{
-    qDebug() << "AlbumControl::getTrashAlbumInfos - Function entry, filterType:" << filterType;
-    QVariantMap reMap;
-
-    QVariantList list;
-    DBImgInfoList dbInfoList = getTrashInfos(filterType);
-    QString title = QObject::tr("Trash");
-    for (DBImgInfo info : dbInfoList) {
-        QVariantMap tmpMap;
-        if (info.itemType == ItemTypePic) {
-            if (filterType == 2) {
-                continue ;
-            }
-            tmpMap.insert("itemType", "pciture");
-        } else if (info.itemType == ItemTypeVideo) {
-            if (filterType == 1) {
-                continue ;
-            }
-            tmpMap.insert("itemType", "video");
-        } else {
-            tmpMap.insert("itemType", "other");
-        }
-
-        //设置url为删除的路径
-        QString realPath = getDeleteFullPath(LibUnionImage_NameSpace::hashByString(info.filePath), DBImgInfo::getFileNameFromFilePath(info.filePath));
-        tmpMap.insert("url", "file://" + realPath);
-        tmpMap.insert("filePath", "file://" + info.filePath);
-        tmpMap.insert("pathHash", info.pathHash);
-        tmpMap.insert("remainDays", info.remainDays);
-        list << tmpMap;
-    }
-    if (list.count() > 0) {
-        qDebug() << "AlbumControl::getTrashAlbumInfos - Branch: adding title" << title << "with" << list.count() << "items";
-        reMap.insert(title, list);
-    }
-    qDebug() << "AlbumControl::getTrashAlbumInfos - Function exit, returning" << reMap.size() << "title groups";
-    return reMap;
-}
-
 bool AlbumControl::addCustomAlbumInfos(int albumId, const QList<QUrl> &urls)
 {
     qDebug() << "AlbumControl::addCustomAlbumInfos - Function entry, albumId:" << albumId << "urls count:" << urls.size();
@@ -1637,51 +1403,18 @@ int AlbumControl::getAllCount(const int &filterType)
 void AlbumControl::insertTrash(const QList<QUrl> &paths)
 {
     qDebug() << "AlbumControl::insertTrash - Function entry, paths count:" << paths.size();
-    // notify show progress start
-    emit sigDeleteProgress(0, paths.size());
-    // 先处理一下UI事件,否则进度条不显示
-    QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents, 50);
-    QStringList tmpList;
-    DBImgInfoList infos;
+    QStringList localPaths;
     for (const QUrl &url : paths) {
-        QString imagePath = url2localPath(url);
-        QFileInfo info(imagePath);
-
-        // 跳过不可写文件
-        if (!info.isWritable()) {
-            // qDebug() << "AlbumControl::insertTrash - Branch: skipping non-writable file:" << imagePath;
-            continue;
-        }
-
-        tmpList << imagePath;
-
-        DBImgInfoList tempInfos = DBManager::instance()->getInfosByPath(imagePath);
-        if (tempInfos.size()) {
-            // qDebug() << "AlbumControl::insertTrash - Branch: found" << tempInfos.size() << "database entries for:" << imagePath;
-            DBImgInfo insertInfo = tempInfos.first();
-            QStringList uids;
-            for (const DBImgInfo &dbInfo : tempInfos) {
-                uids.push_back(dbInfo.albumUID);
-            }
-
-            insertInfo.albumUID = uids.join(",");
-            infos << insertInfo;
-        }
+        localPaths << url2localPath(url);
     }
 
-    DBManager::instance()->insertTrashImgInfos(infos, true);
-
-    // notify show progress end
-    int count = tmpList.size();
-    emit sigDeleteProgress(count + 1, count);
+    // notify show progress start
+    emit sigDeleteProgress(0, paths.size());
 
-    //新增删除主相册数据库
-    DBManager::instance()->removeImgInfos(tmpList);
-    // 通知前端刷新相关界面，包括自定义相册/我的收藏/合集-所有项目/已导入
-    sigRefreshCustomAlbum(-1);
-    sigRefreshAllCollection();
-    sigRefreshImportAlbum();
-    sigRefreshSearchView();
+    //文件操作和数据库更新在线程中执行，进度异步通知
+    TrashImagesThread *trashThread = new TrashImagesThread;
+    trashThread->setData(localPaths);
+    QThreadPool::globalInstance()->start(trashThread);
     qDebug() << "AlbumControl::insertTrash - Function exit";
 }
 
@@ -1869,16 +1602,11 @@ QString AlbumControl::getCustomAlbumByUid(const int &index)
 DBImgInfoList AlbumControl::getTrashInfos(const int &filterType)
 {
     qDebug() << "AlbumControl::getTrashInfos - Function entry, filterType:" << filterType;
+    //已到期的数据由 TrashExpiryScheduler 在后台清理，查询结果中不包含到期数据
     DBImgInfoList allTrashInfos = DBManager::instance()->getAllTrashInfos_getRemainDays();
-    QDateTime currentTime = QDateTime::currentDateTime();
-    DBImgInfoList list;
     for (int i = allTrashInfos.size() - 1; i >= 0; i--) {
         DBImgInfo pinfo = allTrashInfos.at(i);
-        if (!QFile::exists(pinfo.filePath) &&
-                !QFile::exists(getDeleteFullPath(pinfo.pathHash, pinfo.getFileNameFromFilePath()))) {
-            allTrashInfos.removeAt(i);
-        } else if (pinfo.remainDays <= 0) {
-            list << pinfo;
+        if (!DBManager::isTrashFileAvailable(pinfo.filePath, pinfo.pathHash)) {
             allTrashInfos.removeAt(i);
         } else if (pinfo.itemType == ItemTypePic) {
             if (filterType == 2) {
@@ -1890,45 +1618,26 @@ DBImgInfoList AlbumControl::getTrashInfos(const int &filterType)
             }
         }
     }
-    //清理删除时间过长图片
-    if (!list.isEmpty()) {
-        qDebug() << "AlbumControl::getTrashInfos - Branch: removing" << list.size() << "items from trash database";
-        QStringList image_list;
-        for (DBImgInfo info : list) {
-            image_list << info.filePath;
-        }
-        DBManager::instance()->removeTrashImgInfosNoSignal(image_list);
-    }
     qDebug() << "AlbumControl::getTrashInfos - Function exit, returning" << allTrashInfos.size() << "items";
     return allTrashInfos;
 }
 
-DBImgInfoList AlbumControl::getTrashInfos2(const int &filterType)
+/**
+   @brief 分页获取最近删除中的数据，只检查当前页文件是否存在，打开最近删除的开销与页大小相关，
+    文件已不存在的数据会被过滤，\a hasMore 按数据库中的行数返回是否还有下一页
+ */
+DBImgInfoList AlbumControl::getTrashInfos2(const int &filterType, int offset, int limit, bool *hasMore)
 {
-    qDebug() << "AlbumControl::getTrashInfos2 - Function entry, filterType:" << filterType;
-    DBImgInfoList allTrashInfos = DBManager::instance()->getAllTrashInfos_getRemainDays();
-    QDateTime currentTime = QDateTime::currentDateTime();
-    DBImgInfoList list;
+    qDebug() << "AlbumControl::getTrashInfos2 - Function entry, filterType:" << filterType << "offset:" << offset << "limit:" << limit;
+    DBImgInfoList allTrashInfos = DBManager::instance()->getTrashInfosPage(ItemType(filterType), offset, limit);
+    if (hasMore) {
+        *hasMore = allTrashInfos.size() >= limit;
+    }
     for (int i = allTrashInfos.size() - 1; i >= 0; i--) {
-        DBImgInfo pinfo = allTrashInfos.at(i);
-        if (!QFile::exists(pinfo.filePath) &&
-                !QFile::exists(getDeleteFullPath(pinfo.pathHash, pinfo.getFileNameFromFilePath()))) {
-            allTrashInfos.removeAt(i);
-        } else if (pinfo.remainDays <= 0) {
-            list << pinfo;
+        const DBImgInfo &pinfo = allTrashInfos.at(i);
+        if (!DBManager::isTrashFileAvailable(pinfo.filePath, pinfo.pathHash)) {
             allTrashInfos.removeAt(i);
-        } else if (pinfo.itemType != filterType && filterType != ItemTypeNull) {
-            allTrashInfos.removeAt(i);
-        }
-    }
-    //清理删除时间过长图片
-    if (!list.isEmpty()) {
-        qDebug() << "AlbumControl::getTrashInfos2 - Branch: removing" << list.size() << "items from trash database";
-        QStringList image_list;
-        for (DBImgInfo info : list) {
-            image_list << info.filePath;
         }
-        DBManager::instance()->removeTrashImgInfosNoSignal(image_list);
     }
     return allTrashInfos;
 }
@@ -1982,18 +1691,21 @@ const QString AlbumControl::getNewAlbumName(const QString &baseName)
     return static_cast<const QString>(albumName);
 }
 
+/**
+   @brief 选中项中有未收藏的图片时可以收藏，由相册成员索引做一次位运算判断
+ */
 bool AlbumControl::canFavorite(const QStringList &pathList)
 {
     qDebug() << "AlbumControl::canFavorite - Function entry, pathList count:" << pathList.size();
-    bool bCanFavorite = false;
-    for (int i = 0; i < pathList.size(); i++) {
-        if (!pathList[i].isEmpty() && !photoHaveFavorited(pathList[i])) {
-            // qDebug() << "AlbumControl::canFavorite - Branch: found non-favorited item:" << pathList[i];
-            bCanFavorite = true;
-            break;
+    QStringList localPaths;
+    for (const QString &path : pathList) {
+        if (!path.isEmpty()) {
+            localPaths << url2localPath(path);
         }
     }
 
+    bool bCanFavorite = !localPaths.isEmpty()
+                        && !DBManager::instance()->isAllImgExistInAlbum(DBManager::SpUID::u_Favorite, localPaths, AlbumDBType::Favourite);
     qDebug() << "AlbumControl::canFavorite - Function exit, returning:" << bCanFavorite;
     return bCanFavorite;
 }
@@ -2001,15 +1713,14 @@ bool AlbumControl::canFavorite(const QStringList &pathList)
 bool AlbumControl::canAddToCustomAlbum(const int &albumId, const QStringList &pathList)
 {
     qDebug() << "AlbumControl::canAddToCustomAlbum - Function entry, albumId:" << albumId << "pathList count:" << pathList.size();
-    bool bCanAddToCustom = false;
-    for (int i = 0; i < pathList.size(); i++) {
-        if (!pathList[i].isEmpty() && !photoHaveAddedToCustomAlbum(albumId, pathList[i])) {
-            // qDebug() << "AlbumControl::canAddToCustomAlbum - Branch: found item not in custom album:" << pathList[i];
-            bCanAddToCustom = true;
-            break;
+    QStringList localPaths;
+    for (const QString &path : pathList) {
+        if (!path.isEmpty()) {
+            localPaths << url2localPath(path);
         }
     }
 
+    bool bCanAddToCustom = !localPaths.isEmpty() && !DBManager::instance()->isAllImgExistInAlbum(albumId, localPaths);
     qDebug() << "AlbumControl::canAddToCustomAlbum - Function exit, returning:" << bCanAddToCustom;
     return bCanAddToCustom;
 }
@@ -2033,25 +1744,15 @@ bool AlbumControl::photoHaveAddedToCustomAlbum(int albumId, const QString &path)
 int AlbumControl::getCustomAlbumInfoConut(const int &albumId, const int &filterType)
 {
     qDebug() << "AlbumControl::getCustomAlbumInfoConut - Function entry, albumId:" << albumId << "filterType:" << filterType;
-    int rePicVideoConut = 0;
-    DBImgInfoList dbInfoList = DBManager::instance()->getInfosByAlbum(albumId, false);
-    for (DBImgInfo info : dbInfoList) {
-        QVariantMap tmpMap;
-        if (info.itemType == ItemTypePic) {
-            if (filterType == 2) {
-                qDebug() << "AlbumControl::getCustomAlbumInfoConut - Branch: skipping picture due to video filter";
-                continue ;
-            }
-        } else if (info.itemType == ItemTypeVideo) {
-            if (filterType == 1) {
-                qDebug() << "AlbumControl::getCustomAlbumInfoConut - Branch: skipping video due to picture filter";
-                continue ;
-            }
-        }
-        rePicVideoConut++;
+    ItemType type = ItemTypeNull;
+    if (filterType == 2) {
+        type = ItemTypeVideo;
+    } else if (filterType == 1) {
+        type = ItemTypePic;
     }
-    qDebug() << "AlbumControl::getCustomAlbumInfoConut - Function exit, returning count:" << rePicVideoConut;
-    return rePicVideoConut;
+    int count = DBManager::instance()->getItemsCountByAlbum(albumId, type);
+    qDebug() << "AlbumControl::getCustomAlbumInfoConut - Function exit, returning count:" << count;
+    return count;
 }
 
 int AlbumControl::getAllInfoConut(const int &filterType)
@@ -2074,19 +1775,18 @@ int AlbumControl::getAllInfoConut(const int &filterType)
 int AlbumControl::getTrashInfoConut(const int &filterType)
 {
     qDebug() << "AlbumControl::getTrashInfoConut - Function entry, filterType:" << filterType;
-    DBImgInfoList allTrashInfos;
+    int count = 0;
     if (filterType == 0) {
         qDebug() << "AlbumControl::getTrashInfoConut - Branch: getting all trash items";
-        allTrashInfos = getTrashInfos2(ItemTypeNull);
+        count = DBManager::instance()->getTrashImgsCount(ItemTypeNull);
     } else if (filterType == 1) {
         qDebug() << "AlbumControl::getTrashInfoConut - Branch: getting picture trash items";
-        allTrashInfos = getTrashInfos2(ItemTypePic);
+        count = DBManager::instance()->getTrashImgsCount(ItemTypePic);
     } else if (filterType == 2) {
         qDebug() << "AlbumControl::getTrashInfoConut - Branch: getting video trash items";
-        allTrashInfos = getTrashInfos2(ItemTypeVideo);
+        count = DBManager::instance()->getTrashImgsCount(ItemTypeVideo);
     }
 
-    int count = allTrashInfos.size();
     qDebug() << "AlbumControl::getTrashInfoConut - Function exit, returning count:" << count;
     return count;
 }
@@ -2254,21 +1954,9 @@ QVariantList AlbumControl::getClassificationData()
         return result;
     }
 
-    // 获取所有图片信息
-    DBImgInfoList allInfos = DBManager::instance()->getAllInfos(ItemTypePic);
-
-    bool hasUnclassified = std::any_of(allInfos.begin(), allInfos.end(), [](const DBImgInfo &info) {
-        return info.className.isEmpty();
-    });
+    // 未分类的图片由后台调度增量处理，这里只返回已有的分类结果，新结果写入后通过 sigClassificationUpdated 刷新
+    ClassifyScheduler::instance()->wakeUp();
 
-    // 如果存在未分类图片，触发重新分类
-    if (hasUnclassified) {
-        qDebug() << "Found unclassified images, starting classification...";
-        classifyOldDBInfo(allInfos);
-        return result;
-    }
-
-    // 直接获取分类结果，不在这里触发分类
     for (const QString &className : g_classList) {
         DBImgInfoList classImages = DBManager::instance()->getInfosForClass(className);
         if (classImages.isEmpty())
@@ -2312,11 +2000,10 @@ QStringList AlbumControl::imageCanExportFormat(const QString &path)
     return formats;
 }
 
-bool AlbumControl::saveAsImage(const QString &path, const QString &saveName, int index, const QString &fileFormat, int pictureQuality, const QString &saveFolder)
+int AlbumControl::saveAsImage(const QString &path, const QString &saveName, int index, const QString &fileFormat, int pictureQuality, const QString &saveFolder)
 {
     qDebug() << "AlbumControl::saveAsImage - Function entry, path:" << path << "saveName:" << saveName << "index:" << index
              << "fileFormat:" << fileFormat << "pictureQuality:" << pictureQuality << "saveFolder:" << saveFolder;
-    bool bRet = false;
     QString localPath = url2localPath(path);
     QString savePath;
     QString finalSaveFolder;
@@ -2360,36 +2047,32 @@ bool AlbumControl::saveAsImage(const QString &path, const QString &saveName, int
     formats << "xbm";
     formats << "xpm";
     QFileInfo info(localPath);
+    if (!info.exists()) {
+        qWarning() << "AlbumControl::saveAsImage - Source file does not exist:" << localPath;
+        return -1;
+    }
+
+    ExportJob job;
+    job.srcPath = localPath;
+    job.dstPath = savePath;
+    job.size = info.size();
+    auto normalizeSuffix = [](const QString &suffix) {
+        return suffix.toLower() == "jpeg" ? QString("jpg") : suffix.toLower();
+    };
     if (!formats.contains(info.suffix())) {
-
         qDebug() << "AlbumControl::saveAsImage - Branch: non-standard format, using direct file copy";
-        QFileInfo fileinfo(savePath);
-        if (fileinfo.exists() && !fileinfo.isDir()) {
-            //目标位置与原图位置相同则直接返回
-            if (localPath == savePath) {
-                qDebug() << "AlbumControl::saveAsImage - Branch: target path is same as source, returning true";
-                return true;
-            }
-            //目标位置与原图位置不同则先删除再复制
-            qDebug() << "AlbumControl::saveAsImage - Branch: target file exists, removing it first";
-            if (QFile::remove(savePath)) {
-                bRet = QFile::copy(localPath, savePath);
-            }
-        } else {
-            bRet = QFile::copy(localPath, savePath);
-            qDebug() << "AlbumControl::saveAsImage - Branch: direct file copy, result:" << bRet;
-        }
+    } else if (normalizeSuffix(info.suffix()) == normalizeSuffix(fileFormat) && pictureQuality >= 100) {
+        //格式相同且不降低质量时直接复制原文件，避免重新编码
+        qDebug() << "AlbumControl::saveAsImage - Branch: same format, using direct file copy";
     } else {
-        qDebug() << "AlbumControl::saveAsImage - Branch: standard format, using QImage save";
-        QImage m_saveImage;
-        QString errMsg;
-        LibUnionImage_NameSpace::loadStaticImageFromFile(localPath, m_saveImage, errMsg);
-        bRet = m_saveImage.save(savePath, fileFormat.toUpper().toLocal8Bit().data(), pictureQuality);
-        qDebug() << "AlbumControl::saveAsImage - Branch: image save result:" << bRet;
+        qDebug() << "AlbumControl::saveAsImage - Branch: standard format, transcoding";
+        job.format = fileFormat;
+        job.quality = pictureQuality;
     }
 
-    qDebug() << "AlbumControl::saveAsImage - Function exit, returning:" << bRet;
-    return bRet;
+    int jobId = startExport({job});
+    qDebug() << "AlbumControl::saveAsImage - Function exit, job id:" << jobId;
+    return jobId;
 }
 
 QString AlbumControl::getFolder()
@@ -2452,10 +2135,13 @@ bool AlbumControl::getFolders(const QStringList &paths)
     return bRet;
 }
 
-bool AlbumControl::exportFolders(const QStringList &paths, const QString &dir)
+/**
+   @brief 选择目录后在其中新建 \a dir 目录并在后台导出，返回导出任务编号，
+          未选择目录时返回 0，创建目录失败返回 -1
+ */
+int AlbumControl::exportFolders(const QStringList &paths, const QString &dir)
 {
     qDebug() << "AlbumControl::exportFolders - Function entry, paths count:" << paths.size() << "dir:" << dir;
-    bool bRet = true;
     QFileDialog dialog;
     QString fileDir;
     dialog.setDirectory(QStandardPaths::writableLocation(QStandardPaths::HomeLocation));
@@ -2465,37 +2151,69 @@ bool AlbumControl::exportFolders(const QStringList &paths, const QString &dir)
     if (dialog.exec()) {
         fileDir = dialog.selectedFiles().first();
     }
-    QStringList localPaths;
-    for (QString path : paths) {
-        localPaths << url2localPath(path);
+    if (fileDir.isEmpty()) {
+        qDebug() << "AlbumControl::exportFolders - Branch: no directory selected";
+        return 0;
     }
-    if (!fileDir.isEmpty()) {
-        QString newDir = fileDir + "/" + dir;
-        QDir a;
-        a.mkdir(newDir);
 
+    QString newDir = fileDir + "/" + dir;
+    if (!QDir().mkpath(newDir)) {
+        qWarning() << "AlbumControl::exportFolders - Failed to create export directory:" << newDir;
+        return -1;
+    }
 
-        for (QString path : localPaths) {
+    QList<ExportJob> jobs;
+    QSet<QString> usedNames;
+    for (const QString &path : paths) {
+        QFileInfo srcInfo(url2localPath(path));
+        // 不同目录下的同名文件导出到同一目录，依次追加 " (n)" 区分，避免并行导出写入同一目标
+        QString name = srcInfo.completeBaseName() + "." + srcInfo.completeSuffix();
+        for (int n = 1; usedNames.contains(name); ++n) {
+            name = QString("%1 (%2).%3").arg(srcInfo.completeBaseName()).arg(n).arg(srcInfo.completeSuffix());
+        }
+        usedNames.insert(name);
 
-            QString savePath = newDir + "/" + QFileInfo(path).completeBaseName() + "." + QFileInfo(path).completeSuffix();
-            QFileInfo fileinfo(savePath);
-            if (fileinfo.exists() && !fileinfo.isDir()) {
-                //目标位置与原图位置相同则直接返回
-                if (path == savePath) {
-                    qDebug() << "AlbumControl::exportFolders - Branch: target path is same as source, returning true";
-                    return true;
-                }
-                //目标位置与原图位置不同则先删除再复制
-                if (QFile::remove(savePath)) {
-                    bRet = QFile::copy(path, savePath);
-                }
-            } else {
-                bRet = QFile::copy(path, savePath);
-            }
+        ExportJob job;
+        job.srcPath = srcInfo.filePath();
+        job.dstPath = newDir + "/" + name;
+        job.size = srcInfo.size();
+        jobs << job;
+    }
+    int jobId = startExport(jobs);
+    qDebug() << "AlbumControl::exportFolders - Function exit, job id:" << jobId;
+    return jobId;
+}
+
+/**
+   @brief 在后台启动导出任务，返回任务编号，进度和结果通过 sigExportProgress/sigExportFinished 通知
+ */
+int AlbumControl::startExport(const QList<ExportJob> &jobs)
+{
+    if (jobs.isEmpty()) {
+        return -1;
+    }
+
+    const int jobId = ++m_exportJobId;
+    ExportImagesThread *exportThread = new ExportImagesThread(jobId);
+    exportThread->setData(jobs);
+    m_exportThreads.removeAll(nullptr);
+    m_exportThreads << exportThread;
+    QThreadPool::globalInstance()->start(exportThread);
+    return jobId;
+}
+
+/**
+   @brief 取消导出任务，\a jobId 为 -1 时取消全部，已导出的文件保留
+ */
+void AlbumControl::cancelExport(int jobId)
+{
+    m_exportThreads.removeAll(nullptr);
+    for (const QPointer<ExportImagesThread> &exportThread : std::as_const(m_exportThreads)) {
+        if (exportThread && (-1 == jobId || exportThread->jobId() == jobId)) {
+            qInfo() << "Cancel export job:" << exportThread->jobId();
+            exportThread->needStop(nullptr);
         }
     }
-    qDebug() << "AlbumControl::exportFolders - Function exit, returning:" << bRet;
-    return bRet;
 }
 
 void AlbumControl::openDeepinMovie(const QString &path)
@@ -2731,54 +2449,77 @@ void AlbumControl::loadDeviceAlbumInfoAsync(const QString &devicePath)
         return;
     }
 
-    m_PhonePicFileMap.insert(devicePath, nullptr);
-    QThreadPool::globalInstance()->start([=](){
-        // Notify load device info
-        Q_EMIT deviceAlbumInfoLoadStart(devicePath);
+    // 先显示上次插入时缓存的文件列表，后台扫描完成后再整体替换
+    DeviceInfoPtr devicePtr = DeviceInfoPtr::create();
+    devicePtr->fileTypeMap = DeviceIndexer::instance()->cachedListing(devicePath);
+    devicePtr->fromCache = !devicePtr->fileTypeMap.isEmpty();
+    for (ItemType type : std::as_const(devicePtr->fileTypeMap)) {
+        if (ItemTypePic == type)
+            devicePtr->picCount++;
+        else
+            devicePtr->videoCount++;
+    }
+    m_PhonePicFileMap.insert(devicePath, devicePtr);
 
-        //获取所选文件类型过滤器
-        QStringList filters;
-        for (QString i : LibUnionImage_NameSpace::unionImageSupportFormat()) {
-            filters << "*." + i;
-        }
-        for (QString i : LibUnionImage_NameSpace::videoFiletypes()) {
-            filters << "*." + i;
-        }
+    // Notify load device info
+    Q_EMIT deviceAlbumInfoLoadStart(devicePath);
+    if (devicePtr->fromCache) {
+        qDebug() << "AlbumControl::loadDeviceAlbumInfoAsync - Branch: show cached listing, count:" << devicePtr->fileTypeMap.size();
+        Q_EMIT deviceAlbumInfoLoadFinished(devicePath);
+        Q_EMIT deviceAlbumInfoCountChanged(devicePath, devicePtr->picCount, devicePtr->videoCount);
+    }
 
-        //定义迭代器并设置过滤器，包括子目录：QDirIterator::Subdirectories
-        QDirIterator dir_iterator(devicePath,
-                                  filters,
-                                  QDir::Files/* | QDir::NoSymLinks*/,
-                                  QDirIterator::Subdirectories);
-
-        DeviceInfoPtr devicePtr = DeviceInfoPtr::create();
-        while (dir_iterator.hasNext()) {
-            dir_iterator.next();
-
-            ItemType type;
-            QString filePath = dir_iterator.filePath();
-            if (LibUnionImage_NameSpace::isImage(filePath)) {
-                type = ItemTypePic;
-                devicePtr->picCount++;
-            } else if (LibUnionImage_NameSpace::isVideo(filePath)) {
-                type = ItemTypeVideo;
-                devicePtr->videoCount++;
-            } else {
-                continue;
-            }
+    DeviceIndexer::instance()->startScan(devicePath);
+    qDebug() << "AlbumControl::loadDeviceAlbumInfoAsync - Function exit";
+}
 
-            devicePtr->fileTypeMap.insert(filePath, type);
-        }
+/**
+   @brief 扫描过程中分批合并新发现的文件，已显示缓存列表时等待扫描完成
+ */
+void AlbumControl::onDeviceFilesFound(const QString &devicePath, const QMap<QString, ItemType> &files)
+{
+    DeviceInfoPtr devicePtr = m_PhonePicFileMap.value(devicePath);
+    if (devicePtr.isNull() || devicePtr->fromCache)
+        return;
+
+    QMap<QString, ItemType> added;
+    for (auto itr = files.constBegin(); itr != files.constEnd(); ++itr) {
+        if (devicePtr->fileTypeMap.contains(itr.key()))
+            continue;
+        devicePtr->fileTypeMap.insert(itr.key(), itr.value());
+        if (ItemTypePic == itr.value())
+            devicePtr->picCount++;
+        else
+            devicePtr->videoCount++;
+        added.insert(itr.key(), itr.value());
+    }
+    if (added.isEmpty())
+        return;
 
-        // GUI thread, notify update data
-        QMetaObject::invokeMethod(qApp, [=](){
-                m_PhonePicFileMap.insert(devicePath, devicePtr);
+    Q_EMIT deviceAlbumInfoAppended(devicePath, fromDeviceAlbumInfoList(added, ItemTypeNull));
+    Q_EMIT deviceAlbumInfoCountChanged(devicePath, devicePtr->picCount, devicePtr->videoCount);
+}
 
-                Q_EMIT deviceAlbumInfoLoadFinished(devicePath);
-                Q_EMIT deviceAlbumInfoCountChanged(devicePath, devicePtr->picCount, devicePtr->videoCount);
-            }, Qt::QueuedConnection);
-    });
-    qDebug() << "AlbumControl::loadDeviceAlbumInfoAsync - Function exit";
+void AlbumControl::onDeviceScanFinished(const QString &devicePath, const QMap<QString, ItemType> &files)
+{
+    DeviceInfoPtr devicePtr = m_PhonePicFileMap.value(devicePath);
+    if (devicePtr.isNull())
+        return;
+
+    devicePtr->fileTypeMap = files;
+    devicePtr->picCount = 0;
+    devicePtr->videoCount = 0;
+    for (ItemType type : files) {
+        if (ItemTypePic == type)
+            devicePtr->picCount++;
+        else
+            devicePtr->videoCount++;
+    }
+    devicePtr->loading = false;
+    devicePtr->fromCache = false;
+
+    Q_EMIT deviceAlbumInfoLoadFinished(devicePath);
+    Q_EMIT deviceAlbumInfoCountChanged(devicePath, devicePtr->picCount, devicePtr->videoCount);
 }
 
 DBImgInfoList AlbumControl::getDeviceAlbumInfoList(const QString &devicePath, const int &filterType, bool *loading)
@@ -2790,6 +2531,9 @@ DBImgInfoList AlbumControl::getDeviceAlbumInfoList(const QString &devicePath, co
         DeviceInfoPtr devicePtr = *(itr);
         if (!devicePtr.isNull()) {
             qDebug() << "AlbumControl::getDeviceAlbumInfoList - Branch: device info valid, returning album list";
+            // 扫描中返回已发现的部分文件
+            if (loading)
+                *loading = devicePtr->loading && !devicePtr->fromCache;
             return fromDeviceAlbumInfoList(devicePtr->fileTypeMap, filterType);
         }
     }
@@ -2869,74 +2613,33 @@ QList<int> AlbumControl::getPicVideoCountFromPaths(const QStringList &paths, con
 void AlbumControl::importFromMountDevice(const QStringList &paths, const int &index)
 {
     qDebug() << "AlbumControl::importFromMountDevice - Function entry, paths count:" << paths.size() << "index:" << index;
-    //采用线程执行导入
-    QThread *thread = QThread::create([ = ] {
-        qDebug() << "AlbumControl::importFromMountDevice - Branch: starting import thread";
-        QStringList localPaths;
-        for (QString path : paths)
-        {
-            localPaths << url2localPath(path);
-        }
-        QStringList newPathList;
-        DBImgInfoList dbInfos;
-        QString strHomePath = QDir::homePath();
-        //获取系统现在的时间
-        QString strDate = QDateTime::currentDateTime().toString("yyyy-MM-dd");
-        QString basePath = QString("%1%2%3/%4").arg(strHomePath, "/Pictures/", tr("Pictures"), strDate);
-        QDir dir;
-        if (!dir.exists(basePath))
-        {
-            dir.mkpath(basePath);
-        }
-        for (QString strPath : localPaths)
-        {
-            //取出文件名称
-            QStringList pathList = strPath.split("/", Qt::SkipEmptyParts);
-            QStringList nameList = pathList.last().split(".", Qt::SkipEmptyParts);
-            QString strNewPath = QString("%1%2%3%4%5%6").arg(basePath, "/", nameList.first(),
-                                                             QString::number(QDateTime::currentDateTime().toMSecsSinceEpoch()), ".", nameList.last());
-            //判断新路径下是否存在目标文件，若不存在，继续循环
-            if (!dir.exists(strPath)) {
-                continue;
-            }
-            //判断新路径下是否存在目标文件，若存在，先删除掉
-            if (dir.exists(strNewPath)) {
-                dir.remove(strNewPath);
-            }
-            newPathList << strNewPath;
-            QFileInfo fi(strNewPath);
-            //复制失败的图片不算在成功导入
-            if (QFile::copy(strPath, strNewPath)) {
-                dbInfos << getDBInfo(strNewPath, LibUnionImage_NameSpace::isVideo(strNewPath));
-            } else {
-                newPathList.removeOne(strNewPath);
-            }
+    QStringList localPaths;
+    for (const QString &path : paths) {
+        localPaths << url2localPath(path);
+    }
 
-        }
-        if (!dbInfos.isEmpty())
-        {
-            QStringList pathslist;
-            int idblen = dbInfos.length();
-            for (int i = 0; i < idblen; i++) {
-                if (m_bneedstop) {
-                    return;
-                }
-                pathslist << dbInfos[i].filePath;
-            }
+    emit sigImportStart();
 
+    //采用线程执行导入，多路并行复制
+    ImportFromDeviceThread *importThread = new ImportFromDeviceThread;
+    importThread->setData(localPaths, index);
+    m_deviceImportThreads << importThread;
+    QThreadPool::globalInstance()->start(importThread);
+    qDebug() << "AlbumControl::importFromMountDevice - Function exit";
+}
 
-            DBManager::instance()->insertImgInfos(dbInfos);
-            if (index > 0) {
-                DBManager::instance()->insertIntoAlbum(index, pathslist);
-                emit sigRefreshCustomAlbum(index);
-            }
-            emit sigRefreshImportAlbum();
-            emit sigRefreshAllCollection();
+/**
+   @brief 取消从 \a devicePath 导入的任务，已复制完成的文件仍会写入数据库
+ */
+void AlbumControl::cancelDeviceImport(const QString &devicePath)
+{
+    m_deviceImportThreads.removeAll(nullptr);
+    for (const QPointer<ImportFromDeviceThread> &importThread : std::as_const(m_deviceImportThreads)) {
+        if (importThread && importThread->isImportingFrom(devicePath)) {
+            qInfo() << "Cancel importing from device:" << devicePath;
+            importThread->needStop(nullptr);
         }
-    });
-    thread->start();
-    connect(thread, &QThread::destroyed, thread, &QObject::deleteLater);
-    qDebug() << "AlbumControl::importFromMountDevice - Function exit";
+    }
 }
 
 QString AlbumControl::getYearCoverPath(const QString &year)
@@ -2963,24 +2666,13 @@ QStringList AlbumControl::getDayPaths(const QString &day)
 int AlbumControl::getDayInfoCount(const QString &day, const int &filterType)
 {
     qDebug() << "AlbumControl::getDayInfoCount - Function entry, day:" << day << "filterType:" << filterType;
-    int rePicVideoConut = 0;
-    QStringList list = getDayPaths(day);
-    for (QString path : list) {
-        QVariantMap tmpMap;
-        if (LibUnionImage_NameSpace::isImage(url2localPath(path))) {
-            if (filterType == ItemTypePic) {
-                qDebug() << "AlbumControl::getDayInfoCount - Branch: counting image for picture filter";
-                rePicVideoConut++;
-            }
-        } else if (LibUnionImage_NameSpace::isVideo(url2localPath(path))) {
-            if (filterType == ItemTypeVideo) {
-                qDebug() << "AlbumControl::getDayInfoCount - Branch: counting video for video filter";
-                rePicVideoConut++;
-            }
-        }
+    //filterType 与 ItemType 取值一致，其余取值不计数
+    if (filterType != ItemTypePic && filterType != ItemTypeVideo) {
+        return 0;
     }
-    qDebug() << "AlbumControl::getDayInfoCount - Function exit, returning count:" << rePicVideoConut;
-    return rePicVideoConut;
+    int count = DBManager::instance()->getDayCount(day, static_cast<ItemType>(filterType));
+    qDebug() << "AlbumControl::getDayInfoCount - Function exit, returning count:" << count;
+    return count;
 }
 
 //获取日期
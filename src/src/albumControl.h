@@ -6,6 +6,7 @@
 #define AlbumControl_H
 
 #include <QObject>
+#include <QPointer>
 #include <QUrl>
 #include "unionimage/unionimage.h"
 #include "dbmanager/dbmanager.h"
@@ -15,6 +16,9 @@
 using namespace dfmmount;
 
 class FileInotifyGroup;
+class ImportFromDeviceThread;
+class ExportImagesThread;
+struct ExportJob;
 
 class AlbumControl : public QObject
 {
@@ -83,25 +87,6 @@ public:
     //获得某一导入时间的全部路径
     Q_INVOKABLE QStringList getImportTimelinesTitlePaths(const QString &titleName, const int &filterType = 0);
 
-    //QVariantMap接口
-    //获得默认时间线的全部info  , 0:全部 1:图片 2:视频
-    Q_INVOKABLE QVariantMap getTimelinesTitleInfos(const int &filterType = 0);
-
-    //获得年创建时间线 0:全部 1:图片 2:视频
-    Q_INVOKABLE QVariantMap getYearTimelinesInfos(const int &filterType = 0);
-
-    //获得月创建时间线  0:全部 1:图片 2:视频
-    Q_INVOKABLE QVariantMap getMonthTimelinesInfos(const int &filterType = 0);
-
-    //获得月创建时间线  0:全部 1:图片 2:视频
-    Q_INVOKABLE QVariantMap getDayTimelinesInfos(const int &filterType = 0);
-
-    //获得某一导入时间线的全部info  , 0:全部 1:图片 2:视频
-    Q_INVOKABLE QVariantMap getImportTimelinesTitleInfos(const int &filterType = 0);
-
-    //获得某一导入时间线的全部info  ,倒序， 0:全部 1:图片 2:视频
-    Q_INVOKABLE QVariantList getImportTimelinesTitleInfosReverse(const int &filterType = 0);
-
     //获得图片和视频总数
     Q_INVOKABLE int getAllCount(const int &filterType = 0);
 
@@ -141,12 +126,6 @@ public:
     //获得自定义的相册的全部info  albumId 0:我的收藏  1:截图录屏  2:相机 3:画板 4-~:其他自定义,filterType 0:全部 1:图片 2:视频
     Q_INVOKABLE QStringList getAlbumPaths(const int &albumId, const int &filterType = 0);
 
-    //获得自定义的相册的全部info  albumId 0:我的收藏  1:截图录屏  2:相机 3:画板 4-~:其他自定义,filterType 0:全部 1:图片 2:视频
-    Q_INVOKABLE QVariantMap getAlbumInfos(const int &albumId, const int &filterType = 0);
-
-    //获得最近删除的相册的全部info  , 0:全部 1:图片 2:视频
-    Q_INVOKABLE QVariantMap getTrashAlbumInfos(const int &filterType = 0);
-
     //添加到自定义相册
     Q_INVOKABLE bool addCustomAlbumInfos(int albumId, const QList <QUrl> &urls);
 
@@ -206,8 +185,8 @@ public:
     //输入一张图片，获得可以导出的格式
     Q_INVOKABLE QStringList imageCanExportFormat(const QString &path);
 
-    //输入一张图片，获得可以导出的格式
-    Q_INVOKABLE bool saveAsImage(const QString &path, const QString &saveName, int index, const QString &fileFormat, int pictureQuality = 100, const QString &saveFolder = nullptr);
+    //将一张图片另存为指定格式，后台执行，返回导出任务编号，失败返回 -1
+    Q_INVOKABLE int saveAsImage(const QString &path, const QString &saveName, int index, const QString &fileFormat, int pictureQuality = 100, const QString &saveFolder = nullptr);
 
     //获得选择路径
     Q_INVOKABLE QString getFolder();
@@ -215,8 +194,11 @@ public:
     //选择路径导出视频
     Q_INVOKABLE bool getFolders(const QStringList &paths);
 
-    //选择路径导出文件及目录
-    Q_INVOKABLE bool exportFolders(const QStringList &paths, const QString &dir);
+    //选择路径导出文件及目录，返回导出任务编号，未选择目录返回 0，失败返回 -1
+    Q_INVOKABLE int exportFolders(const QStringList &paths, const QString &dir);
+
+    //取消导出任务，-1 为取消全部
+    Q_INVOKABLE void cancelExport(int jobId = -1);
 
     //用影院打开视频
     Q_INVOKABLE void openDeepinMovie(const QString &path);
@@ -256,12 +238,15 @@ public:
     DBImgInfoList getDeviceAlbumInfoList(const QString &devicePath, const int &filterType = 0, bool *loading = nullptr);
     Q_SIGNAL void deviceAlbumInfoLoadStart(const QString &devicePath);
     Q_SIGNAL void deviceAlbumInfoLoadFinished(const QString &devicePath);
+    // 扫描过程中新发现的文件，界面可先行显示
+    Q_SIGNAL void deviceAlbumInfoAppended(const QString &devicePath, const DBImgInfoList &infos);
 
     Q_INVOKABLE void getDeviceAlbumInfoCountAsync(const QString &devicePath);
     Q_SIGNAL void deviceAlbumInfoCountChanged(const QString &devicePath, int picCount, int videoCount);
 
     //手机照片导入 0为已导入，1-n为自定义相册
     Q_INVOKABLE void importFromMountDevice(const QStringList &paths, const int &index = 0);
+    void cancelDeviceImport(const QString &devicePath);
 
     //获取年封面图片路径
     Q_INVOKABLE QString getYearCoverPath(const QString &year);
@@ -339,8 +324,8 @@ public:
     //获得最近删除的文件
     DBImgInfoList getTrashInfos(const int &filterType = 0);
 
-    //获得最近删除的文件
-    DBImgInfoList getTrashInfos2(const int &filterType = 0);
+    //分页获得最近删除的文件
+    DBImgInfoList getTrashInfos2(const int &filterType, int offset, int limit, bool *hasMore = nullptr);
 
     //获得收藏文件
     DBImgInfoList getCollectionInfos();
@@ -360,6 +345,9 @@ public:
     //获得日月年所有创建时间线  0所有 1年 2月 3日
     QStringList getTimelinesTitle(TimeLineEnum timeEnum, const int &filterType = 0);
 
+    //获得按时间线分组的原生数据，顺序与 getTimelinesTitle 一致，供 TimelineSectionModel 直接使用
+    QList<QPair<QString, DBImgInfoList>> getTimelineSections(TimeLineEnum timeEnum, const int &filterType = 0);
+
     //初始化
     void initMonitor();
 
@@ -418,6 +406,14 @@ signals:
     void sigImportFinished();
     //导入失败
     void sigImportFailed(int error);
+    //导入速度，单位字节/秒
+    void sigImportSpeed(qint64 bytesPerSecond);
+    //导出进度信号
+    void sigExportProgress(int jobId, int value, int max);
+    //导出速度，单位字节/秒
+    void sigExportSpeed(int jobId, qint64 bytesPerSecond);
+    //导出完成信号
+    void sigExportFinished(int jobId, int succeeded, int failed);
     //删除进度信号
     void sigDeleteProgress(int value, int max = 100);
 
@@ -445,11 +441,14 @@ signals:
     // 通知打开了非图片/视频文件的格式
     void sigInvalidFormat();
 
-    void sigImageClassifyStarted();
+    // 后台分类有新的结果写入数据库
+    void sigClassificationUpdated();
 
-    void progressOfImageClassify(int total, int value);
+    // 后台分类队列已全部处理完
+    void sigClassificationFinished();
 
-    void sigImageClassifyFinished();
+    // 最近删除中的到期数据已被清理
+    void sigTrashExpired();
 
 private :
     static AlbumControl *m_instance;
@@ -476,10 +475,18 @@ private :
     struct DeviceInfo {
         int picCount{0};
         int videoCount{0};
+        bool loading{true};     // 扫描尚未完成，fileTypeMap 为部分结果
+        bool fromCache{false};  // fileTypeMap 来自上次插入时的缓存，扫描完成后整体替换
         QMap<QString, ItemType> fileTypeMap;
     };
     using DeviceInfoPtr = QSharedPointer<DeviceInfo>;
     QMap<QString, DeviceInfoPtr> m_PhonePicFileMap;   // 外部设备及其全部图片路径
+    QList<QPointer<ImportFromDeviceThread>> m_deviceImportThreads;   // 正在进行的设备导入
+    QList<QPointer<ExportImagesThread>> m_exportThreads;   // 正在进行的导出
+    int m_exportJobId = 0;
+    int startExport(const QList<ExportJob> &jobs);
+    void onDeviceFilesFound(const QString &devicePath, const QMap<QString, ItemType> &files);
+    void onDeviceScanFinished(const QString &devicePath, const QMap<QString, ItemType> &files);
     std::atomic_bool m_couldRun;
     bool m_bneedstop = false;
     QMutex m_mutex;
@@ -0,0 +1,166 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "albummembershipindex.h"
+
+#include <QDebug>
+
+bool AlbumMembershipIndex::isLoaded() const
+{
+    QReadLocker locker(&m_lock);
+    return m_loaded;
+}
+
+void AlbumMembershipIndex::reset(const QList<QPair<int, QString>> &rows)
+{
+    QWriteLocker locker(&m_lock);
+    m_ids.clear();
+    m_albums.clear();
+    // 先分配编号，位图按最终大小一次分配
+    for (const QPair<int, QString> &row : rows) {
+        idForHash(row.second);
+    }
+    for (const QPair<int, QString> &row : rows) {
+        QBitArray &bits = m_albums[row.first];
+        if (bits.isEmpty()) {
+            bits.resize(m_ids.size());
+        }
+        bits.setBit(m_ids.value(row.second));
+    }
+    m_loaded = true;
+    qDebug() << "Album membership index loaded, images:" << m_ids.size() << "albums:" << m_albums.size();
+}
+
+void AlbumMembershipIndex::invalidate()
+{
+    QWriteLocker locker(&m_lock);
+    m_loaded = false;
+    m_ids.clear();
+    m_albums.clear();
+}
+
+void AlbumMembershipIndex::insert(int UID, const QStringList &pathHashs)
+{
+    QWriteLocker locker(&m_lock);
+    if (!m_loaded) {
+        return;
+    }
+
+    QList<int> ids;
+    ids.reserve(pathHashs.size());
+    for (const QString &hash : pathHashs) {
+        ids << idForHash(hash);
+    }
+
+    QBitArray &bits = m_albums[UID];
+    if (bits.size() < m_ids.size()) {
+        bits.resize(m_ids.size());
+    }
+    for (int id : std::as_const(ids)) {
+        bits.setBit(id);
+    }
+}
+
+void AlbumMembershipIndex::remove(int UID, const QStringList &pathHashs)
+{
+    QWriteLocker locker(&m_lock);
+    auto itr = m_albums.find(UID);
+    if (!m_loaded || itr == m_albums.end()) {
+        return;
+    }
+
+    for (const QString &hash : pathHashs) {
+        const int id = m_ids.value(hash, -1);
+        if (id >= 0 && id < itr->size()) {
+            itr->clearBit(id);
+        }
+    }
+}
+
+void AlbumMembershipIndex::removeAlbum(int UID)
+{
+    QWriteLocker locker(&m_lock);
+    m_albums.remove(UID);
+}
+
+void AlbumMembershipIndex::removeFromAllAlbums(const QStringList &pathHashs)
+{
+    QWriteLocker locker(&m_lock);
+    if (!m_loaded || m_albums.isEmpty()) {
+        return;
+    }
+
+    // 先构造待删除集合，再对每个相册做一次 AND NOT
+    QBitArray removed(m_ids.size());
+    for (const QString &hash : pathHashs) {
+        const int id = m_ids.value(hash, -1);
+        if (id >= 0) {
+            removed.setBit(id);
+        }
+    }
+    for (QBitArray &bits : m_albums) {
+        QBitArray mask = removed;
+        mask.resize(bits.size());
+        bits &= ~mask;
+    }
+}
+
+bool AlbumMembershipIndex::contains(int UID, const QString &pathHash) const
+{
+    QReadLocker locker(&m_lock);
+    const int id = m_ids.value(pathHash, -1);
+    const auto itr = m_albums.constFind(UID);
+    return id >= 0 && itr != m_albums.constEnd() && id < itr->size() && itr->testBit(id);
+}
+
+bool AlbumMembershipIndex::containsAll(int UID, const QStringList &pathHashs) const
+{
+    QReadLocker locker(&m_lock);
+    bool allIndexed = true;
+    const QBitArray selected = selection(pathHashs, &allIndexed);
+    // 不在任何相册中的图片没有编号，必然不在该相册中
+    if (!allIndexed) {
+        return false;
+    }
+
+    QBitArray bits = m_albums.value(UID);
+    bits.resize(selected.size());
+    return (selected & ~bits).count(true) == 0;
+}
+
+bool AlbumMembershipIndex::containsAny(int UID, const QStringList &pathHashs) const
+{
+    QReadLocker locker(&m_lock);
+    const QBitArray selected = selection(pathHashs, nullptr);
+    return (selected & m_albums.value(UID)).count(true) > 0;
+}
+
+/**
+   @brief 返回路径 hash 对应的编号，不存在时分配新编号，需在持有写锁时调用
+ */
+int AlbumMembershipIndex::idForHash(const QString &pathHash)
+{
+    auto itr = m_ids.find(pathHash);
+    if (itr == m_ids.end()) {
+        itr = m_ids.insert(pathHash, m_ids.size());
+    }
+    return itr.value();
+}
+
+/**
+   @brief 将路径 hash 列表转换为位图，\a allIndexed 返回是否所有 hash 都有编号，需在持有读锁时调用
+ */
+QBitArray AlbumMembershipIndex::selection(const QStringList &pathHashs, bool *allIndexed) const
+{
+    QBitArray selected(m_ids.size());
+    for (const QString &hash : pathHashs) {
+        const int id = m_ids.value(hash, -1);
+        if (id >= 0) {
+            selected.setBit(id);
+        } else if (allIndexed) {
+            *allIndexed = false;
+        }
+    }
+    return selected;
+}
@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ALBUMMEMBERSHIPINDEX_H
+#define ALBUMMEMBERSHIPINDEX_H
+
+#include <QBitArray>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QReadWriteLock>
+#include <QStringList>
+
+/*
+ * 相册成员关系的内存索引，图片路径 hash 映射为连续的整数编号，每个相册（包括我的收藏）对应一个位图，
+ * 选中项是否都在某个相册中等批量判断转换为位运算，不再逐条查询数据库。
+ * 由 DBManager 在修改 AlbumTable3 时同步更新，未加载时更新操作直接忽略，加载时以数据库为准
+ */
+class AlbumMembershipIndex
+{
+public:
+    bool isLoaded() const;
+    // 以 AlbumTable3 中的 (UID, PathHash) 记录重建索引
+    void reset(const QList<QPair<int, QString>> &rows);
+    // 无法精确同步的修改后调用，下次查询时重新加载
+    void invalidate();
+
+    void insert(int UID, const QStringList &pathHashs);
+    void remove(int UID, const QStringList &pathHashs);
+    void removeAlbum(int UID);
+    void removeFromAllAlbums(const QStringList &pathHashs);
+
+    bool contains(int UID, const QString &pathHash) const;
+    bool containsAll(int UID, const QStringList &pathHashs) const;
+    bool containsAny(int UID, const QStringList &pathHashs) const;
+
+private:
+    int idForHash(const QString &pathHash);
+    QBitArray selection(const QStringList &pathHashs, bool *allIndexed) const;
+
+private:
+    mutable QReadWriteLock m_lock;
+    bool m_loaded { false };
+    QHash<QString, int> m_ids;          // 路径 hash 到位图下标，编号只增不减
+    QHash<int, QBitArray> m_albums;     // 相册 UID 到成员位图
+};
+
+#endif   // ALBUMMEMBERSHIPINDEX_H
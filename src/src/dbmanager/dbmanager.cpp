@@ -11,6 +11,8 @@
 #include "unionimage/unionimage.h"
 #include "unionimage/unionimage_global.h"
 #include "../albumControl.h"
+#include "imageengine/movieservice.h"
+#include "utils/perfmetrics.h"
 
 #include <QDebug>
 #include <QDir>
@@ -23,6 +25,9 @@
 
 //#include "imageengineapi.h"
 
+static const qint64 sc_DaySecs = 24 * 60 * 60;
+static const qint64 sc_TrashKeepSecs = 30 * sc_DaySecs;   // 最近删除中保留 30 天
+
 DBManager *DBManager::m_dbManager = nullptr;
 std::once_flag DBManager::instanceFlag;
 QReadWriteLock DBManager::m_fileMutex;
@@ -55,7 +60,8 @@ DBManager::DBManager(QObject *parent)
 
 const QStringList DBManager::getAllPaths(const ItemType &filterType) const
 {
-    qDebug() << "DBManager::getAllPaths - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getAllPaths");
+    qCDebug(logDatabase) << "DBManager::getAllPaths - Entry";
     QMutexLocker mutex(&m_dbMutex);
     QStringList paths;
 
@@ -82,13 +88,14 @@ const QStringList DBManager::getAllPaths(const ItemType &filterType) const
     }
 
 
-    qDebug() << "DBManager::getAllPaths - Exit, paths:" << paths;
+    qCDebug(logDatabase) << "DBManager::getAllPaths - Exit, paths:" << paths;
     return paths;
 }
 
 const DBImgInfoList DBManager::getAllInfos(int loadCount)const
 {
-    qDebug() << "DBManager::getAllInfos - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getAllInfos");
+    qCDebug(logDatabase) << "DBManager::getAllInfos - Entry";
     QMutexLocker mutex(&m_dbMutex);
     DBImgInfoList infos;
     m_query->setForwardOnly(true);
@@ -113,13 +120,14 @@ const DBImgInfoList DBManager::getAllInfos(int loadCount)const
             infos << info;
         }
     }
-    qDebug() << "DBManager::getAllInfos - Exit";
+    qCDebug(logDatabase) << "DBManager::getAllInfos - Exit";
     return infos;
 }
 
 const DBImgInfoList DBManager::getAllInfosSort(const ItemType &filterType) const
 {
-    qDebug() << "DBManager::getAllInfosSort - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getAllInfosSort");
+    qCDebug(logDatabase) << "DBManager::getAllInfosSort - Entry";
     QMutexLocker mutex(&m_dbMutex);
     DBImgInfoList infos;
     m_query->setForwardOnly(true);
@@ -145,13 +153,14 @@ const DBImgInfoList DBManager::getAllInfosSort(const ItemType &filterType) const
             infos << info;
         }
     }
-    qDebug() << "DBManager::getAllInfosSort - Exit";
+    qCDebug(logDatabase) << "DBManager::getAllInfosSort - Exit";
     return infos;
 }
 
 const DBImgInfoList DBManager::getAllInfosByUID(QString UID) const
 {
-    qDebug() << "DBManager::getAllInfosByUID - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getAllInfosByUID");
+    qCDebug(logDatabase) << "DBManager::getAllInfosByUID - Entry";
     QMutexLocker mutex(&m_dbMutex);
     DBImgInfoList infos;
     m_query->setForwardOnly(true);
@@ -159,7 +168,7 @@ const DBImgInfoList DBManager::getAllInfosByUID(QString UID) const
     m_query->bindValue(":UID", UID);
 
     if (!b || ! m_query->exec()) {
-        qDebug() << "DBManager::getAllInfosByUID - Exit, exec failed";
+        qCDebug(logDatabase) << "DBManager::getAllInfosByUID - Exit, exec failed";
         return infos;
     } else {
         while (m_query->next()) {
@@ -175,31 +184,33 @@ const DBImgInfoList DBManager::getAllInfosByUID(QString UID) const
             infos << info;
         }
     }
-    qDebug() << "DBManager::getAllInfosByUID - Exit";
+    qCDebug(logDatabase) << "DBManager::getAllInfosByUID - Exit";
     return infos;
 }
 
 const QList<QDateTime> DBManager::getAllTimelines() const
 {
-    qDebug() << "DBManager::getAllTimelines - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getAllTimelines");
+    qCDebug(logDatabase) << "DBManager::getAllTimelines - Entry";
     QMutexLocker mutex(&m_dbMutex);
     QList<QDateTime> times;
     m_query->setForwardOnly(true);
     if (!m_query->exec("SELECT DISTINCT Time FROM ImageTable3 ORDER BY Time DESC")) {
-        qDebug() << "DBManager::getAllTimelines - Exit, exec failed";
+        qCDebug(logDatabase) << "DBManager::getAllTimelines - Exit, exec failed";
         return times;
     } else {
         while (m_query->next()) {
             times << m_query->value(0).toDateTime();
         }
     }
-    qDebug() << "DBManager::getAllTimelines - Exit";
+    qCDebug(logDatabase) << "DBManager::getAllTimelines - Exit";
     return times;
 }
 
 const DBImgInfoList DBManager::getInfosByTimeline(const QDateTime &timeline, const ItemType &filterType) const
 {
-    qDebug() << "DBManager::getInfosByTimeline - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getInfosByTimeline");
+    qCDebug(logDatabase) << "DBManager::getInfosByTimeline - Entry";
     QMutexLocker mutex(&m_dbMutex);
     DBImgInfoList infos;
     m_query->setForwardOnly(true);
@@ -214,7 +225,7 @@ const DBImgInfoList DBManager::getInfosByTimeline(const QDateTime &timeline, con
                                      "WHERE Time = :Date ORDER BY Time DESC"));
     }
     if (!b || !m_query->exec()) {
-        qDebug() << "DBManager::getInfosByTimeline - Exit, exec failed";
+        qCDebug(logDatabase) << "DBManager::getInfosByTimeline - Exit, exec failed";
     } else {
         while (m_query->next()) {
             DBImgInfo info;
@@ -225,13 +236,14 @@ const DBImgInfoList DBManager::getInfosByTimeline(const QDateTime &timeline, con
         }
     }
 
-    qDebug() << "DBManager::getInfosByTimeline - Exit";
+    qCDebug(logDatabase) << "DBManager::getInfosByTimeline - Exit";
     return infos;
 }
 
 const QList<QDateTime> DBManager::getImportTimelines() const
 {
-    qDebug() << "DBManager::getImportTimelines - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getImportTimelines");
+    qCDebug(logDatabase) << "DBManager::getImportTimelines - Entry";
     QMutexLocker mutex(&m_dbMutex);
     QList<QDateTime> importtimes;
 
@@ -242,13 +254,14 @@ const QList<QDateTime> DBManager::getImportTimelines() const
             importtimes << m_query->value(0).toDateTime();
         }
     }
-    qDebug() << "DBManager::getImportTimelines - Exit";
+    qCDebug(logDatabase) << "DBManager::getImportTimelines - Exit";
     return importtimes;
 }
 
 const DBImgInfoList DBManager::getInfosByImportTimeline(const QDateTime &timeline, const ItemType &filterType) const
 {
-    qDebug() << "DBManager::getInfosByImportTimeline - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getInfosByImportTimeline");
+    qCDebug(logDatabase) << "DBManager::getInfosByImportTimeline - Entry";
     QMutexLocker mutex(&m_dbMutex);
     DBImgInfoList infos;
     m_query->setForwardOnly(true);
@@ -265,7 +278,7 @@ const DBImgInfoList DBManager::getInfosByImportTimeline(const QDateTime &timelin
     }
 
     if (!b || !m_query->exec()) {
-        qDebug() << "DBManager::getInfosByImportTimeline - Exit, exec failed";
+        qCDebug(logDatabase) << "DBManager::getInfosByImportTimeline - Exit, exec failed";
     } else {
         while (m_query->next()) {
             DBImgInfo info;
@@ -276,31 +289,34 @@ const DBImgInfoList DBManager::getInfosByImportTimeline(const QDateTime &timelin
         }
     }
 
-    qDebug() << "DBManager::getInfosByImportTimeline - Exit";
+    qCDebug(logDatabase) << "DBManager::getInfosByImportTimeline - Exit";
     return infos;
 }
 
 const DBImgInfo DBManager::getInfoByPath(const QString &path) const
 {
-    qDebug() << "DBManager::getInfoByPath - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getInfoByPath");
+    qCDebug(logDatabase) << "DBManager::getInfoByPath - Entry";
     DBImgInfoList list = getImgInfos("FilePath", path, true);
     if (list.count() < 1) {
         return DBImgInfo();
     } else {
         return list.first();
     }
-    qDebug() << "DBManager::getInfoByPath - Exit";
+    qCDebug(logDatabase) << "DBManager::getInfoByPath - Exit";
 }
 
 const DBImgInfoList DBManager::getInfosByPath(const QString &path) const
 {
-    qDebug() << "DBManager::getInfosByPath - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getInfosByPath");
+    qCDebug(logDatabase) << "DBManager::getInfosByPath - Entry";
     return getImgInfos("FilePath", path, true);
 }
 
 int DBManager::getImgsCount(const ItemType &filterType) const
 {
-    qDebug() << "DBManager::getImgsCount - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getImgsCount");
+    qCDebug(logDatabase) << "DBManager::getImgsCount - Entry";
     QMutexLocker mutex(&m_dbMutex);
 
     m_query->setForwardOnly(true);
@@ -310,7 +326,7 @@ int DBManager::getImgsCount(const ItemType &filterType) const
                                      "WHERE FileType = :Type"));
         m_query->bindValue(":Type", filterType);
         if (!b || !m_query->exec()) {
-            qDebug() << "DBManager::getImgsCount - Exit, exec failed";
+            qCDebug(logDatabase) << "DBManager::getImgsCount - Exit, exec failed";
         } else {
             int count = 0;
             while (m_query->next()) {
@@ -323,18 +339,19 @@ int DBManager::getImgsCount(const ItemType &filterType) const
         if (m_query->exec("SELECT COUNT(*) FROM ImageTable3")) {
             m_query->first();
             int count = m_query->value(0).toInt();
-            qDebug() << "DBManager::getImgsCount - Exit";
+            qCDebug(logDatabase) << "DBManager::getImgsCount - Exit";
             return count;
         }
     }
 
-    qDebug() << "DBManager::getImgsCount - Exit, count: 0";
+    qCDebug(logDatabase) << "DBManager::getImgsCount - Exit, count: 0";
     return 0;
 }
 
 void DBManager::insertImgInfos(const DBImgInfoList &infos)
 {
-    qDebug() << "DBManager::insertImgInfos - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.insertImgInfos");
+    qCDebug(logDatabase) << "DBManager::insertImgInfos - Entry";
     QMutexLocker mutex(&m_dbMutex);
     m_query->setForwardOnly(true);
     if (!m_query->exec("BEGIN IMMEDIATE TRANSACTION")) {
@@ -365,19 +382,38 @@ void DBManager::insertImgInfos(const DBImgInfoList &infos)
         }
     }
 
+    //新导入的未分类图片加入后台分类队列，与图片数据在同一事务中提交
+    if (m_query->prepare(QString("INSERT OR IGNORE INTO ClassifyQueueTable3 (PathHash, FilePath, State, RetryCount, UpdateTime) "
+                                 "VALUES (?, ?, %1, 0, ?)").arg(ClassifyPending))) {
+        const qint64 now = QDateTime::currentSecsSinceEpoch();
+        for (const auto &info : infos) {
+            if (info.itemType != ItemTypePic || !info.className.isEmpty())
+                continue;
+            m_query->addBindValue(LibUnionImage_NameSpace::hashByString(info.filePath));
+            m_query->addBindValue(info.filePath);
+            m_query->addBindValue(now);
+            if (!m_query->exec()) {
+                qWarning() << "Failed to enqueue classify task:" << info.filePath << m_query->lastError().text();
+            }
+        }
+    } else {
+        qWarning() << "Failed to prepare classify queue statement:" << m_query->lastError().text();
+    }
+
     if (!m_query->exec("COMMIT")) {
         qWarning() << "Failed to commit transaction:" << m_query->lastError().text();
     } else {
         qInfo() << "Successfully inserted" << infos.size() << "images";
     }
-    qDebug() << "DBManager::insertImgInfos - Exit";
+    qCDebug(logDatabase) << "DBManager::insertImgInfos - Exit";
 }
 
 void DBManager::removeImgInfos(const QStringList &paths)
 {
-    qDebug() << "DBManager::removeImgInfos - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.removeImgInfos");
+    qCDebug(logDatabase) << "DBManager::removeImgInfos - Entry";
     if (paths.isEmpty()) {
-        qDebug() << "No images to remove";
+        qCDebug(logDatabase) << "No images to remove";
         return;
     }
 
@@ -414,6 +450,7 @@ void DBManager::removeImgInfos(const QStringList &paths)
     if (!m_query->exec("COMMIT")) {
         qWarning() << "Failed to commit transaction:" << m_query->lastError().text();
     }
+    m_albumIndex.removeFromAllAlbums(pathHashs);
 
     // Remove from image table
     if (!m_query->exec("BEGIN IMMEDIATE TRANSACTION")) {
@@ -439,12 +476,13 @@ void DBManager::removeImgInfos(const QStringList &paths)
     } else {
         qInfo() << "Successfully removed" << paths.size() << "images";
     }
-    qDebug() << "DBManager::removeImgInfos - Exit";
+    qCDebug(logDatabase) << "DBManager::removeImgInfos - Exit";
 }
 
 void DBManager::removeImgInfosNoSignal(const QStringList &paths)
 {
-    qDebug() << "DBManager::removeImgInfosNoSignal - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.removeImgInfosNoSignal");
+    qCDebug(logDatabase) << "DBManager::removeImgInfosNoSignal - Entry";
     QMutexLocker mutex(&m_dbMutex);
     if (paths.isEmpty()) {
         return;
@@ -471,6 +509,7 @@ void DBManager::removeImgInfosNoSignal(const QStringList &paths)
     if (!m_query->exec("COMMIT")) {
         //        qDebug() << "COMMIT failed.";
     }
+    m_albumIndex.removeFromAllAlbums(pathHashs);
 
     // Remove from image table
     if (!m_query->exec("BEGIN IMMEDIATE TRANSACTION")) {
@@ -482,13 +521,14 @@ void DBManager::removeImgInfosNoSignal(const QStringList &paths)
     }
 
     if (!m_query->exec("COMMIT")) {
-        qDebug() << "DBManager::removeImgInfosNoSignal - Exit, exec failed";
+        qCDebug(logDatabase) << "DBManager::removeImgInfosNoSignal - Exit, exec failed";
     }
-    qDebug() << "DBManager::removeImgInfosNoSignal - Exit";
+    qCDebug(logDatabase) << "DBManager::removeImgInfosNoSignal - Exit";
 }
 
 const DBImgInfoList DBManager::getInfosForClass(const QString &className) const
 {
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getInfosForClass");
     QMutexLocker mutex(&m_dbMutex);
     DBImgInfoList infos;
     m_query->setForwardOnly(true);
@@ -518,6 +558,7 @@ const DBImgInfoList DBManager::getInfosForClass(const QString &className) const
 
 const DBImgInfoList DBManager::getInfosForClassAndKeyword(const QString &className, const QString &keywords) const
 {
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getInfosForClassAndKeyword");
     QMutexLocker mutex(&m_dbMutex);
     DBImgInfoList infos;
     m_query->setForwardOnly(true);
@@ -547,7 +588,8 @@ const DBImgInfoList DBManager::getInfosForClassAndKeyword(const QString &classNa
 
 const QList<std::pair<int, QString>> DBManager::getAllAlbumNames(AlbumDBType atype) const
 {
-    qDebug() << "DBManager::getAllAlbumNames - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getAllAlbumNames");
+    qCDebug(logDatabase) << "DBManager::getAllAlbumNames - Entry";
     QMutexLocker mutex(&m_dbMutex);
     QList<std::pair<int, QString>> list;
     m_query->setForwardOnly(true);
@@ -558,13 +600,14 @@ const QList<std::pair<int, QString>> DBManager::getAllAlbumNames(AlbumDBType aty
         }
     }
 
-    qDebug() << "DBManager::getAllAlbumNames - Exit";
+    qCDebug(logDatabase) << "DBManager::getAllAlbumNames - Exit";
     return list;
 }
 
 bool DBManager::isDefaultAutoImportDB(int UID)
 {
-    qDebug() << "DBManager::isDefaultAutoImportDB - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.isDefaultAutoImportDB");
+    qCDebug(logDatabase) << "DBManager::isDefaultAutoImportDB - Entry";
     if (UID > u_Favorite && UID < u_CustomStart) {
         return true;
     } else {
@@ -574,14 +617,15 @@ bool DBManager::isDefaultAutoImportDB(int UID)
 
 std::tuple<QStringList, QStringList, QList<int>> DBManager::getDefaultNotifyPaths()
 {
-    qDebug() << "DBManager::getDefaultNotifyPaths - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getDefaultNotifyPaths");
+    qCDebug(logDatabase) << "DBManager::getDefaultNotifyPaths - Entry";
     //图片路径
     QStringList monitorPaths;
     QStringList monitorAlbumNames;
     QList<int>  monitorAlbumUIDs;
     auto stdPicPaths = QStandardPaths::standardLocations(QStandardPaths::PicturesLocation);
     if (!stdPicPaths.isEmpty()) {
-        qDebug() << "DBManager::getDefaultNotifyPaths - stdPicPaths is not empty";
+        qCDebug(logDatabase) << "DBManager::getDefaultNotifyPaths - stdPicPaths is not empty";
         auto stdPicPath = stdPicPaths[0];
 
         monitorPaths.push_back(stdPicPath + "/Screenshots");
@@ -600,7 +644,7 @@ std::tuple<QStringList, QStringList, QList<int>> DBManager::getDefaultNotifyPath
     //视频路径
     auto stdMoviePaths = QStandardPaths::standardLocations(QStandardPaths::MoviesLocation);
     if (!stdMoviePaths.isEmpty()) {
-        qDebug() << "DBManager::getDefaultNotifyPaths - stdMoviePaths is not empty";
+        qCDebug(logDatabase) << "DBManager::getDefaultNotifyPaths - stdMoviePaths is not empty";
         auto stdMoviePath = stdMoviePaths[0];
 
         monitorPaths.push_back(stdMoviePath + "/Screen Recordings");
@@ -614,13 +658,14 @@ std::tuple<QStringList, QStringList, QList<int>> DBManager::getDefaultNotifyPath
     }
 
     //返回tuple数据
-    qDebug() << "DBManager::getDefaultNotifyPaths - Exit";
+    qCDebug(logDatabase) << "DBManager::getDefaultNotifyPaths - Exit";
     return std::make_tuple(monitorPaths, monitorAlbumNames, monitorAlbumUIDs);
 }
 
 std::tuple<QList<QStringList>, QStringList, QList<int>> DBManager::getDefaultNotifyPaths_group()
 {
-    qDebug() << "DBManager::getDefaultNotifyPaths_group - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getDefaultNotifyPaths_group");
+    qCDebug(logDatabase) << "DBManager::getDefaultNotifyPaths_group - Entry";
     QList<QStringList> monitorPaths;
     QStringList monitorAlbumNames;
     QList<int>  monitorAlbumUIDs;
@@ -647,13 +692,14 @@ std::tuple<QList<QStringList>, QStringList, QList<int>> DBManager::getDefaultNot
     monitorAlbumUIDs.push_back(DBManager::SpUID::u_Draw);
 
     //返回tuple数据
-    qDebug() << "DBManager::getDefaultNotifyPaths_group - Exit";
+    qCDebug(logDatabase) << "DBManager::getDefaultNotifyPaths_group - Exit";
     return std::make_tuple(monitorPaths, monitorAlbumNames, monitorAlbumUIDs);
 }
 
 bool DBManager::defaultNotifyPathExists(int UID)
 {
-    qDebug() << "DBManager::defaultNotifyPathExists - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.defaultNotifyPathExists");
+    qCDebug(logDatabase) << "DBManager::defaultNotifyPathExists - Entry";
     if (!isDefaultAutoImportDB(UID)) { //如果连默认导入UID都不是，直接返回
         return false;
     }
@@ -672,13 +718,14 @@ bool DBManager::defaultNotifyPathExists(int UID)
             }
         }
     }
-    qDebug() << "DBManager::defaultNotifyPathExists - Exit";
+    qCDebug(logDatabase) << "DBManager::defaultNotifyPathExists - Exit";
     return isExists;
 }
 
 const QStringList DBManager::getPathsByAlbum(int UID) const
 {
-    qDebug() << "DBManager::getPathsByAlbum - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getPathsByAlbum");
+    qCDebug(logDatabase) << "DBManager::getPathsByAlbum - Entry";
     QMutexLocker mutex(&m_dbMutex);
     QStringList list;
     m_query->setForwardOnly(true);
@@ -694,13 +741,14 @@ const QStringList DBManager::getPathsByAlbum(int UID) const
         }
     }
 
-    qDebug() << "DBManager::getPathsByAlbum - Exit";
+    qCDebug(logDatabase) << "DBManager::getPathsByAlbum - Exit";
     return list;
 }
 
 const DBImgInfoList DBManager::getInfosByAlbum(int UID, bool needTimeData, ItemType itemType) const
 {
-    qDebug() << "DBManager::getInfosByAlbum - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getInfosByAlbum");
+    qCDebug(logDatabase) << "DBManager::getInfosByAlbum - Entry";
     QMutexLocker mutex(&m_dbMutex);
     DBImgInfoList infos;
     m_query->setForwardOnly(true);
@@ -749,98 +797,95 @@ const DBImgInfoList DBManager::getInfosByAlbum(int UID, bool needTimeData, ItemT
         }
     }
 
-    qDebug() << "DBManager::getInfosByAlbum - Exit";
+    qCDebug(logDatabase) << "DBManager::getInfosByAlbum - Exit";
     return infos;
 }
 
 int DBManager::getItemsCountByAlbum(int UID, const ItemType &type) const
 {
-    qDebug() << "DBManager::getItemsCountByAlbum - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getItemsCountByAlbum");
+    qCDebug(logDatabase) << "DBManager::getItemsCountByAlbum - Entry";
     int count = 0;
     QMutexLocker mutex(&m_dbMutex);
     m_query->setForwardOnly(true);
-    bool b = m_query->prepare("SELECT i.FileType "
-                              "FROM ImageTable3 AS i, AlbumTable3 AS a "
-                              "WHERE i.PathHash=a.PathHash "
-                              "AND a.UID=:UID ");
+    //只在数据库内聚合计数，由 album_uid_hash_index 和 image_hash_index 完成连接，不再逐行取回
+    QString sql("SELECT COUNT(DISTINCT a.PathHash) "
+                "FROM AlbumTable3 AS a INNER JOIN ImageTable3 AS i ON i.PathHash=a.PathHash "
+                "WHERE a.UID=:UID");
+    if (type == ItemTypePic || type == ItemTypeVideo) {
+        sql += " AND i.FileType=:Type";
+    }
+    bool b = m_query->prepare(sql);
     m_query->bindValue(":UID", UID);
+    if (type == ItemTypePic || type == ItemTypeVideo) {
+        m_query->bindValue(":Type", type);
+    }
     if (!b || ! m_query->exec()) {
-        //    qWarning() << "Get ImgInfo by album failed: " << query.lastError();
-    } else {
-        while (m_query->next()) {
-            ItemType itemType = static_cast<ItemType>(m_query->value(0).toInt());
-            if (type == ItemTypeNull || itemType == type) {
-                count++;
-            }
-        }
+        qWarning() << "Get items count by album failed: " << m_query->lastError();
+    } else if (m_query->next()) {
+        count = m_query->value(0).toInt();
     }
-    qDebug() << __FUNCTION__ << "---count = " << count;
+    qCDebug(logDatabase) << __FUNCTION__ << "---count = " << count;
     return count;
 }
 
-//判断是否所有要查询的数据都在要查询的相册中
+//判断是否所有要查询的数据都在要查询的相册中，相册 UID 唯一，\a atype 仅为兼容保留
 bool DBManager::isAllImgExistInAlbum(int UID, const QStringList &paths, AlbumDBType atype) const
 {
-    qDebug() << "DBManager::isAllImgExistInAlbum - Entry";
-    QMutexLocker mutex(&m_dbMutex);
-    m_query->setForwardOnly(true);
-    QString sql("SELECT COUNT(*) FROM AlbumTable3 WHERE PathHash In ( %1 ) AND UID = :UID AND AlbumDBType =:atype ");
-
-    QString hashList;
-    for (int i = 0; i < paths.size(); i++) {
-        QString path = paths.at(i);
-
-        if (hashList.length() > 0) {
-            hashList += ", ";
-        }
-        hashList += "'";
-        hashList += LibUnionImage_NameSpace::hashByString(path);
-        hashList += "'";
-    }
-
-    bool b = m_query->prepare(sql.arg(hashList));
-
-    if (!b) {
+    ALBUM_TRACE_SCOPE(logDatabase, "db.isAllImgExistInAlbum");
+    Q_UNUSED(atype)
+    if (paths.isEmpty()) {
         return false;
     }
-    m_query->bindValue(":UID", UID);
-    m_query->bindValue(":atype", atype);
-    if (m_query->exec()) {
-        m_query->first();
-        if (m_query->value(0).toInt() == paths.size()) {
-            return true;
-        } else {
-            return false;
-        }
-    } else {
-        return false;
+
+    QStringList pathHashs;
+    pathHashs.reserve(paths.size());
+    for (const QString &path : paths) {
+        pathHashs << LibUnionImage_NameSpace::hashByString(path);
     }
-    qDebug() << "DBManager::isAllImgExistInAlbum - Exit";
+
+    ensureAlbumIndex();
+    return m_albumIndex.containsAll(UID, pathHashs);
 }
 
 bool DBManager::isImgExistInAlbum(int UID, const QString &path) const
 {
-    qDebug() << "DBManager::isImgExistInAlbum - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.isImgExistInAlbum");
+    ensureAlbumIndex();
+    return m_albumIndex.contains(UID, LibUnionImage_NameSpace::hashByString(path));
+}
+
+/**
+   @brief 首次查询相册成员关系时从 AlbumTable3 加载内存索引，之后由各修改操作同步更新
+ */
+void DBManager::ensureAlbumIndex() const
+{
+    ALBUM_TRACE_SCOPE(logDatabase, "db.ensureAlbumIndex");
+    if (m_albumIndex.isLoaded()) {
+        return;
+    }
+
     QMutexLocker mutex(&m_dbMutex);
+    if (m_albumIndex.isLoaded()) {
+        return;
+    }
+
+    QList<QPair<int, QString>> rows;
     m_query->setForwardOnly(true);
-    bool b = m_query->prepare("SELECT COUNT(*) FROM AlbumTable3 WHERE PathHash = :hash "
-                              "AND UID = :UID ");
-    if (!b) {
-        return false;
+    if (!m_query->exec("SELECT UID, PathHash FROM AlbumTable3")) {
+        qWarning() << "Failed to load album membership:" << m_query->lastError().text();
+        return;
     }
-    m_query->bindValue(":hash", LibUnionImage_NameSpace::hashByString(path));
-    m_query->bindValue(":UID", UID);
-    if (m_query->exec()) {
-        m_query->first();
-        return (m_query->value(0).toInt() == 1);
-    } else {
-        return false;
+    while (m_query->next()) {
+        rows << qMakePair(m_query->value(0).toInt(), m_query->value(1).toString());
     }
+    m_albumIndex.reset(rows);
 }
 
 void DBManager::addCustomAlbumIdByPaths(int UID, const QStringList &paths)
 {
-    qDebug() << "DBManager::addCustomAlbumIdByPaths - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.addCustomAlbumIdByPaths");
+    qCDebug(logDatabase) << "DBManager::addCustomAlbumIdByPaths - Entry";
     //记录每个图片下关联的相册ID
     QMap<QString, QStringList> path2UidList;
     for (const auto &path : paths) {
@@ -881,12 +926,13 @@ void DBManager::addCustomAlbumIdByPaths(int UID, const QStringList &paths)
         //qDebug() << m_query->lastError();
     }
     mutex.unlock();
-    qDebug() << "DBManager::addCustomAlbumIdByPaths - Exit";
+    qCDebug(logDatabase) << "DBManager::addCustomAlbumIdByPaths - Exit";
 }
 
 void DBManager::removeCustomAlbumIdByPaths(int UID, const QStringList &paths)
 {
-    qDebug() << "DBManager::removeCustomAlbumIdByPaths - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.removeCustomAlbumIdByPaths");
+    qCDebug(logDatabase) << "DBManager::removeCustomAlbumIdByPaths - Entry";
     //记录每个图片下关联的相册ID
     QMap<QString, QStringList> path2UidList;
     for (const auto &path : paths) {
@@ -926,47 +972,50 @@ void DBManager::removeCustomAlbumIdByPaths(int UID, const QStringList &paths)
         //qDebug() << m_query->lastError();
     }
     mutex.unlock();
-    qDebug() << "DBManager::removeCustomAlbumIdByPaths - Exit";
+    qCDebug(logDatabase) << "DBManager::removeCustomAlbumIdByPaths - Exit";
 }
 
 QString DBManager::getAlbumNameFromUID(int UID) const
 {
-    qDebug() << "DBManager::getAlbumNameFromUID - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getAlbumNameFromUID");
+    qCDebug(logDatabase) << "DBManager::getAlbumNameFromUID - Entry";
     QMutexLocker mutex(&m_dbMutex);
     m_query->setForwardOnly(true);
     bool b = m_query->exec(QString("SELECT DISTINCT AlbumName FROM AlbumTable3 WHERE UID=%1").arg(UID));
     if (!b || !m_query->next()) {
-        qDebug() << "DBManager::getAlbumNameFromUID - Exit, exec failed";
+        qCDebug(logDatabase) << "DBManager::getAlbumNameFromUID - Exit, exec failed";
         return QString();
     }
 
-    qDebug() << "DBManager::getAlbumNameFromUID - Exit";
+    qCDebug(logDatabase) << "DBManager::getAlbumNameFromUID - Exit";
     return m_query->value(0).toString();
 }
 
 AlbumDBType DBManager::getAlbumDBTypeFromUID(int UID) const
 {
-    qDebug() << "DBManager::getAlbumDBTypeFromUID - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getAlbumDBTypeFromUID");
+    qCDebug(logDatabase) << "DBManager::getAlbumDBTypeFromUID - Entry";
     QMutexLocker mutex(&m_dbMutex);
     m_query->setForwardOnly(true);
     bool b = m_query->exec(QString("SELECT DISTINCT AlbumDBType FROM AlbumTable3 WHERE UID=%1").arg(UID));
     if (!b || !m_query->next()) {
-        qDebug() << "DBManager::getAlbumDBTypeFromUID - Exit, exec failed";
+        qCDebug(logDatabase) << "DBManager::getAlbumDBTypeFromUID - Exit, exec failed";
         return TypeCount;
     }
 
-    qDebug() << "DBManager::getAlbumDBTypeFromUID - Exit";
+    qCDebug(logDatabase) << "DBManager::getAlbumDBTypeFromUID - Exit";
     return static_cast<AlbumDBType>(m_query->value(0).toInt());
 }
 
 bool DBManager::isAlbumExistInDB(int UID, AlbumDBType atype) const
 {
-    qDebug() << "DBManager::isAlbumExistInDB - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.isAlbumExistInDB");
+    qCDebug(logDatabase) << "DBManager::isAlbumExistInDB - Entry";
     QMutexLocker mutex(&m_dbMutex);
     m_query->setForwardOnly(true);
     bool b = m_query->prepare("SELECT COUNT(*) FROM AlbumTable3 WHERE UID = :UID AND AlbumDBType =:atype");
     if (!b) {
-        qDebug() << "DBManager::isAlbumExistInDB - Exit, exec failed";
+        qCDebug(logDatabase) << "DBManager::isAlbumExistInDB - Exit, exec failed";
         return false;
     }
     m_query->bindValue(":UID", UID);
@@ -975,14 +1024,15 @@ bool DBManager::isAlbumExistInDB(int UID, AlbumDBType atype) const
         m_query->first();
         return (m_query->value(0).toInt() >= 1);
     } else {
-        qDebug() << "DBManager::isAlbumExistInDB - Exit, exec failed";
+        qCDebug(logDatabase) << "DBManager::isAlbumExistInDB - Exit, exec failed";
         return false;
     }
 }
 
 int DBManager::createAlbum(const QString &album, const QStringList &paths, AlbumDBType atype)
 {
-    qDebug() << "DBManager::createAlbum - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.createAlbum");
+    qCDebug(logDatabase) << "DBManager::createAlbum - Entry";
     QMutexLocker mutex(&m_dbMutex);
     int currentUID = albumMaxUID++;
     QStringList pathHashs;
@@ -995,7 +1045,7 @@ int DBManager::createAlbum(const QString &album, const QStringList &paths, Album
     auto qs = QString("REPLACE INTO AlbumTable3 (AlbumId, AlbumName, PathHash, AlbumDBType, UID) VALUES (null, \"%1\", ?, %2, %3)").arg(album).arg(atype).arg(currentUID);
     bool b = m_query->prepare(qs);
     if (!b) {
-        qDebug() << "DBManager::createAlbum - Exit, exec failed";
+        qCDebug(logDatabase) << "DBManager::createAlbum - Exit, exec failed";
         return -1;
     }
 
@@ -1006,7 +1056,7 @@ int DBManager::createAlbum(const QString &album, const QStringList &paths, Album
     }
 
     if (!m_query->exec("COMMIT")) {
-        qDebug() << "DBManager::createAlbum - Exit, exec failed";
+        qCDebug(logDatabase) << "DBManager::createAlbum - Exit, exec failed";
     }
 
     //FIXME: Don't insert the repeated filepath into the same album
@@ -1018,15 +1068,17 @@ int DBManager::createAlbum(const QString &album, const QStringList &paths, Album
     if (!m_query->exec(ps.arg(EMPTY_HASH_STR).arg(atype))) {
         //   qDebug() << "delete same date failed!";
     }
+    m_albumIndex.insert(currentUID, pathHashs);
 
     //把当前UID传出去
-    qDebug() << "DBManager::createAlbum - Exit";
+    qCDebug(logDatabase) << "DBManager::createAlbum - Exit";
     return currentUID;
 }
 
 bool DBManager::insertIntoAlbum(int UID, const QStringList &paths, AlbumDBType atype)
 {
-    qDebug() << "DBManager::insertIntoAlbum - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.insertIntoAlbum");
+    qCDebug(logDatabase) << "DBManager::insertIntoAlbum - Entry";
     QMutexLocker mutex(&m_dbMutex);
     m_query->setForwardOnly(true);
 
@@ -1046,9 +1098,11 @@ bool DBManager::insertIntoAlbum(int UID, const QStringList &paths, AlbumDBType a
                  .arg(album).arg(atype).arg(UID);
     if (!m_query->prepare(qs)) {
     }
+    QStringList insertedHashs;
     for (auto &eachPath : paths) {
         if (QFile::exists(eachPath)) { //需要路径存在才能执行添加到相册
-            m_query->addBindValue(LibUnionImage_NameSpace::hashByString(eachPath));
+            insertedHashs << LibUnionImage_NameSpace::hashByString(eachPath);
+            m_query->addBindValue(insertedHashs.last());
             if (!m_query->exec()) {
             }
         }
@@ -1066,28 +1120,32 @@ bool DBManager::insertIntoAlbum(int UID, const QStringList &paths, AlbumDBType a
     if (!m_query->exec(ps.arg(EMPTY_HASH_STR).arg(atype))) {
         //   qDebug() << "delete same date failed!";
     }
+    m_albumIndex.insert(UID, insertedHashs);
 
     mutex.unlock();
 
     //发信号通知上层
 //    emit dApp->signalM->insertedIntoAlbum(UID, paths);
 
-    qDebug() << "DBManager::insertIntoAlbum - Exit";
+    qCDebug(logDatabase) << "DBManager::insertIntoAlbum - Exit";
     return true;
 }
 
 void DBManager::removeAlbum(int UID)
 {
-    qDebug() << "DBManager::removeAlbum - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.removeAlbum");
+    qCDebug(logDatabase) << "DBManager::removeAlbum - Entry";
     QMutexLocker mutex(&m_dbMutex);
     if (!m_query->exec(QString("DELETE FROM AlbumTable3 WHERE UID=") + QString::number(UID))) {
     }
-    qDebug() << "DBManager::removeAlbum - Exit";
+    m_albumIndex.removeAlbum(UID);
+    qCDebug(logDatabase) << "DBManager::removeAlbum - Exit";
 }
 
 void DBManager::removeFromAlbum(int UID, const QStringList &paths, AlbumDBType atype)
 {
-    qDebug() << "DBManager::removeFromAlbum - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.removeFromAlbum");
+    qCDebug(logDatabase) << "DBManager::removeFromAlbum - Entry";
     QMutexLocker mutex(&m_dbMutex);
 
     QStringList pathHashs;
@@ -1110,8 +1168,9 @@ void DBManager::removeFromAlbum(int UID, const QStringList &paths, AlbumDBType a
     if (!m_query->exec("COMMIT")) {
         ;
     }
+    m_albumIndex.remove(UID, pathHashs);
     mutex.unlock();
-    qDebug() << "DBManager::removeFromAlbum - Exit";
+    qCDebug(logDatabase) << "DBManager::removeFromAlbum - Exit";
 //    if (success) {
 //        emit dApp->signalM->removedFromAlbum(UID, paths);
 //    }
@@ -1119,18 +1178,20 @@ void DBManager::removeFromAlbum(int UID, const QStringList &paths, AlbumDBType a
 
 bool DBManager::renameAlbum(int UID, const QString &newAlbum, AlbumDBType atype)
 {
-    qDebug() << "DBManager::renameAlbum - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.renameAlbum");
+    qCDebug(logDatabase) << "DBManager::renameAlbum - Entry";
     QMutexLocker mutex(&m_dbMutex);
     if (!m_query->exec(QString("UPDATE AlbumTable3 SET AlbumName=\"%1\" WHERE UID=%2 AND AlbumDBType=%3").arg(newAlbum).arg(UID).arg(atype))) {
         return false;
     }
 
-    qDebug() << "DBManager::renameAlbum - Exit, return true";
+    qCDebug(logDatabase) << "DBManager::renameAlbum - Exit, return true";
     return true;
 }
 
 void DBManager::updateClassName2DB(const DBImgInfoList &infos)
 {
+    ALBUM_TRACE_SCOPE(logDatabase, "db.updateClassName2DB");
     QMutexLocker mutex(&m_dbMutex);
 
     m_query->setForwardOnly(true);
@@ -1159,7 +1220,8 @@ void DBManager::updateClassName2DB(const DBImgInfoList &infos)
 
 const DBImgInfoList DBManager::getInfosByNameTimeline(const QString &value) const
 {
-    qDebug() << "DBManager::getInfosByNameTimeline - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getInfosByNameTimeline");
+    qCDebug(logDatabase) << "DBManager::getInfosByNameTimeline - Entry";
     QMutexLocker mutex(&m_dbMutex);
     DBImgInfoList infos;
     m_query->setForwardOnly(true);
@@ -1182,25 +1244,27 @@ const DBImgInfoList DBManager::getInfosByNameTimeline(const QString &value) cons
             infos << info;
         }
     }
-    qDebug() << "DBManager::getInfosByNameTimeline - Exit";
+    qCDebug(logDatabase) << "DBManager::getInfosByNameTimeline - Exit";
     return infos;
 }
 
 const DBImgInfoList DBManager::getInfosForKeyword(const QString &keywords) const
 {
-    qDebug() << "DBManager::getInfosForKeyword - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getInfosForKeyword");
+    qCDebug(logDatabase) << "DBManager::getInfosForKeyword - Entry";
     const DBImgInfoList list = getInfosByNameTimeline(keywords);
     if (list.count() < 1) {
         return DBImgInfoList();
     } else {
-        qDebug() << "DBManager::getInfosForKeyword - Exit";
+        qCDebug(logDatabase) << "DBManager::getInfosForKeyword - Exit";
         return list;
     }
 }
 
 const DBImgInfoList DBManager::getTrashInfosForKeyword(const QString &keywords) const
 {
-    qDebug() << "DBManager::getTrashInfosForKeyword - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getTrashInfosForKeyword");
+    qCDebug(logDatabase) << "DBManager::getTrashInfosForKeyword - Entry";
     QMutexLocker mutex(&m_dbMutex);
     DBImgInfoList infos;
     m_query->setForwardOnly(true);
@@ -1224,13 +1288,14 @@ const DBImgInfoList DBManager::getTrashInfosForKeyword(const QString &keywords)
             infos << info;
         }
     }
-    qDebug() << "DBManager::getTrashInfosForKeyword - Exit";
+    qCDebug(logDatabase) << "DBManager::getTrashInfosForKeyword - Exit";
     return infos;
 }
 
 const DBImgInfoList DBManager::getInfosForKeyword(int UID, const QString &keywords) const
 {
-    qDebug() << "DBManager::getInfosForKeyword - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getInfosForKeyword");
+    qCDebug(logDatabase) << "DBManager::getInfosForKeyword - Entry";
     QMutexLocker mutex(&m_dbMutex);
 
     DBImgInfoList infos;
@@ -1245,7 +1310,7 @@ const DBImgInfoList DBManager::getInfosForKeyword(int UID, const QString &keywor
     m_query->bindValue(":UID", UID);
 
     if (!b || ! m_query->exec()) {
-        qDebug() << "DBManager::getInfosForKeyword - Exit, exec failed";
+        qCDebug(logDatabase) << "DBManager::getInfosForKeyword - Exit, exec failed";
     } else {
         while (m_query->next()) {
             DBImgInfo info;
@@ -1257,13 +1322,14 @@ const DBImgInfoList DBManager::getInfosForKeyword(int UID, const QString &keywor
             infos << info;
         }
     }
-    qDebug() << "DBManager::getInfosForKeyword - Exit";
+    qCDebug(logDatabase) << "DBManager::getInfosForKeyword - Exit";
     return infos;
 }
 
 bool DBManager::updateImgPath(const QString &oldPath, const QString &newPath)
 {
-    qDebug() << "DBManager::updateImgPath - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.updateImgPath");
+    qCDebug(logDatabase) << "DBManager::updateImgPath - Entry";
     QString oldHash = LibUnionImage_NameSpace::hashByString(oldPath);
     QString newHash = LibUnionImage_NameSpace::hashByString(newPath);
 
@@ -1271,7 +1337,7 @@ bool DBManager::updateImgPath(const QString &oldPath, const QString &newPath)
 
     // 更新 AlbumTable3 表的 PathHash
     if (!m_query->exec("BEGIN IMMEDIATE TRANSACTION")) {
-        qDebug() << m_query->lastError();
+        qCDebug(logDatabase) << m_query->lastError();
         return false;
     }
     QString updateAlbumQs = "UPDATE AlbumTable3 SET PathHash=:newHash WHERE PathHash=:oldHash";
@@ -1284,13 +1350,15 @@ bool DBManager::updateImgPath(const QString &oldPath, const QString &newPath)
         return false;
     }
     if (!m_query->exec("COMMIT")) {
-        qDebug() << m_query->lastError();
+        qCDebug(logDatabase) << m_query->lastError();
         return false;
     }
+    //路径变化较少见，直接重建索引
+    m_albumIndex.invalidate();
 
     // 更新 ImageTable3 表的 PathHash 和 filePath
     if (!m_query->exec("BEGIN IMMEDIATE TRANSACTION")) {
-        qDebug() << m_query->lastError();
+        qCDebug(logDatabase) << m_query->lastError();
         return false;
     }
     QString updateImageQs = "UPDATE ImageTable3 SET PathHash=:newHash, filePath=:newPath WHERE PathHash=:oldHash";
@@ -1308,13 +1376,14 @@ bool DBManager::updateImgPath(const QString &oldPath, const QString &newPath)
     //    qDebug() << m_query->lastError();
         return false;
     }
-    qDebug() << "DBManager::updateImgPath - Exit, return true";
+    qCDebug(logDatabase) << "DBManager::updateImgPath - Exit, return true";
     return true;
 }
 
 const QMultiMap<QString, QString> DBManager::getAllPathAlbumNames() const
 {
-    qDebug() << "DBManager::getAllPathAlbumNames - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getAllPathAlbumNames");
+    qCDebug(logDatabase) << "DBManager::getAllPathAlbumNames - Entry";
     QMutexLocker mutex(&m_dbMutex);
 
     QMultiMap<QString, QString> infos;
@@ -1333,13 +1402,14 @@ const QMultiMap<QString, QString> DBManager::getAllPathAlbumNames() const
             infos.insert(m_query->value(0).toString(), m_query->value(1).toString());
         }
     }
-    qDebug() << "DBManager::getAllPathAlbumNames - Exit";
+    qCDebug(logDatabase) << "DBManager::getAllPathAlbumNames - Exit";
     return infos;
 }
 
 const DBImgInfoList DBManager::getImgInfos(const QString &key, const QString &value, bool needTimeData) const
 {
-    qDebug() << "DBManager::getImgInfos - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getImgInfos");
+    qCDebug(logDatabase) << "DBManager::getImgInfos - Entry";
     QMutexLocker mutex(&m_dbMutex);
     DBImgInfoList infos;
     m_query->setForwardOnly(true);
@@ -1376,13 +1446,14 @@ const DBImgInfoList DBManager::getImgInfos(const QString &key, const QString &va
             }
         }
     }
-    qDebug() << "DBManager::getImgInfos - Exit";
+    qCDebug(logDatabase) << "DBManager::getImgInfos - Exit";
     return infos;
 }
 
 bool DBManager::checkCustomAutoImportPathIsNotified(const QString &path)
 {
-    qDebug() << "DBManager::checkCustomAutoImportPathIsNotified - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.checkCustomAutoImportPathIsNotified");
+    qCDebug(logDatabase) << "DBManager::checkCustomAutoImportPathIsNotified - Entry";
     //检查是否是默认路径，这一段不涉及数据库操作，不需要加锁
     auto defaultPath = getDefaultNotifyPaths();
     auto pathsList = std::get<0>(defaultPath);
@@ -1418,13 +1489,14 @@ bool DBManager::checkCustomAutoImportPathIsNotified(const QString &path)
         }
     }
 
-    qDebug() << "DBManager::checkCustomAutoImportPathIsNotified - Exit, return false";
+    qCDebug(logDatabase) << "DBManager::checkCustomAutoImportPathIsNotified - Exit, return false";
     return false;
 }
 
 int DBManager::createNewCustomAutoImportPath(const QString &path, const QString &albumName)
 {
-    qDebug() << "DBManager::createNewCustomAutoImportPath - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.createNewCustomAutoImportPath");
+    qCDebug(logDatabase) << "DBManager::createNewCustomAutoImportPath - Entry";
     QMutexLocker mutex(&m_dbMutex);
 
     //1.新建相册
@@ -1434,6 +1506,7 @@ int DBManager::createNewCustomAutoImportPath(const QString &path, const QString
                        .arg(albumName).arg("7215ee9c7d9dc229d2921a40e899ec5f").arg(AutoImport).arg(UID))) {
         return -1;
     }
+    m_albumIndex.insert(UID, QStringList("7215ee9c7d9dc229d2921a40e899ec5f"));
 
     //2.新建保存路径
 
@@ -1442,13 +1515,14 @@ int DBManager::createNewCustomAutoImportPath(const QString &path, const QString
         return -1;
     }
 
-    qDebug() << "DBManager::createNewCustomAutoImportPath - Exit, return UID";
+    qCDebug(logDatabase) << "DBManager::createNewCustomAutoImportPath - Exit, return UID";
     return UID;
 }
 
 void DBManager::removeCustomAutoImportPath(int UID)
 {
-    qDebug() << "DBManager::removeCustomAutoImportPath - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.removeCustomAutoImportPath");
+    qCDebug(logDatabase) << "DBManager::removeCustomAutoImportPath - Entry";
     QMutexLocker mutex(&m_dbMutex);
     m_query->setForwardOnly(true);
 
@@ -1510,17 +1584,20 @@ void DBManager::removeCustomAutoImportPath(int UID)
 
     if (!m_query->exec("COMMIT")) {
     }
+    m_albumIndex.removeFromAllAlbums(hashs);
+    m_albumIndex.removeAlbum(UID);
 
     //发送信号通知上层
     mutex.unlock();
-    qDebug() << "DBManager::removeCustomAutoImportPath - Exit";
+    qCDebug(logDatabase) << "DBManager::removeCustomAutoImportPath - Exit";
 //    emit dApp->signalM->imagesRemoved();
 //    emit dApp->signalM->imagesRemovedPar(paths);
 }
 
 QMap <int, QString> DBManager::getAllCustomAutoImportUIDAndPath()
 {
-    qDebug() << "DBManager::getAllCustomAutoImportUIDAndPath - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getAllCustomAutoImportUIDAndPath");
+    qCDebug(logDatabase) << "DBManager::getAllCustomAutoImportUIDAndPath - Entry";
     QMap <int, QString> result;
 
     QMutexLocker mutex(&m_dbMutex);
@@ -1534,13 +1611,14 @@ QMap <int, QString> DBManager::getAllCustomAutoImportUIDAndPath()
         result.insert(m_query->value(0).toInt(), m_query->value(1).toString());
     }
 
-    qDebug() << "DBManager::getAllCustomAutoImportUIDAndPath - Exit";
+    qCDebug(logDatabase) << "DBManager::getAllCustomAutoImportUIDAndPath - Exit";
     return result;
 }
 
 QStringList DBManager::getAllCustomAutoImportNames()
 {
-    qDebug() << "DBManager::getAllCustomAutoImportNames - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getAllCustomAutoImportNames");
+    qCDebug(logDatabase) << "DBManager::getAllCustomAutoImportNames - Entry";
     QStringList result;
 
     QMutexLocker mutex(&m_dbMutex);
@@ -1554,18 +1632,19 @@ QStringList DBManager::getAllCustomAutoImportNames()
         result.push_back(m_query->value(0).toString());
     }
 
-    qDebug() << "DBManager::getAllCustomAutoImportNames - Exit";
+    qCDebug(logDatabase) << "DBManager::getAllCustomAutoImportNames - Exit";
     return result;
 }
 
 void DBManager::checkDatabase()
 {
-    qDebug() << "DBManager::checkDatabase - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.checkDatabase");
+    qCDebug(logDatabase) << "DBManager::checkDatabase - Entry";
     //先建文件夹，再建数据库
     QDir dd(DATABASE_PATH);
     if (! dd.exists()) {
         dd.mkpath(DATABASE_PATH);
-        qDebug() << "Created database directory:" << DATABASE_PATH;
+        qCDebug(logDatabase) << "Created database directory:" << DATABASE_PATH;
     }
 
     auto db = QSqlDatabase::addDatabase("QSQLITE");
@@ -1650,6 +1729,48 @@ void DBManager::checkDatabase()
         qWarning() << "Failed to create CustomAutoImportPathTable3:" << m_query->lastError().text();
     }
 
+    // 视频元数据缓存表，FileSize 和 ModifyTime 用于校验缓存是否过期
+    // MovieInfoTable3
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    //PathHash            | FilePath | FileSize | ModifyTime | Duration | Width   | Height  | VideoCodec //
+    //TEXT primari key    | TEXT     | INTEGER  | INTEGER    | TEXT     | INTEGER | INTEGER | TEXT       //
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    bool f = m_query->exec(QString("CREATE TABLE IF NOT EXISTS MovieInfoTable3 ( "
+                                   "PathHash TEXT primary key, "
+                                   "FilePath TEXT, "
+                                   "FileSize INTEGER, "
+                                   "ModifyTime INTEGER, "
+                                   "Duration TEXT, "
+                                   "Width INTEGER, "
+                                   "Height INTEGER, "
+                                   "VideoCodec TEXT, "
+                                   "VideoBitRate INTEGER, "
+                                   "Fps INTEGER, "
+                                   "AudioCodec TEXT, "
+                                   "AudioBitRate INTEGER, "
+                                   "Channels INTEGER, "
+                                   "Sampling INTEGER, "
+                                   "CreationTime TEXT)"));
+    if (!f) {
+        qWarning() << "Failed to create MovieInfoTable3:" << m_query->lastError().text();
+    }
+
+    // 后台分类任务队列，State 取值见 DBManager::ClassifyTaskState
+    // ClassifyQueueTable3
+    ///////////////////////////////////////////////////////////////////////////
+    //PathHash            | FilePath | State   | RetryCount | UpdateTime      //
+    //TEXT primari key    | TEXT     | INTEGER | INTEGER    | INTEGER(秒)     //
+    ///////////////////////////////////////////////////////////////////////////
+    bool g = m_query->exec(QString("CREATE TABLE IF NOT EXISTS ClassifyQueueTable3 ( "
+                                   "PathHash TEXT primary key, "
+                                   "FilePath TEXT, "
+                                   "State INTEGER, "
+                                   "RetryCount INTEGER, "
+                                   "UpdateTime INTEGER)"));
+    if (!g) {
+        qWarning() << "Failed to create ClassifyQueueTable3:" << m_query->lastError().text();
+    }
+
     // 判断ImageTable3中是否有ChangeTime字段
     QString strSqlImage = QString::fromLocal8Bit("select sql from sqlite_master where name = \"ImageTable3\" and sql like \"%ChangeTime%\"");
     bool q = m_query->exec(strSqlImage);
@@ -1657,32 +1778,32 @@ void DBManager::checkDatabase()
         // 无ChangeTime字段,则增加ChangeTime字段,赋值当前时间
         QString strDate = QDateTime::currentDateTime().toString(DATETIME_FORMAT_DATABASE);
         if (m_query->exec(QString("ALTER TABLE \"ImageTable3\" ADD COLUMN \"ChangeTime\" TEXT"))) {
-            qDebug() << "add ChangeTime success";
+            qCDebug(logDatabase) << "add ChangeTime success";
         }
     }
 
     // 判断ImageTable3中是否有ImportTime字段
     QString strSqlImportTime = "select sql from sqlite_master where name = 'ImageTable3' and sql like '%ImportTime%'";
     if (!m_query->exec(strSqlImportTime)) {
-        qDebug() << m_query->lastError();
+        qCDebug(logDatabase) << m_query->lastError();
     }
     if (!m_query->next()) {
         // 无ImportTime字段,则增加ImportTime字段
         QString strDate = QDateTime::currentDateTime().toString(DATETIME_FORMAT_DATABASE);
         if (m_query->exec(QString("ALTER TABLE \"ImageTable3\" ADD COLUMN \"ImportTime\" TEXT"))) {
-            qDebug() << "add ImportTime success";
+            qCDebug(logDatabase) << "add ImportTime success";
         }
     }
 
     // 判断ImageTable3中是否有FileType字段，区分是图片还是视频
     if (!m_query->exec("select * from sqlite_master where name = 'ImageTable3' and sql like '%FileType%'")) {
-        qDebug() << "add FileType failed";
+        qCDebug(logDatabase) << "add FileType failed";
     }
     if (!m_query->next()) {
         // 无FileType字段,则增加FileType字段,赋值1,默认是图片
         if (m_query->exec(QString("ALTER TABLE \"ImageTable3\" ADD COLUMN \"FileType\" INTEGER default \"%1\"")
                           .arg(QString::number(ItemTypePic)))) {
-            qDebug() << "add FileType success";
+            qCDebug(logDatabase) << "add FileType success";
         }
     }
 
@@ -1694,7 +1815,7 @@ void DBManager::checkDatabase()
             // DataHash,则增加DataHash字段
             if (m_query->exec(QString("ALTER TABLE \"ImageTable3\" ADD COLUMN \"DataHash\" TEXT default \"%1\"")
                               .arg(""))) {
-                qDebug() << "add FileType success";
+                qCDebug(logDatabase) << "add FileType success";
             }
         }
     }
@@ -1707,7 +1828,7 @@ void DBManager::checkDatabase()
             // 无UID,则增加UID字段
             if (m_query->exec(QString("ALTER TABLE \"ImageTable3\" ADD COLUMN \"UID\" TEXT default \"%1\"")
                               .arg(""))) {
-                qDebug() << "add UID success";
+                qCDebug(logDatabase) << "add UID success";
             }
         }
     }
@@ -1718,7 +1839,7 @@ void DBManager::checkDatabase()
         // 无AlbumDBType字段,则增加AlbumDBType字段, 全部赋值为个人相册
         if (m_query->exec(QString("ALTER TABLE \"AlbumTable3\" ADD COLUMN \"AlbumDBType\" INTEGER default %1")
                           .arg("1"))) {
-            qDebug() << "add AlbumDBType success";
+            qCDebug(logDatabase) << "add AlbumDBType success";
         }
         if (m_query->exec(QString("update AlbumTable3 SET AlbumDBType = 0 Where AlbumName = \"%1\" ")
                           .arg(COMMON_STR_FAVORITES))) {
@@ -1734,13 +1855,13 @@ void DBManager::checkDatabase()
         // 无UID字段，则需要主动添加
         if (m_query->exec(QString("ALTER TABLE \"AlbumTable3\" ADD COLUMN \"UID\" INTEGER default %1")
                           .arg("0"))) {
-            qDebug() << "add UID success";
+            qCDebug(logDatabase) << "add UID success";
         }
 
         // UID字段添加完成后，还需要主动为其进行赋值
         //1.获取当前已存在的album name，但要确保不能影响到收藏相册
         if (m_query->exec(QString("SELECT DISTINCT \"AlbumName\" FROM \"AlbumTable3\" WHERE AlbumDBType <> %1 ").arg(Favourite))) {
-            qDebug() << "search album name success";
+            qCDebug(logDatabase) << "search album name success";
         }
 
         //2.在内存中为其进行编号
@@ -1756,7 +1877,7 @@ void DBManager::checkDatabase()
         //4.写入数据库
         for (auto &currentName : nameList) {
             if (!m_query->exec(QString("UPDATE AlbumTable3 SET UID = %1 WHERE AlbumName = \"%2\"").arg(albumMaxUID++).arg(currentName))) {
-                qDebug() << "update AlbumTable3 UID failed";
+                qCDebug(logDatabase) << "update AlbumTable3 UID failed";
             }
         }
 
@@ -1786,7 +1907,7 @@ void DBManager::checkDatabase()
     QString strSqlTrashTable = QString::fromLocal8Bit("select * from sqlite_master where name = \"TrashTable3\"");
     bool build = m_query->exec(strSqlTrashTable);
     if (!build) {
-        qDebug() << m_query->lastError();
+        qCDebug(logDatabase) << m_query->lastError();
     }
     if (!m_query->next()) {
         //无新版TrashTable，则创建新表，导入旧表数据
@@ -1800,31 +1921,43 @@ void DBManager::checkDatabase()
                                    "ImportTime TEXT, "
                                    "FileType INTEGER, "
                                    "UID TEXT, "
-                                   "ClassName TEXT)"))) {
-            qDebug() << m_query->lastError();
+                                   "ClassName TEXT, "
+                                   "ExpireTime INTEGER)"))) {
+            qCDebug(logDatabase) << m_query->lastError();
         }
     } else {
         //判断TrashTable3是否包含FileType
         if (!m_query->exec("select * from sqlite_master where name = \"TrashTable3\" and sql like \"%FileType%\"")) {
-            qDebug() << m_query->lastError();
+            qCDebug(logDatabase) << m_query->lastError();
         }
         if (!m_query->next()) {
             // 无FileType字段,则增加FileType字段, 全部赋值为图片
             if (m_query->exec(QString("ALTER TABLE \"TrashTable3\" ADD COLUMN \"FileType\" INTEGER default %1")
                               .arg(QString::number(ItemType::ItemTypePic)))) {
-                qDebug() << "add AlbumDBType success";
+                qCDebug(logDatabase) << "add AlbumDBType success";
             }
         }
 
         //判断TrashTable3是否包含UID
         if (!m_query->exec("select * from sqlite_master where name = \"TrashTable3\" and sql like \"%UID%\"")) {
-            qDebug() << m_query->lastError();
+            qCDebug(logDatabase) << m_query->lastError();
         }
         if (!m_query->next()) {
             // 无UID字段,则增加UID字段
             if (m_query->exec(QString("ALTER TABLE \"TrashTable3\" ADD COLUMN \"UID\" INTEGER default %1")
                               .arg("-1"))) {
-                qDebug() << "add AlbumDBType success";
+                qCDebug(logDatabase) << "add AlbumDBType success";
+            }
+        }
+
+        //判断TrashTable3是否包含ExpireTime
+        if (!m_query->exec("select * from sqlite_master where name = \"TrashTable3\" and sql like \"%ExpireTime%\"")) {
+            qCDebug(logDatabase) << m_query->lastError();
+        }
+        if (!m_query->next()) {
+            // 无ExpireTime字段,则增加ExpireTime字段, 按原有剩余天数的算法回填到期时间
+            if (m_query->exec("ALTER TABLE \"TrashTable3\" ADD COLUMN \"ExpireTime\" INTEGER")) {
+                qCDebug(logDatabase) << "add ExpireTime success";
             }
         }
     }
@@ -1832,15 +1965,15 @@ void DBManager::checkDatabase()
     QString strSqlTrashTableUpdate = QString::fromLocal8Bit("select * from sqlite_master where name = \"TrashTable\"");
     bool update = m_query->exec(strSqlTrashTableUpdate);
     if (!update) {
-        qDebug() << m_query->lastError();
+        qCDebug(logDatabase) << m_query->lastError();
     }
     if (m_query->next()) {
         if (!m_query->exec("REPLACE INTO TrashTable3 (PathHash, FilePath, FileName, Dir, Time, ChangeTime)"
                            " SELECT PathHash, FilePath, FileName, Dir, Time, ChangeTime From TrashTable ")) {
-            qDebug() << m_query->lastError();
+            qCDebug(logDatabase) << m_query->lastError();
         }
         if (!m_query->exec(QString("DROP TABLE TrashTable"))) {
-            qDebug() << m_query->lastError();
+            qCDebug(logDatabase) << m_query->lastError();
         }
     }
 
@@ -1865,6 +1998,31 @@ void DBManager::checkDatabase()
         qWarning() << "Failed to create trash_hash_index:" << m_query->lastError().text();
     }
 
+    //按相册、类型计数时使用的索引
+    if (!m_query->exec("CREATE INDEX IF NOT EXISTS album_uid_hash_index ON AlbumTable3 (UID, PathHash)")) {
+        qWarning() << "Failed to create album_uid_hash_index:" << m_query->lastError().text();
+    }
+
+    if (!m_query->exec("CREATE INDEX IF NOT EXISTS image_filetype_index ON ImageTable3 (FileType)")) {
+        qWarning() << "Failed to create image_filetype_index:" << m_query->lastError().text();
+    }
+
+    //老版本数据没有到期时间，按删除当天计起的保留天数补齐
+    if (!m_query->exec(QString("UPDATE TrashTable3 SET ExpireTime = "
+                               "COALESCE(CAST(strftime('%s', STRFTIME('%Y-%m-%d', ImportTime)) AS INTEGER), %1) + %2 "
+                               "WHERE ExpireTime IS NULL")
+                       .arg(QDateTime::currentSecsSinceEpoch()).arg(sc_TrashKeepSecs))) {
+        qWarning() << "Failed to fill trash expire time:" << m_query->lastError().text();
+    }
+
+    if (!m_query->exec("CREATE INDEX IF NOT EXISTS trash_expire_index ON TrashTable3 (ExpireTime)")) {
+        qWarning() << "Failed to create trash_expire_index:" << m_query->lastError().text();
+    }
+
+    if (!m_query->exec("CREATE INDEX IF NOT EXISTS trash_type_expire_index ON TrashTable3 (FileType, ExpireTime)")) {
+        qWarning() << "Failed to create trash_type_expire_index:" << m_query->lastError().text();
+    }
+
     //新版删除需求的数据表策略
     //1.沿用老版的TrashTable3表，不做任何改变
     //2.PathHash作为存放在deepin-album-delete下的文件名，但是为了方便用户维修电脑，把原始文件名带在后面
@@ -1890,11 +2048,11 @@ void DBManager::checkDatabase()
         // 检查版本并升级（已存在的数据库）
         if (m_query->next()) {
             QString currentVersion = m_query->value(0).toString();
-            qDebug() << "Current database version:" << currentVersion;
+            qCDebug(logDatabase) << "Current database version:" << currentVersion;
             
             // 如果是5.9或更早版本，升级到6.0
             if (currentVersion == "5.9" || currentVersion < "6.0") {
-                qDebug() << "Upgrading database from" << currentVersion << "to 6.0";
+                qCDebug(logDatabase) << "Upgrading database from" << currentVersion << "to 6.0";
                 
                 // 添加 ClassName 字段
                 checkClassNameColumn("ImageTable3");
@@ -1904,12 +2062,15 @@ void DBManager::checkDatabase()
                 if (!m_query->exec("UPDATE AlbumVersion SET version = \"6.0\"")) {
                     qWarning() << "Failed to update version:" << m_query->lastError().text();
                 } else {
-                    qDebug() << "Database upgraded to version 6.0 successfully";
+                    qCDebug(logDatabase) << "Database upgraded to version 6.0 successfully";
                 }
             }
         }
     }
 
+    //ClassName 字段确认存在后再整理分类队列
+    checkClassifyQueue();
+
     //每次启动后释放一次文件空间，防止占用过多无效空间
     if (!m_query->exec("VACUUM")) {
     }
@@ -1932,12 +2093,36 @@ void DBManager::checkDatabase()
         });
         watcher.waitForFinished();
     }
-    qDebug() << "DBManager::checkDatabase - Exit";
+    qCDebug(logDatabase) << "DBManager::checkDatabase - Exit";
+}
+
+/**
+   @brief 启动时整理分类队列：上次未完成的任务恢复为等待，清理已删除图片的任务，
+    并把队列建立之前导入的未分类图片补入队列
+ */
+void DBManager::checkClassifyQueue()
+{
+    ALBUM_TRACE_SCOPE(logDatabase, "db.checkClassifyQueue");
+    if (!m_query->exec(QString("UPDATE ClassifyQueueTable3 SET State=%1 WHERE State=%2").arg(ClassifyPending).arg(ClassifyInFlight))) {
+        qWarning() << "Failed to reset classify tasks:" << m_query->lastError().text();
+    }
+
+    if (!m_query->exec(QString("DELETE FROM ClassifyQueueTable3 WHERE State=%1 OR PathHash NOT IN (SELECT PathHash FROM ImageTable3)").arg(ClassifyDone))) {
+        qWarning() << "Failed to clean classify tasks:" << m_query->lastError().text();
+    }
+
+    if (!m_query->exec(QString("INSERT OR IGNORE INTO ClassifyQueueTable3 (PathHash, FilePath, State, RetryCount, UpdateTime) "
+                               "SELECT PathHash, FilePath, %1, 0, %2 FROM ImageTable3 "
+                               "WHERE FileType=%3 AND (ClassName IS NULL OR ClassName='')")
+                       .arg(ClassifyPending).arg(QDateTime::currentSecsSinceEpoch()).arg(ItemTypePic))) {
+        qWarning() << "Failed to fill classify queue:" << m_query->lastError().text();
+    }
 }
 
 void DBManager::checkTimeColumn(const QString &tableName)
 {
-    qDebug() << "DBManager::checkTimeColumn - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.checkTimeColumn");
+    qCDebug(logDatabase) << "DBManager::checkTimeColumn - Entry";
     //检查并切换所有时间数据
     if (m_query->exec(QString("SELECT Time, ChangeTime, ImportTime, PathHash FROM %1").arg(tableName))) {
         std::vector<std::tuple<QString, QDateTime, QDateTime, QDateTime>> needUpdate;
@@ -1968,37 +2153,39 @@ void DBManager::checkTimeColumn(const QString &tableName)
             }
         }
     }
-    qDebug() << "DBManager::checkTimeColumn - Exit";
+    qCDebug(logDatabase) << "DBManager::checkTimeColumn - Exit";
 }
 
 void DBManager::checkClassNameColumn(const QString &tableName)
 {
-    qDebug() << "DBManager::checkClassNameColumn - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.checkClassNameColumn");
+    qCDebug(logDatabase) << "DBManager::checkClassNameColumn - Entry";
     // 检查表中是否已存在 ClassName 字段
     QString checkSql = QString("SELECT sql FROM sqlite_master WHERE type='table' AND name='%1'").arg(tableName);
     if (m_query->exec(checkSql) && m_query->next()) {
         QString tableSql = m_query->value(0).toString();
         // 如果表定义中不包含 ClassName，则添加该字段
         if (!tableSql.contains("ClassName", Qt::CaseInsensitive)) {
-            qDebug() << "Adding ClassName column to" << tableName;
+            qCDebug(logDatabase) << "Adding ClassName column to" << tableName;
             QString alterSql = QString("ALTER TABLE %1 ADD COLUMN ClassName TEXT").arg(tableName);
             if (!m_query->exec(alterSql)) {
                 qWarning() << "Failed to add ClassName column to" << tableName << ":" << m_query->lastError().text();
             } else {
-                qDebug() << "Successfully added ClassName column to" << tableName;
+                qCDebug(logDatabase) << "Successfully added ClassName column to" << tableName;
             }
         } else {
-            qDebug() << tableName << "already has ClassName column";
+            qCDebug(logDatabase) << tableName << "already has ClassName column";
         }
     } else {
         qWarning() << "Failed to check table" << tableName << ":" << m_query->lastError().text();
     }
-    qDebug() << "DBManager::checkClassNameColumn - Exit";
+    qCDebug(logDatabase) << "DBManager::checkClassNameColumn - Exit";
 }
 
 void DBManager::insertSpUID(const QString &albumName, AlbumDBType astype, SpUID UID)
 {
-    qDebug() << "DBManager::insertSpUID - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.insertSpUID");
+    qCDebug(logDatabase) << "DBManager::insertSpUID - Entry";
     //0.路径不存在，BUG#111917，只检查默认路径，不要把收藏也搞进来了，否则会导致后续收藏失败
     if (UID != u_Favorite && !defaultNotifyPathExists(UID)) {
         //路径不存在则删除已有的相册
@@ -2020,15 +2207,17 @@ void DBManager::insertSpUID(const QString &albumName, AlbumDBType astype, SpUID
     //2.1.如果是收藏的话，需要对历史收藏的图片进行迁移
     if (UID == u_Favorite) {
         if (!m_query->exec(QString("UPDATE AlbumTable3 SET UID = %1 WHERE AlbumDBType = %2").arg(UID).arg(Favourite))) {
-            qDebug() << "update Favorite failed";
+            qCDebug(logDatabase) << "update Favorite failed";
         }
     }
-    qDebug() << "DBManager::insertSpUID - Exit";
+    m_albumIndex.invalidate();
+    qCDebug(logDatabase) << "DBManager::insertSpUID - Exit";
 }
 
 const DBImgInfoList DBManager::getAllTrashInfos(bool needTimeData) const
 {
-    qDebug() << "DBManager::getAllTrashInfos - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getAllTrashInfos");
+    qCDebug(logDatabase) << "DBManager::getAllTrashInfos - Entry";
     QMutexLocker mutex(&m_dbMutex);
     DBImgInfoList infos;
     m_query->setForwardOnly(true);
@@ -2071,19 +2260,23 @@ const DBImgInfoList DBManager::getAllTrashInfos(bool needTimeData) const
             }
         }
     }
-    qDebug() << "DBManager::getAllTrashInfos - Exit";
+    qCDebug(logDatabase) << "DBManager::getAllTrashInfos - Exit";
     return infos;
 }
 
 const DBImgInfoList DBManager::getAllTrashInfos_getRemainDays() const
 {
-    qDebug() << "DBManager::getAllTrashInfos_getRemainDays - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getAllTrashInfos_getRemainDays");
+    qCDebug(logDatabase) << "DBManager::getAllTrashInfos_getRemainDays - Entry";
     QMutexLocker mutex(&m_dbMutex);
     DBImgInfoList infos;
     m_query->setForwardOnly(true);
 
-    //中间那坨东西就是现在距离导入的时候过了多久
-    bool b = m_query->prepare("SELECT FilePath, julianday('now') - julianday(STRFTIME(\"%Y-%m-%d\", ImportTime)), FileType, PathHash, ClassName FROM TrashTable3 ORDER BY ImportTime DESC");
+    //已到期等待清理的数据不再显示
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    bool b = m_query->prepare("SELECT FilePath, ExpireTime, FileType, PathHash, ClassName FROM TrashTable3 "
+                              "WHERE ExpireTime > :now ORDER BY ExpireTime DESC");
+    m_query->bindValue(":now", now);
     if (!b || ! m_query->exec()) {
         return infos;
     } else {
@@ -2092,22 +2285,122 @@ const DBImgInfoList DBManager::getAllTrashInfos_getRemainDays() const
             info.filePath = m_query->value(0).toString();
             if (info.filePath.isEmpty()) //如果路径为空
                 continue;
-            info.remainDays = 30 - static_cast<int>(m_query->value(1).toDouble());
+            info.remainDays = remainDaysOf(m_query->value(1).toLongLong(), now);
             info.itemType = ItemType(m_query->value(2).toInt());
             info.pathHash = m_query->value(3).toString();
             info.className = m_query->value(4).toString();
             infos << info;
         }
     }
-    qDebug() << "DBManager::getAllTrashInfos_getRemainDays - Exit";
+    qCDebug(logDatabase) << "DBManager::getAllTrashInfos_getRemainDays - Exit";
+    return infos;
+}
+
+/**
+   @brief 按到期时间倒序（即删除时间倒序）分页获取最近删除中未到期的数据，\a filterType 为 ItemTypeNull 时不区分类型
+ */
+const DBImgInfoList DBManager::getTrashInfosPage(const ItemType &filterType, int offset, int limit) const
+{
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getTrashInfosPage");
+    QMutexLocker mutex(&m_dbMutex);
+    DBImgInfoList infos;
+    m_query->setForwardOnly(true);
+
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    QString queryStr("SELECT FilePath, ExpireTime, FileType, PathHash, ClassName FROM TrashTable3 WHERE ExpireTime > :now ");
+    if (filterType != ItemTypeNull) {
+        queryStr += "AND FileType = :type ";
+    }
+    // 同一秒删除的数据到期时间相同，按 PathHash 排序保证分页结果稳定，不会重复或遗漏
+    queryStr += "ORDER BY ExpireTime DESC, PathHash LIMIT :limit OFFSET :offset";
+
+    bool b = m_query->prepare(queryStr);
+    m_query->bindValue(":now", now);
+    if (filterType != ItemTypeNull) {
+        m_query->bindValue(":type", filterType);
+    }
+    m_query->bindValue(":limit", limit);
+    m_query->bindValue(":offset", offset);
+    if (!b || !m_query->exec()) {
+        qWarning() << "Failed to get trash page:" << m_query->lastError().text();
+        return infos;
+    }
+
+    while (m_query->next()) {
+        DBImgInfo info;
+        info.filePath = m_query->value(0).toString();
+        if (info.filePath.isEmpty()) //如果路径为空
+            continue;
+        info.remainDays = remainDaysOf(m_query->value(1).toLongLong(), now);
+        info.itemType = ItemType(m_query->value(2).toInt());
+        info.pathHash = m_query->value(3).toString();
+        info.className = m_query->value(4).toString();
+        infos << info;
+    }
     return infos;
 }
 
+/**
+   @brief 获取最多 \a count 条在 \a deadline 之前到期的数据路径，用于后台分批清理
+ */
+QStringList DBManager::getExpiredTrashPaths(qint64 deadline, int count) const
+{
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getExpiredTrashPaths");
+    QMutexLocker mutex(&m_dbMutex);
+    QStringList paths;
+    m_query->setForwardOnly(true);
+    bool b = m_query->prepare("SELECT FilePath FROM TrashTable3 WHERE ExpireTime <= :deadline LIMIT :count");
+    m_query->bindValue(":deadline", deadline);
+    m_query->bindValue(":count", count);
+    if (!b || !m_query->exec()) {
+        qWarning() << "Failed to get expired trash:" << m_query->lastError().text();
+        return paths;
+    }
+
+    while (m_query->next()) {
+        paths << m_query->value(0).toString();
+    }
+    return paths;
+}
+
+/**
+   @brief 剩余天数向上取整，删除当天为完整的保留天数
+ */
+int DBManager::remainDaysOf(qint64 expireTime, qint64 now)
+{
+    return static_cast<int>((expireTime - now + sc_DaySecs - 1) / sc_DaySecs);
+}
+
+/**
+   @brief 外部设备、网络路径、回收站和保险箱中的文件不移入系统回收站，也不在最近删除中保留记录
+ */
+bool DBManager::isExternalTrashPath(const QString &path)
+{
+    return path.startsWith("/media/") || path.startsWith("/run/media/") || path.startsWith("/mnt/") || //U盘
+           path.contains("smb-share:server=") || //smb地址
+           path.contains("gphoto2:host=Apple") || //apple phone
+           path.contains("ftp:host=") || //ftp路径
+           path.contains("gphoto2:host=") || //ptp路径
+           path.contains("mtp:host=") || //mtp路径
+           path.contains(QDir::homePath() + "/.local/share/Trash") || //垃圾箱
+           LibUnionImage_NameSpace::isVaultFile(path); //保险箱
+}
+
+/**
+   @return 原文件或删除缓存中的备份是否存在，两者都不存在的数据无法恢复，不在最近删除中显示
+ */
+bool DBManager::isTrashFileAvailable(const QString &filePath, const QString &pathHash)
+{
+    return QFile::exists(filePath)
+           || QFile::exists(LibUnionImage_NameSpace::getDeleteFullPath(pathHash, DBImgInfo::getFileNameFromFilePath(filePath)));
+}
+
 void DBManager::insertTrashImgInfos(const DBImgInfoList &infos, bool showWaitDialog)
 {
-    qDebug() << "DBManager::insertTrashImgInfos - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.insertTrashImgInfos");
+    qCDebug(logDatabase) << "DBManager::insertTrashImgInfos - Entry";
     if (infos.isEmpty()) {
-        qDebug() << "DBManager::insertTrashImgInfos - Exit, infos is empty";
+        qCDebug(logDatabase) << "DBManager::insertTrashImgInfos - Exit, infos is empty";
         return;
     }
 
@@ -2131,15 +2424,7 @@ void DBManager::insertTrashImgInfos(const DBImgInfoList &infos, bool showWaitDia
             LibUnionImage_NameSpace::syncCopy(info.filePath, LibUnionImage_NameSpace::getDeleteFullPath(hash, info.getFileNameFromFilePath()));
 
             //判断文件路径来自于哪里
-            QString path = info.filePath;
-            if (path.startsWith("/media/") || path.startsWith("/run/media/") || path.startsWith("/mnt/") || //U盘
-                    path.contains("smb-share:server=") || //smb地址
-                    path.contains("gphoto2:host=Apple") || //apple phone
-                    path.contains("ftp:host=") || //ftp路径
-                    path.contains("gphoto2:host=") || //ptp路径
-                    path.contains("mtp:host=") || //mtp路径
-                    path.contains(QDir::homePath() + "/.local/share/Trash") || //垃圾箱
-                    LibUnionImage_NameSpace::isVaultFile(path)) { //保险箱
+            if (isExternalTrashPath(info.filePath)) {
                 hash.clear();
             } else {
                 LibUnionImage_NameSpace::trashFile(info.filePath);
@@ -2165,13 +2450,14 @@ void DBManager::insertTrashImgInfos(const DBImgInfoList &infos, bool showWaitDia
     //2.向数据库插入数据
     m_query->setForwardOnly(true);
     if (!m_query->exec("BEGIN IMMEDIATE TRANSACTION")) {
-        qDebug() << "begin transaction failed.";
+        qCDebug(logDatabase) << "begin transaction failed.";
     }
 
     QString qs("REPLACE INTO TrashTable3 "
-               "(PathHash, FilePath, FileName, Time, ChangeTime, ImportTime, FileType, UID, ClassName) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)");
+               "(PathHash, FilePath, FileName, Time, ChangeTime, ImportTime, FileType, UID, ClassName, ExpireTime) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
     if (!m_query->prepare(qs)) {
     }
+    const qint64 expireTime = QDateTime::currentSecsSinceEpoch() + sc_TrashKeepSecs;
     for (int i = 0; i != infos.size(); ++i) {
         if (pathHashs[i].isEmpty()) {
             continue;
@@ -2185,26 +2471,109 @@ void DBManager::insertTrashImgInfos(const DBImgInfoList &infos, bool showWaitDia
         m_query->addBindValue(infos[i].itemType);
         m_query->addBindValue(infos[i].albumUID);
         m_query->addBindValue(infos[i].className);
+        m_query->addBindValue(expireTime);
         if (!m_query->exec()) {
         }
     }
 
     if (!m_query->exec("COMMIT")) {
-        qDebug() << "COMMIT failed.";
+        qCDebug(logDatabase) << "COMMIT failed.";
     }
 
     mutex.unlock();
 
-    qDebug() << "DBManager::insertTrashImgInfos - Exit";
+    qCDebug(logDatabase) << "DBManager::insertTrashImgInfos - Exit";
 //    //3.通知UI模块有图片删除
 //    emit dApp->signalM->imagesTrashInserted();
 }
 
+/**
+   @brief 在一个事务中将图片移入最近删除：\a trashPaths 的记录按路径合并相册 UID 后写入 TrashTable3，
+    \a removePaths 的记录从 ImageTable3 和 AlbumTable3 中删除。文件操作由调用方完成
+ */
+void DBManager::moveImgInfosToTrash(const QStringList &trashPaths, const QStringList &removePaths)
+{
+    ALBUM_TRACE_SCOPE(logDatabase, "db.moveImgInfosToTrash");
+    if (trashPaths.isEmpty() && removePaths.isEmpty()) {
+        return;
+    }
+
+    QMutexLocker mutex(&m_dbMutex);
+    m_query->setForwardOnly(true);
+    if (!m_query->exec("BEGIN IMMEDIATE TRANSACTION")) {
+        qWarning() << "Failed to begin transaction:" << m_query->lastError().text();
+        return;
+    }
+
+    //1.同一图片在多个相册中有多条记录，合并 UID 后整体复制到 TrashTable3
+    if (!trashPaths.isEmpty() && fillPathHashTemp(trashPaths)) {
+        if (!m_query->exec(QString("REPLACE INTO TrashTable3 "
+                                   "(PathHash, FilePath, FileName, Time, ChangeTime, ImportTime, FileType, UID, ClassName, ExpireTime) "
+                                   "SELECT PathHash, FilePath, FileName, Time, ChangeTime, ImportTime, FileType, group_concat(UID, ','), ClassName, %1 "
+                                   "FROM ImageTable3 WHERE PathHash IN (SELECT PathHash FROM PathHashTemp) GROUP BY PathHash")
+                           .arg(QDateTime::currentSecsSinceEpoch() + sc_TrashKeepSecs))) {
+            qWarning() << "Failed to move images to trash table:" << m_query->lastError().text();
+        }
+    }
+
+    //2.删除图库和相册中的记录
+    if (!removePaths.isEmpty() && fillPathHashTemp(removePaths)) {
+        if (!m_query->exec("DELETE FROM AlbumTable3 WHERE PathHash IN (SELECT PathHash FROM PathHashTemp)")) {
+            qWarning() << "Failed to remove from AlbumTable3:" << m_query->lastError().text();
+        }
+        if (!m_query->exec("DELETE FROM ImageTable3 WHERE PathHash IN (SELECT PathHash FROM PathHashTemp)")) {
+            qWarning() << "Failed to remove from ImageTable3:" << m_query->lastError().text();
+        }
+
+        QStringList removeHashs;
+        for (const QString &path : removePaths) {
+            removeHashs << LibUnionImage_NameSpace::hashByString(path);
+        }
+        m_albumIndex.removeFromAllAlbums(removeHashs);
+    }
+
+    if (!m_query->exec("COMMIT")) {
+        qWarning() << "Failed to commit transaction:" << m_query->lastError().text();
+    } else {
+        qInfo() << "Moved" << trashPaths.size() << "images to trash, removed" << removePaths.size() << "images";
+    }
+}
+
+/**
+   @brief 将路径 hash 写入临时表 PathHashTemp，供集合查询使用，需在持有数据库锁时调用
+ */
+bool DBManager::fillPathHashTemp(const QStringList &paths)
+{
+    ALBUM_TRACE_SCOPE(logDatabase, "db.fillPathHashTemp");
+    if (!m_query->exec("CREATE TEMP TABLE IF NOT EXISTS PathHashTemp (PathHash TEXT primary key)")
+            || !m_query->exec("DELETE FROM PathHashTemp")) {
+        qWarning() << "Failed to prepare path hash table:" << m_query->lastError().text();
+        return false;
+    }
+
+    if (!m_query->prepare("INSERT OR IGNORE INTO PathHashTemp (PathHash) VALUES (?)")) {
+        qWarning() << "Failed to prepare path hash statement:" << m_query->lastError().text();
+        return false;
+    }
+
+    QVariantList hashs;
+    for (const QString &path : paths) {
+        hashs << LibUnionImage_NameSpace::hashByString(path);
+    }
+    m_query->addBindValue(hashs);
+    if (!m_query->execBatch()) {
+        qWarning() << "Failed to fill path hash table:" << m_query->lastError().text();
+        return false;
+    }
+    return true;
+}
+
 void DBManager::removeTrashImgInfos(const QStringList &paths)
 {
-    qDebug() << "DBManager::removeTrashImgInfos - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.removeTrashImgInfos");
+    qCDebug(logDatabase) << "DBManager::removeTrashImgInfos - Entry";
     if (paths.isEmpty()) {
-        qDebug() << "DBManager::removeTrashImgInfos - Exit, paths is empty";
+        qCDebug(logDatabase) << "DBManager::removeTrashImgInfos - Exit, paths is empty";
         return;
     }
 
@@ -2242,14 +2611,15 @@ void DBManager::removeTrashImgInfos(const QStringList &paths)
 
     mutex.unlock();
 //    emit dApp->signalM->imagesTrashRemoved();
-    qDebug() << "DBManager::removeTrashImgInfos - Exit";
+    qCDebug(logDatabase) << "DBManager::removeTrashImgInfos - Exit";
 }
 
 QStringList DBManager::recoveryImgFromTrash(const QStringList &paths)
 {
-    qDebug() << "DBManager::recoveryImgFromTrash - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.recoveryImgFromTrash");
+    qCDebug(logDatabase) << "DBManager::recoveryImgFromTrash - Entry";
     if (paths.isEmpty()) {
-        qDebug() << "No images to recover from trash";
+        qCDebug(logDatabase) << "No images to recover from trash";
         return QStringList();
     }
 
@@ -2470,6 +2840,7 @@ QStringList DBManager::recoveryImgFromTrash(const QStringList &paths)
                 qWarning() << "insert AlbumTable3 failed" << m_query->lastError().text();
                 continue;
             }
+            m_albumIndex.insert(UID, QStringList(info.pathHash));
         }
 
         if (!m_query->exec("COMMIT")) {
@@ -2483,16 +2854,17 @@ QStringList DBManager::recoveryImgFromTrash(const QStringList &paths)
 //        emit dApp->signalM->imagesInserted();
     }
 
-    qDebug() << "DBManager::recoveryImgFromTrash - Exit, return failedFiles";
+    qCDebug(logDatabase) << "DBManager::recoveryImgFromTrash - Exit, return failedFiles";
     //5.返回失败的文件
     return failedFiles;
 }
 
 void DBManager::removeTrashImgInfosNoSignal(const QStringList &paths)
 {
-    qDebug() << "DBManager::removeTrashImgInfosNoSignal - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.removeTrashImgInfosNoSignal");
+    qCDebug(logDatabase) << "DBManager::removeTrashImgInfosNoSignal - Entry";
     if (paths.isEmpty()) {
-        qDebug() << "DBManager::removeTrashImgInfosNoSignal - Exit, paths is empty";
+        qCDebug(logDatabase) << "DBManager::removeTrashImgInfosNoSignal - Exit, paths is empty";
         return;
     }
 
@@ -2511,7 +2883,7 @@ void DBManager::removeTrashImgInfosNoSignal(const QStringList &paths)
     }
     QString qs("DELETE FROM AlbumTable3 WHERE PathHash=:hash");
     if (!m_query->prepare(qs)) {
-        qDebug() << "DBManager::removeTrashImgInfosNoSignal - Exit, prepare failed";
+        qCDebug(logDatabase) << "DBManager::removeTrashImgInfosNoSignal - Exit, prepare failed";
     }
     for (const auto &hash : pathHashs) {
         m_query->bindValue(":hash", hash);
@@ -2521,6 +2893,7 @@ void DBManager::removeTrashImgInfosNoSignal(const QStringList &paths)
     if (!m_query->exec("COMMIT")) {
 //        qDebug() << "COMMIT failed.";
     }
+    m_albumIndex.removeFromAllAlbums(pathHashs);
 
     //从TrashTable3删除
     if (!m_query->exec("BEGIN IMMEDIATE TRANSACTION")) {
@@ -2543,12 +2916,13 @@ void DBManager::removeTrashImgInfosNoSignal(const QStringList &paths)
         auto deletePath = LibUnionImage_NameSpace::getDeleteFullPath(pathHashs[i], DBImgInfo::getFileNameFromFilePath(paths[i]));
         QFile::remove(deletePath);
     }
-    qDebug() << "DBManager::removeTrashImgInfosNoSignal - Exit";
+    qCDebug(logDatabase) << "DBManager::removeTrashImgInfosNoSignal - Exit";
 }
 
 const DBImgInfo DBManager::getTrashInfoByPath(const QString &path) const
 {
-    qDebug() << "DBManager::getTrashInfoByPath - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getTrashInfoByPath");
+    qCDebug(logDatabase) << "DBManager::getTrashInfoByPath - Entry";
     DBImgInfoList list = getTrashImgInfos("FilePath", path);
     if (list.count() != 1) {
         return DBImgInfo();
@@ -2559,7 +2933,8 @@ const DBImgInfo DBManager::getTrashInfoByPath(const QString &path) const
 
 const DBImgInfoList DBManager::getTrashImgInfos(const QString &key, const QString &value) const
 {
-    qDebug() << "DBManager::getTrashImgInfos - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getTrashImgInfos");
+    qCDebug(logDatabase) << "DBManager::getTrashImgInfos - Entry";
     QMutexLocker mutex(&m_dbMutex);
     DBImgInfoList infos;
     m_query->setForwardOnly(true);
@@ -2585,27 +2960,41 @@ const DBImgInfoList DBManager::getTrashImgInfos(const QString &key, const QStrin
             infos << info;
         }
     }
-    qDebug() << "DBManager::getTrashImgInfos - Exit";
+    qCDebug(logDatabase) << "DBManager::getTrashImgInfos - Exit";
     return infos;
 }
 
-int DBManager::getTrashImgsCount() const
+/**
+   @brief 获取最近删除中未到期的数据数量，原文件和备份均已不存在的数据由 TrashExpiryScheduler 在后台清理
+ */
+int DBManager::getTrashImgsCount(const ItemType &filterType) const
 {
-    qDebug() << "DBManager::getTrashImgsCount - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getTrashImgsCount");
+    qCDebug(logDatabase) << "DBManager::getTrashImgsCount - Entry";
     QMutexLocker mutex(&m_dbMutex);
     m_query->setForwardOnly(true);
-    if (m_query->exec("SELECT COUNT(*) FROM TrashTable3")) {
+    QString queryStr("SELECT COUNT(*) FROM TrashTable3 WHERE ExpireTime > :now");
+    if (filterType != ItemTypeNull) {
+        queryStr += " AND FileType = :type";
+    }
+    bool b = m_query->prepare(queryStr);
+    m_query->bindValue(":now", QDateTime::currentSecsSinceEpoch());
+    if (filterType != ItemTypeNull) {
+        m_query->bindValue(":type", filterType);
+    }
+    if (b && m_query->exec()) {
         m_query->first();
         int count = m_query->value(0).toInt();
         return count;
     }
-    qDebug() << "DBManager::getTrashImgsCount - Exit, return 0";
+    qCDebug(logDatabase) << "DBManager::getTrashImgsCount - Exit, return 0";
     return 0;
 }
 
 int DBManager::getAlbumImgsCount(int UID) const
 {
-    qDebug() << "DBManager::getAlbumImgsCount - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getAlbumImgsCount");
+    qCDebug(logDatabase) << "DBManager::getAlbumImgsCount - Entry";
     QMutexLocker mutex(&m_dbMutex);
     m_query->setForwardOnly(true);
     if (m_query->exec(QString("SELECT COUNT(*) FROM AlbumTable3 WHERE UID=%1 AND PathHash<>\"%2\"")
@@ -2614,13 +3003,14 @@ int DBManager::getAlbumImgsCount(int UID) const
         int count = m_query->value(0).toInt();
         return count;
     }
-    qDebug() << "DBManager::getAlbumImgsCount - Exit, return 0";
+    qCDebug(logDatabase) << "DBManager::getAlbumImgsCount - Exit, return 0";
     return 0;
 }
 
 QDateTime DBManager::getFileImportTime(const QString &path)
 {
-    qDebug() << "DBManager::getFileImportTime - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getFileImportTime");
+    qCDebug(logDatabase) << "DBManager::getFileImportTime - Entry";
     QMutexLocker mutex(&m_dbMutex);
     m_query->setForwardOnly(true);
     QDateTime result;
@@ -2628,13 +3018,14 @@ QDateTime DBManager::getFileImportTime(const QString &path)
         m_query->first();
         result = m_query->value(0).toDateTime();
     }
-    qDebug() << "DBManager::getFileImportTime - Exit, return result";
+    qCDebug(logDatabase) << "DBManager::getFileImportTime - Exit, return result";
     return result;
 }
 
 QStringList DBManager::getYearPaths(const QString &year, int maxCount)
 {
-    qDebug() << "DBManager::getYearPaths - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getYearPaths");
+    qCDebug(logDatabase) << "DBManager::getYearPaths - Entry";
     QMutexLocker mutex(&m_dbMutex);
     m_query->setForwardOnly(true);
     QStringList result;
@@ -2644,13 +3035,14 @@ QStringList DBManager::getYearPaths(const QString &year, int maxCount)
             result.push_back(m_query->value(0).toString());
         }
     }
-    qDebug() << "DBManager::getYearPaths - Exit, return result";
+    qCDebug(logDatabase) << "DBManager::getYearPaths - Exit, return result";
     return result;
 }
 
 QStringList DBManager::getYears()
 {
-    qDebug() << "DBManager::getYears - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getYears");
+    qCDebug(logDatabase) << "DBManager::getYears - Entry";
     QMutexLocker mutex(&m_dbMutex);
     m_query->setForwardOnly(true);
     QStringList result;
@@ -2660,13 +3052,14 @@ QStringList DBManager::getYears()
             result.push_back(m_query->value(0).toString());
         }
     }
-    qDebug() << "DBManager::getYears - Exit, return result";
+    qCDebug(logDatabase) << "DBManager::getYears - Exit, return result";
     return result;
 }
 
 int DBManager::getYearCount(const QString &year)
 {
-    qDebug() << "DBManager::getYearCount - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getYearCount");
+    qCDebug(logDatabase) << "DBManager::getYearCount - Entry";
     QMutexLocker mutex(&m_dbMutex);
     m_query->setForwardOnly(true);
     int result = 0;
@@ -2675,13 +3068,14 @@ int DBManager::getYearCount(const QString &year)
         m_query->first();
         result = m_query->value(0).toInt();
     }
-    qDebug() << "DBManager::getYearCount - Exit, return result";
+    qCDebug(logDatabase) << "DBManager::getYearCount - Exit, return result";
     return result;
 }
 
 QStringList DBManager::getMonthPaths(const QString &year, const QString &month, int maxCount)
 {
-    qDebug() << "DBManager::getMonthPaths - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getMonthPaths");
+    qCDebug(logDatabase) << "DBManager::getMonthPaths - Entry";
     QMutexLocker mutex(&m_dbMutex);
     m_query->setForwardOnly(true);
     QStringList result;
@@ -2691,13 +3085,14 @@ QStringList DBManager::getMonthPaths(const QString &year, const QString &month,
             result.push_back(m_query->value(0).toString());
         }
     }
-    qDebug() << "DBManager::getMonthPaths - Exit, return result";
+    qCDebug(logDatabase) << "DBManager::getMonthPaths - Exit, return result";
     return result;
 }
 
 QStringList DBManager::getMonths()
 {
-    qDebug() << "DBManager::getMonths - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getMonths");
+    qCDebug(logDatabase) << "DBManager::getMonths - Entry";
     QMutexLocker mutex(&m_dbMutex);
     m_query->setForwardOnly(true);
     QStringList result;
@@ -2707,13 +3102,14 @@ QStringList DBManager::getMonths()
             result.push_back(m_query->value(0).toString());
         }
     }
-    qDebug() << "DBManager::getMonths - Exit, return result";
+    qCDebug(logDatabase) << "DBManager::getMonths - Exit, return result";
     return result;
 }
 
 int DBManager::getMonthCount(const QString &year, const QString &month)
 {
-    qDebug() << "DBManager::getMonthCount - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getMonthCount");
+    qCDebug(logDatabase) << "DBManager::getMonthCount - Entry";
     QMutexLocker mutex(&m_dbMutex);
     m_query->setForwardOnly(true);
     int result = 0;
@@ -2722,13 +3118,14 @@ int DBManager::getMonthCount(const QString &year, const QString &month)
         m_query->first();
         result = m_query->value(0).toInt();
     }
-    qDebug() << "DBManager::getMonthCount - Exit, return result";
+    qCDebug(logDatabase) << "DBManager::getMonthCount - Exit, return result";
     return result;
 }
 
 DBImgInfoList DBManager::getInfosByDay(const QString &day)
 {
-    qDebug() << "DBManager::getInfosByDay - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getInfosByDay");
+    qCDebug(logDatabase) << "DBManager::getInfosByDay - Entry";
     QMutexLocker mutex(&m_dbMutex);
     m_query->setForwardOnly(true);
     DBImgInfoList infos;
@@ -2745,13 +3142,14 @@ DBImgInfoList DBManager::getInfosByDay(const QString &day)
         }
     }
 
-    qDebug() << "DBManager::getInfosByDay - Exit, return infos";
+    qCDebug(logDatabase) << "DBManager::getInfosByDay - Exit, return infos";
     return infos;
 }
 
 QStringList DBManager::getDayPaths(const QString &day)
 {
-    qDebug() << "DBManager::getDayPaths - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getDayPaths");
+    qCDebug(logDatabase) << "DBManager::getDayPaths - Entry";
     QMutexLocker mutex(&m_dbMutex);
     m_query->setForwardOnly(true);
     QStringList result;
@@ -2761,13 +3159,39 @@ QStringList DBManager::getDayPaths(const QString &day)
             result.push_back("file://" + m_query->value(0).toString());
         }
     }
-    qDebug() << "DBManager::getDayPaths - Exit, return result";
+    qCDebug(logDatabase) << "DBManager::getDayPaths - Exit, return result";
     return result;
 }
 
+int DBManager::getDayCount(const QString &day, const ItemType &filterType) const
+{
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getDayCount");
+    qCDebug(logDatabase) << "DBManager::getDayCount - Entry";
+    QMutexLocker mutex(&m_dbMutex);
+    m_query->setForwardOnly(true);
+    QString sql("SELECT COUNT(*) FROM ImageTable3 WHERE substr(Time, 0, 11) = :Day");
+    if (filterType == ItemTypePic || filterType == ItemTypeVideo) {
+        sql += " AND FileType = :Type";
+    }
+    int count = 0;
+    bool b = m_query->prepare(sql);
+    m_query->bindValue(":Day", day);
+    if (filterType == ItemTypePic || filterType == ItemTypeVideo) {
+        m_query->bindValue(":Type", filterType);
+    }
+    if (!b || !m_query->exec()) {
+        qWarning() << "Get day count failed: " << m_query->lastError();
+    } else if (m_query->next()) {
+        count = m_query->value(0).toInt();
+    }
+    qCDebug(logDatabase) << "DBManager::getDayCount - Exit, count:" << count;
+    return count;
+}
+
 QStringList DBManager::getDays()
 {
-    qDebug() << "DBManager::getDays - Entry";
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getDays");
+    qCDebug(logDatabase) << "DBManager::getDays - Entry";
     QMutexLocker mutex(&m_dbMutex);
     m_query->setForwardOnly(true);
     QStringList result;
@@ -2777,6 +3201,240 @@ QStringList DBManager::getDays()
             result.push_back(m_query->value(0).toString());
         }
     }
-    qDebug() << "DBManager::getDays - Exit, return result";
+    qCDebug(logDatabase) << "DBManager::getDays - Exit, return result";
     return result;
 }
+
+bool DBManager::getMovieInfo(const QString &path, qint64 fileSize, qint64 modifyTime, MovieInfo &info) const
+{
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getMovieInfo");
+    // qDebug() << "DBManager::getMovieInfo - Entry";
+    QMutexLocker mutex(&m_dbMutex);
+    m_query->setForwardOnly(true);
+    bool b = m_query->prepare("SELECT Duration, Width, Height, VideoCodec, VideoBitRate, Fps, "
+                              "AudioCodec, AudioBitRate, Channels, Sampling, CreationTime FROM MovieInfoTable3 "
+                              "WHERE PathHash = :hash AND FileSize = :size AND ModifyTime = :time");
+    m_query->bindValue(":hash", LibUnionImage_NameSpace::hashByString(path));
+    m_query->bindValue(":size", fileSize);
+    m_query->bindValue(":time", modifyTime);
+    if (!b || !m_query->exec()) {
+        qWarning() << "Failed to query movie info:" << m_query->lastError().text();
+        return false;
+    }
+
+    if (!m_query->next()) {
+        return false;
+    }
+
+    info.duration = m_query->value(0).toString();
+    info.width = m_query->value(1).toInt();
+    info.height = m_query->value(2).toInt();
+    info.vCodecID = m_query->value(3).toString();
+    info.vCodeRate = m_query->value(4).toLongLong();
+    info.fps = m_query->value(5).toInt();
+    info.aCodeID = m_query->value(6).toString();
+    info.aCodeRate = m_query->value(7).toLongLong();
+    info.channels = m_query->value(8).toInt();
+    info.sampling = m_query->value(9).toInt();
+    const QDateTime creation = QDateTime::fromString(m_query->value(10).toString(), Qt::ISODate);
+    if (creation.isValid()) {
+        info.creation = creation;
+    }
+    // qDebug() << "DBManager::getMovieInfo - Exit";
+    return true;
+}
+
+void DBManager::insertMovieInfo(const MovieInfo &info, qint64 modifyTime)
+{
+    ALBUM_TRACE_SCOPE(logDatabase, "db.insertMovieInfo");
+    // qDebug() << "DBManager::insertMovieInfo - Entry";
+    QMutexLocker mutex(&m_dbMutex);
+    m_query->setForwardOnly(true);
+    bool b = m_query->prepare("REPLACE INTO MovieInfoTable3 (PathHash, FilePath, FileSize, ModifyTime, Duration, "
+                              "Width, Height, VideoCodec, VideoBitRate, Fps, AudioCodec, AudioBitRate, Channels, "
+                              "Sampling, CreationTime) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+    if (!b) {
+        qWarning() << "Failed to prepare movie info statement:" << m_query->lastError().text();
+        return;
+    }
+
+    m_query->addBindValue(LibUnionImage_NameSpace::hashByString(info.filePath));
+    m_query->addBindValue(info.filePath);
+    m_query->addBindValue(info.fileSize);
+    m_query->addBindValue(modifyTime);
+    m_query->addBindValue(info.duration);
+    m_query->addBindValue(info.width);
+    m_query->addBindValue(info.height);
+    m_query->addBindValue(info.vCodecID);
+    m_query->addBindValue(info.vCodeRate);
+    m_query->addBindValue(info.fps);
+    m_query->addBindValue(info.aCodeID);
+    m_query->addBindValue(info.aCodeRate);
+    m_query->addBindValue(info.channels);
+    m_query->addBindValue(info.sampling);
+    m_query->addBindValue(info.creation.toString(Qt::ISODate));
+    if (!m_query->exec()) {
+        qWarning() << "Failed to insert movie info:" << info.filePath << m_query->lastError().text();
+    }
+    // qDebug() << "DBManager::insertMovieInfo - Exit";
+}
+
+/**
+   @brief 将未分类的图片加入后台分类队列，已在队列中的图片保持原状态
+ */
+void DBManager::enqueueClassifyTasks(const DBImgInfoList &infos)
+{
+    ALBUM_TRACE_SCOPE(logDatabase, "db.enqueueClassifyTasks");
+    QMutexLocker mutex(&m_dbMutex);
+    m_query->setForwardOnly(true);
+    if (!m_query->exec("BEGIN IMMEDIATE TRANSACTION")) {
+        qWarning() << "Failed to begin transaction:" << m_query->lastError().text();
+        return;
+    }
+
+    bool b = m_query->prepare(QString("INSERT OR IGNORE INTO ClassifyQueueTable3 (PathHash, FilePath, State, RetryCount, UpdateTime) "
+                                      "VALUES (?, ?, %1, 0, ?)").arg(ClassifyPending));
+    if (b) {
+        const qint64 now = QDateTime::currentSecsSinceEpoch();
+        for (const auto &info : infos) {
+            if (info.itemType != ItemTypePic || !info.className.isEmpty())
+                continue;
+            m_query->addBindValue(LibUnionImage_NameSpace::hashByString(info.filePath));
+            m_query->addBindValue(info.filePath);
+            m_query->addBindValue(now);
+            if (!m_query->exec()) {
+                qWarning() << "Failed to enqueue classify task:" << info.filePath << m_query->lastError().text();
+            }
+        }
+    } else {
+        qWarning() << "Failed to prepare classify queue statement:" << m_query->lastError().text();
+    }
+
+    if (!m_query->exec("COMMIT")) {
+        qWarning() << "Failed to commit transaction:" << m_query->lastError().text();
+    }
+}
+
+/**
+   @brief 取出至多 \a count 个等待分类的任务并标记为进行中，已从图库移除的图片不再分类
+ */
+DBImgInfoList DBManager::takeClassifyTasks(int count)
+{
+    ALBUM_TRACE_SCOPE(logDatabase, "db.takeClassifyTasks");
+    QMutexLocker mutex(&m_dbMutex);
+    DBImgInfoList infos;
+    m_query->setForwardOnly(true);
+    if (!m_query->exec("BEGIN IMMEDIATE TRANSACTION")) {
+        qWarning() << "Failed to begin transaction:" << m_query->lastError().text();
+        return infos;
+    }
+
+    // 等待重试的任务 UpdateTime 为下次重试时间，未到时间的不取出
+    bool b = m_query->prepare(QString("SELECT q.PathHash, q.FilePath FROM ClassifyQueueTable3 q WHERE q.State=%1 "
+                                      "AND q.UpdateTime <= :now "
+                                      "AND EXISTS (SELECT 1 FROM ImageTable3 i WHERE i.PathHash=q.PathHash) "
+                                      "ORDER BY q.UpdateTime DESC LIMIT :count").arg(ClassifyPending));
+    m_query->bindValue(":now", QDateTime::currentSecsSinceEpoch());
+    m_query->bindValue(":count", count);
+    if (!b || !m_query->exec()) {
+        qWarning() << "Failed to query classify tasks:" << m_query->lastError().text();
+    } else {
+        while (m_query->next()) {
+            DBImgInfo info;
+            info.pathHash = m_query->value(0).toString();
+            info.filePath = m_query->value(1).toString();
+            info.itemType = ItemTypePic;
+            infos << info;
+        }
+    }
+
+    if (!infos.isEmpty() && m_query->prepare(QString("UPDATE ClassifyQueueTable3 SET State=%1, UpdateTime=:time WHERE PathHash=:hash").arg(ClassifyInFlight))) {
+        const qint64 now = QDateTime::currentSecsSinceEpoch();
+        for (const auto &info : infos) {
+            m_query->bindValue(":time", now);
+            m_query->bindValue(":hash", info.pathHash);
+            if (!m_query->exec()) {
+                qWarning() << "Failed to mark classify task:" << info.filePath << m_query->lastError().text();
+            }
+        }
+    }
+
+    if (!m_query->exec("COMMIT")) {
+        qWarning() << "Failed to commit transaction:" << m_query->lastError().text();
+    }
+    return infos;
+}
+
+/**
+   @brief 记录分类结果，失败的任务累计重试次数，未超过 \a maxRetry 时重新等待分类，
+    第 n 次失败后等待 \a retryDelay * 2^(n-1) 秒再重试，避免服务异常时反复请求
+ */
+void DBManager::finishClassifyTasks(const DBImgInfoList &done, const DBImgInfoList &failed, int maxRetry, int retryDelay)
+{
+    ALBUM_TRACE_SCOPE(logDatabase, "db.finishClassifyTasks");
+    QMutexLocker mutex(&m_dbMutex);
+    m_query->setForwardOnly(true);
+    if (!m_query->exec("BEGIN IMMEDIATE TRANSACTION")) {
+        qWarning() << "Failed to begin transaction:" << m_query->lastError().text();
+        return;
+    }
+
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    // 完成的任务直接移除，队列中只保留等待、进行中和失败的任务，不随使用时间增长
+    if (!done.isEmpty() && m_query->prepare("DELETE FROM ClassifyQueueTable3 WHERE PathHash=:hash")) {
+        for (const auto &info : done) {
+            m_query->bindValue(":hash", info.pathHash);
+            if (!m_query->exec()) {
+                qWarning() << "Failed to finish classify task:" << info.filePath << m_query->lastError().text();
+            }
+        }
+    }
+
+    if (!failed.isEmpty() && m_query->prepare(QString("UPDATE ClassifyQueueTable3 SET RetryCount=RetryCount+1, "
+                                                      "UpdateTime=:time + (:delay << RetryCount), "
+                                                      "State=CASE WHEN RetryCount+1>=:max THEN %1 ELSE %2 END WHERE PathHash=:hash")
+                                              .arg(ClassifyFailed).arg(ClassifyPending))) {
+        for (const auto &info : failed) {
+            m_query->bindValue(":time", now);
+            m_query->bindValue(":delay", retryDelay);
+            m_query->bindValue(":max", maxRetry);
+            m_query->bindValue(":hash", info.pathHash);
+            if (!m_query->exec()) {
+                qWarning() << "Failed to retry classify task:" << info.filePath << m_query->lastError().text();
+            }
+        }
+    }
+
+    if (!m_query->exec("COMMIT")) {
+        qWarning() << "Failed to commit transaction:" << m_query->lastError().text();
+    }
+}
+
+int DBManager::getClassifyPendingCount() const
+{
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getClassifyPendingCount");
+    QMutexLocker mutex(&m_dbMutex);
+    m_query->setForwardOnly(true);
+    if (!m_query->exec(QString("SELECT COUNT(*) FROM ClassifyQueueTable3 WHERE State=%1").arg(ClassifyPending)) || !m_query->next()) {
+        qWarning() << "Failed to count classify tasks:" << m_query->lastError().text();
+        return 0;
+    }
+    return m_query->value(0).toInt();
+}
+
+/**
+   @return 最早一个等待重试的分类任务的重试时间（秒），没有时返回 -1
+ */
+qint64 DBManager::getClassifyRetryTime() const
+{
+    ALBUM_TRACE_SCOPE(logDatabase, "db.getClassifyRetryTime");
+    QMutexLocker mutex(&m_dbMutex);
+    m_query->setForwardOnly(true);
+    bool b = m_query->prepare(QString("SELECT MIN(UpdateTime) FROM ClassifyQueueTable3 WHERE State=%1 AND UpdateTime > :now")
+                              .arg(ClassifyPending));
+    m_query->bindValue(":now", QDateTime::currentSecsSinceEpoch());
+    if (!b || !m_query->exec() || !m_query->next() || m_query->value(0).isNull()) {
+        return -1;
+    }
+    return m_query->value(0).toLongLong();
+}
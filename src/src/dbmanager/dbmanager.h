@@ -27,6 +27,7 @@
 #include <mutex>
 #include <QReadWriteLock>
 #include "unionimage/unionimage_global.h"
+#include "albummembershipindex.h"
 //#include "connectionpool.h"
 
 
@@ -38,6 +39,7 @@ enum AlbumDBType {
 };
 
 class QSqlDatabase;
+struct MovieInfo;
 
 //注意：需要支持相册重名的版本，在对底层相册操作时，只能传入UID
 
@@ -61,6 +63,14 @@ public:
         u_CustomStart
     };
 
+    //分类任务状态
+    enum ClassifyTaskState {
+        ClassifyPending = 0,    //等待分类
+        ClassifyInFlight,       //正在分类，异常退出后下次启动时恢复为等待
+        ClassifyDone,           //分类完成，完成的任务已直接从队列移除，仅保留取值
+        ClassifyFailed          //重试次数用尽，不再自动分类
+    };
+
     static DBManager  *instance();
     explicit DBManager(QObject *parent = nullptr);
     ~DBManager() = default;
@@ -136,13 +146,18 @@ public:
     // TabelTrash
     const DBImgInfoList     getAllTrashInfos(bool needTimeData) const;
     const DBImgInfoList     getAllTrashInfos_getRemainDays() const;
+    const DBImgInfoList     getTrashInfosPage(const ItemType &filterType, int offset, int limit) const;
+    QStringList             getExpiredTrashPaths(qint64 deadline, int count) const;
     void                    insertTrashImgInfos(const DBImgInfoList &infos, bool showWaitDialog);
+    void                    moveImgInfosToTrash(const QStringList &trashPaths, const QStringList &removePaths);
+    static bool             isExternalTrashPath(const QString &path);
+    static bool             isTrashFileAvailable(const QString &filePath, const QString &pathHash);
     void                    removeTrashImgInfos(const QStringList &paths);
     QStringList             recoveryImgFromTrash(const QStringList &paths); //返回无法恢复的文件
     void                    removeTrashImgInfosNoSignal(const QStringList &paths);
     const DBImgInfo         getTrashInfoByPath(const QString &path) const;
     const DBImgInfoList     getTrashImgInfos(const QString &key, const QString &value) const;
-    int                     getTrashImgsCount() const;
+    int                     getTrashImgsCount(const ItemType &filterType = ItemTypeNull) const;
     int                     getAlbumImgsCount(int UID) const;
     QDateTime               getFileImportTime(const QString &path);
 
@@ -157,7 +172,19 @@ public:
     //日聚合数据
     DBImgInfoList           getInfosByDay(const QString &day);
     QStringList             getDayPaths(const QString &day);
+    int                     getDayCount(const QString &day, const ItemType &filterType = ItemTypeNull) const;
     QStringList             getDays();
+
+    //视频元数据缓存，文件大小或修改时间变化后缓存失效
+    bool                    getMovieInfo(const QString &path, qint64 fileSize, qint64 modifyTime, MovieInfo &info) const;
+    void                    insertMovieInfo(const MovieInfo &info, qint64 modifyTime);
+
+    //后台分类任务队列
+    void                    enqueueClassifyTasks(const DBImgInfoList &infos);
+    DBImgInfoList           takeClassifyTasks(int count);
+    void                    finishClassifyTasks(const DBImgInfoList &done, const DBImgInfoList &failed, int maxRetry, int retryDelay);
+    int                     getClassifyPendingCount() const;
+    qint64                  getClassifyRetryTime() const;
 private:
     const DBImgInfoList     getInfosByNameTimeline(const QString &value) const;
     const DBImgInfoList     getImgInfos(const QString &key, const QString &value, bool needTimeData) const;
@@ -165,12 +192,17 @@ private:
     void                    checkDatabase();
     void                    checkTimeColumn(const QString &tableName);
     void                    checkClassNameColumn(const QString &tableName);
+    void                    checkClassifyQueue();
+    bool                    fillPathHashTemp(const QStringList &paths);
+    static int              remainDaysOf(qint64 expireTime, qint64 now);
+    void                    ensureAlbumIndex() const;
     static DBManager       *m_dbManager;
     static std::once_flag   instanceFlag; //线程安全的单例flag
     void insertSpUID(const QString &albumName, AlbumDBType astype, SpUID UID);
 private:
     mutable QMutex m_dbMutex; //数据库锁，用于锁定Sqlite数据库的操作权限
     mutable QSqlQuery *m_query; //将数据库查询对象统一到类成员变量，以尝试解决sqlite崩溃问题
+    mutable AlbumMembershipIndex m_albumIndex; //相册成员关系的内存索引，首次查询时加载
     std::atomic_int albumMaxUID; //当前数据库中UID的最大值，用于新建UID用
 
     //数据库相关路径
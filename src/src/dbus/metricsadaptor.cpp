@@ -0,0 +1,41 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "metricsadaptor.h"
+
+MetricsAdaptor::MetricsAdaptor(PerfMetrics *metrics)
+    : QDBusAbstractAdaptor(metrics)
+    , metrics(metrics)
+{
+}
+
+QString MetricsAdaptor::snapshot()
+{
+    return QString::fromUtf8(metrics->snapshotJson());
+}
+
+void MetricsAdaptor::reset()
+{
+    metrics->reset();
+}
+
+bool MetricsAdaptor::dumpTo(const QString &path)
+{
+    return metrics->dumpTo(path);
+}
+
+bool MetricsAdaptor::tracing() const
+{
+    return PerfTrace::isEnabled();
+}
+
+bool MetricsAdaptor::startTrace(const QString &path)
+{
+    return PerfTrace::instance()->start(path);
+}
+
+bool MetricsAdaptor::stopTrace()
+{
+    return PerfTrace::instance()->stop();
+}
@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef METRICSADAPTOR_H
+#define METRICSADAPTOR_H
+
+#include "utils/perfmetrics.h"
+
+#include <QtDBus>
+
+/**
+ * @brief 性能指标调试接口，注册在 com.deepin.album 服务的 /metrics 路径下。
+ *      例：qdbus com.deepin.album /metrics com.deepin.album.Metrics.snapshot
+ */
+class MetricsAdaptor : public QDBusAbstractAdaptor
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "com.deepin.album.Metrics")
+    Q_PROPERTY(bool tracing READ tracing)
+    Q_CLASSINFO("D-Bus Introspection",
+                "<interface name=\"com.deepin.album.Metrics\">\n"
+                "    <method name=\"snapshot\">\n"
+                "        <arg direction=\"out\" type=\"s\"/>\n"
+                "    </method>\n"
+                "    <method name=\"reset\"/>\n"
+                "    <method name=\"dumpTo\">\n"
+                "        <arg direction=\"in\" type=\"s\" name=\"path\"/>\n"
+                "        <arg direction=\"out\" type=\"b\"/>\n"
+                "    </method>\n"
+                "    <method name=\"startTrace\">\n"
+                "        <arg direction=\"in\" type=\"s\" name=\"path\"/>\n"
+                "        <arg direction=\"out\" type=\"b\"/>\n"
+                "    </method>\n"
+                "    <method name=\"stopTrace\">\n"
+                "        <arg direction=\"out\" type=\"b\"/>\n"
+                "    </method>\n"
+                "    <property access=\"read\" type=\"b\" name=\"tracing\"/>\n"
+                "</interface>\n")
+
+public:
+    explicit MetricsAdaptor(PerfMetrics *metrics);
+
+    bool tracing() const;
+
+public Q_SLOTS:
+    // 返回 JSON 格式的指标快照
+    QString snapshot();
+    // 清零计数器和直方图
+    void reset();
+    // 将快照写入文件
+    bool dumpTo(const QString &path);
+    // 开始记录 Chrome trace，停止时写入 path
+    bool startTrace(const QString &path);
+    // 停止记录并写入文件
+    bool stopTrace();
+
+private:
+    PerfMetrics *metrics = nullptr;
+};
+
+#endif  // METRICSADAPTOR_H
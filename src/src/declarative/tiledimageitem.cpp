@@ -0,0 +1,382 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "tiledimageitem.h"
+
+#include <QImageReader>
+#include <QImageIOHandler>
+#include <QPainter>
+#include <QQuickWindow>
+#include <QRunnable>
+#include <QtMath>
+#include <QDebug>
+
+static const int sc_TileSize = 512;              // 分块解码后的边长
+static const int sc_TileCacheSizeKB = 64 * 1024; // 分块缓存容量 64MB
+static const int sc_UpdateInterval = 30;         // 缩放拖拽时刷新分块的间隔(ms)
+
+/**
+   @class TileDecodeTask
+   @brief 在子线程中按区域解码原图的一个分块，完成后通过队列连接投递回界面线程
+ */
+class TileDecodeTask : public QRunnable
+{
+public:
+    TileDecodeTask(QObject *r, const QString &path, const QRect &rect, const QSize &size, int gen, int l, int c, int ro)
+        : receiver(r)
+        , filePath(path)
+        , sourceRect(rect)
+        , scaledSize(size)
+        , generation(gen)
+        , level(l)
+        , column(c)
+        , row(ro)
+    {
+    }
+
+    void run() override
+    {
+        QImageReader reader(filePath);
+        reader.setAutoTransform(false);
+        reader.setClipRect(sourceRect);
+        reader.setScaledSize(scaledSize);
+
+        QImage tile = reader.read();
+        if (tile.isNull()) {
+            qWarning() << "Failed to decode tile" << sourceRect << "of" << filePath << reader.errorString();
+        }
+
+        // 接收者析构前会等待线程池结束，此处投递是安全的
+        QMetaObject::invokeMethod(receiver, "onTileDecoded", Qt::QueuedConnection,
+                                  Q_ARG(int, generation), Q_ARG(int, level), Q_ARG(int, column), Q_ARG(int, row),
+                                  Q_ARG(QImage, tile));
+    }
+
+private:
+    QObject *receiver;
+    QString filePath;
+    QRect sourceRect;
+    QSize scaledSize;
+    int generation;
+    int level;
+    int column;
+    int row;
+};
+
+/**
+   @class TiledImageItem
+   @brief 超大图片的分块绘制组件，覆盖在大图展示的 Image 之上。
+    Image 展示的是限制尺寸后的预览图，当放大超过预览图精度时，仅对可见区域按当前缩放
+    选择降采样级别，通过 QImageReader::setClipRect() 区域解码原图分块，并缓存在 LRU 分块池中。
+    绘制时优先使用当前级别的分块，缺失时使用已缓存的更低精度分块，均缺失时露出底部的预览图。
+    组件自身尺寸与视口一致，绘制内存不随缩放增长。
+ */
+TiledImageItem::TiledImageItem(QQuickItem *parent)
+    : QQuickPaintedItem(parent)
+{
+    setAcceptedMouseButtons(Qt::NoButton);
+    tileCache.setMaxCost(sc_TileCacheSizeKB);
+    decodePool.setMaxThreadCount(2);
+
+    updateTimer = new QTimer(this);
+    updateTimer->setSingleShot(true);
+    updateTimer->setInterval(sc_UpdateInterval);
+    connect(updateTimer, &QTimer::timeout, this, &TiledImageItem::updateTiles);
+}
+
+TiledImageItem::~TiledImageItem()
+{
+    decodePool.clear();
+    decodePool.waitForDone();
+}
+
+QUrl TiledImageItem::source() const
+{
+    return imageSource;
+}
+
+/**
+   @brief 设置原图路径 \a source ，读取原图尺寸并判断是否支持区域解码
+ */
+void TiledImageItem::setSource(const QUrl &source)
+{
+    if (imageSource != source) {
+        imageSource = source;
+        resetSource();
+        Q_EMIT sourceChanged();
+    }
+}
+
+QQuickItem *TiledImageItem::targetImage() const
+{
+    return target;
+}
+
+/**
+   @brief 设置展示预览图的 Image 组件 \a image ，分块按其绘制区域和缩放进行定位
+ */
+void TiledImageItem::setTargetImage(QQuickItem *image)
+{
+    if (target == image) {
+        return;
+    }
+
+    if (target) {
+        disconnect(target, nullptr, this, nullptr);
+    }
+    target = image;
+    if (target) {
+        connect(target, &QQuickItem::xChanged, this, &TiledImageItem::scheduleUpdateTiles);
+        connect(target, &QQuickItem::yChanged, this, &TiledImageItem::scheduleUpdateTiles);
+        connect(target, &QQuickItem::scaleChanged, this, &TiledImageItem::scheduleUpdateTiles);
+        connect(target, &QQuickItem::rotationChanged, this, &TiledImageItem::scheduleUpdateTiles);
+        connect(target, &QQuickItem::widthChanged, this, &TiledImageItem::scheduleUpdateTiles);
+        connect(target, &QQuickItem::heightChanged, this, &TiledImageItem::scheduleUpdateTiles);
+        // QQuickImage 为私有类型，通过信号名称关联绘制区域变更
+        connect(target, SIGNAL(paintedGeometryChanged()), this, SLOT(scheduleUpdateTiles()));
+    }
+
+    scheduleUpdateTiles();
+    Q_EMIT targetImageChanged();
+}
+
+/**
+   @return 返回当前是否正在分块绘制原图细节
+ */
+bool TiledImageItem::tiling() const
+{
+    return tilingEnabled;
+}
+
+void TiledImageItem::setTiling(bool b)
+{
+    if (tilingEnabled != b) {
+        tilingEnabled = b;
+        Q_EMIT tilingChanged();
+    }
+}
+
+/**
+   @brief 绘制可见分块，当前级别的分块未就绪时使用更低精度的已缓存分块
+ */
+void TiledImageItem::paint(QPainter *painter)
+{
+    if (!tilingEnabled) {
+        return;
+    }
+
+    const QRectF imageRect = imageRectInItem();
+    if (imageRect.isEmpty()) {
+        return;
+    }
+
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, true);
+    const qreal ratio = imageRect.width() / originalSize.width();
+
+    const int maxLevel = levelForScale(qreal(sc_TileSize) / qMax(originalSize.width(), originalSize.height()));
+    // 从粗到细绘制，精细的分块覆盖在粗糙的分块之上
+    for (int level = maxLevel; level >= currentLevel; --level) {
+        const QList<TileKey> tiles = visibleTiles(level);
+        for (const TileKey &key : tiles) {
+            QImage *tile = tileCache.object(key);
+            if (!tile || tile->isNull()) {
+                continue;
+            }
+
+            const QRectF srcRect = tileSourceRect(key);
+            const QRectF targetRect(imageRect.x() + srcRect.x() * ratio, imageRect.y() + srcRect.y() * ratio,
+                                    srcRect.width() * ratio, srcRect.height() * ratio);
+            painter->drawImage(targetRect, *tile);
+        }
+    }
+}
+
+void TiledImageItem::geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickPaintedItem::geometryChange(newGeometry, oldGeometry);
+    scheduleUpdateTiles();
+}
+
+/**
+   @brief 节流刷新分块，拖拽缩放过程中按间隔更新
+ */
+void TiledImageItem::scheduleUpdateTiles()
+{
+    if (!updateTimer->isActive()) {
+        updateTimer->start();
+    }
+}
+
+/**
+   @brief 根据当前缩放判断是否需要分块绘制，计算降采样级别并请求可见分块
+ */
+void TiledImageItem::updateTiles()
+{
+    bool needTiling = supportTiling && target && !originalSize.isEmpty();
+    if (needTiling) {
+        // 旋转过程中不进行分块绘制
+        needTiling = qFuzzyIsNull(std::fmod(target->rotation(), 360.0));
+    }
+
+    qreal displayScale = 0;
+    if (needTiling) {
+        const qreal dpr = window() ? window()->effectiveDevicePixelRatio() : 1.0;
+        displayScale = imageRectInItem().width() * dpr / originalSize.width();
+
+        // 仅当屏幕显示精度超过预览图精度时启用
+        const QSize previewSize = target->property("sourceSize").toSize();
+        needTiling = previewSize.width() > 0 && displayScale * originalSize.width() > previewSize.width();
+    }
+
+    setTiling(needTiling);
+    if (!needTiling) {
+        update();
+        return;
+    }
+
+    currentLevel = levelForScale(displayScale);
+
+    const QList<TileKey> tiles = visibleTiles(currentLevel);
+    for (const TileKey &key : tiles) {
+        if (!tileCache.contains(key)) {
+            requestTile(key);
+        }
+    }
+
+    update();
+}
+
+/**
+   @brief 接收子线程解码完成的分块 \a tile ，过期批次的结果直接丢弃
+ */
+void TiledImageItem::onTileDecoded(int gen, int level, int column, int row, const QImage &tile)
+{
+    const TileKey key { level, column, row };
+    if (gen != generation) {
+        return;
+    }
+
+    pendingTiles.remove(key);
+    tileCache.insert(key, new QImage(tile), static_cast<int>(qMax<qsizetype>(1, tile.sizeInBytes() / 1024)));
+
+    if (tilingEnabled && level >= currentLevel) {
+        update();
+    }
+}
+
+/**
+   @brief 图片源变更，清除缓存的分块并重新读取原图信息
+ */
+void TiledImageItem::resetSource()
+{
+    ++generation;
+    decodePool.clear();
+    tileCache.clear();
+    pendingTiles.clear();
+    originalSize = QSize();
+    supportTiling = false;
+
+    const QString filePath = imageSource.toLocalFile();
+    if (!filePath.isEmpty()) {
+        QImageReader reader(filePath);
+        originalSize = reader.size();
+        // 仅对支持区域解码且无需方向变换的图片分块，其它格式区域解码仍需完整解码原图
+        supportTiling = reader.supportsOption(QImageIOHandler::ClipRect)
+                        && reader.supportsOption(QImageIOHandler::ScaledSize)
+                        && QImageIOHandler::TransformationNone == reader.transformation();
+    }
+
+    scheduleUpdateTiles();
+}
+
+/**
+   @return 返回预览图实际绘制区域在当前组件中的坐标
+ */
+QRectF TiledImageItem::imageRectInItem() const
+{
+    if (!target) {
+        return QRectF();
+    }
+
+    const qreal paintedWidth = target->property("paintedWidth").toReal();
+    const qreal paintedHeight = target->property("paintedHeight").toReal();
+    const QRectF paintedRect((target->width() - paintedWidth) / 2, (target->height() - paintedHeight) / 2,
+                             paintedWidth, paintedHeight);
+    return target->mapRectToItem(this, paintedRect);
+}
+
+/**
+   @return 返回显示缩放 \a scale (屏幕像素 / 原图像素) 对应的降采样级别，
+    保证分块精度不低于屏幕精度
+ */
+int TiledImageItem::levelForScale(qreal scale) const
+{
+    if (scale >= 1.0 || scale <= 0) {
+        return 0;
+    }
+
+    return qMax(0, qFloor(std::log2(1.0 / scale)));
+}
+
+/**
+   @return 返回分块 \a key 在原图中对应的区域
+ */
+QRect TiledImageItem::tileSourceRect(const TileKey &key) const
+{
+    const int span = sc_TileSize << key.level;
+    return QRect(key.column * span, key.row * span, span, span).intersected(QRect(QPoint(0, 0), originalSize));
+}
+
+/**
+   @return 返回降采样级别 \a level 下与视口相交的分块
+ */
+QList<TiledImageItem::TileKey> TiledImageItem::visibleTiles(int level) const
+{
+    QList<TileKey> tiles;
+    const QRectF imageRect = imageRectInItem();
+    if (imageRect.isEmpty() || originalSize.isEmpty()) {
+        return tiles;
+    }
+
+    // 视口映射到原图坐标
+    const QRectF visibleRect = imageRect.intersected(boundingRect());
+    if (visibleRect.isEmpty()) {
+        return tiles;
+    }
+
+    const qreal ratio = originalSize.width() / imageRect.width();
+    const QRectF sourceRect((visibleRect.x() - imageRect.x()) * ratio, (visibleRect.y() - imageRect.y()) * ratio,
+                            visibleRect.width() * ratio, visibleRect.height() * ratio);
+
+    const int span = sc_TileSize << level;
+    const int firstColumn = qMax(0, qFloor(sourceRect.left() / span));
+    const int lastColumn = qMin((originalSize.width() - 1) / span, qFloor(sourceRect.right() / span));
+    const int firstRow = qMax(0, qFloor(sourceRect.top() / span));
+    const int lastRow = qMin((originalSize.height() - 1) / span, qFloor(sourceRect.bottom() / span));
+
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            tiles.append(TileKey { level, column, row });
+        }
+    }
+
+    return tiles;
+}
+
+/**
+   @brief 请求在子线程中解码分块 \a key ，已在解码中的分块不重复请求
+ */
+void TiledImageItem::requestTile(const TileKey &key)
+{
+    if (pendingTiles.contains(key)) {
+        return;
+    }
+    pendingTiles.insert(key);
+
+    const QRect srcRect = tileSourceRect(key);
+    const QSize scaledSize(qMax(1, qCeil(qreal(srcRect.width()) / (1 << key.level))),
+                           qMax(1, qCeil(qreal(srcRect.height()) / (1 << key.level))));
+    decodePool.start(new TileDecodeTask(this, imageSource.toLocalFile(), srcRect, scaledSize,
+                                        generation, key.level, key.column, key.row));
+}
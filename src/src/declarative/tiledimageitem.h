@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef TILEDIMAGEITEM_H
+#define TILEDIMAGEITEM_H
+
+#include <QQuickPaintedItem>
+#include <QPointer>
+#include <QCache>
+#include <QSet>
+#include <QThreadPool>
+#include <QTimer>
+#include <QImage>
+#include <QUrl>
+
+class TiledImageItem : public QQuickPaintedItem
+{
+    Q_OBJECT
+    Q_PROPERTY(QUrl source READ source WRITE setSource NOTIFY sourceChanged FINAL)
+    Q_PROPERTY(QQuickItem *targetImage READ targetImage WRITE setTargetImage NOTIFY targetImageChanged FINAL)
+    Q_PROPERTY(bool tiling READ tiling NOTIFY tilingChanged FINAL)
+
+public:
+    explicit TiledImageItem(QQuickItem *parent = nullptr);
+    ~TiledImageItem() override;
+
+    QUrl source() const;
+    void setSource(const QUrl &source);
+    Q_SIGNAL void sourceChanged();
+
+    QQuickItem *targetImage() const;
+    void setTargetImage(QQuickItem *image);
+    Q_SIGNAL void targetImageChanged();
+
+    bool tiling() const;
+    Q_SIGNAL void tilingChanged();
+
+    void paint(QPainter *painter) override;
+
+protected:
+    void geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+
+private:
+    // 分块索引，level 为降采样级别，分块解码尺寸为原图的 1 / 2^level
+    struct TileKey
+    {
+        int level { 0 };
+        int column { 0 };
+        int row { 0 };
+
+        bool operator==(const TileKey &other) const
+        {
+            return level == other.level && column == other.column && row == other.row;
+        }
+    };
+    friend size_t qHash(const TileKey &key, size_t seed) noexcept
+    {
+        return qHashMulti(seed, key.level, key.column, key.row);
+    }
+
+    Q_SLOT void scheduleUpdateTiles();
+    Q_SLOT void updateTiles();
+    Q_INVOKABLE void onTileDecoded(int generation, int level, int column, int row, const QImage &tile);
+
+    void resetSource();
+    void setTiling(bool b);
+    QRectF imageRectInItem() const;
+    int levelForScale(qreal scale) const;
+    QRect tileSourceRect(const TileKey &key) const;
+    QList<TileKey> visibleTiles(int level) const;
+    void requestTile(const TileKey &key);
+
+private:
+    QUrl imageSource;
+    QPointer<QQuickItem> target;
+
+    QSize originalSize;              // 原图尺寸
+    bool supportTiling { false };    // 图片格式是否支持区域解码
+    bool tilingEnabled { false };    // 当前缩放下是否需要分块绘制
+    int currentLevel { 0 };
+
+    int generation { 0 };            // 图片源变更批次，用于丢弃过期的解码结果
+    QCache<TileKey, QImage> tileCache;  // 分块缓存，开销按 KiB 计算
+    QSet<TileKey> pendingTiles;
+    QThreadPool decodePool;
+    QTimer *updateTimer { nullptr };
+};
+
+#endif  // TILEDIMAGEITEM_H
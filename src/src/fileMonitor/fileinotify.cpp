@@ -6,6 +6,7 @@
 #include "fileinotify.h"
 #include "unionimage/unionimage.h"
 #include "dbmanager/dbmanager.h"
+#include "utils/perfmetrics.h"
 
 #include <sys/inotify.h>
 #include <dirent.h>
@@ -25,7 +26,7 @@ FileInotify::FileInotify(QObject *parent)
     : QObject(parent)
     , m_Supported(LibUnionImage_NameSpace::unionImageSupportFormat() + LibUnionImage_NameSpace::videoFiletypes()) //图片+视频
 {
-    qDebug() << "Initializing FileInotify with supported formats:" << m_Supported;
+    qCDebug(logMonitor) << "Initializing FileInotify with supported formats:" << m_Supported;
 
     for (auto &eachData : m_Supported) {
         eachData = eachData.toUpper();
@@ -35,7 +36,8 @@ FileInotify::FileInotify(QObject *parent)
     connect(m_timer, &QTimer::timeout, this, &FileInotify::onNeedSendPictures);
 
     connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, [this](const QString & path) {
-        qDebug() << "Directory change detected in:" << path;
+        ALBUM_COUNTER_INC("monitor.events");
+        qCDebug(logMonitor) << "Directory change detected in:" << path;
 
         // 检查是否有待创建的目录已经被创建
         checkPendingDirectories(path);
@@ -47,13 +49,13 @@ FileInotify::FileInotify(QObject *parent)
 
 FileInotify::~FileInotify()
 {
-    qDebug() << "Cleaning up FileInotify resources";
+    qCDebug(logMonitor) << "Cleaning up FileInotify resources";
     clear();
 }
 
 void FileInotify::checkNewPath()
 {
-    qDebug() << "Checking for new paths in monitored directories";
+    qCDebug(logMonitor) << "Checking for new paths in monitored directories";
 
     // 检查现有监控目录的子目录
     for (const auto &currentDir : m_currentDirs) {
@@ -67,7 +69,7 @@ void FileInotify::checkNewPath()
         });
 
         if (!dirs.isEmpty()) {
-            qDebug() << "Adding new subdirectories to watch:" << dirs;
+            qCDebug(logMonitor) << "Adding new subdirectories to watch:" << dirs;
             m_watcher.addPaths(dirs);
         }
     }
@@ -90,7 +92,7 @@ void FileInotify::checkNewPath()
 
 void FileInotify::addWather(const QStringList &paths, const QString &album, int UID)
 {
-    qDebug() << "Adding watch for paths:" << paths << "Album:" << album << "UID:" << UID;
+    qCDebug(logMonitor) << "Adding watch for paths:" << paths << "Album:" << album << "UID:" << UID;
 
     m_currentAlbum = album;
     m_currentUID = UID;
@@ -105,7 +107,7 @@ void FileInotify::addWather(const QStringList &paths, const QString &album, int
             existingPaths.append(path);
         } else {
             nonExistingPaths.append(path);
-            qDebug() << "Path does not exist, will try parent monitoring:" << path;
+            qCDebug(logMonitor) << "Path does not exist, will try parent monitoring:" << path;
         }
     }
 
@@ -115,7 +117,7 @@ void FileInotify::addWather(const QStringList &paths, const QString &album, int
     // 为存在的路径添加直接监听
     if (!existingPaths.isEmpty()) {
         m_watcher.addPaths(existingPaths);
-        qDebug() << "Added direct monitoring for existing paths:" << existingPaths;
+        qCDebug(logMonitor) << "Added direct monitoring for existing paths:" << existingPaths;
     }
 
     // 为不存在的路径设置父级监听
@@ -127,7 +129,7 @@ void FileInotify::addWather(const QStringList &paths, const QString &album, int
         if (parentInfo.exists() && parentInfo.isDir()) {
             addParentWatcher(parentPath, path);
             m_pendingDirs.append(path);
-            qDebug() << "Added parent monitoring for non-existing path:" << path << "parent:" << parentPath;
+            qCDebug(logMonitor) << "Added parent monitoring for non-existing path:" << path << "parent:" << parentPath;
         } else {
             qWarning() << "Cannot monitor path, parent directory does not exist:" << path << "parent:" << parentPath;
         }
@@ -150,7 +152,7 @@ void FileInotify::addWather(const QStringList &paths, const QString &album, int
 
 void FileInotify::clear()
 {
-    qDebug() << "Clearing FileInotify state";
+    qCDebug(logMonitor) << "Clearing FileInotify state";
     m_Supported.clear();
     m_newFile.clear();
     m_deleteFile.clear();
@@ -168,7 +170,8 @@ void FileInotify::clear()
 
 void FileInotify::getAllPicture(bool isFirst)
 {
-    qDebug() << "Getting all pictures, isFirst:" << isFirst;
+    ALBUM_TRACE_SCOPE(logMonitor, "monitor.scan");
+    qCDebug(logMonitor) << "Getting all pictures, isFirst:" << isFirst;
     QFileInfoList list;
     for (int i = 0; i != m_currentDirs.size(); ++i) {
         QDir dir(m_currentDirs[i]);
@@ -210,7 +213,7 @@ void FileInotify::getAllPicture(bool isFirst)
     //筛选出新增图片文件
     for (auto path : filePaths) {
         if (!allPaths.contains(path)) {
-            qDebug() << "New file detected:" << path;
+            qCDebug(logMonitor) << "New file detected:" << path;
             m_newFile << path;
         }
     }
@@ -219,7 +222,7 @@ void FileInotify::getAllPicture(bool isFirst)
     if (!isFirst) {
         for (auto path : allPaths) {
             if (!filePaths.contains(path)) {
-                qDebug() << "File removed:" << path;
+                qCDebug(logMonitor) << "File removed:" << path;
                 m_deleteFile << path;
             }
         }
@@ -253,7 +256,9 @@ void FileInotify::getAllPicture(bool isFirst)
 
 void FileInotify::onNeedSendPictures()
 {
-    qDebug() << "Processing file changes";
+    ALBUM_COUNTER_INC("monitor.rescans");
+    ALBUM_TRACE_SCOPE(logMonitor, "monitor.rescan");
+    qCDebug(logMonitor) << "Processing file changes";
     checkNewPath();
     getAllPicture(false);
 
@@ -261,17 +266,19 @@ void FileInotify::onNeedSendPictures()
     if (!m_newFile.isEmpty() || !m_deleteFile.isEmpty()) {
         qInfo() << "Emitting monitor changed signal - New files:" << m_newFile.size()
                 << "Deleted files:" << m_deleteFile.size();
+        ALBUM_COUNTER_ADD("monitor.files.added", m_newFile.size());
+        ALBUM_COUNTER_ADD("monitor.files.removed", m_deleteFile.size());
         emit sigMonitorChanged(m_newFile, m_deleteFile, m_currentAlbum, m_currentUID);
 
         if (m_newFile.size() > 100) {
-            qDebug() << "Clearing large new file list";
+            qCDebug(logMonitor) << "Clearing large new file list";
             QStringList().swap(m_newFile); //强制清理内存
         } else {
             m_newFile.clear();
         }
 
         if (m_deleteFile.size() > 100) {
-            qDebug() << "Clearing large delete file list";
+            qCDebug(logMonitor) << "Clearing large delete file list";
             QStringList().swap(m_deleteFile); //强制清理内存
         } else {
             m_deleteFile.clear();
@@ -283,13 +290,13 @@ void FileInotify::onNeedSendPictures()
 
 void FileInotify::addParentWatcher(const QString &parentPath, const QString &targetChild)
 {
-    qDebug() << "Adding parent watcher for:" << parentPath << "target child:" << targetChild;
+    qCDebug(logMonitor) << "Adding parent watcher for:" << parentPath << "target child:" << targetChild;
 
     // 检查是否已经监听了这个父级目录
     if (!m_parentDirs.contains(parentPath)) {
         m_parentDirs.append(parentPath);
         m_watcher.addPath(parentPath);
-        qDebug() << "Started monitoring parent directory:" << parentPath;
+        qCDebug(logMonitor) << "Started monitoring parent directory:" << parentPath;
     }
 
     // 建立父级目录到子目录的映射
@@ -299,13 +306,13 @@ void FileInotify::addParentWatcher(const QString &parentPath, const QString &tar
 
     if (!m_parentToChildren[parentPath].contains(targetChild)) {
         m_parentToChildren[parentPath].append(targetChild);
-        qDebug() << "Added target child mapping:" << parentPath << "->" << targetChild;
+        qCDebug(logMonitor) << "Added target child mapping:" << parentPath << "->" << targetChild;
     }
 }
 
 void FileInotify::checkPendingDirectories(const QString &changedPath)
 {
-    qDebug() << "Checking pending directories for changed path:" << changedPath;
+    qCDebug(logMonitor) << "Checking pending directories for changed path:" << changedPath;
 
     // 检查是否有待创建的目录位于变化的路径下
     QStringList foundDirs;
@@ -341,7 +348,7 @@ void FileInotify::checkPendingDirectories(const QString &changedPath)
                 m_parentToChildren.remove(parentPath);
                 m_parentDirs.removeAll(parentPath);
                 m_watcher.removePath(parentPath);
-                qDebug() << "Removed parent monitoring for:" << parentPath;
+                qCDebug(logMonitor) << "Removed parent monitoring for:" << parentPath;
             }
         }
 
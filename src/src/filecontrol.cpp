@@ -9,6 +9,7 @@
 #include "printdialog/printhelper.h"
 #include "ocr/ocrinterface.h"
 #include "imagedata/imageinfo.h"
+#include "utils/rotateimagehelper.h"
 
 #include <DSysInfo>
 
@@ -99,6 +100,10 @@ FileControl::FileControl(QObject *parent)
     imageFileWatcher = ImageFileWatcher::instance();
 
     QObject::connect(imageFileWatcher, &ImageFileWatcher::imageFileChanged, this, &FileControl::imageFileChanged);
+    QObject::connect(RotateImageHelper::instance(), &RotateImageHelper::batchRotateProgress, this,
+                     [this](const QString &, bool, int finished, int total) { Q_EMIT batchRotateProgress(finished, total); });
+    QObject::connect(RotateImageHelper::instance(), &RotateImageHelper::batchRotateSkipped, this,
+                     [this](const QStringList &paths) { Q_EMIT batchRotateSkipped(paths.size()); });
 
     // 在1000ms以内只保存一次配置信息
     if (!m_tSaveSetting) {
@@ -1187,12 +1192,21 @@ bool FileControl::rotateFile(const QVariantList &pathList, const int &rotateAnge
 {
     qDebug() << "FileControl::rotateFile - Function entry, pathList:" << pathList << "rotateAngel:" << rotateAngel;
     bool bRet = true;
+    // 先保存延时处理中的单张旋转，避免与批量任务同时写入同一文件
+    if (m_tSaveImage->isActive()) {
+        slotRotatePixCurrent(true);
+    }
+
+    QStringList paths;
     for (int i = 0; i < pathList.size(); i++) {
         if (!pathList[i].toString().isEmpty()) {
-            rotateFile(pathList[i].toString(), rotateAngel);
+            paths.append(LibUnionImage_NameSpace::localPath(pathList[i].toString()));
         }
     }
 
+    // 批量旋转在线程池中并发处理，结束后统一刷新缩略图
+    RotateImageHelper::instance()->rotateImageFiles(paths, rotateAngel);
+
     qDebug() << "FileControl::rotateFile - Function exit, returning:" << bRet;
     return bRet;
 }
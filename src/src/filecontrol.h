@@ -103,6 +103,10 @@ public:
     Q_SIGNAL void imageRenamed(const QUrl &oldName, const QUrl &newName);
     // 文件变更通知信号，文件被移动、删除、覆盖等操作时触发
     Q_SIGNAL void imageFileChanged(const QString &fileName);
+    // 批量旋转进度，\a finished 等于 \a total 时全部处理完成
+    Q_SIGNAL void batchRotateProgress(int finished, int total);
+    // 批量旋转中为保持画质未旋转的文件数
+    Q_SIGNAL void batchRotateSkipped(int count);
 
 signals:
     // 通知相册刷新缩略图内容
@@ -35,6 +35,10 @@ GlobalControl::GlobalControl(QObject *parent)
             submitImageChangeImmediately();
         }
     });
+    // 批量旋转完成后统一刷新缩略图
+    connect(RotateImageHelper::instance(), &RotateImageHelper::batchRotateFinished, this, [](const QStringList &paths) {
+        ImageDataService::instance()->reloadThumbnails(paths);
+    });
     qDebug() << "GlobalControl::GlobalControl - Function exit";
 }
 
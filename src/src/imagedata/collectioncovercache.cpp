@@ -0,0 +1,187 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "collectioncovercache.h"
+#include "derivativestore.h"
+#include "unionimage/unionimage.h"
+#include "imageengine/movieservice.h"
+#include "utils/perfmetrics.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QUrl>
+#include <QtConcurrent>
+#include <QDebug>
+
+static const int sc_MemoryCacheKiB = 64 * 1024;        // 内存缓存上限 64 MiB
+static const int sc_DiskExpireDays = 60;               // 磁盘缓存超过该天数未更新即清理
+static const char *const sc_CacheFormat = "jpg";
+static const int sc_CacheQuality = 90;
+
+CollectionCoverCache::CollectionCoverCache()
+    : cacheDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/collection_cover")
+{
+    cache.setMaxCost(sc_MemoryCacheKiB);
+    QDir().mkpath(cacheDir);
+
+    // 过期的封面不影响正确性，只占用磁盘，后台清理即可
+    QtConcurrent::run([this]() {
+        pruneExpired();
+    });
+}
+
+CollectionCoverCache::~CollectionCoverCache()
+{
+}
+
+CollectionCoverCache *CollectionCoverCache::instance()
+{
+    static CollectionCoverCache ins;
+    return &ins;
+}
+
+/**
+   @return 返回聚合周期 \a period 、尺寸类型 \a sizeClass 及封面 \a coverPath 对应的缓存键，
+    封面文件的修改时间参与计算，文件变更后缓存自动失效
+ */
+QString CollectionCoverCache::makeKey(const QString &period, int sizeClass, const QString &coverPath)
+{
+    const qint64 mtime = QFileInfo(coverPath).lastModified().toMSecsSinceEpoch();
+    const QString raw = QString("%1|%2|%3|%4").arg(period).arg(sizeClass).arg(coverPath).arg(mtime);
+    return QString::fromLatin1(QCryptographicHash::hash(raw.toUtf8(), QCryptographicHash::Md5).toHex());
+}
+
+/**
+   @return 返回缓存键 \a key 对应的封面，先查内存缓存，再查磁盘缓存，均未命中返回空图
+ */
+QImage CollectionCoverCache::find(const QString &key)
+{
+    {
+        QMutexLocker _locker(&mutex);
+        if (QImage *image = cache.object(key)) {
+            ALBUM_COUNTER_INC("cache.cover.memory.hit");
+            return *image;
+        }
+    }
+
+    QImage image;
+    const QString filePath = cacheFilePath(key);
+    if (!QFile::exists(filePath) || !image.load(filePath, sc_CacheFormat)) {
+        ALBUM_COUNTER_INC("cache.cover.miss");
+        return QImage();
+    }
+    ALBUM_COUNTER_INC("cache.cover.disk.hit");
+
+    // 刷新修改时间，常用的封面不会被过期清理
+    QFile file(filePath);
+    if (file.open(QIODevice::ReadWrite)) {
+        file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    }
+
+    QMutexLocker _locker(&mutex);
+    cache.insert(key, new QImage(image), qMax(1, static_cast<int>(image.sizeInBytes() / 1024)));
+    return image;
+}
+
+/**
+   @brief 保存封面 \a image 到内存及磁盘缓存
+ */
+void CollectionCoverCache::insert(const QString &key, const QImage &image)
+{
+    if (image.isNull()) {
+        return;
+    }
+
+    {
+        QMutexLocker _locker(&mutex);
+        cache.insert(key, new QImage(image), qMax(1, static_cast<int>(image.sizeInBytes() / 1024)));
+    }
+
+    // QSaveFile 在同目录下写入唯一命名的临时文件后原子替换，并发写入同一封面时互不干扰，读取方不会读到不完整的文件
+    const QString filePath = cacheFilePath(key);
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly) || !image.save(&file, sc_CacheFormat, sc_CacheQuality) || !file.commit()) {
+        qWarning() << "Failed to save collection cover cache:" << filePath;
+    }
+}
+
+void CollectionCoverCache::clear()
+{
+    QMutexLocker _locker(&mutex);
+    cache.clear();
+    QDir(cacheDir).removeRecursively();
+    QDir().mkpath(cacheDir);
+}
+
+/**
+   @return 读取 \a path 用于生成封面的图像，优先使用派生图，派生图不足时支持缩放解码的格式按覆盖
+    \a coverSize 的尺寸解码，不再完整解码原图；视频取封面帧
+ */
+QImage CollectionCoverCache::loadScaledSource(const QString &path, const QSize &coverSize)
+{
+    QImage image;
+    if (LibUnionImage_NameSpace::isVideo(path)) {
+        return MovieService::instance()->getMovieCover(QUrl::fromLocalFile(path));
+    }
+
+    // 派生图足够覆盖封面时直接使用，否则按封面尺寸缩放解码
+    image = DerivativeStore::instance()->image(path, coverSize, Qt::KeepAspectRatioByExpanding);
+    if (!image.isNull()) {
+        return image;
+    }
+
+    QImageReader reader(path);
+    reader.setAutoTransform(true);
+    if (reader.canRead()) {
+        const QSize sourceSize = reader.size();
+        if (sourceSize.isValid()) {
+            // 缩放解码在旋转之前进行，需按旋转前的方向计算目标尺寸
+            QSize target = coverSize;
+            if (reader.transformation() & QImageIOHandler::TransformationRotate90) {
+                target.transpose();
+            }
+            target = sourceSize.scaled(target, Qt::KeepAspectRatioByExpanding);
+            if (target.width() < sourceSize.width() && target.height() < sourceSize.height()) {
+                reader.setScaledSize(target);
+            }
+        }
+        if (reader.read(&image)) {
+            return image;
+        }
+    }
+
+    QString error;
+    LibUnionImage_NameSpace::loadStaticImageFromFile(path, image, error);
+    if (!error.isEmpty()) {
+        qWarning() << "Failed to load collection cover source:" << path << error;
+    }
+    return image;
+}
+
+QString CollectionCoverCache::cacheFilePath(const QString &key) const
+{
+    return cacheDir + "/" + key + "." + sc_CacheFormat;
+}
+
+void CollectionCoverCache::pruneExpired()
+{
+    const QDateTime deadline = QDateTime::currentDateTime().addDays(-sc_DiskExpireDays);
+    int count = 0;
+    QDirIterator it(cacheDir, QDir::Files);
+    while (it.hasNext()) {
+        it.next();
+        if (it.fileInfo().lastModified() < deadline && QFile::remove(it.filePath())) {
+            ++count;
+        }
+    }
+    if (count > 0) {
+        qDebug() << "Pruned" << count << "expired collection covers";
+    }
+}
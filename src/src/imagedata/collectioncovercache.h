@@ -0,0 +1,42 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef COLLECTIONCOVERCACHE_H
+#define COLLECTIONCOVERCACHE_H
+
+#include <QMutex>
+#include <QCache>
+#include <QImage>
+
+/**
+ * @brief 年/月聚合视图封面缓存，内存缓存之外同时保存到磁盘，重新打开程序后可直接读取。
+ *      缓存键由聚合周期、尺寸类型、封面路径及其修改时间组成，封面文件变更或聚合周期的封面改变时自然失效。
+ * @warning 由图片提供者的工作线程调用，接口均需可重入。
+ */
+class CollectionCoverCache
+{
+public:
+    CollectionCoverCache();
+    ~CollectionCoverCache();
+    static CollectionCoverCache *instance();
+
+    static QString makeKey(const QString &period, int sizeClass, const QString &coverPath);
+
+    QImage find(const QString &key);
+    void insert(const QString &key, const QImage &image);
+    void clear();
+
+    static QImage loadScaledSource(const QString &path, const QSize &coverSize);
+
+private:
+    QString cacheFilePath(const QString &key) const;
+    void pruneExpired();
+
+private:
+    QString cacheDir;
+    QMutex mutex;
+    QCache<QString, QImage> cache;  // 内存缓存，开销按 KiB 计算
+};
+
+#endif  // COLLECTIONCOVERCACHE_H
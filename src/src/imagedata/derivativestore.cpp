@@ -0,0 +1,263 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "derivativestore.h"
+#include "imagescaler.h"
+#include "unionimage/unionimage.h"
+#include "unionimage/baseutils.h"
+#include "unionimage/unionimage_global.h"
+#include "utils/perfmetrics.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QDebug>
+
+static const int sc_JpegQuality = 88;
+static const char *const sc_SourceSizeKey = "SourceSize";   // 派生图中记录的原图尺寸
+static const char *const sc_Suffixes[] = {"jpg", "png"};     // 带透明通道的图片保存为 png
+
+static QSize sizeFromText(const QString &text)
+{
+    const QStringList values = text.split('x');
+    if (values.size() != 2) {
+        return QSize();
+    }
+    return QSize(values.at(0).toInt(), values.at(1).toInt());
+}
+
+DerivativeStore::DerivativeStore()
+{
+}
+
+DerivativeStore::~DerivativeStore()
+{
+}
+
+DerivativeStore *DerivativeStore::instance()
+{
+    static DerivativeStore ins;
+    return &ins;
+}
+
+/**
+   @return 派生图各级别的最长边，升序排列
+ */
+QList<int> DerivativeStore::levels()
+{
+    static const QList<int> sc_Levels {128, 256, 1024};
+    return sc_Levels;
+}
+
+/**
+   @return 返回文件 \a path 按 \a mode 缩放到 \a size 时足够清晰的最小级别派生图，\a sourceSize 返回原图尺寸。
+    派生图不存在或已失效时一次解码原图生成全部级别；所需尺寸超过最大级别时返回空图，由调用方解码原图
+ */
+QImage DerivativeStore::image(const QString &path, const QSize &size, Qt::AspectRatioMode mode, QSize *sourceSize)
+{
+    if (path.isEmpty() || size.isEmpty() || LibUnionImage_NameSpace::isVideo(path)) {
+        return QImage();
+    }
+
+    // 第二次循环用于等待其它线程生成完成后重新读取
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        const QList<Level> existing = validLevels(path);
+        if (existing.size() == levels().size()) {
+            bool damaged = false;
+            for (const Level &level : existing) {
+                // 只读取文件头判断尺寸，命中后再解码
+                QImageReader reader(level.filePath);
+                const QSize levelSize = reader.size();
+                const QSize srcSize = sizeFromText(reader.text(sc_SourceSizeKey));
+                if (!covers(levelSize, srcSize, size, mode)) {
+                    continue;
+                }
+
+                QImage result;
+                if (!reader.read(&result)) {
+                    qWarning() << "Damaged derivative, regenerating:" << level.filePath;
+                    damaged = true;
+                    break;
+                }
+                if (sourceSize) {
+                    *sourceSize = srcSize.isValid() ? srcSize : result.size();
+                }
+                ALBUM_COUNTER_INC("cache.derivative.hit");
+                return result;
+            }
+
+            if (!damaged) {
+                ALBUM_COUNTER_INC("cache.derivative.uncovered");
+                return QImage();
+            }
+        }
+
+        QMutexLocker locker(&mutex);
+        if (generating.contains(path)) {
+            while (generating.contains(path)) {
+                generated.wait(&mutex);
+            }
+            continue;
+        }
+        generating.insert(path);
+        locker.unlock();
+        ALBUM_COUNTER_INC("cache.derivative.miss");
+
+        QSize srcSize;
+        const QMap<int, QImage> chain = generate(path, &srcSize);
+
+        locker.relock();
+        generating.remove(path);
+        generated.wakeAll();
+        locker.unlock();
+
+        for (auto it = chain.cbegin(); it != chain.cend(); ++it) {
+            if (covers(it.value().size(), srcSize, size, mode)) {
+                if (sourceSize) {
+                    *sourceSize = srcSize;
+                }
+                return it.value();
+            }
+        }
+        return QImage();
+    }
+
+    return QImage();
+}
+
+/**
+   @brief 移除文件 \a path 的全部派生图，文件删除或内容变更时调用
+ */
+void DerivativeStore::remove(const QString &path)
+{
+    for (int edge : levels()) {
+        for (const char *suffix : sc_Suffixes) {
+            QFile::remove(levelFilePath(path, edge, suffix));
+        }
+    }
+}
+
+/**
+   @return 返回文件 \a path 未失效的派生图，按级别升序排列
+ */
+QList<DerivativeStore::Level> DerivativeStore::validLevels(const QString &path) const
+{
+    QList<Level> result;
+    const QDateTime sourceTime = QFileInfo(path).lastModified();
+    for (int edge : levels()) {
+        for (const char *suffix : sc_Suffixes) {
+            QFileInfo info(levelFilePath(path, edge, suffix));
+            if (info.exists() && info.lastModified() >= sourceTime) {
+                result.append({edge, info.absoluteFilePath()});
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+/**
+   @brief 解码一次原图，生成并保存全部级别的派生图
+   @return 级别最长边到派生图的映射
+ */
+QMap<int, QImage> DerivativeStore::generate(const QString &path, QSize *sourceSize)
+{
+    ALBUM_TRACE_SCOPE(logCache, "derivative.generate");
+    QMap<int, QImage> chain;
+    const int maxEdge = levels().last();
+
+    // 支持缩放解码的格式直接按最大级别解码，不再完整解码原图
+    QImage image;
+    QSize srcSize;
+    QImageReader reader(path);
+    reader.setAutoTransform(true);
+    if (reader.canRead()) {
+        srcSize = reader.size();
+        if (srcSize.isValid()) {
+            const QSize target = srcSize.scaled(maxEdge, maxEdge, Qt::KeepAspectRatio);
+            if (target.width() < srcSize.width()) {
+                reader.setScaledSize(target);
+            }
+            // 缩放解码在旋转之前进行，原图尺寸按旋转后的方向记录
+            if (reader.transformation() & QImageIOHandler::TransformationRotate90) {
+                srcSize.transpose();
+            }
+        }
+        reader.read(&image);
+    }
+
+    if (image.isNull()) {
+        QString error;
+        if (!LibUnionImage_NameSpace::loadStaticImageFromFile(path, image, error)) {
+            qWarning() << "Failed to decode image for derivatives:" << path << error;
+            return chain;
+        }
+        srcSize = image.size();
+    }
+    if (!srcSize.isValid()) {
+        srcSize = image.size();
+    }
+
+    // 由大到小逐级缩放，每级只从上一级缩放
+    QImage current = image;
+    for (int i = levels().size() - 1; i >= 0; --i) {
+        const int edge = levels().at(i);
+        if (current.width() > edge || current.height() > edge) {
+            current = ImageScaler::scaled(current, QSize(edge, edge), Qt::KeepAspectRatio);
+        }
+        chain.insert(edge, current);
+    }
+
+    const QString sizeText = QString("%1x%2").arg(srcSize.width()).arg(srcSize.height());
+    for (auto it = chain.cbegin(); it != chain.cend(); ++it) {
+        QImage out = it.value();
+        out.setText(sc_SourceSizeKey, sizeText);
+
+        const char *suffix = out.hasAlphaChannel() ? sc_Suffixes[1] : sc_Suffixes[0];
+        const QString filePath = levelFilePath(path, it.key(), suffix);
+        Libutils::base::mkMutiDir(filePath.mid(0, filePath.lastIndexOf('/')));
+
+        // 先写临时文件再重命名，避免其它线程读取到不完整的文件
+        const QString tempPath = filePath + ".tmp";
+        if (!out.save(tempPath, suffix, sc_JpegQuality)) {
+            qWarning() << "Failed to save derivative:" << filePath;
+            QFile::remove(tempPath);
+            continue;
+        }
+        for (const char *other : sc_Suffixes) {
+            QFile::remove(levelFilePath(path, it.key(), other));
+        }
+        QFile::rename(tempPath, filePath);
+    }
+
+    if (sourceSize) {
+        *sourceSize = srcSize;
+    }
+    qCDebug(logCache) << "Generated derivatives for:" << path << "source size:" << srcSize;
+    return chain;
+}
+
+/**
+   @return 尺寸为 \a levelSize 的派生图按 \a mode 缩放到 \a size 时是否无需放大，
+    派生图已是原图尺寸 \a sourceSize 时总是满足
+ */
+bool DerivativeStore::covers(const QSize &levelSize, const QSize &sourceSize, const QSize &size, Qt::AspectRatioMode mode)
+{
+    if (levelSize.isEmpty()) {
+        return false;
+    }
+    if (levelSize == sourceSize) {
+        return true;
+    }
+    const QSize target = levelSize.scaled(size, mode);
+    return levelSize.width() >= target.width() && levelSize.height() >= target.height();
+}
+
+QString DerivativeStore::levelFilePath(const QString &path, int edge, const char *suffix)
+{
+    // 与缩略图使用相同的存储目录结构，文件名按路径计算，内容变更由修改时间判断
+    return albumGlobal::CACHE_PATH + QFileInfo(path).path() + "/"
+           + LibUnionImage_NameSpace::hashByString(path) + "_" + QString::number(edge) + "." + suffix;
+}
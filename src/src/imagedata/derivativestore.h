@@ -0,0 +1,55 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DERIVATIVESTORE_H
+#define DERIVATIVESTORE_H
+
+#include <QImage>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QSet>
+#include <QWaitCondition>
+
+/**
+ * @brief 图片派生图（多级缩放图）存储。
+ *      一次解码原图生成 128 / 256 / 1024 三级缩放图并保存在缩略图存储目录中，
+ *      缩略图、预览小图、聚合封面等需要缩小图的场景按所需尺寸取覆盖该尺寸的最小级别，
+ *      不再各自解码原图。原图修改时间晚于派生图时派生图失效并重新生成。
+ * @note 视频及多页图的非首帧不经过派生图存储，由调用方按原流程处理。
+ * @warning 可能被多个线程同时调用，接口均需可重入。
+ */
+class DerivativeStore
+{
+public:
+    DerivativeStore();
+    ~DerivativeStore();
+    static DerivativeStore *instance();
+
+    static QList<int> levels();
+
+    QImage image(const QString &path, const QSize &size, Qt::AspectRatioMode mode = Qt::KeepAspectRatioByExpanding,
+                 QSize *sourceSize = nullptr);
+    void remove(const QString &path);
+
+private:
+    struct Level
+    {
+        int edge{0};
+        QString filePath;
+    };
+
+    QList<Level> validLevels(const QString &path) const;
+    QMap<int, QImage> generate(const QString &path, QSize *sourceSize);
+
+    static bool covers(const QSize &levelSize, const QSize &sourceSize, const QSize &size, Qt::AspectRatioMode mode);
+    static QString levelFilePath(const QString &path, int edge, const char *suffix);
+
+private:
+    QMutex mutex;
+    QWaitCondition generated;
+    QSet<QString> generating;    // 正在生成派生图的文件，同一文件只解码一次
+};
+
+#endif  // DERIVATIVESTORE_H
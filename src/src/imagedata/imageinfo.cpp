@@ -5,6 +5,7 @@
 #include "imageinfo.h"
 #include "types.h"
 #include "thumbnailcache.h"
+#include "derivativestore.h"
 #include "unionimage/unionimage.h"
 #include "globalcontrol.h"
 
@@ -222,6 +223,13 @@ void LoadImageInfoRunnable::run()
 bool LoadImageInfoRunnable::loadImage(QImage &image, QSize &sourceSize) const
 {
     qDebug() << "LoadImageInfoRunnable::loadImage - Entry";
+    // 优先使用派生图，避免为缩略图解码原图
+    image = DerivativeStore::instance()->image(loadPath, QSize(100, 100), Qt::KeepAspectRatioByExpanding, &sourceSize);
+    if (!image.isNull()) {
+        image = image.scaled(100, 100, Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
+        return true;
+    }
+
     QString error;
     bool ret = LibUnionImage_NameSpace::loadStaticImageFromFile(loadPath, image, error);
     if (ret) {
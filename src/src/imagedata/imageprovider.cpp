@@ -5,14 +5,45 @@
 #include "imageprovider.h"
 #include "unionimage/unionimage.h"
 #include "imagedata/thumbnailcache.h"
+#include "configsetter.h"
 
 #include <QThread>
 #include <QThreadPool>
 #include <QRunnable>
+#include <QFile>
 #include <QDebug>
 
 static const QString s_tagFrame = "#frame_";
 
+static const QString s_settingsGroup = "ImageViewer";
+static const QString s_settingsCacheSize = "ImageCacheSizeMB";   // 大图缓存容量(MB)，未配置时根据可用内存计算
+static const int s_minCacheSizeMB = 128;
+static const int s_maxCacheSizeMB = 1024;
+
+/**
+   @return 返回系统当前可用内存(MB)，读取失败时返回 0
+ */
+static int availableMemoryMB()
+{
+    QFile meminfo("/proc/meminfo");
+    if (!meminfo.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return 0;
+    }
+
+    // 格式为 "MemAvailable:    8012345 kB"
+    while (!meminfo.atEnd()) {
+        const QByteArray line = meminfo.readLine();
+        if (line.startsWith("MemAvailable:")) {
+            const QList<QByteArray> fields = line.simplified().split(' ');
+            if (fields.size() >= 2) {
+                return static_cast<int>(fields.at(1).toLongLong() / 1024);
+            }
+        }
+    }
+
+    return 0;
+}
+
 /**
    @brief 解析图像处理器 \a id , 取得请求的文件路径 \a filePath 和 \a frameIndex
    @note QML 中使用 ImageProvider 取得图像信息，\a id 格式为 \b{图像路径#frame_帧号} ，例如 "/home/tmp.tif#frame_3" ，
@@ -126,7 +157,7 @@ void AsyncImageResponse::run()
     parseProviderID(providerId, tempPath, frameIndex);
 
     // 判断缓存中是否存在图片
-    image = provider->imageCache.get(tempPath, frameIndex);
+    image = provider->getImageCache(tempPath, frameIndex);
     if (image.isNull()) {
         qDebug() << "Image not found in cache, loading from file:" << tempPath;
         if (frameIndex) {
@@ -136,7 +167,7 @@ void AsyncImageResponse::run()
         }
 
         // 缓存图片信息，即使是异常图片
-        provider->imageCache.add(tempPath, frameIndex, image);
+        provider->addImageCache(tempPath, frameIndex, image);
     } else {
         qDebug() << "Using cached image for:" << tempPath << "frame:" << frameIndex;
     }
@@ -151,13 +182,54 @@ void AsyncImageResponse::run()
     emit finished();
 }
 
+/**
+   @class PrefetchImageTask
+   @brief 预加载任务，在低优先级线程中解码图像并存入缓存，
+    若执行时已有更新的预加载批次，则直接放弃。
+ */
+class PrefetchImageTask : public QRunnable
+{
+public:
+    PrefetchImageTask(AsyncImageProvider *p, const QString &path, int frame, int gen)
+        : provider(p)
+        , imagePath(path)
+        , frameIndex(frame)
+        , generation(gen)
+    {
+    }
+
+    void run() override
+    {
+        if (generation != provider->prefetchGeneration || provider->imageCache.contains(imagePath, frameIndex)) {
+            return;
+        }
+
+        QImage image = frameIndex ? readMultiImage(imagePath, frameIndex) : readNormalImage(imagePath);
+
+        // 解码期间切换了图片，过期的结果不再写入缓存，避免挤占当前区间
+        if (generation != provider->prefetchGeneration) {
+            qDebug() << "Drop stale prefetch:" << imagePath << "frame:" << frameIndex;
+            return;
+        }
+
+        provider->addImageCache(imagePath, frameIndex, image);
+    }
+
+    AsyncImageProvider *provider = nullptr;
+    QString imagePath;
+    int frameIndex = 0;
+    int generation = 0;
+};
+
 /**
    @class ProviderCache
    @brief 图像加载器缓存，存储最近的图像数据并处理旋转等操作
  */
-ProviderCache::ProviderCache() 
+ProviderCache::ProviderCache()
 {
-    // qDebug() << "Initializing provider cache";
+    // 按字节计费，容量上限固定，长时间浏览内存占用也不会超过预算
+    imageCache.setMaxCost(cacheBudget());
+    qDebug() << "Initializing provider cache, budget(KiB):" << imageCache.maxCost();
 }
 
 ProviderCache::~ProviderCache() 
@@ -183,6 +255,7 @@ void ProviderCache::rotateImageCached(int angle, const QString &imagePath, int f
     if (imagePath != lastRotatePath) {
         qDebug() << "First rotation for image:" << imagePath;
         image = imageCache.get(imagePath, frameIndex);
+        touchImageCache(ThumbnailCache::Key(imagePath, frameIndex));
 
         // 首次处理时记录图像数据，防止多次旋转处理导致图片质量降低
         lastRotateImage = image;
@@ -205,7 +278,7 @@ void ProviderCache::rotateImageCached(int angle, const QString &imagePath, int f
         }
 
         // 更新图片缓存
-        imageCache.add(imagePath, frameIndex, image);
+        addImageCache(imagePath, frameIndex, image);
 
         // 同样更新缩略图缓存
         QImage tmpImage = image.scaled(100, 100, Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
@@ -231,6 +304,7 @@ void ProviderCache::removeImageCache(const QString &imagePath)
         if (key.first == imagePath) {
             _locker.relock();
             imageCache.remove(key.first, key.second);
+            lruKeys.removeOne(key);
             _locker.unlock();
         }
     }
@@ -244,10 +318,113 @@ void ProviderCache::clearCache()
     qDebug() << "Clearing provider cache";
     QMutexLocker _locker(&mutex);
     imageCache.clear();
+    lruKeys.clear();
+    prefetchPaths.clear();
     lastRotatePath.clear();
     lastRotateImage = QImage();
 }
 
+/**
+   @brief 设置当前展示图片及两侧图片的路径 \a imagePaths ，这些图片在缓存中最后被淘汰
+ */
+void ProviderCache::setNeighbourhood(const QStringList &imagePaths)
+{
+    QSet<QString> paths(imagePaths.begin(), imagePaths.end());
+
+    QMutexLocker _locker(&mutex);
+    if (paths == neighbourPaths) {
+        return;
+    }
+    neighbourPaths = paths;
+
+    // 访问一次邻近图片，将其置为最近使用，淘汰时优先移除其它图片
+    const QList<ThumbnailCache::Key> keys = lruKeys;
+    for (const ThumbnailCache::Key &key : keys) {
+        if (neighbourPaths.contains(key.first)) {
+            imageCache.get(key.first, key.second);
+            touchImageCache(key);
+        }
+    }
+}
+
+/**
+   @return 返回缓存中 \a imagePath 和 \a frameIndex 对应的图像，命中时将其置为最近使用
+ */
+QImage ProviderCache::getImageCache(const QString &imagePath, int frameIndex)
+{
+    QMutexLocker _locker(&mutex);
+    const ThumbnailCache::Key key(imagePath, frameIndex);
+    if (!imageCache.contains(imagePath, frameIndex)) {
+        return QImage();
+    }
+
+    touchImageCache(key);
+    return imageCache.get(imagePath, frameIndex);
+}
+
+/**
+   @brief 将 \a key 移动到访问顺序的头部，调用时需持有 mutex
+ */
+void ProviderCache::touchImageCache(const ThumbnailCache::Key &key)
+{
+    lruKeys.removeOne(key);
+    lruKeys.prepend(key);
+}
+
+/**
+   @brief 缓存 \a imagePath 和 \a frameIndex 对应的图像 \a image ，
+    容量不足时按最近最少使用淘汰，当前展示区间和预加载的图片不被淘汰
+ */
+void ProviderCache::addImageCache(const QString &imagePath, int frameIndex, const QImage &image)
+{
+    const int cost = imageCost(image);
+
+    QMutexLocker _locker(&mutex);
+    const int maxCost = imageCache.maxCost();
+    if (imageCache.totalCost() + cost > maxCost) {
+        // 从最久未使用的一端开始淘汰
+        for (int i = lruKeys.size() - 1; i >= 0 && imageCache.totalCost() + cost > maxCost; --i) {
+            const ThumbnailCache::Key key = lruKeys.at(i);
+            if (!neighbourPaths.contains(key.first) && !prefetchPaths.contains(key.first)) {
+                imageCache.remove(key.first, key.second);
+                lruKeys.removeAt(i);
+            }
+        }
+    }
+
+    imageCache.add(imagePath, frameIndex, image, cost);
+    touchImageCache(ThumbnailCache::Key(imagePath, frameIndex));
+
+    // 邻近图片占满容量时 QCache 会自行淘汰，同步移除已不在缓存中的记录
+    for (int i = lruKeys.size() - 1; i >= 0; --i) {
+        if (!imageCache.contains(lruKeys.at(i).first, lruKeys.at(i).second)) {
+            lruKeys.removeAt(i);
+        }
+    }
+}
+
+/**
+   @return 返回大图缓存容量(KiB)，优先使用配置值，否则取可用内存的 1/8 ，
+    并限制在 [128MB, 1024MB] 区间内
+ */
+int ProviderCache::cacheBudget()
+{
+    int budgetMB = LibConfigSetter::instance()->value(s_settingsGroup, s_settingsCacheSize, 0).toInt();
+    if (budgetMB <= 0) {
+        budgetMB = qBound(s_minCacheSizeMB, availableMemoryMB() / 8, s_maxCacheSizeMB);
+    }
+
+    return budgetMB * 1024;
+}
+
+/**
+   @return 返回图像 \a image 的缓存开销(KiB)，异常图片最少计为 1
+ */
+int ProviderCache::imageCost(const QImage &image)
+{
+    return static_cast<int>(qMax<qsizetype>(1, image.sizeInBytes() / 1024));
+}
+
 /**
    @brief 预载图片数据并缓存
  */
@@ -257,6 +434,14 @@ void ProviderCache::preloadImage(const QString &)
     // Nothing
 }
 
+/**
+   @brief 预加载切换方向上的图片 \a images ，数据为 (图片路径, 帧索引)
+ */
+void ProviderCache::prefetchImages(const QList<QPair<QString, int>> &)
+{
+    // Nothing
+}
+
 /**
    @class AsyncImageProvider
    @brief 异步图像加载器，提供主要图像的并行加载，主要用于展示图像的加载，会缓存最近的图像信息。
@@ -265,13 +450,16 @@ void ProviderCache::preloadImage(const QString &)
 AsyncImageProvider::AsyncImageProvider()
 {
     qDebug() << "Initializing async image provider";
-    // 缓存最近 3 张图片 + 1 张切换之前的图片
-    imageCache.setMaxCost(4);
+    // 预加载不能抢占当前图片的解码
+    prefetchPool.setMaxThreadCount(1);
+    prefetchPool.setThreadPriority(QThread::LowPriority);
 }
 
-AsyncImageProvider::~AsyncImageProvider() 
+AsyncImageProvider::~AsyncImageProvider()
 {
     qDebug() << "Cleaning up async image provider";
+    prefetchPool.clear();
+    prefetchPool.waitForDone();
 }
 
 /**
@@ -299,6 +487,28 @@ void AsyncImageProvider::preloadImage(const QString &filePath)
     QThreadPool::globalInstance()->start(response, QThread::TimeCriticalPriority);
 }
 
+/**
+   @brief 在低优先级线程池中预加载 \a images 并缓存，数据为 (图片路径, 帧索引)，
+    新的请求会取消之前尚未开始或尚未完成的预加载
+ */
+void AsyncImageProvider::prefetchImages(const QList<QPair<QString, int>> &images)
+{
+    const int generation = ++prefetchGeneration;
+    prefetchPool.clear();
+
+    // 切换后替换保护的预加载图片，已进入展示区间的图片由 neighbourPaths 继续保护
+    QMutexLocker _locker(&mutex);
+    prefetchPaths.clear();
+    for (const QPair<QString, int> &image : images) {
+        prefetchPaths.insert(image.first);
+    }
+    _locker.unlock();
+
+    for (const QPair<QString, int> &image : images) {
+        prefetchPool.start(new PrefetchImageTask(this, image.first, image.second, generation));
+    }
+}
+
 /**
    @class ImageProvider
    @brief 图片加载类，读取图像信息并加载。
@@ -333,7 +543,7 @@ QImage ImageProvider::requestImage(const QString &id, QSize *size, const QSize &
     parseProviderID(id, tempPath, frameIndex);
 
     // 判断缓存中是否存在图片
-    QImage image = imageCache.get(tempPath, frameIndex);
+    QImage image = getImageCache(tempPath, frameIndex);
     if (image.isNull()) {
         qDebug() << "Image not found in cache, loading from file:" << tempPath;
         if (frameIndex) {
@@ -347,7 +557,7 @@ QImage ImageProvider::requestImage(const QString &id, QSize *size, const QSize &
         }
 
         // 缓存图片信息，即使是异常图片
-        imageCache.add(tempPath, frameIndex, image);
+        addImageCache(tempPath, frameIndex, image);
     } else {
         qDebug() << "Using cached image for:" << tempPath << "frame:" << frameIndex;
     }
@@ -11,6 +11,10 @@
 #include <QImageReader>
 #include <QImage>
 #include <QMutex>
+#include <QSet>
+#include <QThreadPool>
+
+#include <atomic>
 
 class ProviderCache
 {
@@ -21,12 +25,27 @@ public:
     void rotateImageCached(int angle, const QString &imagePath, int frameIndex = 0);
     void removeImageCache(const QString &imagePath);
     void clearCache();
+    void setNeighbourhood(const QStringList &imagePaths);
 
     virtual void preloadImage(const QString &filePath);
+    virtual void prefetchImages(const QList<QPair<QString, int>> &images);
+
+    static int cacheBudget();
+    static int imageCost(const QImage &image);
+
+protected:
+    QImage getImageCache(const QString &imagePath, int frameIndex);
+    void addImageCache(const QString &imagePath, int frameIndex, const QImage &image);
+
+private:
+    void touchImageCache(const ThumbnailCache::Key &key);
 
 protected:
     QMutex mutex;
-    ThumbnailCache imageCache;  ///< 图像数据缓存(已存在锁保护)
+    ThumbnailCache imageCache;  ///< 图像数据缓存(已存在锁保护)，开销按图像占用的 KiB 计算
+    QList<ThumbnailCache::Key> lruKeys;  ///< 缓存图片的访问顺序，最近使用的在前，淘汰时从尾部开始
+    QSet<QString> neighbourPaths;  ///< 当前展示图片及两侧的图片路径，最后被淘汰
+    QSet<QString> prefetchPaths;   ///< 最近一次预加载的图片路径，下一次预加载前不被淘汰
     QString lastRotatePath;     ///< 缓存的旋转文件路径
     QImage lastRotateImage;     ///< 缓存的旋转图像信息
     int lastRotation { 0 };     ///< 缓存的旋转角度
@@ -43,9 +62,14 @@ public:
 
     virtual QQuickImageResponse *requestImageResponse(const QString &id, const QSize &requestedSize) override;
     void preloadImage(const QString &filePath) override;
+    void prefetchImages(const QList<QPair<QString, int>> &images) override;
 
 private:
     friend class AsyncImageResponse;
+    friend class PrefetchImageTask;
+
+    QThreadPool prefetchPool;                   ///< 低优先级预加载线程池
+    std::atomic_int prefetchGeneration { 0 };   ///< 预加载批次，用于丢弃过期的预加载任务
 };
 
 // 同步图片加载器
@@ -0,0 +1,653 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "imagescaler.h"
+#include "utils/perfmetrics.h"
+
+#include <QVarLengthArray>
+#include <QVector>
+#include <QtEndian>
+#include <QDebug>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define IMAGESCALER_X86 1
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define IMAGESCALER_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+const double sc_Pi = 3.14159265358979323846;
+
+// 输出像素 index 由源像素 [first, first + count) 加权得到，权重从 weights[offset] 开始
+struct Contribution {
+    int first;
+    int count;
+    int offset;
+};
+
+struct Axis {
+    QVector<Contribution> contributions;
+    QVector<float> weights;
+    int maxTaps{0};
+};
+
+// 32 位格式中各通道所在的字节位置
+struct Layout {
+    int r;
+    int g;
+    int b;
+    int a;
+    bool premultiplied;
+    bool opaque;
+};
+
+double lanczos3(double x)
+{
+    x = std::abs(x);
+    if (x < 1e-7) {
+        return 1.0;
+    }
+    if (x >= 3.0) {
+        return 0.0;
+    }
+    const double px = sc_Pi * x;
+    return 3.0 * std::sin(px) * std::sin(px / 3.0) / (px * px);
+}
+
+double triangle(double x)
+{
+    return std::max(0.0, 1.0 - std::abs(x));
+}
+
+/**
+   @brief 计算一个方向上的卷积权重，源区间 [start, start + length) 映射到 outLength 个输出像素，
+    源像素下标限制在 [0, limit) 内，超出部分的权重舍弃后重新归一化
+ */
+Axis buildAxis(double start, double length, int limit, int outLength, ImageScaler::Filter filter)
+{
+    Axis axis;
+    axis.contributions.reserve(outLength);
+    const double scale = length / outLength;
+
+    for (int i = 0; i < outLength; ++i) {
+        QVarLengthArray<float, 64> taps;
+        int first = 0;
+        double sum = 0;
+
+        if (filter == ImageScaler::AreaAverage && scale >= 1.0) {
+            // 缩小时按源像素落在输出像素内的面积计权
+            const double left = start + i * scale;
+            const double right = left + scale;
+            first = std::max(0, static_cast<int>(std::floor(left)));
+            const int last = std::min(limit, static_cast<int>(std::ceil(right)));
+            for (int j = first; j < last; ++j) {
+                const double w = std::min(right, j + 1.0) - std::max(left, static_cast<double>(j));
+                taps.append(static_cast<float>(w));
+                sum += w;
+            }
+        } else {
+            const double support = (filter == ImageScaler::Lanczos3 ? 3.0 : 1.0) * std::max(scale, 1.0);
+            const double stretch = std::max(scale, 1.0);
+            const double center = start + (i + 0.5) * scale;
+            first = std::max(0, static_cast<int>(std::floor(center - support)));
+            const int last = std::min(limit, static_cast<int>(std::ceil(center + support)));
+            for (int j = first; j < last; ++j) {
+                const double x = (j + 0.5 - center) / stretch;
+                const double w = filter == ImageScaler::Lanczos3 ? lanczos3(x) : triangle(x);
+                taps.append(static_cast<float>(w));
+                sum += w;
+            }
+        }
+
+        // 去掉两端权重为 0 的像素，减少无效计算
+        int begin = 0;
+        int end = taps.size();
+        while (begin < end && taps.at(begin) == 0.0f) {
+            ++begin;
+        }
+        while (end > begin && taps.at(end - 1) == 0.0f) {
+            --end;
+        }
+        if (begin == end || std::abs(sum) < 1e-9) {
+            // 区间落在源图外，取最近的边缘像素
+            const int nearest = std::min(limit - 1, std::max(0, static_cast<int>(start + (i + 0.5) * scale)));
+            axis.contributions.append({nearest, 1, static_cast<int>(axis.weights.size())});
+            axis.weights.append(1.0f);
+            axis.maxTaps = std::max(axis.maxTaps, 1);
+            continue;
+        }
+
+        axis.contributions.append({first + begin, end - begin, static_cast<int>(axis.weights.size())});
+        for (int t = begin; t < end; ++t) {
+            axis.weights.append(static_cast<float>(taps.at(t) / sum));
+        }
+        axis.maxTaps = std::max(axis.maxTaps, end - begin);
+    }
+
+    return axis;
+}
+
+bool layoutOf(QImage::Format format, Layout *layout)
+{
+    switch (format) {
+    case QImage::Format_RGB32:
+    case QImage::Format_ARGB32:
+    case QImage::Format_ARGB32_Premultiplied:
+        // 按 quint32 存储，字节顺序与字节序相关
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        *layout = {2, 1, 0, 3, false, false};
+#else
+        *layout = {1, 2, 3, 0, false, false};
+#endif
+        break;
+    case QImage::Format_RGBX8888:
+    case QImage::Format_RGBA8888:
+    case QImage::Format_RGBA8888_Premultiplied:
+        *layout = {0, 1, 2, 3, false, false};
+        break;
+    default:
+        return false;
+    }
+
+    layout->premultiplied = (format == QImage::Format_ARGB32_Premultiplied || format == QImage::Format_RGBA8888_Premultiplied);
+    layout->opaque = (format == QImage::Format_RGB32 || format == QImage::Format_RGBX8888);
+    return true;
+}
+
+/**
+   @return 卷积直接读取的格式：不透明及预乘格式原样读取，非预乘的透明格式需先预乘，
+    其余格式（调色板、灰度、24 位等）转换为 32 位格式
+ */
+QImage::Format workingFormat(const QImage &image)
+{
+    switch (image.format()) {
+    case QImage::Format_RGB32:
+    case QImage::Format_ARGB32_Premultiplied:
+    case QImage::Format_RGBX8888:
+    case QImage::Format_RGBA8888_Premultiplied:
+        return image.format();
+    case QImage::Format_ARGB32:
+        return QImage::Format_ARGB32_Premultiplied;
+    case QImage::Format_RGBA8888:
+        return QImage::Format_RGBA8888_Premultiplied;
+    default:
+        return image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 卷积核：vertical 把若干源行按权重合并为一行浮点数据，horizontal 再按列合并为输出行
+
+void verticalScalar(const uchar *const *rows, const float *weights, int taps, int length, float *out)
+{
+    const uchar *row = rows[0];
+    float w = weights[0];
+    for (int k = 0; k < length; ++k) {
+        out[k] = w * row[k];
+    }
+    for (int t = 1; t < taps; ++t) {
+        row = rows[t];
+        w = weights[t];
+        for (int k = 0; k < length; ++k) {
+            out[k] += w * row[k];
+        }
+    }
+}
+
+void horizontalScalar(const float *in, const Contribution *contributions, const float *weights, int outWidth, float *out)
+{
+    for (int i = 0; i < outWidth; ++i) {
+        const Contribution &c = contributions[i];
+        const float *p = in + c.first * 4;
+        const float *w = weights + c.offset;
+        float acc[4] = {0, 0, 0, 0};
+        for (int t = 0; t < c.count; ++t) {
+            acc[0] += w[t] * p[t * 4];
+            acc[1] += w[t] * p[t * 4 + 1];
+            acc[2] += w[t] * p[t * 4 + 2];
+            acc[3] += w[t] * p[t * 4 + 3];
+        }
+        std::copy(acc, acc + 4, out + i * 4);
+    }
+}
+
+#ifdef IMAGESCALER_X86
+
+__attribute__((target("sse4.1")))
+void verticalSse41(const uchar *const *rows, const float *weights, int taps, int length, float *out)
+{
+    const int simdLength = length & ~15;
+    for (int t = 0; t < taps; ++t) {
+        const uchar *row = rows[t];
+        const __m128 w = _mm_set1_ps(weights[t]);
+        for (int k = 0; k < simdLength; k += 16) {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + k));
+            for (int part = 0; part < 4; ++part) {
+                __m128i chunk;
+                switch (part) {
+                case 0: chunk = bytes; break;
+                case 1: chunk = _mm_srli_si128(bytes, 4); break;
+                case 2: chunk = _mm_srli_si128(bytes, 8); break;
+                default: chunk = _mm_srli_si128(bytes, 12); break;
+                }
+                const __m128 value = _mm_mul_ps(w, _mm_cvtepi32_ps(_mm_cvtepu8_epi32(chunk)));
+                float *dst = out + k + part * 4;
+                _mm_storeu_ps(dst, t == 0 ? value : _mm_add_ps(_mm_loadu_ps(dst), value));
+            }
+        }
+        for (int k = simdLength; k < length; ++k) {
+            out[k] = t == 0 ? weights[t] * row[k] : out[k] + weights[t] * row[k];
+        }
+    }
+}
+
+__attribute__((target("sse4.1")))
+void horizontalSse41(const float *in, const Contribution *contributions, const float *weights, int outWidth, float *out)
+{
+    for (int i = 0; i < outWidth; ++i) {
+        const Contribution &c = contributions[i];
+        const float *p = in + c.first * 4;
+        const float *w = weights + c.offset;
+        __m128 acc = _mm_setzero_ps();
+        for (int t = 0; t < c.count; ++t) {
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(w[t]), _mm_loadu_ps(p + t * 4)));
+        }
+        _mm_storeu_ps(out + i * 4, acc);
+    }
+}
+
+__attribute__((target("avx2,fma")))
+void verticalAvx2(const uchar *const *rows, const float *weights, int taps, int length, float *out)
+{
+    const int simdLength = length & ~15;
+    for (int t = 0; t < taps; ++t) {
+        const uchar *row = rows[t];
+        const __m256 w = _mm256_set1_ps(weights[t]);
+        for (int k = 0; k < simdLength; k += 16) {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + k));
+            const __m256 low = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes));
+            const __m256 high = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(bytes, 8)));
+            if (t == 0) {
+                _mm256_storeu_ps(out + k, _mm256_mul_ps(w, low));
+                _mm256_storeu_ps(out + k + 8, _mm256_mul_ps(w, high));
+            } else {
+                _mm256_storeu_ps(out + k, _mm256_fmadd_ps(w, low, _mm256_loadu_ps(out + k)));
+                _mm256_storeu_ps(out + k + 8, _mm256_fmadd_ps(w, high, _mm256_loadu_ps(out + k + 8)));
+            }
+        }
+        for (int k = simdLength; k < length; ++k) {
+            out[k] = t == 0 ? weights[t] * row[k] : out[k] + weights[t] * row[k];
+        }
+    }
+}
+
+__attribute__((target("avx2,fma")))
+void horizontalAvx2(const float *in, const Contribution *contributions, const float *weights, int outWidth, float *out)
+{
+    for (int i = 0; i < outWidth; ++i) {
+        const Contribution &c = contributions[i];
+        const float *p = in + c.first * 4;
+        const float *w = weights + c.offset;
+        // 每次处理两个源像素，低 128 位对应第一个像素
+        __m256 acc = _mm256_setzero_ps();
+        int t = 0;
+        for (; t + 1 < c.count; t += 2) {
+            const __m256 wv = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_set1_ps(w[t])), _mm_set1_ps(w[t + 1]), 1);
+            acc = _mm256_fmadd_ps(wv, _mm256_loadu_ps(p + t * 4), acc);
+        }
+        __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+        if (t < c.count) {
+            sum = _mm_fmadd_ps(_mm_set1_ps(w[t]), _mm_loadu_ps(p + t * 4), sum);
+        }
+        _mm_storeu_ps(out + i * 4, sum);
+    }
+}
+
+#endif  // IMAGESCALER_X86
+
+#ifdef IMAGESCALER_NEON
+
+void verticalNeon(const uchar *const *rows, const float *weights, int taps, int length, float *out)
+{
+    const int simdLength = length & ~15;
+    for (int t = 0; t < taps; ++t) {
+        const uchar *row = rows[t];
+        const float w = weights[t];
+        for (int k = 0; k < simdLength; k += 16) {
+            const uint8x16_t bytes = vld1q_u8(row + k);
+            const uint16x8_t low = vmovl_u8(vget_low_u8(bytes));
+            const uint16x8_t high = vmovl_u8(vget_high_u8(bytes));
+            const float32x4_t values[4] = {
+                vcvtq_f32_u32(vmovl_u16(vget_low_u16(low))),
+                vcvtq_f32_u32(vmovl_u16(vget_high_u16(low))),
+                vcvtq_f32_u32(vmovl_u16(vget_low_u16(high))),
+                vcvtq_f32_u32(vmovl_u16(vget_high_u16(high))),
+            };
+            for (int part = 0; part < 4; ++part) {
+                float *dst = out + k + part * 4;
+                vst1q_f32(dst, t == 0 ? vmulq_n_f32(values[part], w) : vmlaq_n_f32(vld1q_f32(dst), values[part], w));
+            }
+        }
+        for (int k = simdLength; k < length; ++k) {
+            out[k] = t == 0 ? w * row[k] : out[k] + w * row[k];
+        }
+    }
+}
+
+void horizontalNeon(const float *in, const Contribution *contributions, const float *weights, int outWidth, float *out)
+{
+    for (int i = 0; i < outWidth; ++i) {
+        const Contribution &c = contributions[i];
+        const float *p = in + c.first * 4;
+        const float *w = weights + c.offset;
+        float32x4_t acc = vdupq_n_f32(0);
+        for (int t = 0; t < c.count; ++t) {
+            acc = vmlaq_n_f32(acc, vld1q_f32(p + t * 4), w[t]);
+        }
+        vst1q_f32(out + i * 4, acc);
+    }
+}
+
+#endif  // IMAGESCALER_NEON
+
+struct Kernels {
+    void (*vertical)(const uchar *const *, const float *, int, int, float *);
+    void (*horizontal)(const float *, const Contribution *, const float *, int, float *);
+    const char *name;
+};
+
+Kernels selectKernels()
+{
+#ifdef IMAGESCALER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return {verticalAvx2, horizontalAvx2, "AVX2"};
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return {verticalSse41, horizontalSse41, "SSE4.1"};
+    }
+#elif defined(IMAGESCALER_NEON)
+    return {verticalNeon, horizontalNeon, "NEON"};
+#endif
+    return {verticalScalar, horizontalScalar, "scalar"};
+}
+
+const Kernels &kernels()
+{
+    static const Kernels sc_Kernels = [] {
+        const Kernels selected = selectKernels();
+        qDebug() << "Image scaler kernels:" << selected.name;
+        return selected;
+    }();
+    return sc_Kernels;
+}
+
+inline uchar toByte(float value)
+{
+    return static_cast<uchar>(std::min(255.0f, std::max(0.0f, value + 0.5f)));
+}
+
+/**
+   @brief 将一行浮点结果写入输出格式，同时完成通道重排、预乘还原及不透明格式的 alpha 填充
+ */
+void storeRow(const float *in, const Layout &from, const Layout &to, int width, uchar *out)
+{
+    for (int i = 0; i < width; ++i) {
+        const float *p = in + i * 4;
+        uchar *q = out + i * 4;
+        float a = from.opaque ? 255.0f : std::min(255.0f, std::max(0.0f, p[from.a]));
+        float r = p[from.r];
+        float g = p[from.g];
+        float b = p[from.b];
+
+        if (!from.opaque) {
+            // Lanczos 的负瓣可能使颜色超过 alpha，预乘数据中颜色不能大于 alpha
+            r = std::min(r, a);
+            g = std::min(g, a);
+            b = std::min(b, a);
+            if (!to.premultiplied && !to.opaque && a > 0.0f) {
+                const float factor = 255.0f / a;
+                r *= factor;
+                g *= factor;
+                b *= factor;
+            }
+        }
+        if (to.opaque) {
+            a = 255.0f;
+        }
+
+        q[to.r] = toByte(r);
+        q[to.g] = toByte(g);
+        q[to.b] = toByte(b);
+        q[to.a] = toByte(a);
+    }
+}
+
+}  // namespace
+
+namespace ImageScaler {
+
+/**
+   @return 将 \a src 中的区域 \a sourceRect 缩放到 \a size ，输出格式为 \a format ，
+    \a format 为 Format_Invalid 时保持原图格式，调色板格式输出 32 位格式。区域可以是小数坐标，超出原图的部分按边缘像素处理
+ */
+QImage cropScaled(const QImage &src, const QRectF &sourceRect, const QSize &size, Filter filter, QImage::Format format)
+{
+    if (src.isNull() || size.isEmpty() || sourceRect.isEmpty()) {
+        return QImage();
+    }
+    ALBUM_TRACE_SCOPE(logDecode, "scale.cropScaled");
+    if (format == QImage::Format_Invalid) {
+        switch (src.format()) {
+        case QImage::Format_Mono:
+        case QImage::Format_MonoLSB:
+        case QImage::Format_Indexed8:
+            // 缩放会产生调色板之外的颜色，与 QImage::scaled 一致输出 32 位格式，避免重新量化
+            format = src.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32;
+            break;
+        default:
+            format = src.format();
+            break;
+        }
+    }
+
+    // 整数区域且尺寸不变时只需裁剪
+    const QRect alignedRect = sourceRect.toRect();
+    if (QRectF(alignedRect) == sourceRect && alignedRect.size() == size && src.rect().contains(alignedRect)) {
+        return src.copy(alignedRect).convertToFormat(format);
+    }
+
+    QImage source = src;
+    const QImage::Format working = workingFormat(source);
+    if (source.format() != working) {
+        source = source.convertToFormat(working);
+    }
+
+    Layout from;
+    Layout to;
+    layoutOf(working, &from);
+    QImage::Format outFormat = format;
+    if (!layoutOf(outFormat, &to)) {
+        // 输出格式不是 32 位格式时先按工作格式输出，缩小后的图再转换
+        outFormat = working;
+        to = from;
+    }
+
+    const Axis horizontal = buildAxis(sourceRect.x(), sourceRect.width(), source.width(), size.width(), filter);
+    const Axis vertical = buildAxis(sourceRect.y(), sourceRect.height(), source.height(), size.height(), filter);
+
+    // 只读取水平方向实际用到的列
+    const int firstColumn = horizontal.contributions.first().first;
+    int lastColumn = firstColumn;
+    for (const Contribution &c : horizontal.contributions) {
+        lastColumn = std::max(lastColumn, c.first + c.count);
+    }
+    QVector<Contribution> columns = horizontal.contributions;
+    for (Contribution &c : columns) {
+        c.first -= firstColumn;
+    }
+    const int length = (lastColumn - firstColumn) * 4;
+
+    QImage result(size, outFormat);
+    if (result.isNull()) {
+        qWarning() << "Failed to allocate scaled image:" << size;
+        return QImage();
+    }
+
+    const Kernels &k = kernels();
+    QVector<float> rowBuffer(length);
+    QVector<float> outBuffer(size.width() * 4);
+    QVarLengthArray<const uchar *, 64> rows(vertical.maxTaps);
+    for (int y = 0; y < size.height(); ++y) {
+        const Contribution &c = vertical.contributions.at(y);
+        for (int t = 0; t < c.count; ++t) {
+            rows[t] = source.constScanLine(c.first + t) + firstColumn * 4;
+        }
+        k.vertical(rows.constData(), vertical.weights.constData() + c.offset, c.count, length, rowBuffer.data());
+        k.horizontal(rowBuffer.constData(), columns.constData(), horizontal.weights.constData(), size.width(), outBuffer.data());
+        storeRow(outBuffer.constData(), from, to, size.width(), result.scanLine(y));
+    }
+
+    if (outFormat != format) {
+        result = result.convertToFormat(format);
+    }
+    return result;
+}
+
+/**
+   @return 将整张 \a src 缩放到 \a size
+ */
+QImage scaled(const QImage &src, const QSize &size, Filter filter, QImage::Format format)
+{
+    return cropScaled(src, QRectF(src.rect()), size, filter, format);
+}
+
+/**
+   @return 按 \a mode 计算目标尺寸后缩放，与 QImage::scaled 的尺寸计算一致
+ */
+QImage scaled(const QImage &src, const QSize &size, Qt::AspectRatioMode mode, Filter filter)
+{
+    const QSize target = src.size().scaled(size, mode);
+    if (target == src.size()) {
+        return src;
+    }
+    return scaled(src, target, filter);
+}
+
+/**
+   @return 缩略图裁剪模式：短边缩放到 \a edge 后居中裁剪为方图，长宽相差不足一成时不裁剪。
+    尺寸与原先先缩放再裁剪的结果一致，缩放和裁剪合并为一次计算
+ */
+QImage clipToSquare(const QImage &src, int edge)
+{
+    if (src.isNull() || src.width() == 0 || src.height() == 0) {
+        return src;
+    }
+
+    const int srcWidth = src.width();
+    const int srcHeight = src.height();
+    int width = srcWidth;
+    int height = srcHeight;
+    if (srcHeight / srcWidth < 10 && srcWidth / srcHeight < 10) {
+        bool byWidth = srcHeight >= srcWidth;
+        if (srcHeight == edge || srcWidth == edge) {
+            byWidth = static_cast<float>(srcHeight) / static_cast<float>(srcWidth) > 3;
+        }
+        if (byWidth) {
+            width = edge;
+            height = std::max(1, qRound(srcHeight * static_cast<double>(edge) / srcWidth));
+        } else {
+            width = std::max(1, qRound(srcWidth * static_cast<double>(edge) / srcHeight));
+            height = edge;
+        }
+    }
+
+    const double factorX = static_cast<double>(srcWidth) / width;
+    const double factorY = static_cast<double>(srcHeight) / height;
+    if (std::abs((width - height) * 10 / width) >= 1) {
+        const int side = std::min(width, height);
+        const int x = width > height ? width / 2 - height / 2 : 0;
+        const int y = width > height ? 0 : height / 2 - width / 2;
+        return cropScaled(src, QRectF(x * factorX, y * factorY, side * factorX, side * factorY), QSize(side, side));
+    }
+    return cropScaled(src, QRectF(src.rect()), QSize(width, height));
+}
+
+/**
+   @return 缩略图完整显示模式：长边缩放到 \a edge ，输出格式为 \a format
+ */
+QImage fitToEdge(const QImage &src, int edge, QImage::Format format)
+{
+    if (src.isNull()) {
+        return src;
+    }
+
+    QSize size;
+    if (src.height() > src.width()) {
+        size = QSize(std::max(1, qRound(src.width() * static_cast<double>(edge) / src.height())), edge);
+    } else {
+        size = QSize(edge, std::max(1, qRound(src.height() * static_cast<double>(edge) / src.width())));
+    }
+    return cropScaled(src, QRectF(src.rect()), size, AreaAverage, format);
+}
+
+/**
+   @return 按 KeepAspectRatioByExpanding 缩放到 \a size 并保留中间部分（Qt 裁剪的是右侧或下侧）
+ */
+QImage clipCentered(const QImage &src, const QSize &size)
+{
+    if (src.isNull() || size.isEmpty()) {
+        return QImage();
+    }
+
+    double x = 0;
+    double y = 0;
+    double resizeW = 0;
+    double resizeH = 0;
+    const double widthF = size.width();
+    const double heightF = size.height();
+    if (src.width() > src.height()) {
+        resizeH = heightF;
+        resizeW = src.width() / (src.height() / heightF);
+        if (resizeW < widthF) {
+            resizeH = resizeH * widthF / resizeW;
+            resizeW = widthF;
+            y = (resizeH - heightF) / 2;
+        } else {
+            x = (resizeW - widthF) / 2;
+        }
+    } else {
+        resizeW = widthF;
+        resizeH = src.height() / (src.width() / widthF);
+        if (resizeH < heightF) {
+            resizeW = resizeW * heightF / resizeH;
+            resizeH = heightF;
+            x = (resizeW - widthF) / 2;
+        } else {
+            y = (resizeH - heightF) / 2;
+        }
+    }
+
+    // 中间缩放尺寸取整与原先一致，再映射回原图坐标
+    const double factorX = src.width() / std::max(1.0, std::floor(resizeW));
+    const double factorY = src.height() / std::max(1.0, std::floor(resizeH));
+    const QRectF rect(std::floor(x) * factorX, std::floor(y) * factorY, size.width() * factorX, size.height() * factorY);
+    return cropScaled(src, rect, size);
+}
+
+/**
+   @return 当前使用的卷积核指令集名称
+ */
+const char *instructionSet()
+{
+    return kernels().name;
+}
+
+}  // namespace ImageScaler
@@ -0,0 +1,39 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef IMAGESCALER_H
+#define IMAGESCALER_H
+
+#include <QImage>
+#include <QRectF>
+
+/**
+ * @brief 缩略图缩放模块。
+ *      裁剪、缩放和格式转换在一次遍历中完成：先按列方向对源图的裁剪区域做加权合并，再按行方向合并，
+ *      直接读取解码器输出的 32 位格式，不再先转换整张原图。
+ *      卷积核在运行时按 CPU 支持的指令集选择 AVX2 / SSE4.1 / NEON 实现，其它平台使用标量实现。
+ * @warning 可能被多个线程同时调用，接口均可重入。
+ */
+namespace ImageScaler {
+
+enum Filter {
+    AreaAverage,    // 区域平均，缩小时每个源像素按覆盖面积计入，放大时退化为双线性
+    Lanczos3        // Lanczos 窗口大小为 3，锐利度更高，开销更大
+};
+
+QImage cropScaled(const QImage &src, const QRectF &sourceRect, const QSize &size, Filter filter = AreaAverage,
+                  QImage::Format format = QImage::Format_Invalid);
+QImage scaled(const QImage &src, const QSize &size, Filter filter = AreaAverage,
+              QImage::Format format = QImage::Format_Invalid);
+QImage scaled(const QImage &src, const QSize &size, Qt::AspectRatioMode mode, Filter filter = AreaAverage);
+
+QImage clipToSquare(const QImage &src, int edge);
+QImage fitToEdge(const QImage &src, int edge, QImage::Format format = QImage::Format_Invalid);
+QImage clipCentered(const QImage &src, const QSize &size);
+
+const char *instructionSet();
+
+}  // namespace ImageScaler
+
+#endif  // IMAGESCALER_H
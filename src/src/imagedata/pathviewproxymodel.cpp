@@ -9,6 +9,8 @@
 
 #include <QDebug>
 
+static const int sc_PrefetchCount = 2;  // 沿切换方向在展示区间之外预加载的图片数
+
 PathViewProxyModel::IndexInfo::IndexInfo(const IndexInfo &other)
     : url { other.url }
     , index { other.index }
@@ -178,6 +180,8 @@ void PathViewProxyModel::movePrevoius()
     int changeIndex = (currentProxyIdx + radius + 1) % maxCount;
     const IndexInfoPtr &baseInfo = indexQueue[nextProxyIdx(changeIndex)];
     updateIndexInfo(changeIndex, createPreviousIndexInfo(baseInfo));
+
+    requestPrefetch(Previous);
 }
 
 /**
@@ -193,6 +197,8 @@ void PathViewProxyModel::moveNext()
     const IndexInfoPtr &baseInfo = indexQueue[previousPorxyIdx(changeIndex)];
 
     updateIndexInfo(changeIndex, createNextIndexInfo(baseInfo));
+
+    requestPrefetch(Next);
 }
 
 /**
@@ -229,6 +235,8 @@ void PathViewProxyModel::resetModel(int sourceIndex, int frameIndex)
 
     endResetModel();
     qDebug() << "Model reset complete, queue size:" << indexQueue.size();
+
+    requestPrefetch(Next);
 }
 
 /**
@@ -301,6 +309,23 @@ void PathViewProxyModel::setQueueCount(int count)
     radius = qFloor(maxCount / 2);
 }
 
+/**
+   @return 返回当前环队列中图片的本地路径，当前图片位于首位，
+    用于图像缓存判断当前展示区间
+ */
+QStringList PathViewProxyModel::windowPaths() const
+{
+    QStringList paths;
+    for (int i = 0; i < indexQueue.size(); ++i) {
+        const IndexInfoPtr &info = indexQueue.at((currentProxyIdx + i) % indexQueue.size());
+        if (info && !paths.contains(info->url.toLocalFile())) {
+            paths.append(info->url.toLocalFile());
+        }
+    }
+
+    return paths;
+}
+
 /**
    @brief 打印当前的队列缓存信息
  */
@@ -355,6 +380,8 @@ void PathViewProxyModel::jumpToIndex(int sourceIndex, int frameIndex)
     // currentIndex 的变更会判断 jumpFlag 触发 jumpFinished() ，
     // 因此 jumpFlag 的变更在 currentIndexChanged() 之后触发
     jumpFlag = flag;
+
+    requestPrefetch(flag);
 }
 
 /**
@@ -382,6 +409,39 @@ void PathViewProxyModel::refreshBothSideData()
     jumpFlag = Current;
 }
 
+/**
+   @brief 沿切换方向 \a direction 请求预加载展示区间之外的 sc_PrefetchCount 张图片，
+    区间内的图片由 view 的委托自行加载，不重复请求。新的请求会取消之前尚未执行的预加载。
+   @note 只通过源模型取路径，不创建 ImageInfo ，不会触发图片信息的加载；
+    多页图按首帧预加载，区间边界按源索引估算
+ */
+void PathViewProxyModel::requestPrefetch(DistanceType direction)
+{
+    if (indexQueue.isEmpty() || !sourceModel || (Previous != direction && Next != direction)) {
+        return;
+    }
+
+    const IndexInfoPtr &current = indexQueue[currentProxyIdx];
+    if (!current) {
+        return;
+    }
+
+    const int rowCount = sourceModel->rowCount();
+    const int edgeIndex = current->index + direction * radius;
+    QList<QPair<QString, int>> images;
+    for (int i = 1; i <= sc_PrefetchCount; ++i) {
+        const int sourceIndex = edgeIndex + direction * i;
+        if (sourceIndex < 0 || sourceIndex >= rowCount) {
+            break;
+        }
+        images.append(qMakePair(sourcePath(sourceIndex).toLocalFile(), 0));
+    }
+
+    // 即使没有需要预加载的图片也通知，以清除之前预加载的图片的保护状态
+    qDebug() << "Request prefetch" << images.size() << "images, direction:" << direction;
+    Q_EMIT prefetchRequested(images);
+}
+
 /**
    @return 返回源索引为 \a soureIndex 和 \a frameIndex 与当前图片的相对距离
  */
@@ -42,6 +42,10 @@ public:
     void deleteCurrent();
 
     void setQueueCount(int count);
+    QStringList windowPaths() const;
+
+    // 请求预加载切换方向上展示区间之外的图片，数据为 (图片路径, 帧索引)
+    Q_SIGNAL void prefetchRequested(const QList<QPair<QString, int>> &images);
 
     void dumpInfo();
 
@@ -69,6 +73,7 @@ private:
 
     void jumpToIndex(int sourceIndex, int frameIndex);
     void refreshBothSideData();
+    void requestPrefetch(DistanceType direction);
 
     QUrl sourcePath(int sourceIndex);
     DistanceType distance(int sourceIndex, int frameIndex);
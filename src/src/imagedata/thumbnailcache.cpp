@@ -3,6 +3,8 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "thumbnailcache.h"
+#include "utils/perfmetrics.h"
+
 #include <QDebug>
 
 ThumbnailCache::ThumbnailCache()
@@ -32,7 +34,7 @@ bool ThumbnailCache::contains(const QString &path, int frameIndex)
     // qDebug() << "ThumbnailCache::contains - Entry";
     QMutexLocker _locker(&mutex);
     bool result = cache.contains(toFindKey(path, frameIndex));
-    qDebug() << "Checking thumbnail cache for path:" << path << "frame:" << frameIndex << "result:" << result;
+    qCDebug(logCache) << "Checking thumbnail cache for path:" << path << "frame:" << frameIndex << "result:" << result;
     return result;
 }
 
@@ -46,23 +48,27 @@ QImage ThumbnailCache::get(const QString &path, int frameIndex)
     QMutexLocker _locker(&mutex);
     QImage *image = cache.object(toFindKey(path, frameIndex));
     if (image) {
-        qDebug() << "Retrieved thumbnail from cache for path:" << path << "frame:" << frameIndex;
+        ALBUM_COUNTER_INC("cache.thumbnail.hit");
+        qCDebug(logCache) << "Retrieved thumbnail from cache for path:" << path << "frame:" << frameIndex;
         return *image;
     } else {
-        qDebug() << "Thumbnail not found in cache for path:" << path << "frame:" << frameIndex;
+        ALBUM_COUNTER_INC("cache.thumbnail.miss");
+        qCDebug(logCache) << "Thumbnail not found in cache for path:" << path << "frame:" << frameIndex;
         return QImage();
     }
 }
 
 /**
-   @brief 添加文件路径为 \a path 和图片帧索引为 \a frameIndex 的缩略图
+   @brief 添加文件路径为 \a path 和图片帧索引为 \a frameIndex 的缩略图，缓存开销为 \a cost
+    开销单位由调用方决定，需与 setMaxCost() 设置的容量单位保持一致
  */
-void ThumbnailCache::add(const QString &path, int frameIndex, const QImage &image)
+void ThumbnailCache::add(const QString &path, int frameIndex, const QImage &image, int cost)
 {
     // qDebug() << "ThumbnailCache::add - Entry";
     QMutexLocker _locker(&mutex);
-    cache.insert(toFindKey(path, frameIndex), new QImage(image));
-    qDebug() << "Added thumbnail to cache for path:" << path << "frame:" << frameIndex << "size:" << image.size();
+    cache.insert(toFindKey(path, frameIndex), new QImage(image), cost);
+    ALBUM_GAUGE_SET("cache.thumbnail.cost", cache.totalCost());
+    qCDebug(logCache) << "Added thumbnail to cache for path:" << path << "frame:" << frameIndex << "size:" << image.size() << "cost:" << cost;
 }
 
 /**
@@ -73,7 +79,7 @@ void ThumbnailCache::remove(const QString &path, int frameIndex)
     // qDebug() << "ThumbnailCache::remove - Entry";
     QMutexLocker _locker(&mutex);
     cache.remove(toFindKey(path, frameIndex));
-    qDebug() << "Removed thumbnail from cache for path:" << path << "frame:" << frameIndex;
+    qCDebug(logCache) << "Removed thumbnail from cache for path:" << path << "frame:" << frameIndex;
 }
 
 /**
@@ -87,6 +93,24 @@ void ThumbnailCache::setMaxCost(int maxCost)
     qDebug() << "Set thumbnail cache max cost to:" << maxCost;
 }
 
+/**
+   @return 返回当前缓存的最大容量
+ */
+int ThumbnailCache::maxCost()
+{
+    QMutexLocker _locker(&mutex);
+    return static_cast<int>(cache.maxCost());
+}
+
+/**
+   @return 返回当前缓存已使用的容量
+ */
+int ThumbnailCache::totalCost()
+{
+    QMutexLocker _locker(&mutex);
+    return static_cast<int>(cache.totalCost());
+}
+
 /**
    @brief 清空缩略图信息
  */
@@ -104,6 +128,7 @@ void ThumbnailCache::clear()
 QList<ThumbnailCache::Key> ThumbnailCache::keys()
 {
     // qDebug() << "ThumbnailCache::keys - Entry";
+    QMutexLocker _locker(&mutex);
     return cache.keys();
 }
 
@@ -21,9 +21,11 @@ public:
 
     bool contains(const QString &path, int frameIndex = 0);
     QImage get(const QString &path, int frameIndex = 0);
-    void add(const QString &path, int frameIndex, const QImage &image);
+    void add(const QString &path, int frameIndex, const QImage &image, int cost = 1);
     void remove(const QString &path, int frameIndex);
     void setMaxCost(int maxCost);
+    int maxCost();
+    int totalCost();
     void clear();
 
     QList<Key> keys();
@@ -25,6 +25,9 @@
 #include "dbmanager/dbmanager.h"
 #include "configsetter.h"
 #include "movieservice.h"
+#include "imagedata/derivativestore.h"
+#include "imagedata/imagescaler.h"
+#include "utils/perfmetrics.h"
 #include <QDebug>
 
 #include <QMetaType>
@@ -77,9 +80,11 @@ std::pair<QImage, bool> ImageDataService::getImageFromMap(const QString &path)
     });
     if (iter != m_AllImageMap.end()) {
         // qDebug() << "ImageDataService::getImageFromMap - Exit, return iter->second";
+        ALBUM_COUNTER_INC("thumbnail.memory.hit");
         return std::make_pair(iter->second, true);
     } else {
-        qDebug() << "Image not found in map for path:" << path;
+        ALBUM_COUNTER_INC("thumbnail.memory.miss");
+        qCDebug(logThumbnail) << "Image not found in map for path:" << path;
         return std::make_pair(QImage(), false);
     }
 }
@@ -93,7 +98,7 @@ void ImageDataService::removePathFromMap(const QString &path)
         return pr.first == path;
     });
     if (iter != m_AllImageMap.end()) {
-        qDebug() << "Removing path from map:" << path;
+        qCDebug(logThumbnail) << "Removing path from map:" << path;
         m_AllImageMap.erase(iter);
     }
 
@@ -102,7 +107,7 @@ void ImageDataService::removePathFromMap(const QString &path)
         return pr.first == scalPath;
     });
     if (iter != m_AllImageMap.end()) {
-        qDebug() << "Removing scaled path from map:" << scalPath;
+        qCDebug(logThumbnail) << "Removing scaled path from map:" << scalPath;
         m_AllImageMap.erase(iter);
     }
     // qDebug() << "ImageDataService::removePathFromMap - Exit";
@@ -118,13 +123,14 @@ void ImageDataService::removeThumbnailFile(const QString &path)
 
     QString thumbnailPath = Libutils::base::filePathToThumbnailPath(path);
     QString thumbnailScalePath = ImageDataService::instance()->getLoadModePath(thumbnailPath);
+    DerivativeStore::instance()->remove(path);
     if (QFile::exists(thumbnailPath)) {
         QFile::remove(thumbnailPath);
-        qDebug() << "Removed thumbnail file:" << thumbnailPath;
+        qCDebug(logThumbnail) << "Removed thumbnail file:" << thumbnailPath;
     }
     if (QFile::exists(thumbnailScalePath)) {
         QFile::remove(thumbnailScalePath);
-        qDebug() << "Removed scaled thumbnail file:" << thumbnailScalePath;
+        qCDebug(logThumbnail) << "Removed scaled thumbnail file:" << thumbnailScalePath;
     }
     // qDebug() << "ImageDataService::removeThumbnailFile - Exit";
 }
@@ -161,13 +167,13 @@ void ImageDataService::addImage(const QString &path, const QImage &image)
     });
 
     if (iter != m_AllImageMap.end()) {
-        qDebug() << "Updating existing image in map for path:" << path;
+        qCDebug(logThumbnail) << "Updating existing image in map for path:" << path;
         iter->second = image;
     } else {
-        qDebug() << "Adding new image to map for path:" << path;
+        qCDebug(logThumbnail) << "Adding new image to map for path:" << path;
         m_AllImageMap.push_back(std::make_pair(loadModePath, image));
         if (m_AllImageMap.size() > 500) {
-            qDebug() << "Image map size exceeded 500, removing oldest entry";
+            qCDebug(logThumbnail) << "Image map size exceeded 500, removing oldest entry";
             m_AllImageMap.pop_front();
         }
     }
@@ -179,7 +185,7 @@ void ImageDataService::addMovieDurationStr(const QString &path, const QString &d
     // qDebug() << "ImageDataService::addMovieDurationStr - Entry";
     QMutexLocker locker(&m_imgDataMutex);
     m_movieDurationStrMap[path] = durationStr;
-    qDebug() << "Added movie duration for path:" << path << "duration:" << durationStr;
+    qCDebug(logThumbnail) << "Added movie duration for path:" << path << "duration:" << durationStr;
 }
 
 QString ImageDataService::getMovieDurationStrByPath(const QString &path)
@@ -192,60 +198,61 @@ QString ImageDataService::getMovieDurationStrByPath(const QString &path)
 
 bool ImageDataService::imageIsLoaded(const QString &path, bool isTrashFile)
 {
-    qDebug() << "ImageDataService::imageIsLoaded - Entry";
+    qCDebug(logThumbnail) << "ImageDataService::imageIsLoaded - Entry";
     QMutexLocker locker(&m_imgDataMutex);
 
     bool loaded = false;
     if (isTrashFile) {
-        qDebug() << "ImageDataService::imageIsLoaded - Entry, isTrashFile is true";
+        qCDebug(logThumbnail) << "ImageDataService::imageIsLoaded - Entry, isTrashFile is true";
         QString realPath = Libutils::base::getDeleteFullPath(Libutils::base::hashByString(path), DBImgInfo::getFileNameFromFilePath(path));
         loaded = pathInMap(realPath) || pathInMap(path);
     } else {
-        qDebug() << "ImageDataService::imageIsLoaded - Entry, isTrashFile is false";
+        qCDebug(logThumbnail) << "ImageDataService::imageIsLoaded - Entry, isTrashFile is false";
         loaded = pathInMap(path);
     }
-    qDebug() << "ImageDataService::imageIsLoaded - Exit, return:" << loaded;
+    qCDebug(logThumbnail) << "ImageDataService::imageIsLoaded - Exit, return:" << loaded;
     return loaded;
 }
 
 ImageDataService::ImageDataService(QObject *parent) : QObject(parent)
 {
-    qDebug() << "Initializing ImageDataService";
+    qCDebug(logThumbnail) << "Initializing ImageDataService";
     m_loadMode = 1;
     readThumbnailManager = new ReadThumbnailManager;
     readThread = new QThread;
+    readThread->setObjectName("ThumbnailReader");
     readThumbnailManager->moveToThread(readThread);
     readThread->start();
     connect(this, &ImageDataService::startImageLoad, readThumbnailManager, &ReadThumbnailManager::readThumbnail);
 
     //初始化的时候读取上次退出时的状态
     m_loadMode = LibConfigSetter::instance()->value(SETTINGS_GROUP, SETTINGS_DISPLAY_MODE, 0).toInt();
-    qDebug() << "Initial load mode set to:" << m_loadMode;
+    qCDebug(logThumbnail) << "Initial load mode set to:" << m_loadMode;
 }
 
 void ImageDataService::stopFlushThumbnail()
 {
-    qDebug() << "Stopping thumbnail flush";
+    qCDebug(logThumbnail) << "Stopping thumbnail flush";
     readThumbnailManager->stopRead();
 }
 
 void ImageDataService::waitFlushThumbnailFinish()
 {
-    qDebug() << "Waiting for thumbnail flush to finish";
+    qCDebug(logThumbnail) << "Waiting for thumbnail flush to finish";
     while (ImageDataService::instance()->readThumbnailManager->isRunning());
-    qDebug() << "Thumbnail flush finished";
+    qCDebug(logThumbnail) << "Thumbnail flush finished";
 }
 
 bool ImageDataService::readerIsRunning()
 {
     bool running = readThumbnailManager->isRunning();
-    qDebug() << "Thumbnail reader running status:" << running;
+    qCDebug(logThumbnail) << "Thumbnail reader running status:" << running;
     return running;
 }
 
 void ImageDataService::switchLoadMode()
 {
-    qDebug() << "ImageDataService::switchLoadMode - Entry";
+    qCDebug(logThumbnail) << "ImageDataService::switchLoadMode - Entry";
     int oldMode = m_loadMode;
     switch (m_loadMode) {
     case 0:
@@ -261,41 +268,40 @@ void ImageDataService::switchLoadMode()
 
     //切完以后保存状态
     LibConfigSetter::instance()->setValue(SETTINGS_GROUP, SETTINGS_DISPLAY_MODE, m_loadMode.load());
-    qDebug() << "Switched load mode from" << oldMode << "to" << m_loadMode;
+    qCDebug(logThumbnail) << "Switched load mode from" << oldMode << "to" << m_loadMode;
 }
 
 int ImageDataService::getLoadMode()
 {
-    qDebug() << "ImageDataService::getLoadMode - Entry, return:" << m_loadMode;
+    qCDebug(logThumbnail) << "ImageDataService::getLoadMode - Entry, return:" << m_loadMode;
     return m_loadMode;
 }
 
-QImage ImageDataService::getThumnailImageByPathRealTime(const QString &path, bool isTrashFile, bool bReload/* = false*/)
+QString ImageDataService::realThumbnailPath(const QString &path, bool isTrashFile)
 {
-    qDebug() << "ImageDataService::getThumnailImageByPathRealTime - Entry";
-    QString realPath;
-
     if (!isTrashFile) {
-        realPath = path;
-        if (!QFile::exists(realPath)) {
-            qWarning() << "File does not exist:" << realPath;
-            return QImage();
-        }
-    } else {
-        realPath = Libutils::base::getDeleteFullPath(Libutils::base::hashByString(path), DBImgInfo::getFileNameFromFilePath(path));
-        if (!QFile::exists(realPath)) {
-            if (!QFile::exists(path)) {
-                qWarning() << "Trash file does not exist:" << path;
-                return QImage();
-            } else {
-                realPath = path;
-            }
-        }
+        return QFile::exists(path) ? path : QString();
+    }
+
+    QString realPath = Libutils::base::getDeleteFullPath(Libutils::base::hashByString(path), DBImgInfo::getFileNameFromFilePath(path));
+    if (QFile::exists(realPath))
+        return realPath;
+
+    return QFile::exists(path) ? path : QString();
+}
+
+QImage ImageDataService::getThumnailImageByPathRealTime(const QString &path, bool isTrashFile, bool bReload/* = false*/)
+{
+    qCDebug(logThumbnail) << "ImageDataService::getThumnailImageByPathRealTime - Entry";
+    QString realPath = realThumbnailPath(path, isTrashFile);
+    if (realPath.isEmpty()) {
+        qWarning() << "File does not exist:" << path;
+        return QImage();
     }
 
     // 重新加载缩略图，清楚缓存对应缩略图
     if (bReload) {
-        qDebug() << "Reloading thumbnail for path:" << realPath;
+        qCDebug(logThumbnail) << "Reloading thumbnail for path:" << realPath;
         removePathFromMap(realPath);
         removeThumbnailFile(realPath);
     }
@@ -303,48 +309,144 @@ QImage ImageDataService::getThumnailImageByPathRealTime(const QString &path, boo
     //尝试在缓存里面找图
     auto bufferImage = getImageFromMap(realPath);
     if (bufferImage.second) {
-        qDebug() << "ImageDataService::getThumnailImageByPathRealTime - Exit, return bufferImage.first";
+        qCDebug(logThumbnail) << "ImageDataService::getThumnailImageByPathRealTime - Exit, return bufferImage.first";
         return bufferImage.first;
     }
 
     //缓存没找到则加入图片到加载队列
-    qDebug() << "Adding path to thumbnail load queue:" << realPath;
+    qCDebug(logThumbnail) << "Adding path to thumbnail load queue:" << realPath;
     readThumbnailManager->addLoadPath(realPath);
 
     //如果加载队列正在休眠，则发信号唤醒，反之不去反复发信号激活队列
     if (!readThumbnailManager->isRunning()) {
-        qDebug() << "Waking up thumbnail reader thread";
+        qCDebug(logThumbnail) << "Waking up thumbnail reader thread";
         emit startImageLoad();
     }
 
-    qDebug() << "ImageDataService::getThumnailImageByPathRealTime - Exit, return QImage()";
+    qCDebug(logThumbnail) << "ImageDataService::getThumnailImageByPathRealTime - Exit, return QImage()";
     return QImage();
 }
 
+void ImageDataService::reloadThumbnails(const QStringList &paths)
+{
+    qCDebug(logThumbnail) << "ImageDataService::reloadThumbnails - Entry, count:" << paths.size();
+    if (paths.isEmpty()) {
+        return;
+    }
+
+    QSet<QString> keys;
+    for (const QString &path : paths) {
+        keys.insert(path);
+        keys.insert(getScaledPath(path));
+    }
+
+    // 一次加锁移除全部缓存项
+    {
+        QMutexLocker locker(&m_imgDataMutex);
+        m_AllImageMap.erase(std::remove_if(m_AllImageMap.begin(), m_AllImageMap.end(), [&keys](const std::pair<QString, QImage> &pr) {
+            return keys.contains(pr.first);
+        }), m_AllImageMap.end());
+    }
+
+    for (const QString &path : paths) {
+        removeThumbnailFile(path);
+        readThumbnailManager->addLoadPath(path);
+    }
+
+    if (!readThumbnailManager->isRunning()) {
+        qCDebug(logThumbnail) << "Waking up thumbnail reader thread";
+        emit startImageLoad();
+    }
+    qCDebug(logThumbnail) << "ImageDataService::reloadThumbnails - Exit";
+}
+
+void ImageDataService::setVisibleHint(const QStringList &visiblePaths, const QStringList &prefetchPaths, bool isTrashFile)
+{
+    // 仅将尚未缓存的路径交给加载队列，已缓存的图片无需再读
+    auto filterUnloaded = [this, isTrashFile](const QStringList &paths) {
+        QStringList result;
+        for (const QString &path : paths) {
+            if (path.isEmpty())
+                continue;
+
+            QString realPath = isTrashFile ? realThumbnailPath(path, true) : path;
+            if (realPath.isEmpty())
+                continue;
+
+            QMutexLocker locker(&m_imgDataMutex);
+            if (!pathInMap(realPath))
+                result.append(realPath);
+        }
+        return result;
+    };
+
+    QStringList visible = filterUnloaded(visiblePaths);
+    QStringList prefetch = filterUnloaded(prefetchPaths);
+    qCDebug(logThumbnail) << "Thumbnail visible hint, visible:" << visible.size() << "prefetch:" << prefetch.size();
+
+    readThumbnailManager->setPriorityWindow(visible, prefetch);
+
+    if (!(visible.isEmpty() && prefetch.isEmpty()) && !readThumbnailManager->isRunning()) {
+        emit startImageLoad();
+    }
+}
+
 ReadThumbnailManager::ReadThumbnailManager(QObject *parent)
     : QObject(parent)
     , runningFlag(false)
     , stopFlag(false)
 {
-    qDebug() << "ReadThumbnailManager initialized";
+    qCDebug(logThumbnail) << "ReadThumbnailManager initialized";
 }
 
 void ReadThumbnailManager::addLoadPath(const QString &path)
 {
-    qDebug() << "ReadThumbnailManager::addLoadPath - Entry";
+    qCDebug(logThumbnail) << "ReadThumbnailManager::addLoadPath - Entry";
     mutex.lock();
-    needLoadPath.push_back(path);
-    if (needLoadPath.size() > 100) {
-        qDebug() << "Load path queue exceeded 100 items, removing oldest";
+    // 不在优先窗口内的请求（如视图缓冲区的委托）排到队首，最后读取
+    if (!windowPaths.isEmpty() && !windowPaths.contains(path)) {
+        needLoadPath.push_front(path);
+    } else {
+        needLoadPath.push_back(path);
+    }
+
+    // 队列上限至少能容纳整个优先窗口，超出时丢弃优先级最低的队首
+    const size_t maxSize = static_cast<size_t>(qMax(100, windowPaths.size()));
+    while (needLoadPath.size() > maxSize) {
+        qCDebug(logThumbnail) << "Load path queue exceeded" << maxSize << "items, removing lowest priority";
         needLoadPath.pop_front();
     }
+    ALBUM_GAUGE_SET("thumbnail.queue", static_cast<qint64>(needLoadPath.size()));
     mutex.unlock();
-    qDebug() << "ReadThumbnailManager::addLoadPath - Exit";
+    qCDebug(logThumbnail) << "ReadThumbnailManager::addLoadPath - Exit";
+}
+
+void ReadThumbnailManager::setPriorityWindow(const QStringList &visiblePaths, const QStringList &prefetchPaths)
+{
+    QMutexLocker locker(&mutex);
+
+    windowPaths.clear();
+    for (const QString &path : visiblePaths)
+        windowPaths.insert(path);
+    for (const QString &path : prefetchPaths)
+        windowPaths.insert(path);
+
+    // 重建队列，窗口外的排队任务直接取消；队尾先读，因此由远及近入队：
+    // 预加载项（远 -> 近），再到可见项（末项 -> 首项）
+    std::deque<QString> queue;
+    for (auto iter = prefetchPaths.crbegin(); iter != prefetchPaths.crend(); ++iter)
+        queue.push_back(*iter);
+    for (auto iter = visiblePaths.crbegin(); iter != visiblePaths.crend(); ++iter)
+        queue.push_back(*iter);
+
+    qCDebug(logThumbnail) << "Priority window updated, replaced" << needLoadPath.size() << "queued items with" << queue.size();
+    needLoadPath.swap(queue);
+    ALBUM_GAUGE_SET("thumbnail.queue", static_cast<qint64>(needLoadPath.size()));
 }
 
 void ReadThumbnailManager::readThumbnail()
 {
-    qDebug() << "Starting thumbnail read process";
+    qCDebug(logThumbnail) << "Starting thumbnail read process";
     int sendCounter = 0; //刷新上层界面指示
     runningFlag = true;  //告诉外面加载队列处于激活状态
 
@@ -362,9 +464,13 @@ void ReadThumbnailManager::readThumbnail()
 
         auto path = needLoadPath[needLoadPath.size() - 1];
         needLoadPath.pop_back();
+        ALBUM_GAUGE_SET("thumbnail.queue", static_cast<qint64>(needLoadPath.size()));
 
         mutex.unlock();
 
+        // 单张缩略图从出队到交付的总耗时
+        ALBUM_TRACE_SCOPE(logThumbnail, "thumbnail.load");
+
         sendCounter++;
         if (sendCounter == 5) { //每加载5张图，就让上层界面主动刷新一次
             sendCounter = 0;
@@ -386,8 +492,14 @@ void ReadThumbnailManager::readThumbnail()
         QFileInfo thumbnailFile(thumbnailPath);
         QString errMsg;
         if (thumbnailFile.exists()) {
-            qDebug() << "Loading existing thumbnail:" << thumbnailPath;
-            if (!loadStaticImageFromFile(thumbnailPath, tImg, errMsg, "PNG")) {
+            ALBUM_COUNTER_INC("thumbnail.file.hit");
+            qCDebug(logThumbnail) << "Loading existing thumbnail:" << thumbnailPath;
+            bool loaded = false;
+            {
+                ALBUM_TRACE_SCOPE(logThumbnail, "thumbnail.readFile");
+                loaded = loadStaticImageFromFile(thumbnailPath, tImg, errMsg, "PNG");
+            }
+            if (!loaded) {
                 qWarning() << "Failed to load thumbnail:" << errMsg;
                 //不正常退出导致的缩略图损坏，删除原文件后重新尝试制作
                 QFile::remove(thumbnailPath);
@@ -397,21 +509,26 @@ void ReadThumbnailManager::readThumbnail()
             }
 
             if (isVideo(srcPath)) {
-                qDebug() << "Getting video info for:" << srcPath;
+                qCDebug(logThumbnail) << "Getting video info for:" << srcPath;
                 MovieInfo mi = MovieService::instance()->getMovieInfo(QUrl::fromLocalFile(srcPath));
                 ImageDataService::instance()->addMovieDurationStr(srcPath, mi.duration);
             }
         } else {
-            qDebug() << "Generating new thumbnail for:" << srcPath;
+            ALBUM_COUNTER_INC("thumbnail.file.miss");
+            ALBUM_TRACE_SCOPE(logThumbnail, "thumbnail.decode");
+            qCDebug(logThumbnail) << "Generating new thumbnail for:" << srcPath;
             //读图
             if (isVideo(srcPath)) {
-                tImg = MovieService::instance()->getMovieCover(QUrl::fromLocalFile(srcPath));
-
-                //获取视频信息 demo
-                MovieInfo mi = MovieService::instance()->getMovieInfo(QUrl::fromLocalFile(srcPath));
+                //首帧图片和视频信息由同一次解封装获取
+                MovieInfo mi;
+                tImg = MovieService::instance()->getMovieCoverAndInfo(QUrl::fromLocalFile(srcPath), mi);
                 ImageDataService::instance()->addMovieDurationStr(path, mi.duration);
             } else {
-                if (!loadStaticImageFromFile(srcPath, tImg, errMsg)) {
+                //优先使用派生图，裁切模式需覆盖正方形，填充模式只需适应正方形
+                const Qt::AspectRatioMode mode = ImageDataService::instance()->getLoadMode() == 0 ? Qt::KeepAspectRatioByExpanding
+                                                                                                 : Qt::KeepAspectRatio;
+                tImg = DerivativeStore::instance()->image(srcPath, QSize(THUMBNAIL_MAX_SIZE, THUMBNAIL_MAX_SIZE), mode);
+                if (tImg.isNull() && !loadStaticImageFromFile(srcPath, tImg, errMsg)) {
                     qWarning() << "Failed to load image:" << errMsg;
                     ImageDataService::instance()->addImage(srcPath, tImg);
                     DBManager::m_fileMutex.unlock();
@@ -421,10 +538,10 @@ void ReadThumbnailManager::readThumbnail()
 
             //裁切
             if (ImageDataService::instance()->getLoadMode() == 0) {
-                qDebug() << "Clipping image to rect";
+                qCDebug(logThumbnail) << "Clipping image to rect";
                 tImg = clipToRect(tImg);
             } else if (ImageDataService::instance()->getLoadMode() == 1) {
-                qDebug() << "Adding pad and scaling image";
+                qCDebug(logThumbnail) << "Adding pad and scaling image";
                 tImg = addPadAndScaled(tImg);
             }
 
@@ -432,7 +549,8 @@ void ReadThumbnailManager::readThumbnail()
         }
 
         if (!tImg.isNull() && !thumbnailFile.exists()) {
-            qDebug() << "Saving new thumbnail to:" << thumbnailPath;
+            ALBUM_TRACE_SCOPE(logThumbnail, "thumbnail.save");
+            qCDebug(logThumbnail) << "Saving new thumbnail to:" << thumbnailPath;
             tImg.save(thumbnailPath, "PNG"); //保存裁好的缩略图，下次读的时候直接刷进去
         }
 
@@ -449,69 +567,21 @@ void ReadThumbnailManager::readThumbnail()
     }
 
     runningFlag = false; //告诉外面加载队列处于休眠状态
-    qDebug() << "Thumbnail read process finished";
+    qCDebug(logThumbnail) << "Thumbnail read process finished";
 }
 
 QImage ReadThumbnailManager::clipToRect(const QImage &src)
 {
-    qDebug() << "ReadThumbnailManager::clipToRect - Entry";
-    auto tImg = src;
-
-    if (!tImg.isNull() && 0 != tImg.height() && 0 != tImg.width() && (tImg.height() / tImg.width()) < 10 && (tImg.width() / tImg.height()) < 10) {
-        bool cache_exist = false;
-        if (tImg.height() != THUMBNAIL_MAX_SIZE && tImg.width() != THUMBNAIL_MAX_SIZE) {
-            if (tImg.height() >= tImg.width()) {
-                cache_exist = true;
-                tImg = tImg.scaledToWidth(THUMBNAIL_MAX_SIZE,  Qt::FastTransformation);
-            } else if (tImg.height() <= tImg.width()) {
-                cache_exist = true;
-                tImg = tImg.scaledToHeight(THUMBNAIL_MAX_SIZE,  Qt::FastTransformation);
-            }
-        }
-        if (!cache_exist) {
-            if ((static_cast<float>(tImg.height()) / (static_cast<float>(tImg.width()))) > 3) {
-                tImg = tImg.scaledToWidth(THUMBNAIL_MAX_SIZE,  Qt::FastTransformation);
-            } else {
-                tImg = tImg.scaledToHeight(THUMBNAIL_MAX_SIZE,  Qt::FastTransformation);
-            }
-        }
-    }
-
-    if (!tImg.isNull()) {
-        qDebug() << "ReadThumbnailManager::clipToRect - Entry, tImg is not null";
-        int width = tImg.width();
-        int height = tImg.height();
-        if (abs((width - height) * 10 / width) >= 1) {
-            QRect rect = tImg.rect();
-            int x = rect.x() + width / 2;
-            int y = rect.y() + height / 2;
-            if (width > height) {
-                x = x - height / 2;
-                y = 0;
-                tImg = tImg.copy(x, y, height, height);
-            } else {
-                y = y - width / 2;
-                x = 0;
-                tImg = tImg.copy(x, y, width, width);
-            }
-        }
-    }
-
-    qDebug() << "ReadThumbnailManager::clipToRect - Exit, return tImg";
-    return tImg;
+    qCDebug(logThumbnail) << "ReadThumbnailManager::clipToRect - Entry";
+    ALBUM_TRACE_SCOPE(logThumbnail, "thumbnail.clip");
+    // 短边缩放到缩略图尺寸并居中裁剪为方图，缩放与裁剪一次完成
+    return ImageScaler::clipToSquare(src, THUMBNAIL_MAX_SIZE);
 }
 
 QImage ReadThumbnailManager::addPadAndScaled(const QImage &src)
 {
-    qDebug() << "ReadThumbnailManager::addPadAndScaled - Entry";
-    auto result = src.convertToFormat(QImage::Format_RGBA8888);
-
-    if (result.height() > result.width()) {
-        result = result.scaledToHeight(THUMBNAIL_MAX_SIZE, Qt::SmoothTransformation);
-    } else {
-        result = result.scaledToWidth(THUMBNAIL_MAX_SIZE, Qt::SmoothTransformation);
-    }
-
-    qDebug() << "ReadThumbnailManager::addPadAndScaled - Exit, return result";
-    return result;
+    qCDebug(logThumbnail) << "ReadThumbnailManager::addPadAndScaled - Entry";
+    ALBUM_TRACE_SCOPE(logThumbnail, "thumbnail.pad");
+    // 长边缩放到缩略图尺寸，格式转换在缩放时一并完成，不再转换整张原图
+    return ImageScaler::fitToEdge(src, THUMBNAIL_MAX_SIZE, QImage::Format_RGBA8888);
 }
@@ -27,6 +27,7 @@
 #include <QMutex>
 #include <QThread>
 #include <QQueue>
+#include <QSet>
 #include <deque>
 
 class readThumbnailThread;
@@ -42,6 +43,13 @@ public:
     QImage getThumnailImageByPathRealTime(const QString &path, bool isTrashFile, bool bReload = false);
     bool imageIsLoaded(const QString &path, bool isTrashFile);
 
+    // 设置视图当前可见区域的缩略图提示：visiblePaths为可见项，prefetchPaths为滚动方向上的预加载项（由近及远）
+    // 加载队列将优先读取可见项，其次为预加载项，窗口外的排队任务会被取消
+    void setVisibleHint(const QStringList &visiblePaths, const QStringList &prefetchPaths, bool isTrashFile);
+
+    // 批量失效缩略图缓存及缩略图文件并重新加载，用于批量修改文件后统一刷新
+    void reloadThumbnails(const QStringList &paths);
+
     void addMovieDurationStr(const QString &path, const QString &durationStr);
     QString getMovieDurationStrByPath(const QString &path);
 
@@ -71,6 +79,9 @@ public:
 private:
     bool pathInMap(const QString &path);
 
+    // 获取缩略图实际对应的原图路径，回收站文件需转换为回收站内的路径，文件不存在时返回空
+    QString realThumbnailPath(const QString &path, bool isTrashFile);
+
     //QImage:图片，bool:是否是从缓存加载
     std::pair<QImage, bool> getImageFromMap(const QString &path);
     // 从缓存清除图片信息
@@ -103,6 +114,9 @@ public:
     explicit ReadThumbnailManager(QObject *parent = nullptr);
     void addLoadPath(const QString &path);
 
+    // 更新优先加载窗口，队列按"可见项 > 预加载项"重排，窗口外的排队任务被取消
+    void setPriorityWindow(const QStringList &visiblePaths, const QStringList &prefetchPaths);
+
     bool isRunning()
     {
         return runningFlag;
@@ -122,7 +136,10 @@ private:
     // 将图片按比例缩小
     QImage addPadAndScaled(const QImage &src);
 private:
+    //队尾优先读取
     std::deque<QString> needLoadPath;
+    //当前优先加载窗口
+    QSet<QString> windowPaths;
     QMutex mutex;
     std::atomic_bool runningFlag;
     std::atomic_bool stopFlag;
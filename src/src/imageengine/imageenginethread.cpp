@@ -8,9 +8,21 @@
 #include "unionimage/baseutils.h"
 #include "albumControl.h"
 #include "utils/classifyutils.h"
+#include "utils/classifyscheduler.h"
+#include "utils/trashexpiryscheduler.h"
 #include <QDebug>
 
 #include <QDirIterator>
+#include <QImageWriter>
+#include <QScopeGuard>
+#include <QThread>
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <cstring>
+#include <sys/sendfile.h>
+#include <unistd.h>
+#endif
 
 ImageEngineThreadObject::ImageEngineThreadObject()
 {
@@ -99,6 +111,11 @@ bool ImportImagesThread::ifCanStopThread(void *imgobject)
 void ImportImagesThread::runDetail()
 {
     qDebug() << "Starting import process for UID:" << m_UID;
+    // 导入期间暂停后台分类，导入的新图片在结束后进入分类
+    ClassifyScheduler::instance()->beginImport();
+    auto importGuard = qScopeGuard([]() {
+        ClassifyScheduler::instance()->endImport();
+    });
     //相册中本次导入之前已导入的所有路径
     DBImgInfoList oldInfos = AlbumControl::instance()->getAllInfosByUID(QString::number(m_UID));
     QStringList allOldImportedPaths;
@@ -221,43 +238,722 @@ void ImportImagesThread::runDetail()
     }
 }
 
-ImagesClassifyThread::ImagesClassifyThread()
+static const qint64 sc_CopyChunkSize = 4 * 1024 * 1024;         // 大文件复制时每次复制的数据块
+static const int sc_DeviceCopyStreams = 3;                      // 并行复制数，USB 设备上多路读取可掩盖单文件的访问延迟
+static const qint64 sc_DeviceCopyHeadSize = 256 * 1024;         // 首个数据块，覆盖常见的 EXIF 段
+static const int sc_DeviceCommitCount = 100;                    // 每累计多少个文件写入一次数据库
+static const int sc_DeviceCommitInterval = 2000;                // 最长写入间隔，毫秒
+
+/**
+   @brief 从 \a offset 处开始复制 \a in 的剩余内容到 \a out，已复制的字节数累加到 \a copiedBytes，
+    优先使用 copy_file_range/sendfile 在内核中复制，不支持时（如 MTP 的 FUSE 挂载）使用大缓冲区读写，\a stop 为 true 时中止
+ */
+static bool copyFileData(QFile &in, QFile &out, qint64 offset, qint64 size, QAtomicInteger<qint64> &copiedBytes, const bool &stop)
 {
+#ifdef Q_OS_LINUX
+    enum { CopyFileRange, SendFile, ReadWrite } mode = CopyFileRange;
+    while (offset < size && !stop && ReadWrite != mode) {
+        ssize_t n = -1;
+        if (CopyFileRange == mode) {
+            loff_t inOffset = offset;
+            loff_t outOffset = offset;
+            n = ::copy_file_range(in.handle(), &inOffset, out.handle(), &outOffset, size_t(sc_CopyChunkSize), 0);
+        } else {
+            off_t inOffset = offset;
+            n = ::sendfile(out.handle(), in.handle(), &inOffset, size_t(sc_CopyChunkSize));
+        }
 
+        if (n > 0) {
+            offset += n;
+            copiedBytes.fetchAndAddRelaxed(n);
+        } else if (0 == n) {
+            break;
+        } else if (EINTR == errno) {
+            continue;
+        } else if (EXDEV == errno || ENOSYS == errno || EOPNOTSUPP == errno || EINVAL == errno) {
+            // 当前文件系统不支持，降级到下一种方式继续复制
+            mode = (CopyFileRange == mode) ? SendFile : ReadWrite;
+            if (SendFile == mode && ::lseek(out.handle(), offset, SEEK_SET) < 0) {
+                mode = ReadWrite;
+            }
+        } else {
+            qWarning() << "Failed to copy file:" << in.fileName() << strerror(errno);
+            return false;
+        }
+    }
+#endif
+
+    if (offset < size && !stop) {
+        if (!in.seek(offset) || !out.seek(offset)) {
+            qWarning() << "Failed to seek file:" << in.fileName();
+            return false;
+        }
+        QByteArray buffer(sc_CopyChunkSize, Qt::Uninitialized);
+        while (!stop) {
+            const qint64 n = in.read(buffer.data(), buffer.size());
+            if (n < 0) {
+                qWarning() << "Failed to read file:" << in.fileName() << in.errorString();
+                return false;
+            }
+            if (0 == n) {
+                break;
+            }
+            if (out.write(buffer.constData(), n) != n) {
+                qWarning() << "Failed to write file:" << out.fileName() << out.errorString();
+                return false;
+            }
+            offset += n;
+            copiedBytes.fetchAndAddRelaxed(n);
+        }
+    }
+    return true;
 }
 
-ImagesClassifyThread::~ImagesClassifyThread()
+ImportFromDeviceThread::ImportFromDeviceThread()
+{
+    connect(this, &ImportFromDeviceThread::sigImportProgress, AlbumControl::instance(), &AlbumControl::sigImportProgress);
+    connect(this, &ImportFromDeviceThread::sigImportSpeed, AlbumControl::instance(), &AlbumControl::sigImportSpeed);
+}
+
+ImportFromDeviceThread::~ImportFromDeviceThread()
+{
+}
+
+void ImportFromDeviceThread::setData(const QStringList &paths, const int UID)
+{
+    m_paths = paths;
+    m_UID = UID;
+}
+
+bool ImportFromDeviceThread::isImportingFrom(const QString &devicePath) const
+{
+    return std::any_of(m_paths.begin(), m_paths.end(), [&devicePath](const QString &path) {
+        return path.startsWith(devicePath);
+    });
+}
+
+void ImportFromDeviceThread::runDetail()
+{
+    QString strHomePath = QDir::homePath();
+    //获取系统现在的时间
+    QString strDate = QDateTime::currentDateTime().toString("yyyy-MM-dd");
+    QString basePath = QString("%1%2%3/%4").arg(strHomePath, "/Pictures/", AlbumControl::tr("Pictures"), strDate);
+    QDir dir;
+    if (!dir.exists(basePath)) {
+        dir.mkpath(basePath);
+    }
+
+    // 目标文件名为 原文件名 + 时间戳 + 后缀，时间戳按序号递增，避免同一毫秒内重名
+    QList<CopyJob> jobs;
+    qint64 totalBytes = 0;
+    const qint64 stamp = QDateTime::currentDateTime().toMSecsSinceEpoch();
+    for (const QString &strPath : m_paths) {
+        QFileInfo srcInfo(strPath);
+        if (!srcInfo.exists()) {
+            continue;
+        }
+
+        QStringList nameList = srcInfo.fileName().split(".", Qt::SkipEmptyParts);
+        if (nameList.isEmpty()) {
+            continue;
+        }
+        CopyJob job;
+        job.srcPath = strPath;
+        job.dstPath = QString("%1/%2%3.%4").arg(basePath, nameList.first(), QString::number(stamp + jobs.size()), nameList.last());
+        job.isVideo = LibUnionImage_NameSpace::isVideo(strPath);
+        job.size = srcInfo.size();
+        //判断新路径下是否存在目标文件，若存在，先删除掉
+        if (dir.exists(job.dstPath)) {
+            dir.remove(job.dstPath);
+        }
+        totalBytes += job.size;
+        jobs << job;
+    }
+
+    if (jobs.isEmpty()) {
+        qWarning() << "No files to import from device";
+        emit AlbumControl::instance()->sigImportFailed(m_paths.size());
+        return;
+    }
+
+    // 导入期间暂停后台分类
+    ClassifyScheduler::instance()->beginImport();
+    auto importGuard = qScopeGuard([]() {
+        ClassifyScheduler::instance()->endImport();
+    });
+
+    qInfo() << "Importing" << jobs.size() << "files from device, total bytes:" << totalBytes;
+    QThreadPool copyPool;
+    copyPool.setMaxThreadCount(qMin(sc_DeviceCopyStreams, int(jobs.size())));
+    for (const CopyJob &job : std::as_const(jobs)) {
+        copyPool.start([this, job]() { copyJob(job); });
+    }
+
+    // 等待复制的同时分批写入数据库并上报进度和速度
+    QElapsedTimer elapsed;
+    elapsed.start();
+    m_commitTimer.start();
+    qint64 lastBytes = 0;
+    qint64 lastSpeedTime = 0;
+    int lastDone = -1;
+    bool running = true;
+    while (running) {
+        running = !copyPool.waitForDone(200);
+        commitFinished(!running);
+
+        const int done = m_doneCount.loadRelaxed();
+        if (done != lastDone) {
+            lastDone = done;
+            emit sigImportProgress(done, jobs.size());
+        }
+
+        const qint64 now = elapsed.elapsed();
+        if (now - lastSpeedTime >= 1000) {
+            const qint64 bytes = m_copiedBytes.loadRelaxed();
+            emit sigImportSpeed((bytes - lastBytes) * 1000 / (now - lastSpeedTime));
+            lastBytes = bytes;
+            lastSpeedTime = now;
+        }
+    }
+
+    const qint64 cost = qMax<qint64>(1, elapsed.elapsed());
+    qInfo() << "Device import finished, imported:" << m_committedCount << "failed:" << m_failedCount.loadRelaxed()
+            << "bytes:" << m_copiedBytes.loadRelaxed() << "cost:" << cost << "ms"
+            << "speed:" << m_copiedBytes.loadRelaxed() * 1000 / cost / 1024 << "KiB/s";
+
+    if (m_committedCount > 0) {
+        if (m_UID > 0) {
+            emit AlbumControl::instance()->sigRefreshCustomAlbum(m_UID);
+        }
+        emit AlbumControl::instance()->sigRefreshImportAlbum();
+        emit AlbumControl::instance()->sigRefreshAllCollection();
+        emit AlbumControl::instance()->sigImportFinished();
+    } else {
+        emit AlbumControl::instance()->sigImportFailed(jobs.size());
+    }
+}
+
+/**
+   @brief 在复制线程中执行，复制完成后解析元数据，结果等待分批写入数据库
+ */
+void ImportFromDeviceThread::copyJob(const CopyJob &job)
+{
+    if (bneedstop) {
+        return;
+    }
+
+    QByteArray head;
+    if (!copyFile(job, head)) {
+        QFile::remove(job.dstPath);
+        m_failedCount.ref();
+        m_doneCount.ref();
+        return;
+    }
+
+    DBImgInfo info = fileDBInfo(job, head);
+    if (ItemTypeNull == info.itemType) {
+        qWarning() << "Skipping file with invalid format:" << job.srcPath;
+        m_failedCount.ref();
+    } else {
+        QMutexLocker locker(&m_resultMutex);
+        m_finishedInfos << info;
+    }
+    m_doneCount.ref();
+}
+
+/**
+   @brief 复制单个文件，首个数据块保存在 \a head 中用于解析元数据，剩余部分由 copyFileData 复制
+ */
+bool ImportFromDeviceThread::copyFile(const CopyJob &job, QByteArray &head)
+{
+    QFile in(job.srcPath);
+    QFile out(job.dstPath);
+    if (!in.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+        qWarning() << "Failed to open source file:" << job.srcPath << in.errorString();
+        return false;
+    }
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) {
+        qWarning() << "Failed to open target file:" << job.dstPath << out.errorString();
+        return false;
+    }
+
+    head = in.read(sc_DeviceCopyHeadSize);
+    if (head.size() != qMin(job.size, sc_DeviceCopyHeadSize) || out.write(head) != head.size()) {
+        qWarning() << "Failed to copy file head:" << job.srcPath << in.errorString() << out.errorString();
+        return false;
+    }
+    m_copiedBytes.fetchAndAddRelaxed(head.size());
+
+    if (!copyFileData(in, out, head.size(), job.size, m_copiedBytes, bneedstop)) {
+        return false;
+    }
+
+    if (bneedstop) {
+        qInfo() << "Device import canceled:" << job.srcPath;
+        return false;
+    }
+    return true;
+}
+
+/**
+   @brief 生成数据库信息，JPEG 的拍摄时间从复制时保留的首个数据块中解析，不再重新读取文件，
+    时间的取值顺序与 AlbumControl::getDBInfo 一致
+ */
+DBImgInfo ImportFromDeviceThread::fileDBInfo(const CopyJob &job, const QByteArray &head) const
+{
+    QFileInfo srcfi(job.dstPath);
+    DBImgInfo dbi;
+    dbi.filePath = job.dstPath;
+    dbi.importTime = QDateTime::currentDateTime();
+
+    QDateTime original;
+    QDateTime digitized;
+    if (job.isVideo) {
+        // 多个复制线程同时解析，直接使用线程安全的 MovieService，不经过 AlbumControl 的视频信息缓存
+        MovieInfo movieInfo = MovieService::instance()->getMovieInfo(QUrl::fromLocalFile(job.dstPath));
+        if (!movieInfo.valid) {
+            dbi.itemType = ItemTypeNull;
+            return dbi;
+        }
+        dbi.itemType = ItemTypeVideo;
+        dbi.changeTime = srcfi.lastModified();
+        original = movieInfo.creation;
+    } else if (LibUnionImage_NameSpace::readExifDateTime(head, original, digitized)) {
+        dbi.itemType = ItemTypePic;
+        dbi.changeTime = digitized;
+    } else {
+        // 非 JPEG 图片读取已复制到本地的文件
+        return AlbumControl::instance()->getDBInfo(job.dstPath, false);
+    }
+
+    if (original.isValid()) {
+        dbi.time = original;
+    } else if (srcfi.birthTime().isValid()) {
+        dbi.time = srcfi.birthTime();
+    } else if (srcfi.metadataChangeTime().isValid()) {
+        dbi.time = srcfi.metadataChangeTime();
+    } else {
+        dbi.time = dbi.changeTime;
+    }
+    return dbi;
+}
+
+/**
+   @brief 将已复制的文件写入数据库，未达到批量大小且未超时时跳过，\a force 为 true 时全部写入
+ */
+void ImportFromDeviceThread::commitFinished(bool force)
+{
+    DBImgInfoList infos;
+    {
+        QMutexLocker locker(&m_resultMutex);
+        if (!force && m_finishedInfos.size() < sc_DeviceCommitCount && m_commitTimer.elapsed() < sc_DeviceCommitInterval) {
+            return;
+        }
+        infos.swap(m_finishedInfos);
+    }
+    m_commitTimer.restart();
+    if (infos.isEmpty()) {
+        return;
+    }
+
+    DBManager::instance()->insertImgInfos(infos);
+    if (m_UID > 0) {
+        QStringList paths;
+        std::transform(infos.begin(), infos.end(), std::back_inserter(paths), [](const DBImgInfo &info) {
+            return info.filePath;
+        });
+        DBManager::instance()->insertIntoAlbum(m_UID, paths);
+    }
+    m_committedCount += infos.size();
+}
+
+static const int sc_ExportCopyStreams = 2;   // 并行复制数，保持目标设备的写队列不空，又不至于产生过多的随机写
+
+/**
+   @brief 按目标格式设置编码参数：JPEG 使用指定质量并优化哈夫曼表，PNG 的质量对应压缩级别，其余格式使用默认参数
+ */
+static void applyEncoderSettings(QImageWriter &writer, const QString &format, int quality)
+{
+    const QString suffix = format.toLower();
+    if ("jpg" == suffix || "jpeg" == suffix) {
+        writer.setQuality(quality);
+        writer.setOptimizedWrite(true);
+        writer.setProgressiveScanWrite(false);
+    } else if ("png" == suffix) {
+        writer.setQuality(quality);
+    }
+}
+
+ExportImagesThread::ExportImagesThread(int jobId)
+    : m_jobId(jobId)
+{
+    connect(this, &ExportImagesThread::sigExportProgress, AlbumControl::instance(), &AlbumControl::sigExportProgress);
+    connect(this, &ExportImagesThread::sigExportSpeed, AlbumControl::instance(), &AlbumControl::sigExportSpeed);
+    connect(this, &ExportImagesThread::sigExportFinished, AlbumControl::instance(), &AlbumControl::sigExportFinished);
+}
+
+ExportImagesThread::~ExportImagesThread()
+{
+}
+
+void ExportImagesThread::setData(const QList<ExportJob> &jobs)
 {
+    m_jobs = jobs;
+}
+
+int ExportImagesThread::jobId() const
+{
+    return m_jobId;
+}
+
+void ExportImagesThread::runDetail()
+{
+    if (m_jobs.isEmpty()) {
+        emit sigExportFinished(m_jobId, 0, 0);
+        return;
+    }
+
+    QList<ExportJob> copyJobs;
+    QList<ExportJob> transcodeJobs;
+    for (const ExportJob &job : std::as_const(m_jobs)) {
+        if (job.format.isEmpty()) {
+            copyJobs << job;
+        } else {
+            transcodeJobs << job;
+        }
+    }
+
+    // 大文件优先复制，目标设备一开始就有连续的大块写入，小文件和编码结果在后面填补空隙
+    std::stable_sort(copyJobs.begin(), copyJobs.end(), [](const ExportJob &a, const ExportJob &b) {
+        return a.size > b.size;
+    });
+
+    qInfo() << "Export job" << m_jobId << "started, copy:" << copyJobs.size() << "transcode:" << transcodeJobs.size();
+    emit sigExportProgress(m_jobId, 0, m_jobs.size());
+
+    // 编码受 CPU 限制，复制受目标设备限制，分别在两个线程池中执行，互不阻塞
+    QThreadPool encodePool;
+    encodePool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+    for (const ExportJob &job : std::as_const(transcodeJobs)) {
+        encodePool.start([this, job]() { exportJob(job); });
+    }
+
+    QThreadPool copyPool;
+    copyPool.setMaxThreadCount(sc_ExportCopyStreams);
+    for (const ExportJob &job : std::as_const(copyJobs)) {
+        copyPool.start([this, job]() { exportJob(job); });
+    }
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+    qint64 lastBytes = 0;
+    qint64 lastSpeedTime = 0;
+    int lastDone = 0;
+    bool running = true;
+    while (running) {
+        const bool copying = !copyPool.waitForDone(100);
+        const bool encoding = !encodePool.waitForDone(100);
+        running = copying || encoding;
+
+        const int done = m_doneCount.loadRelaxed();
+        if (done != lastDone) {
+            lastDone = done;
+            emit sigExportProgress(m_jobId, done, m_jobs.size());
+        }
+
+        const qint64 now = elapsed.elapsed();
+        if (now - lastSpeedTime >= 1000) {
+            const qint64 bytes = m_writtenBytes.loadRelaxed();
+            emit sigExportSpeed(m_jobId, (bytes - lastBytes) * 1000 / (now - lastSpeedTime));
+            lastBytes = bytes;
+            lastSpeedTime = now;
+        }
+    }
+
+    // 取消后未开始的任务计为失败
+    const int failed = m_jobs.size() - m_doneCount.loadRelaxed() + m_failedCount.loadRelaxed();
+    const qint64 cost = qMax<qint64>(1, elapsed.elapsed());
+    qInfo() << "Export job" << m_jobId << "finished, failed:" << failed << "bytes:" << m_writtenBytes.loadRelaxed()
+            << "cost:" << cost << "ms" << "speed:" << m_writtenBytes.loadRelaxed() * 1000 / cost / 1024 << "KiB/s";
+    emit sigExportFinished(m_jobId, m_jobs.size() - failed, failed);
+}
+
+/**
+   @brief 在复制或编码线程中执行，目标位置已有文件时先删除，失败或取消时删除不完整的目标文件
+ */
+void ExportImagesThread::exportJob(const ExportJob &job)
+{
+    if (bneedstop) {
+        return;
+    }
+
+    //目标位置与原图位置相同则直接跳过
+    bool bRet = true;
+    if (job.srcPath != job.dstPath) {
+        if (QFile::exists(job.dstPath) && !QFile::remove(job.dstPath)) {
+            qWarning() << "Failed to remove existing target file:" << job.dstPath;
+            bRet = false;
+        } else {
+            bRet = job.format.isEmpty() ? copyFile(job) : transcodeFile(job);
+            if (!bRet) {
+                QFile::remove(job.dstPath);
+            }
+        }
+    }
 
+    if (!bRet) {
+        m_failedCount.ref();
+    }
+    m_doneCount.ref();
 }
 
-void ImagesClassifyThread::setData(const DBImgInfoList &infos)
+bool ExportImagesThread::copyFile(const ExportJob &job)
 {
-    m_infos = infos;
+    QFile in(job.srcPath);
+    QFile out(job.dstPath);
+    if (!in.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+        qWarning() << "Failed to open source file:" << job.srcPath << in.errorString();
+        return false;
+    }
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) {
+        qWarning() << "Failed to open target file:" << job.dstPath << out.errorString();
+        return false;
+    }
+
+    if (!copyFileData(in, out, 0, in.size(), m_writtenBytes, bneedstop)) {
+        return false;
+    }
+
+    if (bneedstop) {
+        qInfo() << "Export canceled:" << job.srcPath;
+        return false;
+    }
+    return true;
+}
+
+bool ExportImagesThread::transcodeFile(const ExportJob &job)
+{
+    QImage image;
+    QString errMsg;
+    if (!LibUnionImage_NameSpace::loadStaticImageFromFile(job.srcPath, image, errMsg)) {
+        qWarning() << "Failed to load image for export:" << job.srcPath << errMsg;
+        return false;
+    }
+    if (bneedstop) {
+        return false;
+    }
+
+    QImageWriter writer(job.dstPath, job.format.toUpper().toLatin1());
+    applyEncoderSettings(writer, job.format, job.quality);
+    if (!writer.write(image)) {
+        qWarning() << "Failed to write image:" << job.dstPath << writer.errorString();
+        return false;
+    }
+
+    m_writtenBytes.fetchAndAddRelaxed(QFileInfo(job.dstPath).size());
+    return true;
+}
+
+static const int sc_TrashConcurrency = 4;   // 并行备份删除文件的线程数
+
+TrashImagesThread::TrashImagesThread()
+{
+    connect(this, &TrashImagesThread::sigDeleteProgress, AlbumControl::instance(), &AlbumControl::sigDeleteProgress);
+}
+
+TrashImagesThread::~TrashImagesThread()
+{
+}
+
+void TrashImagesThread::setData(const QStringList &paths)
+{
+    m_paths = paths;
+}
+
+void TrashImagesThread::runDetail()
+{
+    // 跳过不可写文件
+    QStringList removePaths;
+    for (const QString &path : std::as_const(m_paths)) {
+        if (QFileInfo(path).isWritable()) {
+            removePaths << path;
+        }
+    }
+    const int total = removePaths.size();
+    qInfo() << "Trash" << total << "files, skipped" << m_paths.size() - total << "non-writable files";
+
+    // 进度按百分比节流，避免大量删除时堆积界面事件
+    const int progressStep = qMax(1, total / 100);
+    QStringList trashPaths;
+    QMutex trashPathsMutex;
+    QAtomicInt finished { 0 };
+
+    //锁定文件操作权限
+    DBManager::m_fileMutex.lockForWrite();
+    {
+        QThreadPool filePool;
+        filePool.setMaxThreadCount(sc_TrashConcurrency);
+        for (const QString &path : std::as_const(removePaths)) {
+            filePool.start([&, path]() {
+                if (backupAndTrashFile(path)) {
+                    QMutexLocker locker(&trashPathsMutex);
+                    trashPaths << path;
+                }
+                const int value = finished.fetchAndAddRelaxed(1) + 1;
+                if (0 == value % progressStep || value == total) {
+                    emit sigDeleteProgress(value, total);
+                }
+            });
+        }
+        filePool.waitForDone();
+    }
+    DBManager::m_fileMutex.unlock();
+
+    //数据库记录一次性移动
+    DBManager::instance()->moveImgInfosToTrash(trashPaths, removePaths);
+
+    // notify show progress end
+    emit sigDeleteProgress(total + 1, total);
+
+    // 通知前端刷新相关界面，包括自定义相册/我的收藏/合集-所有项目/已导入
+    emit AlbumControl::instance()->sigRefreshCustomAlbum(-1);
+    emit AlbumControl::instance()->sigRefreshAllCollection();
+    emit AlbumControl::instance()->sigRefreshImportAlbum();
+    emit AlbumControl::instance()->sigRefreshSearchView();
+}
+
+/**
+   @brief 备份文件到相册删除目录并移入系统回收站，外部设备等位置的文件只备份
+   @return 是否需要在最近删除中保留记录
+ */
+bool TrashImagesThread::backupAndTrashFile(const QString &path)
+{
+    if (!QFile::exists(path)) {
+        return true;
+    }
+
+    const QString hash = LibUnionImage_NameSpace::hashByString(path);
+    LibUnionImage_NameSpace::syncCopy(path, LibUnionImage_NameSpace::getDeleteFullPath(hash, QFileInfo(path).fileName()));
+
+    if (DBManager::isExternalTrashPath(path)) {
+        return false;
+    }
+
+    // 回收站中的文件名查重不是线程安全的，移动操作串行执行
+    static QMutex s_trashMutex;
+    QMutexLocker locker(&s_trashMutex);
+    LibUnionImage_NameSpace::trashFile(path);
+    return true;
+}
+
+static const int sc_ClassifyBatchSize = 100;   // 每次从队列取出的任务数
+static const int sc_ClassifyMaxRetry = 3;      // 分类失败后的最大重试次数
+static const int sc_ClassifyRetryDelay = 60;   // 首次重试的等待秒数，之后每次加倍
+
+ImagesClassifyThread::ImagesClassifyThread()
+{
+
+}
+
+ImagesClassifyThread::~ImagesClassifyThread()
+{
+
 }
 
 void ImagesClassifyThread::runDetail()
 {
-    int infoCount = m_infos.size();
-
-    emit AlbumControl::instance()->progressOfImageClassify(infoCount, 0);
-    int i = 0 ;
-    for (auto &info : m_infos) {
-        if (info.className.isEmpty()) {
-            QFileInfo srcfi(info.filePath);
-            if (srcfi.exists() && Libutils::base::isSupportClassify(info.filePath) && srcfi.isReadable())
-                info.className = Classifyutils::GetInstance()->imageClassify(info.filePath.toStdString().c_str());
-            else
-                info.className = "";
-            if (info.className.isEmpty() && srcfi.isReadable())
-                info.className = "Other";
-
-            emit AlbumControl::instance()->progressOfImageClassify(infoCount, i++);
+    ClassifyScheduler *scheduler = ClassifyScheduler::instance();
+
+    // 后台低优先级运行，保持少量异步请求，忙碌时暂停发起新请求
+    ClassifyPipeline pipeline;
+    pipeline.setMaxInFlight(2);
+    pipeline.setCommitInterval(50, 5000);
+    pipeline.setPauseCheck([scheduler, &pipeline]() {
+        if (scheduler->isStopped()) {
+            pipeline.stop();
+            return false;
+        }
+        return scheduler->isBusy();
+    });
+    // 退出时调度器在主线程等待本线程结束，直接通知流水线放弃未返回的请求
+    connect(scheduler, &ClassifyScheduler::stopRequested, &pipeline, &ClassifyPipeline::stop, Qt::DirectConnection);
+    if (scheduler->isStopped())
+        return;
+    connect(&pipeline, &ClassifyPipeline::batchCommitted, scheduler, [scheduler](const DBImgInfoList &infos) {
+        DBManager::instance()->finishClassifyTasks(infos, DBImgInfoList(), sc_ClassifyMaxRetry, sc_ClassifyRetryDelay);
+        emit scheduler->classifyUpdated();
+    }, Qt::DirectConnection);
+    connect(&pipeline, &ClassifyPipeline::batchFailed, scheduler, [](const DBImgInfoList &infos) {
+        DBManager::instance()->finishClassifyTasks(DBImgInfoList(), infos, sc_ClassifyMaxRetry, sc_ClassifyRetryDelay);
+    }, Qt::DirectConnection);
+
+    // 每次取出一小批，忙碌或退出时剩余任务留在队列中等待下次调度
+    int processed = 0;
+    while (!scheduler->isStopped() && !scheduler->isBusy()) {
+        const DBImgInfoList infos = DBManager::instance()->takeClassifyTasks(sc_ClassifyBatchSize);
+        if (infos.isEmpty()) {
+            // 队列已处理完，本轮确有分类时通知界面
+            if (processed > 0)
+                emit scheduler->classifyFinished();
+            break;
         }
+
+        qDebug() << "Classify" << infos.size() << "queued images";
+        pipeline.exec(infos);
+        processed += infos.size();
+    }
+}
+
+static const int sc_TrashPurgeBatchSize = 200;   // 每批清理的到期记录数
+
+PurgeExpiredTrashThread::PurgeExpiredTrashThread()
+{
+
+}
+
+PurgeExpiredTrashThread::~PurgeExpiredTrashThread()
+{
+
+}
+
+void PurgeExpiredTrashThread::runDetail()
+{
+    TrashExpiryScheduler *scheduler = TrashExpiryScheduler::instance();
+    const qint64 deadline = QDateTime::currentSecsSinceEpoch();
+
+    // 分批删除，每批单独提交，忙碌或退出时剩余的记录留到下次处理
+    int purgedCount = 0;
+    while (!scheduler->isStopped() && !ClassifyScheduler::instance()->isBusy()) {
+        const QStringList paths = DBManager::instance()->getExpiredTrashPaths(deadline, sc_TrashPurgeBatchSize);
+        if (paths.isEmpty())
+            break;
+
+        DBManager::instance()->removeTrashImgInfos(paths);
+        purgedCount += paths.size();
     }
-    DBManager::instance()->updateClassName2DB(m_infos);
 
-    m_infos.clear();
+    // 原文件和删除缓存中的备份都已不存在的记录无法恢复，一并清理，使最近删除的计数与列表一致
+    if (!scheduler->isStopped() && !ClassifyScheduler::instance()->isBusy()) {
+        QStringList lostPaths;
+        const DBImgInfoList trashInfos = DBManager::instance()->getAllTrashInfos(false);
+        for (const DBImgInfo &info : trashInfos) {
+            if (scheduler->isStopped())
+                break;
+            if (!DBManager::isTrashFileAvailable(info.filePath, info.pathHash))
+                lostPaths << info.filePath;
+        }
+        for (int i = 0; i < lostPaths.size() && !scheduler->isStopped(); i += sc_TrashPurgeBatchSize) {
+            const QStringList paths = lostPaths.mid(i, sc_TrashPurgeBatchSize);
+            DBManager::instance()->removeTrashImgInfos(paths);
+            purgedCount += paths.size();
+        }
+        if (!lostPaths.isEmpty()) {
+            qInfo() << "Removed" << lostPaths.size() << "unrecoverable items from trash";
+        }
+    }
 
-    emit AlbumControl::instance()->sigImageClassifyFinished();
+    if (purgedCount > 0) {
+        qInfo() << "Purged" << purgedCount << "expired items from trash";
+        emit scheduler->trashPurged(purgedCount);
+    }
 }
@@ -15,6 +15,7 @@
 #include <QMutex>
 #include <QUrl>
 #include <QWaitCondition>
+#include <QElapsedTimer>
 
 class ImageEngineThreadObject;
 
@@ -82,19 +83,140 @@ private:
     bool m_checkRepeat = true;
 };
 
+//从外部设备导入文件线程，多路并行复制，复制过程中解析元数据并分批写入数据库
+class ImportFromDeviceThread : public ImageEngineThreadObject
+{
+    Q_OBJECT
+public:
+    ImportFromDeviceThread();
+    ~ImportFromDeviceThread() override;
+    void setData(const QStringList &paths, const int UID);
+    // 导入的源文件是否位于 \a devicePath 下，用于设备卸载时取消导入
+    bool isImportingFrom(const QString &devicePath) const;
+
+protected:
+    void runDetail() override;
+
+signals:
+    //导入进度信号
+    void sigImportProgress(int value, int max = 100);
+    //导入速度，单位字节/秒
+    void sigImportSpeed(qint64 bytesPerSecond);
+
+private:
+    struct CopyJob {
+        QString srcPath;
+        QString dstPath;
+        bool isVideo = false;
+        qint64 size = 0;
+    };
+
+    void copyJob(const CopyJob &job);
+    bool copyFile(const CopyJob &job, QByteArray &head);
+    DBImgInfo fileDBInfo(const CopyJob &job, const QByteArray &head) const;
+    void commitFinished(bool force);
+
+private:
+    QStringList m_paths;
+    int m_UID = -1;
+
+    QAtomicInteger<qint64> m_copiedBytes { 0 };
+    QAtomicInt m_failedCount { 0 };
+    QAtomicInt m_doneCount { 0 };       //已处理完成的文件数，包括失败的文件
+    QMutex m_resultMutex;
+    DBImgInfoList m_finishedInfos;      //已复制但未写入数据库的文件
+    int m_committedCount = 0;
+    QElapsedTimer m_commitTimer;
+};
+
+//删除图片到最近删除线程，文件备份和移入回收站并行执行，数据库记录在一个事务中移动
+class TrashImagesThread : public ImageEngineThreadObject
+{
+    Q_OBJECT
+public:
+    TrashImagesThread();
+    ~TrashImagesThread() override;
+    void setData(const QStringList &paths);
+
+protected:
+    void runDetail() override;
+
+signals:
+    //删除进度信号
+    void sigDeleteProgress(int value, int max = 100);
+
+private:
+    bool backupAndTrashFile(const QString &path);
+
+private:
+    QStringList m_paths;
+};
+
+//导出任务，format 为空时直接复制原文件
+struct ExportJob {
+    QString srcPath;
+    QString dstPath;
+    QString format;
+    int quality = -1;
+    qint64 size = 0;
+};
+
+//导出图片线程，格式转换在多个编码线程中执行，普通文件按大小排序后多路复制，均可取消
+class ExportImagesThread : public ImageEngineThreadObject
+{
+    Q_OBJECT
+public:
+    explicit ExportImagesThread(int jobId);
+    ~ExportImagesThread() override;
+    void setData(const QList<ExportJob> &jobs);
+    int jobId() const;
+
+protected:
+    void runDetail() override;
+
+signals:
+    //导出进度信号
+    void sigExportProgress(int jobId, int value, int max);
+    //导出速度，单位字节/秒
+    void sigExportSpeed(int jobId, qint64 bytesPerSecond);
+    void sigExportFinished(int jobId, int succeeded, int failed);
+
+private:
+    void exportJob(const ExportJob &job);
+    bool copyFile(const ExportJob &job);
+    bool transcodeFile(const ExportJob &job);
+
+private:
+    int m_jobId = -1;
+    QList<ExportJob> m_jobs;
+
+    QAtomicInteger<qint64> m_writtenBytes { 0 };
+    QAtomicInt m_failedCount { 0 };
+    QAtomicInt m_doneCount { 0 };       //已处理完成的文件数，包括失败的文件
+};
+
+//从数据库分类队列中分批取出任务进行分类，由 ClassifyScheduler 调度
 class ImagesClassifyThread : public ImageEngineThreadObject
 {
     Q_OBJECT
 public:
     ImagesClassifyThread();
     ~ImagesClassifyThread() override;
-    void setData(const DBImgInfoList &infos);
 
 protected:
     void runDetail() override;
+};
 
-private:
-    DBImgInfoList m_infos;
+//分批清理最近删除中已到期的文件和记录，由 TrashExpiryScheduler 调度
+class PurgeExpiredTrashThread : public ImageEngineThreadObject
+{
+    Q_OBJECT
+public:
+    PurgeExpiredTrashThread();
+    ~PurgeExpiredTrashThread() override;
+
+protected:
+    void runDetail() override;
 };
 
 #endif // IMAGEENGINETHREAD_H
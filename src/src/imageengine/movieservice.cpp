@@ -5,6 +5,8 @@
 
 #include "movieservice.h"
 #include "unionimage/unionimage.h"
+#include "dbmanager/dbmanager.h"
+#include "utils/perfmetrics.h"
 #include <QMetaType>
 #include <QDirIterator>
 #include <QStandardPaths>
@@ -13,6 +15,7 @@
 #include <memory>
 #include <QtDebug>
 #include <QGuiApplication>
+#include <QThread>
 
 extern "C" {
 #include <libavformat/avformat.h>
@@ -145,101 +148,181 @@ MovieService *MovieService::instance(QObject *parent)
 
 MovieInfo MovieService::getMovieInfo(const QUrl &url)
 {
+    ALBUM_TRACE_SCOPE(logDecode, "movie.info");
     qDebug() << "Getting movie info for URL:" << url.toString();
     MovieInfo result;
+    result.valid = false;
 
-    m_bufferMutex.lock();
-    auto iter = std::find_if(m_movieInfoBuffer.begin(), m_movieInfoBuffer.end(), [url](const std::pair<QUrl, MovieInfo> &data) {
-        return data.first == url;
-    });
-    if (iter != m_movieInfoBuffer.end()) {
-        qDebug() << "Found movie info in cache for URL:" << url.toString();
-        m_bufferMutex.unlock();
-        return iter->second;
+    if (!url.isLocalFile()) {
+        return result;
     }
-    m_bufferMutex.unlock();
 
-    if (url.isLocalFile()) {
-        QFileInfo fi(LibUnionImage_NameSpace::localPath(url));
+    QFileInfo fi(LibUnionImage_NameSpace::localPath(url));
+    if (!fi.exists()) {
+        qWarning() << "File does not exist:" << fi.filePath();
+        return result;
+    }
 
-        if (fi.exists()) {
-            qDebug() << "Parsing movie info from file:" << fi.filePath();
-            auto filePath = fi.filePath();
-            result = parseFromFile(fi);
-        } else {
-            qWarning() << "File does not exist:" << fi.filePath();
-        }
+    if (lookupMovieInfo(fi, result)) {
+        return result;
     }
 
-    m_bufferMutex.lock();
-    m_movieInfoBuffer.push_back(std::make_pair(url, result));
-    if (m_movieInfoBuffer.size() > 30) {
-        qDebug() << "Movie info buffer exceeded 30 items, removing oldest entry";
-        m_movieInfoBuffer.pop_front();
+    qDebug() << "Parsing movie info from file:" << fi.filePath();
+    AVFormatContext *av_ctx = openInput(fi);
+    if (av_ctx) {
+        result = parseFromContext(fi, av_ctx);
+        g_mvideo_avformat_close_input(&av_ctx);
     }
-    m_bufferMutex.unlock();
+    storeMovieInfo(fi, result);
 
     return result;
 }
 
 QImage MovieService::getMovieCover(const QUrl &url)
 {
+    MovieInfo info;
+    return getMovieCoverAndInfo(url, info);
+}
+
+/**
+   @brief 通过一次解封装同时获取视频 \a url 的首帧图片和视频信息 \a info ，
+    视频信息已缓存时仅用于生成首帧图片
+ */
+QImage MovieService::getMovieCoverAndInfo(const QUrl &url, MovieInfo &info)
+{
+    ALBUM_TRACE_SCOPE(logDecode, "movie.cover");
     qDebug() << "Getting movie cover for URL:" << url.toString();
-    QMutexLocker locker(&m_queuqMutex);
-    if (!m_bInitThumb) {
-        qDebug() << "Initializing thumbnail generator";
-        initThumb();
-        m_mvideo_thumbnailer_destroy_image_data(m_image_data);
-        m_image_data = nullptr;
-    }
+    info.valid = false;
 
-    if (m_creat_video_thumbnailer == nullptr
-            || m_mvideo_thumbnailer_destroy == nullptr
-            || m_mvideo_thumbnailer_create_image_data == nullptr
-            || m_mvideo_thumbnailer_destroy_image_data == nullptr
-            || m_mvideo_thumbnailer_generate_thumbnail_to_buffer == nullptr
-            || m_video_thumbnailer == nullptr) {
-        qWarning() << "Thumbnail generator not properly initialized";
+    QFileInfo fi(LibUnionImage_NameSpace::localPath(url));
+    if (!fi.exists()) {
+        qWarning() << "File does not exist:" << fi.filePath();
         return QImage();
     }
 
-    m_video_thumbnailer->thumbnail_size = static_cast<int>(THUMBNAIL_SIZE);
-    m_image_data = m_mvideo_thumbnailer_create_image_data();
-    QString file = QFileInfo(LibUnionImage_NameSpace::localPath(url)).absoluteFilePath();
-    qDebug() << "Generating thumbnail for file:" << file;
-    m_mvideo_thumbnailer_generate_thumbnail_to_buffer(m_video_thumbnailer, file.toUtf8().data(), m_image_data);
-    QImage img = QImage::fromData(m_image_data->image_data_ptr, static_cast<int>(m_image_data->image_data_size), "png");
-    m_mvideo_thumbnailer_destroy_image_data(m_image_data);
-    m_image_data = nullptr;
+    // 已知无法解析的文件不再解封装，首帧由缩略图生成器自行打开
+    bool needInfo = !lookupMovieInfo(fi, info);
+    AVFormatContext *av_ctx = (needInfo || info.valid) ? openInput(fi) : nullptr;
+    if (needInfo) {
+        if (av_ctx)
+            info = parseFromContext(fi, av_ctx);
+        storeMovieInfo(fi, info);
+    }
+
+    QImage img = generateCover(fi, av_ctx);
+    if (av_ctx) {
+        g_mvideo_avformat_close_input(&av_ctx);
+    }
+
     qDebug() << "Generated thumbnail size:" << img.size();
     return img;
 }
 
-MovieInfo MovieService::parseFromFile(const QFileInfo &fi)
+/**
+   @brief 从内存缓存或数据库中查找视频 \a fi 的信息，文件大小或修改时间变化时视为未命中。
+    解析失败的结果同样缓存在内存中，命中时返回 true 且 \a info 无效
+ */
+bool MovieService::lookupMovieInfo(const QFileInfo &fi, MovieInfo &info)
 {
-    qDebug() << "Parsing movie file:" << fi.filePath();
-    struct MovieInfo mi;
-    mi.valid = false;
-    AVFormatContext *av_ctx = nullptr;
-    AVCodecParameters *video_dec_ctx = nullptr;
-    AVCodecParameters *audio_dec_ctx = nullptr;
+    const QString key = fi.canonicalFilePath();
+    const qint64 modifyTime = fi.lastModified().toMSecsSinceEpoch();
+
+    {
+        QMutexLocker locker(&m_bufferMutex);
+        CachedMovieInfo *cached = m_movieInfoBuffer.object(key);
+        if (cached && cached->modifyTime == modifyTime && cached->info.fileSize == fi.size()) {
+            qDebug() << "Found movie info in cache for:" << key;
+            info = cached->info;
+            return true;
+        }
+    }
 
-    if (!fi.exists()) {
-        qWarning() << "File does not exist:" << fi.filePath();
-        return mi;
+    MovieInfo mi = fileBaseInfo(fi);
+    if (!DBManager::instance()->getMovieInfo(key, mi.fileSize, modifyTime, mi)) {
+        return false;
+    }
+
+    qDebug() << "Found movie info in database for:" << key;
+    mi.resolution = QString("%1x%2").arg(mi.width).arg(mi.height);
+    mi.proportion = 0 != mi.height ? static_cast<float>(mi.width) / static_cast<float>(mi.height) : 0;
+    mi.valid = true;
+
+    QMutexLocker locker(&m_bufferMutex);
+    m_movieInfoBuffer.insert(key, new CachedMovieInfo { mi, modifyTime });
+    info = mi;
+    return true;
+}
+
+/**
+   @brief 缓存解析得到的视频信息 \a info ，并持久化到数据库。
+    解析失败时按文件修改时间缓存在内存中，文件未变化前不再重复解析，不写入数据库
+ */
+void MovieService::storeMovieInfo(const QFileInfo &fi, const MovieInfo &info)
+{
+    if (!info.valid) {
+        const MovieInfo failed = fileBaseInfo(fi);
+        QMutexLocker locker(&m_bufferMutex);
+        m_movieInfoBuffer.insert(fi.canonicalFilePath(), new CachedMovieInfo { failed, fi.lastModified().toMSecsSinceEpoch() });
+        return;
+    }
+
+    const qint64 modifyTime = fi.lastModified().toMSecsSinceEpoch();
+    {
+        QMutexLocker locker(&m_bufferMutex);
+        m_movieInfoBuffer.insert(info.filePath, new CachedMovieInfo { info, modifyTime });
+    }
+
+    DBManager::instance()->insertMovieInfo(info, modifyTime);
+}
+
+/**
+   @return 返回打开并读取流信息后的视频 \a fi 的解封装上下文，失败返回 nullptr
+ */
+AVFormatContext *MovieService::openInput(const QFileInfo &fi)
+{
+    if (!g_mvideo_avformat_open_input || !g_mvideo_avformat_find_stream_info || !g_mvideo_avformat_close_input
+            || !g_mvideo_av_find_best_stream || !g_mvideo_av_dict_get) {
+        return nullptr;
     }
 
+    AVFormatContext *av_ctx = nullptr;
     auto ret = g_mvideo_avformat_open_input(&av_ctx, fi.filePath().toUtf8().constData(), nullptr, nullptr);
     if (ret < 0) {
         qWarning() << "Failed to open input file:" << fi.filePath();
-        return mi;
+        return nullptr;
     }
 
     if (g_mvideo_avformat_find_stream_info(av_ctx, nullptr) < 0) {
         qWarning() << "Failed to find stream info for file:" << fi.filePath();
-        return mi;
+        g_mvideo_avformat_close_input(&av_ctx);
+        return nullptr;
     }
 
+    return av_ctx;
+}
+
+/**
+   @return 返回视频文件 \a fi 中与解封装无关的基础信息
+ */
+MovieInfo MovieService::fileBaseInfo(const QFileInfo &fi)
+{
+    MovieInfo mi;
+    mi.valid = false;
+    mi.title = fi.fileName(); //FIXME this
+    mi.filePath = fi.canonicalFilePath();
+    mi.creation = fi.birthTime();
+    mi.fileSize = fi.size();
+    mi.fileType = fi.suffix();
+    return mi;
+}
+
+MovieInfo MovieService::parseFromContext(const QFileInfo &fi, AVFormatContext *av_ctx)
+{
+    qDebug() << "Parsing movie file:" << fi.filePath();
+    struct MovieInfo mi = fileBaseInfo(fi);
+    AVCodecParameters *video_dec_ctx = nullptr;
+    AVCodecParameters *audio_dec_ctx = nullptr;
+
     if (av_ctx->nb_streams == 0) {
         qWarning() << "No streams found in file:" << fi.filePath();
         return mi;
@@ -299,11 +382,6 @@ MovieInfo MovieService::parseFromFile(const QFileInfo &fi)
     duration = duration + (duration <= INT64_MAX - 5000 ? 5000 : 0);
     mi.duration = Time2str(duration / AV_TIME_BASE);
     mi.resolution = QString("%1x%2").arg(mi.width).arg(mi.height);
-    mi.title = fi.fileName(); //FIXME this
-    mi.filePath = fi.canonicalFilePath();
-    mi.creation = fi.birthTime();
-    mi.fileSize = fi.size();
-    mi.fileType = fi.suffix();
 
     AVDictionaryEntry *tag = nullptr;
 
@@ -314,16 +392,89 @@ MovieInfo MovieService::parseFromFile(const QFileInfo &fi)
         qDebug() << "Found creation time in metadata:" << mi.creation;
     }
 
-    g_mvideo_avformat_close_input(&av_ctx);
     mi.valid = true;
     qDebug() << "Successfully parsed movie file:" << fi.filePath();
     return mi;
 }
 
+/**
+   @brief 使用线程独占的缩略图生成器生成视频 \a fi 的首帧图片，
+    \a av_ctx 不为空时复用已打开的解封装上下文，避免重复打开文件
+ */
+QImage MovieService::generateCover(const QFileInfo &fi, AVFormatContext *av_ctx)
+{
+    ThumbnailerContext *context = acquireThumbnailer();
+    if (!context) {
+        qWarning() << "Thumbnail generator not properly initialized";
+        return QImage();
+    }
+
+    context->thumbnailer->av_format_context = av_ctx;
+    QString file = fi.absoluteFilePath();
+    qDebug() << "Generating thumbnail for file:" << file;
+    QImage img;
+    int ret = m_mvideo_thumbnailer_generate_thumbnail_to_buffer(context->thumbnailer, file.toUtf8().data(), context->data);
+    if (0 == ret && context->data->image_data_ptr) {
+        // 直接输出 RGB 数据，避免 PNG 编码后再解码
+        const int width = context->data->image_data_width;
+        const int height = context->data->image_data_height;
+        if (width > 0 && height > 0 && context->data->image_data_size >= width * height * 3) {
+            img = QImage(context->data->image_data_ptr, width, height, width * 3, QImage::Format_RGB888).copy();
+        }
+    }
+    context->thumbnailer->av_format_context = nullptr;
+
+    releaseThumbnailer(context);
+    return img;
+}
+
+/**
+   @brief 获取空闲的缩略图生成器，不足时创建新实例，达到上限时等待其它线程释放
+ */
+MovieService::ThumbnailerContext *MovieService::acquireThumbnailer()
+{
+    QMutexLocker locker(&m_queuqMutex);
+    if (!m_bInitThumb) {
+        qDebug() << "Initializing thumbnail generator";
+        initThumb();
+        if (!m_bInitThumb) {
+            return nullptr;
+        }
+    }
+
+    while (m_idleThumbnailers.isEmpty() && m_thumbnailerCount >= m_maxThumbnailerCount) {
+        m_thumbnailerCond.wait(&m_queuqMutex);
+    }
+
+    if (!m_idleThumbnailers.isEmpty()) {
+        return m_idleThumbnailers.takeLast();
+    }
+
+    video_thumbnailer *thumbnailer = m_creat_video_thumbnailer();
+    if (!thumbnailer) {
+        return nullptr;
+    }
+    thumbnailer->thumbnail_size = static_cast<int>(THUMBNAIL_SIZE);
+    thumbnailer->thumbnail_image_type = Rgb;
+
+    ++m_thumbnailerCount;
+    return new ThumbnailerContext { thumbnailer, m_mvideo_thumbnailer_create_image_data() };
+}
+
+void MovieService::releaseThumbnailer(ThumbnailerContext *context)
+{
+    QMutexLocker locker(&m_queuqMutex);
+    m_idleThumbnailers.append(context);
+    m_thumbnailerCond.wakeOne();
+}
+
 MovieService::MovieService(QObject *parent)
     : QObject(parent)
 {
     qDebug() << "Initializing MovieService";
+    m_movieInfoBuffer.setMaxCost(2000);
+    // 每个工作线程独占一个缩略图生成器
+    m_maxThumbnailerCount = qMax(2, QThread::idealThreadCount());
     initFFmpeg();
 }
 
@@ -336,19 +487,16 @@ void MovieService::initThumb()
     m_mvideo_thumbnailer_create_image_data = (mvideo_thumbnailer_create_image_data) library.resolve("video_thumbnailer_create_image_data");
     m_mvideo_thumbnailer_destroy_image_data = (mvideo_thumbnailer_destroy_image_data) library.resolve("video_thumbnailer_destroy_image_data");
     m_mvideo_thumbnailer_generate_thumbnail_to_buffer = (mvideo_thumbnailer_generate_thumbnail_to_buffer) library.resolve("video_thumbnailer_generate_thumbnail_to_buffer");
-    m_video_thumbnailer = m_creat_video_thumbnailer();
 
-    if (m_mvideo_thumbnailer_destroy == nullptr
+    if (m_creat_video_thumbnailer == nullptr
+            || m_mvideo_thumbnailer_destroy == nullptr
             || m_mvideo_thumbnailer_create_image_data == nullptr
             || m_mvideo_thumbnailer_destroy_image_data == nullptr
-            || m_mvideo_thumbnailer_generate_thumbnail_to_buffer == nullptr
-            || m_video_thumbnailer == nullptr) {
+            || m_mvideo_thumbnailer_generate_thumbnail_to_buffer == nullptr) {
         qWarning() << "Failed to resolve thumbnail generator functions";
         return;
     }
 
-    m_image_data = m_mvideo_thumbnailer_create_image_data();
-    m_video_thumbnailer->thumbnail_size = 400 * qApp->devicePixelRatio();
     m_bInitThumb = true;
     qDebug() << "Thumbnail generator initialized successfully";
 }
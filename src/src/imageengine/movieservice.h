@@ -11,12 +11,15 @@
 #include <QUrl>
 #include <QFileInfo>
 #include <QMutex>
+#include <QWaitCondition>
+#include <QCache>
 #include <mutex>
 #include <QDateTime>
-#include <deque>
 #include <QImage>
 #include <libffmpegthumbnailer/videothumbnailerc.h>
 
+struct AVFormatContext;
+
 typedef video_thumbnailer *(*mvideo_thumbnailer_create)();
 typedef void (*mvideo_thumbnailer_destroy)(video_thumbnailer *thumbnailer);
 /* create image_data structure */
@@ -96,8 +99,28 @@ public:
     MovieInfo   getMovieInfo(const QUrl &url);
     //获取视频首帧图片
     QImage      getMovieCover(const QUrl &url);
+    //一次解封装同时获取视频首帧图片和视频信息
+    QImage      getMovieCoverAndInfo(const QUrl &url, MovieInfo &info);
 private:
-    struct MovieInfo parseFromFile(const QFileInfo &fi);
+    // 缩略图生成器及其输出缓冲，每个工作线程独占一个
+    struct ThumbnailerContext {
+        video_thumbnailer *thumbnailer;
+        image_data *data;
+    };
+    // 内存中缓存的视频信息，修改时间用于校验是否过期
+    struct CachedMovieInfo {
+        MovieInfo info;
+        qint64 modifyTime;
+    };
+
+    struct MovieInfo parseFromContext(const QFileInfo &fi, AVFormatContext *av_ctx);
+    MovieInfo fileBaseInfo(const QFileInfo &fi);
+    AVFormatContext *openInput(const QFileInfo &fi);
+    bool lookupMovieInfo(const QFileInfo &fi, MovieInfo &info);
+    void storeMovieInfo(const QFileInfo &fi, const MovieInfo &info);
+    QImage generateCover(const QFileInfo &fi, AVFormatContext *av_ctx);
+    ThumbnailerContext *acquireThumbnailer();
+    void releaseThumbnailer(ThumbnailerContext *context);
     explicit MovieService(QObject *parent = nullptr);
     void initThumb();
     void initFFmpeg();
@@ -109,15 +132,17 @@ public:
 
 private:
     QMutex m_queuqMutex;
+    QWaitCondition m_thumbnailerCond;
     static MovieService *m_movieService;
     static std::once_flag instanceFlag;
     bool m_bInitThumb = false;
 
-    video_thumbnailer *m_video_thumbnailer = nullptr;
-    image_data *m_image_data = nullptr;
+    QList<ThumbnailerContext *> m_idleThumbnailers;
+    int m_thumbnailerCount = 0;
+    int m_maxThumbnailerCount = 2;
 
     QMutex m_bufferMutex;
-    std::deque<std::pair<QUrl, MovieInfo>> m_movieInfoBuffer;
+    QCache<QString, CachedMovieInfo> m_movieInfoBuffer;
 
     mvideo_thumbnailer_create m_creat_video_thumbnailer = nullptr;
     mvideo_thumbnailer_destroy m_mvideo_thumbnailer_destroy = nullptr;
@@ -0,0 +1,201 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "printdocument.h"
+#include "unionimage/unionimage.h"
+#include "imagedata/imagescaler.h"
+#include "utils/perfmetrics.h"
+
+#include <QFileInfo>
+#include <QImageReader>
+#include <QtConcurrent>
+#include <QDebug>
+
+static const int sc_CachePages = 3;       // 缓存的页面数，A4 300dpi 每页约 35 MiB
+static const int sc_PrefetchPages = 2;    // 预解码的后续页面数
+
+PrintDocument::PrintDocument()
+{
+    cache.setMaxCost(sc_CachePages);
+    prefetchPool.setMaxThreadCount(1);
+}
+
+PrintDocument::~PrintDocument()
+{
+    clear();
+}
+
+/**
+   @brief 设置打印的图片 \a paths ，仅读取文件头获取帧数，不解码图像
+ */
+void PrintDocument::setPaths(const QStringList &paths)
+{
+    clear();
+
+    QMutexLocker _locker(&mutex);
+    for (const QString &path : paths) {
+        if (!QFileInfo::exists(path)) {
+            qWarning() << "Skipping missing file for printing:" << path;
+            continue;
+        }
+
+        QImageReader reader(path);
+        const int count = reader.imageCount();
+        if (count > 1) {
+            qDebug() << "Found multi-page image with" << count << "pages";
+            for (int i = 0; i < count; ++i) {
+                m_pages.append({path, i});
+            }
+        } else {
+            m_pages.append({path, -1});
+        }
+    }
+    qDebug() << "Print document prepared with" << m_pages.size() << "pages";
+}
+
+/**
+   @brief 清空页面及缓存，等待进行中的预解码结束
+ */
+void PrintDocument::clear()
+{
+    prefetchPool.clear();
+    prefetchPool.waitForDone();
+
+    QMutexLocker _locker(&mutex);
+    pending.clear();
+    wanted.clear();
+    cache.clear();
+    m_pages.clear();
+}
+
+int PrintDocument::pageCount() const
+{
+    return m_pages.size();
+}
+
+QString PrintDocument::firstPath() const
+{
+    return m_pages.isEmpty() ? QString() : m_pages.first().path;
+}
+
+/**
+   @return 第 \a index 页适应 \a targetSize 的图像，依次查找缓存、等待预解码结果，均未命中时在当前线程解码
+ */
+QImage PrintDocument::page(int index, const QSize &targetSize)
+{
+    if (index < 0 || index >= m_pages.size()) {
+        return QImage();
+    }
+
+    const quint64 key = cacheKey(index, targetSize);
+    QFuture<QImage> future;
+    bool prefetched = false;
+    {
+        QMutexLocker _locker(&mutex);
+        if (QImage *image = cache.object(key)) {
+            ALBUM_COUNTER_INC("print.page.hit");
+            return *image;
+        }
+        prefetched = pending.contains(key);
+        if (prefetched) {
+            future = pending.take(key);
+        }
+    }
+
+    if (prefetched) {
+        ALBUM_COUNTER_INC("print.page.prefetched");
+    } else {
+        ALBUM_COUNTER_INC("print.page.miss");
+    }
+    QImage image = prefetched ? future.result() : QImage();
+    // 预解码任务开始前页面已不再需要时会直接返回空图像，此时在当前线程解码
+    if (image.isNull()) {
+        image = decodePage(m_pages.at(index), targetSize);
+    }
+    if (image.isNull()) {
+        qWarning() << "Failed to decode print page" << index << m_pages.at(index).path;
+        return image;
+    }
+
+    QMutexLocker _locker(&mutex);
+    cache.insert(key, new QImage(image), 1);
+    return image;
+}
+
+/**
+   @brief 在后台解码第 \a index 页之后的若干页，已缓存或正在解码的页面跳过，
+    不再需要的页面（翻页跳转或纸张尺寸变化）从 wanted 中移除，尚未开始的任务不再解码。
+    第 \a index 页本身保留在 wanted 中，其预解码结果留给随后的 page() 使用
+ */
+void PrintDocument::prefetch(int index, const QSize &targetSize)
+{
+    QMutexLocker _locker(&mutex);
+    wanted.clear();
+    for (int i = index; i <= index + sc_PrefetchPages && i < m_pages.size(); ++i) {
+        wanted.insert(cacheKey(i, targetSize));
+    }
+    // 已完成的预解码结果移入缓存，未完成且不再需要的任务丢弃
+    for (auto it = pending.begin(); it != pending.end();) {
+        if (it.value().isFinished()) {
+            const QImage image = it.value().result();
+            if (!image.isNull()) {
+                ALBUM_COUNTER_INC("print.page.prefetchCached");
+                cache.insert(it.key(), new QImage(image), 1);
+            }
+            it = pending.erase(it);
+        } else {
+            it = wanted.contains(it.key()) ? std::next(it) : pending.erase(it);
+        }
+    }
+
+    for (int i = index + 1; i <= index + sc_PrefetchPages && i < m_pages.size(); ++i) {
+        const quint64 key = cacheKey(i, targetSize);
+        if (cache.contains(key) || pending.contains(key)) {
+            continue;
+        }
+        const Page page = m_pages.at(i);
+        pending.insert(key, QtConcurrent::run(&prefetchPool, [this, key, page, targetSize]() {
+            {
+                QMutexLocker _locker(&mutex);
+                if (!wanted.contains(key)) {
+                    ALBUM_COUNTER_INC("print.page.prefetchSkipped");
+                    return QImage();
+                }
+            }
+            return decodePage(page, targetSize);
+        }));
+    }
+}
+
+/**
+   @return 解码 \a page 并缩小到适应 \a targetSize ，原图更小时保持原尺寸，由绘制时放大
+ */
+QImage PrintDocument::decodePage(const Page &page, const QSize &targetSize)
+{
+    ALBUM_TRACE_SCOPE(logDecode, "print.decodePage");
+    QImage image;
+    if (page.frameIndex >= 0) {
+        QImageReader reader(page.path);
+        reader.setAutoTransform(true);
+        if (reader.jumpToImage(page.frameIndex)) {
+            image = reader.read();
+        }
+    } else {
+        QString errMsg;
+        LibUnionImage_NameSpace::loadStaticImageFromFile(page.path, image, errMsg);
+    }
+
+    if (!image.isNull() && targetSize.isValid()
+            && (image.width() > targetSize.width() || image.height() > targetSize.height())) {
+        image = ImageScaler::scaled(image, targetSize, Qt::KeepAspectRatio);
+    }
+    return image;
+}
+
+quint64 PrintDocument::cacheKey(int index, const QSize &targetSize)
+{
+    // 页面尺寸随纸张、方向变化，一并作为键
+    return (static_cast<quint64>(index) << 32) | (static_cast<quint64>(targetSize.width() & 0xffff) << 16)
+           | static_cast<quint64>(targetSize.height() & 0xffff);
+}
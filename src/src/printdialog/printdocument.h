@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PRINTDOCUMENT_H
+#define PRINTDOCUMENT_H
+
+#include <QCache>
+#include <QFuture>
+#include <QImage>
+#include <QMap>
+#include <QMutex>
+#include <QSet>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVector>
+
+/**
+ * @brief 打印文档，每页对应一张图片或多页图片（如 TIFF）中的一帧。
+ *      只保存文件路径和帧索引，页面在预览或打印时按打印机的设备像素尺寸解码，
+ *      最近使用的少量页面保留在缓存中，并在后台预解码后续页面。
+ */
+class PrintDocument
+{
+public:
+    PrintDocument();
+    ~PrintDocument();
+
+    void setPaths(const QStringList &paths);
+    void clear();
+
+    int pageCount() const;
+    QString firstPath() const;
+
+    QImage page(int index, const QSize &targetSize);
+    void prefetch(int index, const QSize &targetSize);
+
+private:
+    struct Page {
+        QString path;
+        int frameIndex;     // 多帧图片的帧索引，单帧图片为 -1
+    };
+
+    static QImage decodePage(const Page &page, const QSize &targetSize);
+    static quint64 cacheKey(int index, const QSize &targetSize);
+
+private:
+    Q_DISABLE_COPY(PrintDocument)
+
+    QVector<Page> m_pages;
+    QMutex mutex;
+    QCache<quint64, QImage> cache;                  // 已解码页面，按页数计算容量
+    QMap<quint64, QFuture<QImage>> pending;         // 后台预解码中的页面
+    QSet<quint64> wanted;                           // 仍需要预解码的页面，任务开始解码前检查
+    QThreadPool prefetchPool;
+};
+
+#endif  // PRINTDOCUMENT_H
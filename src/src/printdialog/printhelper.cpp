@@ -102,37 +102,11 @@ void PrintHelper::showPrintDialog(const QStringList &paths, QWidget *parent)
 {
     Q_UNUSED(parent)
     qDebug() << "Showing print dialog for" << paths.size() << "files";
-    m_re->m_paths.clear();
-    m_re->m_imgs.clear();
-
     m_re->m_paths = paths;
-    QStringList tempExsitPaths;//保存存在的图片路径
-    QImage imgTemp;
-    for (const QString &path : paths) {
-        qDebug() << "Processing file for printing:" << path;
-        QString errMsg;
-        QImageReader imgReadreder(path);
-        if (imgReadreder.imageCount() > 1) {
-            qDebug() << "Found multi-page image with" << imgReadreder.imageCount() << "pages";
-            for (int imgindex = 0; imgindex < imgReadreder.imageCount(); imgindex++) {
-                imgReadreder.jumpToImage(imgindex);
-                m_re->m_imgs << imgReadreder.read();
-            }
-        } else {
-            //QImage不应该多次赋值，所以换到这里来，修复style问题
-            QImage img;
-            LibUnionImage_NameSpace::loadStaticImageFromFile(path, img, errMsg);
-            if (!img.isNull()) {
-                m_re->m_imgs << img;
-                qDebug() << "Added single image to print queue, size:" << img.size();
-            } else {
-                qWarning() << "Loaded image is null for file:" << path;
-            }
-        }
-        tempExsitPaths << paths;
-    }
+    // 只记录路径和帧索引，页面在预览或打印时按需解码
+    m_re->m_document.setPaths(paths);
 
-    qDebug() << "Total images prepared for printing:" << m_re->m_imgs.size();
+    qDebug() << "Total pages prepared for printing:" << m_re->m_document.pageCount();
     //看图采用同步,因为只有一张图片
     DPrintPreviewDialog printDialog2(nullptr);
 #if (DTK_VERSION_MAJOR > 5 \
@@ -140,17 +114,31 @@ void PrintHelper::showPrintDialog(const QStringList &paths, QWidget *parent)
     || (DTK_VERSION_MAJOR >= 5 && DTK_VERSION_MINOR >= 4 && DTK_VERSION_PATCH >= 10))//5.4.4暂时没有合入
     //增加运行时版本判断
     if (DApplication::runtimeDtkVersion() >= DTK_VERSION_CHECK(5, 4, 10, 0)) {
-        if (tempExsitPaths.count() > 0) {
+        if (m_re->m_document.pageCount() > 0) {
             //直接传递为路径,不会有问题
-            QString docName = QString(QFileInfo(tempExsitPaths.at(0)).completeBaseName());
+            QString docName = QString(QFileInfo(m_re->m_document.firstPath()).completeBaseName());
             docName = docName + ".pdf";
             printDialog2.setDocName(docName);
             qDebug() << "Set document name for printing:" << docName;
         }
     }
 #endif
-    connect(&printDialog2, SIGNAL(paintRequested(DPrinter *)),
-            m_re, SLOT(paintRequestSync(DPrinter *)));
+
+    bool asynPreview = false;
+#if (DTK_VERSION_MAJOR > 5 || (DTK_VERSION_MAJOR >= 5 && DTK_VERSION_MINOR >= 5))
+    // 异步预览只请求需要显示或打印的页面
+    if (DApplication::runtimeDtkVersion() >= DTK_VERSION_CHECK(5, 5, 0, 0)) {
+        asynPreview = printDialog2.setAsynPreview(m_re->m_document.pageCount());
+    }
+#endif
+    if (asynPreview) {
+        qDebug() << "Using asynchronous print preview";
+        connect(&printDialog2, SIGNAL(paintRequested(DPrinter *, const QVector<int> &)),
+                m_re, SLOT(paintRequestAsyn(DPrinter *, const QVector<int> &)));
+    } else {
+        connect(&printDialog2, SIGNAL(paintRequested(DPrinter *)),
+                m_re, SLOT(paintRequestSync(DPrinter *)));
+    }
 
 #ifndef USE_TEST
     qDebug() << "Executing print preview dialog";
@@ -160,7 +148,7 @@ void PrintHelper::showPrintDialog(const QStringList &paths, QWidget *parent)
     printDialog2.show();
 #endif
     m_re->m_paths.clear();
-    m_re->m_imgs.clear();
+    m_re->m_document.clear();
     qDebug() << "Print dialog closed";
 }
 
@@ -177,35 +165,13 @@ RequestedSlot::~RequestedSlot()
 
 void RequestedSlot::paintRequestSync(DPrinter *_printer)
 {
-    qDebug() << "Starting print job with" << m_imgs.size() << "images";
+    const int pageCount = m_document.pageCount();
+    qDebug() << "Starting print job with" << pageCount << "pages";
     //由于之前再度修改了打印的逻辑，导致了相同图片不在被显示，多余多页tiff来说不合理
     QPainter painter(_printer);
-    int indexNum = 0;
-    for (QImage img : m_imgs) {
-        if (!img.isNull()) {
-            qDebug() << "Printing image" << indexNum + 1 << "of" << m_imgs.size() << "size:" << img.size();
-            painter.setRenderHint(QPainter::Antialiasing);
-            painter.setRenderHint(QPainter::SmoothPixmapTransform);
-            QRectF wRect = _printer->pageRect(QPrinter::DevicePixel);
-            //修复bug98129，打印不完全问题，ratio应该是适应宽或者高，不应该直接适应宽
-            qreal ratio = 0.0;
-            qDebug() << "Page rectangle:" << wRect;
-            ratio = wRect.width() * 1.0 / img.width();
-            if (qreal(wRect.height() - img.height() * ratio) > 0) {
-                qDebug() << "Fitting image to width, ratio:" << ratio;
-                painter.drawImage(QRectF(0, abs(qreal(wRect.height() - img.height() * ratio)) / 2,
-                                         wRect.width(), img.height() * ratio), img);
-            } else {
-                ratio = wRect.height() * 1.0 / img.height();
-                qDebug() << "Fitting image to height, ratio:" << ratio;
-                painter.drawImage(QRectF(qreal(wRect.width() - img.width() * ratio) / 2, 0,
-                                         img.width() * ratio, wRect.height()), img);
-            }
-        } else {
-            qWarning() << "Skipping null image at index" << indexNum;
-        }
-        indexNum++;
-        if (indexNum != m_imgs.size()) {
+    for (int index = 0; index < pageCount; ++index) {
+        paintPage(painter, _printer, index);
+        if (index + 1 != pageCount) {
             qDebug() << "Adding new page for next image";
             _printer->newPage();
         }
@@ -214,3 +180,53 @@ void RequestedSlot::paintRequestSync(DPrinter *_printer)
     qDebug() << "Print job completed";
 }
 
+/**
+   @brief 异步预览及打印时只绘制 \a pageRange 中的页面，页码从 1 开始
+ */
+void RequestedSlot::paintRequestAsyn(DPrinter *_printer, const QVector<int> &pageRange)
+{
+    qDebug() << "Starting print job for" << pageRange.size() << "of" << m_document.pageCount() << "pages";
+    QPainter painter(_printer);
+    for (int i = 0; i < pageRange.size(); ++i) {
+        paintPage(painter, _printer, pageRange.at(i) - 1);
+        if (i + 1 != pageRange.size()) {
+            _printer->newPage();
+        }
+    }
+    painter.end();
+    qDebug() << "Print job completed";
+}
+
+/**
+   @brief 绘制第 \a index 页，图片按打印机设备像素尺寸解码，同时在后台预解码后续页面
+ */
+void RequestedSlot::paintPage(QPainter &painter, DPrinter *_printer, int index)
+{
+    QRectF wRect = _printer->pageRect(QPrinter::DevicePixel);
+    const QSize targetSize = wRect.size().toSize();
+    m_document.prefetch(index, targetSize);
+
+    const QImage img = m_document.page(index, targetSize);
+    if (img.isNull()) {
+        qWarning() << "Skipping null image at index" << index;
+        return;
+    }
+
+    qDebug() << "Printing image" << index + 1 << "of" << m_document.pageCount() << "size:" << img.size();
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    //修复bug98129，打印不完全问题，ratio应该是适应宽或者高，不应该直接适应宽
+    qreal ratio = 0.0;
+    qDebug() << "Page rectangle:" << wRect;
+    ratio = wRect.width() * 1.0 / img.width();
+    if (qreal(wRect.height() - img.height() * ratio) > 0) {
+        qDebug() << "Fitting image to width, ratio:" << ratio;
+        painter.drawImage(QRectF(0, abs(qreal(wRect.height() - img.height() * ratio)) / 2,
+                                 wRect.width(), img.height() * ratio), img);
+    } else {
+        ratio = wRect.height() * 1.0 / img.height();
+        qDebug() << "Fitting image to height, ratio:" << ratio;
+        painter.drawImage(QRectF(qreal(wRect.width() - img.width() * ratio) / 2, 0,
+                                 img.width() * ratio, wRect.height()), img);
+    }
+}
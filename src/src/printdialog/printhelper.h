@@ -5,6 +5,8 @@
 #ifndef PRINTHELPER_H
 #define PRINTHELPER_H
 
+#include "printdocument.h"
+
 #include <QObject>
 
 #include <dprintpreviewwidget.h>
@@ -20,10 +22,14 @@ public:
     ~RequestedSlot();
 private slots:
     void paintRequestSync(DPrinter *_printer);
+    void paintRequestAsyn(DPrinter *_printer, const QVector<int> &pageRange);
+
+private:
+    void paintPage(QPainter &painter, DPrinter *_printer, int index);
 
 public:
     QStringList m_paths;
-    QList<QImage> m_imgs;
+    PrintDocument m_document;   // 打印页面，按需解码
 };
 class PrintHelper : public QObject
 {
@@ -7,6 +7,9 @@
 #include "configsetter.h"
 #include "imageengine/movieservice.h"
 #include "dbmanager/dbmanager.h"
+#include "imagedata/collectioncovercache.h"
+#include "imagedata/derivativestore.h"
+#include "imagedata/imagescaler.h"
 #include <QPainter>
 
 const QString SETTINGS_GROUP = "Thumbnail";
@@ -29,7 +32,10 @@ QImage ThumbnailLoad::requestImage(const QString &id, QSize *size, const QSize &
     QMutexLocker _locker(&m_mutex);
     if (!m_imgMap.keys().contains(tempPath)) {
         qDebug() << "Loading new image:" << tempPath;
-        LibUnionImage_NameSpace::loadStaticImageFromFile(tempPath, Img, error);
+        Img = DerivativeStore::instance()->image(tempPath, QSize(100, 100), Qt::KeepAspectRatio);
+        if (Img.isNull()) {
+            LibUnionImage_NameSpace::loadStaticImageFromFile(tempPath, Img, error);
+        }
         if (!error.isEmpty()) {
             qWarning() << "Failed to load image:" << tempPath << "Error:" << error;
         }
@@ -650,66 +656,16 @@ int ImagePublisher::getLoadMode()
 QImage ImagePublisher::clipToRect(const QImage &src)
 {
     qDebug() << "Clipping image to rect";
-    auto tImg = src;
-
-    if (!tImg.isNull() && 0 != tImg.height() && 0 != tImg.width() && (tImg.height() / tImg.width()) < 10 && (tImg.width() / tImg.height()) < 10) {
-        bool cache_exist = false;
-        if (tImg.height() != THUMBNAIL_MAX_SIZE && tImg.width() != THUMBNAIL_MAX_SIZE) {
-            if (tImg.height() >= tImg.width()) {
-                cache_exist = true;
-                tImg = tImg.scaledToWidth(THUMBNAIL_MAX_SIZE,  Qt::FastTransformation);
-            } else if (tImg.height() <= tImg.width()) {
-                cache_exist = true;
-                tImg = tImg.scaledToHeight(THUMBNAIL_MAX_SIZE,  Qt::FastTransformation);
-            }
-        }
-        if (!cache_exist) {
-            if ((static_cast<float>(tImg.height()) / (static_cast<float>(tImg.width()))) > 3) {
-                tImg = tImg.scaledToWidth(THUMBNAIL_MAX_SIZE,  Qt::FastTransformation);
-            } else {
-                tImg = tImg.scaledToHeight(THUMBNAIL_MAX_SIZE,  Qt::FastTransformation);
-            }
-        }
-    }
-
-    if (!tImg.isNull()) {
-        qDebug() << "Clipping image is not null";
-        int width = tImg.width();
-        int height = tImg.height();
-        if (abs((width - height) * 10 / width) >= 1) {
-            QRect rect = tImg.rect();
-            int x = rect.x() + width / 2;
-            int y = rect.y() + height / 2;
-            if (width > height) {
-                x = x - height / 2;
-                y = 0;
-                tImg = tImg.copy(x, y, height, height);
-            } else {
-                y = y - width / 2;
-                x = 0;
-                tImg = tImg.copy(x, y, width, width);
-            }
-        }
-    }
-
-    qDebug() << "Clipping image to rect returning image";
-    return tImg;
+    // 短边缩放到缩略图尺寸并居中裁剪为方图，缩放与裁剪一次完成
+    return ImageScaler::clipToSquare(src, THUMBNAIL_MAX_SIZE);
 }
 
 //将图片按比例缩小
 QImage ImagePublisher::addPadAndScaled(const QImage &src)
 {
     qDebug() << "Adding pad and scaled image";
-    auto result = src.convertToFormat(QImage::Format_RGBA8888);
-
-    if (result.height() > result.width()) {
-        result = result.scaledToHeight(THUMBNAIL_MAX_SIZE, Qt::SmoothTransformation);
-    } else {
-        result = result.scaledToWidth(THUMBNAIL_MAX_SIZE, Qt::SmoothTransformation);
-    }
-
-    qDebug() << "Adding pad and scaled image returning image";
-    return result;
+    // 长边缩放到缩略图尺寸，格式转换在缩放时一并完成，不再转换整张原图
+    return ImageScaler::fitToEdge(src, THUMBNAIL_MAX_SIZE, QImage::Format_RGBA8888);
 }
 
 //图片请求类
@@ -750,16 +706,31 @@ QImage ImagePublisher::requestImage(const QString &id, QSize *size, const QSize
 
     if (requestedSize.width() > 0 && requestedSize.height() > 0) {
         qDebug() << "Scaling image to:" << requestedSize;
-        return image.scaled(requestedSize, Qt::KeepAspectRatio);
+        return ImageScaler::scaled(image, requestedSize, Qt::KeepAspectRatio);
     } else {
         return image;
     }
 }
 
 CollectionPublisher::CollectionPublisher()
-    : QQuickImageProvider(Image)
+    : QQuickAsyncImageProvider()
 {
     qDebug() << "Initializing CollectionPublisher";
+    // 封面解码以 IO 和缩放为主，少量线程即可，避免与缩略图加载争抢
+    pool.setMaxThreadCount(qBound(1, QThread::idealThreadCount() / 2, 4));
+}
+
+QQuickImageResponse *CollectionPublisher::requestImageResponse(const QString &id, const QSize &requestedSize)
+{
+    CollectionImageResponse *response = new CollectionImageResponse(id, requestedSize);
+    pool.start(response);
+    return response;
+}
+
+void CollectionImageResponse::run()
+{
+    m_image = CollectionPublisher::requestImage(m_id, nullptr, m_requestedSize);
+    emit finished();
 }
 
 //id: random_Y_2022_0 random_M_2022_6
@@ -770,7 +741,7 @@ QImage CollectionPublisher::requestImage(const QString &id, QSize *size, const Q
 
     QImage result;
 
-    if (id.size() < 4) {
+    if (id.size() < 4 || tokens.size() < 3) {
         qWarning() << "Invalid collection image ID:" << id;
         return result;
     }
@@ -779,7 +750,7 @@ QImage CollectionPublisher::requestImage(const QString &id, QSize *size, const Q
     if (type == "Y") {
         qDebug() << "Creating year image for:" << tokens[2];
         result = createYearImage(tokens[2]);
-    } else if (type == "M") {
+    } else if (type == "M" && tokens.size() > 3) {
         CollectionPublisher::ImageSize imageSize = static_cast<CollectionPublisher::ImageSize>(tokens[3].toInt());
         qDebug() << "Creating month cell image with size type:" << imageSize;
         result = createMonthCellImage(id.mid(id.indexOf("/")), imageSize);
@@ -790,7 +761,7 @@ QImage CollectionPublisher::requestImage(const QString &id, QSize *size, const Q
     }
     if (requestedSize.width() > 0 && requestedSize.height() > 0) {
         qDebug() << "Scaling collection image to:" << requestedSize;
-        return result.scaled(requestedSize, Qt::KeepAspectRatio);
+        return ImageScaler::scaled(result, requestedSize, Qt::KeepAspectRatio);
     } else {
         return result;
     }
@@ -806,20 +777,32 @@ QImage CollectionPublisher::createYearImage(const QString &year)
     }
     auto picPath = paths.at(0);
 
+    const QString key = CollectionCoverCache::makeKey("Y" + year, ImageSize_Full, picPath);
+    QImage image = CollectionCoverCache::instance()->find(key);
+    if (!image.isNull()) {
+        return image;
+    }
+
     //TODO: 异常处理：裂图问题
 
-    //加载原图
-    QImage image;
-    QString error;
-    LibUnionImage_NameSpace::loadStaticImageFromFile(picPath, image, error);
-    image = image.scaled(outputWidth, outputHeight, Qt::KeepAspectRatioByExpanding);
+    //按封面所需尺寸加载原图
+    image = CollectionCoverCache::loadScaledSource(picPath, QSize(outputWidth, outputHeight));
+    image = ImageScaler::scaled(image, QSize(outputWidth, outputHeight), Qt::KeepAspectRatioByExpanding, ImageScaler::Lanczos3);
 
+    CollectionCoverCache::instance()->insert(key, image);
     return image;
 }
 
 QImage CollectionPublisher::createMonthCellImage(const QString &path, const CollectionPublisher::ImageSize &sizeType)
 {
     qDebug() << "Creating month cell image for:" << path << "Size type:" << sizeType;
+    // 月视图请求中不含月份，同一文件同一尺寸的封面可在各月份间共用
+    const QString key = CollectionCoverCache::makeKey("M", sizeType, path);
+    QImage image = CollectionCoverCache::instance()->find(key);
+    if (!image.isNull()) {
+        return image;
+    }
+
     // 计算图片尺寸
     QSize requestSize(outputWidth, outputHeight);
     if (ImageSize_Full == sizeType)
@@ -835,18 +818,13 @@ QImage CollectionPublisher::createMonthCellImage(const QString &path, const Coll
     else if (ImageSize_Split_Fifth == sizeType)
         requestSize = QSize(outputWidth / 5, static_cast<int>(outputHeight * (1 - 0.618)));
 
-    //1.加载原图
-    QImage image;
-    QString error;
-    if (LibUnionImage_NameSpace::isVideo(path))
-        image = MovieService::instance()->getMovieCover(QUrl::fromLocalFile(path));
-    else
-        LibUnionImage_NameSpace::loadStaticImageFromFile(path, image, error);
-    image = image.scaled(outputWidth, outputHeight, Qt::KeepAspectRatioByExpanding);
+    //1.按封面所需尺寸加载原图
+    image = CollectionCoverCache::loadScaledSource(path, QSize(outputWidth, outputHeight));
 
-    // 2.根据比例裁剪
+    // 2.根据比例缩放并裁剪，缩放与裁剪一次完成
     image = clipHelper(image, requestSize.width(), requestSize.height());
 
+    CollectionCoverCache::instance()->insert(key, image);
     qDebug() << "Creating month cell image returning image";
     return image;
 }
@@ -855,43 +833,7 @@ QImage CollectionPublisher::createMonthCellImage(const QString &path, const Coll
 QImage CollectionPublisher::clipHelper(const QImage &image, int width, int height)
 {
     qDebug() << "Clipping image to:" << width << "Height:" << height;
-    QImage temp;
-    double x = 0;
-    double y = 0;
-
-    double resizeW = 0;
-    double resizeH = 0;
-    double widthF = width;
-    double heightF = height;
-    if (image.width() > image.height()) {
-        resizeH = heightF;
-        resizeW = image.width() / (image.height() / heightF);
-        if (resizeW < widthF) {
-            resizeH = resizeH * widthF / resizeW;
-            resizeW = widthF;
-            y = (resizeH - heightF) / 2;
-        } else {
-            x = (resizeW - widthF) / 2;
-        }
-    } else {
-        resizeW = widthF;
-        resizeH = image.height() / (image.width() / widthF);
-        if (resizeH < heightF) {
-            resizeW = resizeW * heightF / resizeH;
-            resizeH = heightF;
-            x = (resizeW - widthF) / 2;
-        } else {
-            y = (resizeH - heightF) / 2;
-        }
-    }
-
-    temp = image.scaled(static_cast<int>(resizeW), static_cast<int>(resizeH));
-
-    QRect rect(static_cast<int>(x), static_cast<int>(y), width, height);
-    QImage result(width, height, QImage::Format_RGB888);
-    result = temp.copy(rect);
-    qDebug() << "Clipping image returning image";
-    return result;
+    return ImageScaler::clipCentered(image, QSize(width, height));
 }
 
 void AsyncImageResponseAlbum::run()
@@ -925,7 +867,7 @@ void AsyncImageResponseAlbum::run()
 
     if (m_requestedSize.width() > 0 && m_requestedSize.height() > 0) {
         qDebug() << "Scaling async image to:" << m_requestedSize;
-        m_image = m_image.scaled(m_requestedSize, Qt::KeepAspectRatio);
+        m_image = ImageScaler::scaled(m_image, m_requestedSize, Qt::KeepAspectRatio);
     }
 
     emit finished();
@@ -935,65 +877,16 @@ void AsyncImageResponseAlbum::run()
 QImage AsyncImageResponseAlbum::clipToRect(const QImage &src)
 {
     qDebug() << "Clipping image to rect";
-    auto tImg = src;
-
-    if (!tImg.isNull() && 0 != tImg.height() && 0 != tImg.width() && (tImg.height() / tImg.width()) < 10 && (tImg.width() / tImg.height()) < 10) {
-        bool cache_exist = false;
-        if (tImg.height() != THUMBNAIL_MAX_SIZE && tImg.width() != THUMBNAIL_MAX_SIZE) {
-            if (tImg.height() >= tImg.width()) {
-                cache_exist = true;
-                tImg = tImg.scaledToWidth(THUMBNAIL_MAX_SIZE,  Qt::FastTransformation);
-            } else if (tImg.height() <= tImg.width()) {
-                cache_exist = true;
-                tImg = tImg.scaledToHeight(THUMBNAIL_MAX_SIZE,  Qt::FastTransformation);
-            }
-        }
-        if (!cache_exist) {
-            if ((static_cast<float>(tImg.height()) / (static_cast<float>(tImg.width()))) > 3) {
-                tImg = tImg.scaledToWidth(THUMBNAIL_MAX_SIZE,  Qt::FastTransformation);
-            } else {
-                tImg = tImg.scaledToHeight(THUMBNAIL_MAX_SIZE,  Qt::FastTransformation);
-            }
-        }
-    }
-
-    if (!tImg.isNull()) {
-        int width = tImg.width();
-        int height = tImg.height();
-        if (abs((width - height) * 10 / width) >= 1) {
-            QRect rect = tImg.rect();
-            int x = rect.x() + width / 2;
-            int y = rect.y() + height / 2;
-            if (width > height) {
-                x = x - height / 2;
-                y = 0;
-                tImg = tImg.copy(x, y, height, height);
-            } else {
-                y = y - width / 2;
-                x = 0;
-                tImg = tImg.copy(x, y, width, width);
-            }
-        }
-    }
-
-    qDebug() << "Clipping image to rect returning image";
-    return tImg;
+    // 短边缩放到缩略图尺寸并居中裁剪为方图，缩放与裁剪一次完成
+    return ImageScaler::clipToSquare(src, THUMBNAIL_MAX_SIZE);
 }
 
 //将图片按比例缩小
 QImage AsyncImageResponseAlbum::addPadAndScaled(const QImage &src)
 {
     qDebug() << "Adding pad and scaled image";
-    auto result = src.convertToFormat(QImage::Format_RGBA8888);
-
-    if (result.height() > result.width()) {
-        result = result.scaledToHeight(THUMBNAIL_MAX_SIZE, Qt::SmoothTransformation);
-    } else {
-        result = result.scaledToWidth(THUMBNAIL_MAX_SIZE, Qt::SmoothTransformation);
-    }
-
-    qDebug() << "Adding pad and scaled image returning image";
-    return result;
+    // 长边缩放到缩略图尺寸，格式转换在缩放时一并完成，不再转换整张原图
+    return ImageScaler::fitToEdge(src, THUMBNAIL_MAX_SIZE, QImage::Format_RGBA8888);
 }
 
 AsyncImageProviderAlbum::AsyncImageProviderAlbum(QObject *parent)
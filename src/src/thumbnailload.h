@@ -139,10 +139,10 @@ private:
     QImage m_damagedImage;
 };
 
-//聚合图
-class CollectionPublisher : public QQuickImageProvider
+//聚合图，封面在线程池中生成并由 CollectionCoverCache 缓存，滚动时重建的条目直接命中缓存
+class CollectionPublisher : public QQuickAsyncImageProvider
 {
-
+public:
     enum ImageSize {
         ImageSize_Full = 0,
         ImageSize_Half,
@@ -152,11 +152,12 @@ class CollectionPublisher : public QQuickImageProvider
         ImageSize_Split_Fifth,
     };
 
-public:
     explicit CollectionPublisher();
 
-protected:
-    QImage requestImage(const QString &id, QSize *size, const QSize &requestedSize) override;
+    QQuickImageResponse *requestImageResponse(const QString &id, const QSize &requestedSize) override;
+
+    //id: random_Y_2022_0 random_M_2022_6
+    static QImage requestImage(const QString &id, QSize *size, const QSize &requestedSize);
 
 private:
     //图片输出尺寸（黄金矩形）
@@ -164,11 +165,35 @@ private:
     static constexpr int outputHeight = 618;
 
     //图片裁剪策略
-    QImage createYearImage(const QString &year); //生成年视图
-    QImage createMonthCellImage(const QString &path, const CollectionPublisher::ImageSize &sizeType);
+    static QImage createYearImage(const QString &year); //生成年视图
+    static QImage createMonthCellImage(const QString &path, const CollectionPublisher::ImageSize &sizeType);
 
     //辅助裁剪函数
-    QImage clipHelper(const QImage &image, int width, int height);
+    static QImage clipHelper(const QImage &image, int width, int height);
+
+    QThreadPool pool;
+};
+
+class CollectionImageResponse : public QQuickImageResponse, public QRunnable
+{
+public:
+    CollectionImageResponse(const QString &id, const QSize &requestedSize)
+        : m_id(id), m_requestedSize(requestedSize)
+    {
+        setAutoDelete(false);
+    }
+
+    QQuickTextureFactory *textureFactory() const override
+    {
+        return QQuickTextureFactory::textureFactoryForImage(m_image);
+    }
+
+    void run() override;
+
+private:
+    QString m_id;
+    QSize m_requestedSize;
+    QImage m_image;
 };
 
 //异步缩略图_start
@@ -10,6 +10,8 @@
 
 #include <QUrl>
 
+static const int sc_TrashPageSize = 200;   // 最近删除每页加载的数量
+
 ImageDataModel::ImageDataModel(QObject *parent)
     : QAbstractListModel(parent)
     , m_modelType(Types::ModelType::Normal)
@@ -20,6 +22,7 @@ ImageDataModel::ImageDataModel(QObject *parent)
 {
     qDebug() << "Initializing ImageDataModel";
     connect(AlbumControl::instance(), &AlbumControl::deviceAlbumInfoLoadFinished, this, &ImageDataModel::onDeviceDataLoaded);
+    connect(AlbumControl::instance(), &AlbumControl::deviceAlbumInfoAppended, this, &ImageDataModel::onDeviceDataAppended);
 }
 
 QHash<int, QByteArray> ImageDataModel::roleNames() const
@@ -246,6 +249,8 @@ void ImageDataModel::loadData(Types::ItemType type)
         m_loadType = ItemTypeVideo;
 
     beginResetModel();
+    m_trashOffset = 0;
+    m_trashHasMore = false;
     if (m_modelType == Types::AllCollection) {
         qDebug() << "Loading all collection data";
         m_infoList = DBManager::instance()->getAllInfosSort(m_loadType);
@@ -254,14 +259,15 @@ void ImageDataModel::loadData(Types::ItemType type)
         m_infoList = DBManager::instance()->getInfosByAlbum(m_albumID, false, m_loadType);
     } else if (m_modelType == Types::RecentlyDeleted) {
         qDebug() << "Loading recently deleted data";
-        m_infoList = AlbumControl::instance()->getTrashInfos2(m_loadType);
+        // 只加载第一页，其余在视图滚动时通过 fetchMore 加载
+        m_infoList = AlbumControl::instance()->getTrashInfos2(m_loadType, 0, sc_TrashPageSize, &m_trashHasMore);
+        m_trashOffset = sc_TrashPageSize;
     } else if (m_modelType == Types::Device) {
         qDebug() << "Loading device data for path:" << m_devicePath;
         bool waiting = false;
         m_infoList = AlbumControl::instance()->getDeviceAlbumInfoList(m_devicePath, m_loadType, &waiting);
         if (waiting) {
-            m_infoList.clear();
-            qDebug() << "Device data not ready, refresh later";
+            qDebug() << "Device data still loading, showing" << m_infoList.size() << "items found so far";
         }
     } else if (m_modelType == Types::SearchResult) {
         qDebug() << "Loading search results for keyword:" << m_keyWord << "in album:" << m_albumID;
@@ -280,6 +286,30 @@ void ImageDataModel::loadData(Types::ItemType type)
     qDebug() << QString("loadData modelType:[%1] cost [%2]ms, loaded [%3] items").arg(m_modelType).arg(time.elapsed()).arg(m_infoList.size());
 }
 
+bool ImageDataModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (parent.isValid() || m_modelType != Types::RecentlyDeleted)
+        return false;
+
+    return m_trashHasMore;
+}
+
+void ImageDataModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent))
+        return;
+
+    // 当前页中的文件可能已不存在被过滤掉，以数据库中读取的行数判断是否读取完毕
+    DBImgInfoList infos = AlbumControl::instance()->getTrashInfos2(m_loadType, m_trashOffset, sc_TrashPageSize, &m_trashHasMore);
+    m_trashOffset += sc_TrashPageSize;
+    if (infos.isEmpty())
+        return;
+
+    beginInsertRows(QModelIndex(), m_infoList.size(), m_infoList.size() + infos.size() - 1);
+    m_infoList << infos;
+    endInsertRows();
+}
+
 void ImageDataModel::onDeviceDataLoaded(QString devicePath)
 {
     if (devicePath != m_devicePath) {
@@ -294,3 +324,24 @@ void ImageDataModel::onDeviceDataLoaded(QString devicePath)
 
     qDebug() << "Device data ready, refreshed model with" << m_infoList.size() << "items";
 }
+
+/**
+   @brief 设备扫描过程中追加新发现的文件，扫描完成后由 onDeviceDataLoaded 整体刷新排序
+ */
+void ImageDataModel::onDeviceDataAppended(const QString &devicePath, const DBImgInfoList &infos)
+{
+    if (m_modelType != Types::Device || devicePath != m_devicePath)
+        return;
+
+    DBImgInfoList appended;
+    for (const DBImgInfo &info : infos) {
+        if (ItemTypeNull == m_loadType || m_loadType == info.itemType)
+            appended << info;
+    }
+    if (appended.isEmpty())
+        return;
+
+    beginInsertRows(QModelIndex(), m_infoList.size(), m_infoList.size() + appended.size() - 1);
+    m_infoList << appended;
+    endInsertRows();
+}
@@ -27,6 +27,8 @@ public:
     QHash<int, QByteArray> roleNames() const override;
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
 
     Types::ModelType modelType() const;
     void setModelType(Types::ModelType modelType);
@@ -54,6 +56,7 @@ public:
     Q_INVOKABLE void loadData(Types::ItemType type = Types::All);
 
     Q_SLOT void onDeviceDataLoaded(QString devicePath);
+    Q_SLOT void onDeviceDataAppended(const QString &devicePath, const DBImgInfoList &infos);
 
 signals:
     void modelTypeChanged();
@@ -77,6 +80,8 @@ private:
     DBImgInfoList m_infoList;
 
     ItemType m_loadType{ItemTypeNull};
+    int m_trashOffset{0};        // 最近删除已读取到的数据库偏移
+    bool m_trashHasMore{false};  // 最近删除是否还有未加载的分页
 };
 
 #endif // IMAGELOCATIONMODEL_H
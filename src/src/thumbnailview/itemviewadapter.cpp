@@ -137,3 +137,18 @@ void ItemViewAdapter::setAdapterVisibleArea(QRect rect)
         Q_EMIT adapterVisibleAreaChanged();
     }
 }
+
+QSize ItemViewAdapter::adapterCellSize() const
+{
+    return m_adapterCellSize;
+}
+
+void ItemViewAdapter::setAdapterCellSize(QSize size)
+{
+    if (m_adapterCellSize != size) {
+        qDebug() << "Setting adapter cell size from" << m_adapterCellSize << "to" << size;
+        m_adapterCellSize = size;
+
+        Q_EMIT adapterCellSizeChanged();
+    }
+}
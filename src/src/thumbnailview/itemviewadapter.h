@@ -9,11 +9,11 @@
 
 #include <QObject>
 #include <QRect>
+#include <QSize>
 
 class QAbstractItemModel;
 class QModelIndex;
 class QPalette;
-class QSize;
 class ItemViewAdapter : public QObject
 {
     Q_OBJECT
@@ -22,6 +22,7 @@ class ItemViewAdapter : public QObject
     Q_PROPERTY(QAbstractItemModel *adapterModel READ adapterModel WRITE setAdapterModel NOTIFY adapterModelChanged)
     Q_PROPERTY(int adapterIconSize READ adapterIconSize WRITE setAdapterIconSize NOTIFY adapterIconSizeChanged)
     Q_PROPERTY(QRect adapterVisibleArea READ adapterVisibleArea WRITE setAdapterVisibleArea NOTIFY adapterVisibleAreaChanged)
+    Q_PROPERTY(QSize adapterCellSize READ adapterCellSize WRITE setAdapterCellSize NOTIFY adapterCellSizeChanged)
 
 public:
     enum Signal { ScrollBarValueChanged, IconSizeChanged };
@@ -47,18 +48,23 @@ public:
     QRect adapterVisibleArea() const;
     void setAdapterVisibleArea(QRect rect);
 
+    QSize adapterCellSize() const;
+    void setAdapterCellSize(QSize size);
+
 Q_SIGNALS:
     void viewScrolled() const;
     void adapterViewChanged() const;
     void adapterModelChanged() const;
     void adapterIconSizeChanged() const;
     void adapterVisibleAreaChanged() const;
+    void adapterCellSizeChanged() const;
 
 private:
     QObject *m_adapterView;
     QAbstractItemModel *m_adapterModel;
     int m_adapterIconSize;
     QRect m_adapterVisibleArea;
+    QSize m_adapterCellSize;
 };
 
 #endif
@@ -0,0 +1,287 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "thumbnailimageitem.h"
+
+#include <QQuickWindow>
+#include <QSGGeometryNode>
+#include <QSGTexture>
+#include <QSGTextureMaterial>
+#include <QtMath>
+#include <QDebug>
+
+static const int sc_CornerSegments = 6;  // 圆角的分段数
+
+/**
+   @class ThumbnailNode
+   @brief 缩略图的场景图节点，纹理来自场景图共享的纹理图集，
+    相同图集的节点使用相同材质，可由渲染器合并为少量绘制调用
+ */
+class ThumbnailNode : public QSGGeometryNode
+{
+public:
+    ThumbnailNode()
+        : geometry(QSGGeometry::defaultAttributes_TexturedPoint2D(), 0)
+    {
+        geometry.setDrawingMode(QSGGeometry::DrawTriangles);
+        setGeometry(&geometry);
+        setMaterial(&material);
+    }
+
+    QSGGeometry geometry;
+    QSGTextureMaterial material;
+    QSGOpaqueTextureMaterial opaqueMaterial;
+    QScopedPointer<QSGTexture> texture;
+};
+
+/**
+   @class ThumbnailImageItem
+   @brief 基于场景图的缩略图组件，替代逐个 QPainter 绘制的 QImageItem 。
+    图片仅在变更时上传到纹理图集，滚动时只更新节点位置，不重新光栅化；
+    圆角通过几何裁剪实现，无需额外的图层和遮罩。
+ */
+ThumbnailImageItem::ThumbnailImageItem(QQuickItem *parent)
+    : QQuickItem(parent)
+{
+    setFlag(ItemHasContents, true);
+    connect(this, &QQuickItem::smoothChanged, this, &QQuickItem::update);
+}
+
+ThumbnailImageItem::~ThumbnailImageItem()
+{
+}
+
+/**
+   @brief 设置缩略图 \a image ，与当前图片相同时不重新上传纹理
+ */
+void ThumbnailImageItem::setImage(const QImage &image)
+{
+    if (image.cacheKey() == m_image.cacheKey()) {
+        return;
+    }
+
+    bool oldImageNull = m_image.isNull();
+    QSize oldSize = m_image.size();
+    m_image = image;
+    m_textureDirty = true;
+
+    updatePaintedRect();
+    update();
+
+    if (oldSize != m_image.size()) {
+        Q_EMIT nativeWidthChanged();
+        Q_EMIT nativeHeightChanged();
+    }
+    Q_EMIT imageChanged();
+    if (oldImageNull != m_image.isNull()) {
+        Q_EMIT nullChanged();
+    }
+}
+
+QImage ThumbnailImageItem::image() const
+{
+    return m_image;
+}
+
+void ThumbnailImageItem::resetImage()
+{
+    setImage(QImage());
+}
+
+qreal ThumbnailImageItem::radius() const
+{
+    return m_radius;
+}
+
+void ThumbnailImageItem::setRadius(qreal radius)
+{
+    if (qFuzzyCompare(m_radius, radius)) {
+        return;
+    }
+
+    m_radius = radius;
+    m_geometryDirty = true;
+    update();
+    Q_EMIT radiusChanged();
+}
+
+int ThumbnailImageItem::nativeWidth() const
+{
+    return static_cast<int>(m_image.width() / m_image.devicePixelRatio());
+}
+
+int ThumbnailImageItem::nativeHeight() const
+{
+    return static_cast<int>(m_image.height() / m_image.devicePixelRatio());
+}
+
+int ThumbnailImageItem::paintedWidth() const
+{
+    return qRound(m_paintedRect.width());
+}
+
+int ThumbnailImageItem::paintedHeight() const
+{
+    return qRound(m_paintedRect.height());
+}
+
+ThumbnailImageItem::FillMode ThumbnailImageItem::fillMode() const
+{
+    return m_fillMode;
+}
+
+void ThumbnailImageItem::setFillMode(ThumbnailImageItem::FillMode mode)
+{
+    if (mode == m_fillMode) {
+        return;
+    }
+
+    m_fillMode = mode;
+    updatePaintedRect();
+    update();
+    Q_EMIT fillModeChanged();
+}
+
+bool ThumbnailImageItem::isNull() const
+{
+    return m_image.isNull();
+}
+
+/**
+   @brief 更新场景图节点，纹理仅在图片变更时重新创建，几何仅在尺寸变更时重建
+ */
+QSGNode *ThumbnailImageItem::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data)
+{
+    Q_UNUSED(data)
+    ThumbnailNode *node = static_cast<ThumbnailNode *>(oldNode);
+
+    if (m_image.isNull() || m_paintedRect.isEmpty()) {
+        delete node;
+        return nullptr;
+    }
+
+    if (!node) {
+        node = new ThumbnailNode;
+        m_textureDirty = true;
+    }
+
+    if (m_textureDirty) {
+        // 小尺寸图片由场景图放入共享纹理图集
+        node->texture.reset(window()->createTextureFromImage(m_image, QQuickWindow::TextureCanUseAtlas));
+        node->material.setTexture(node->texture.data());
+        node->opaqueMaterial.setTexture(node->texture.data());
+        // 带透明通道的图片不能使用不透明材质
+        node->setOpaqueMaterial(node->texture->hasAlphaChannel() ? nullptr : &node->opaqueMaterial);
+        node->markDirty(QSGNode::DirtyMaterial);
+        m_geometryDirty = true;
+        m_textureDirty = false;
+    }
+
+    const QSGTexture::Filtering filtering = smooth() ? QSGTexture::Linear : QSGTexture::Nearest;
+    if (node->material.filtering() != filtering) {
+        node->material.setFiltering(filtering);
+        node->opaqueMaterial.setFiltering(filtering);
+        node->markDirty(QSGNode::DirtyMaterial);
+    }
+
+    if (m_geometryDirty) {
+        const QRectF &rect = m_paintedRect;
+        const qreal r = qMax<qreal>(0, qMin(m_radius, qMin(rect.width(), rect.height()) / 2));
+
+        // 圆角矩形的轮廓点，按顺时针从左上角开始
+        QList<QPointF> outline;
+        if (r > 0) {
+            const QPointF centers[4] = { rect.topLeft() + QPointF(r, r), rect.topRight() + QPointF(-r, r),
+                                         rect.bottomRight() + QPointF(-r, -r), rect.bottomLeft() + QPointF(r, -r) };
+            for (int corner = 0; corner < 4; ++corner) {
+                const qreal startAngle = M_PI + corner * M_PI_2;
+                for (int i = 0; i <= sc_CornerSegments; ++i) {
+                    const qreal angle = startAngle + i * M_PI_2 / sc_CornerSegments;
+                    outline.append(centers[corner] + QPointF(r * qCos(angle), r * qSin(angle)));
+                }
+            }
+        } else {
+            outline << rect.topLeft() << rect.topRight() << rect.bottomRight() << rect.bottomLeft();
+        }
+
+        // 以中心点展开为独立三角形，便于渲染器合并批次
+        const QRectF subRect = node->texture->normalizedTextureSubRect();
+        auto texturePoint = [&](const QPointF &point, QSGGeometry::TexturedPoint2D *vertex) {
+            const qreal u = m_sourceRect.x() + (point.x() - rect.x()) / rect.width() * m_sourceRect.width();
+            const qreal v = m_sourceRect.y() + (point.y() - rect.y()) / rect.height() * m_sourceRect.height();
+            vertex->set(static_cast<float>(point.x()), static_cast<float>(point.y()),
+                        static_cast<float>(subRect.x() + u * subRect.width()),
+                        static_cast<float>(subRect.y() + v * subRect.height()));
+        };
+
+        node->geometry.allocate(outline.size() * 3);
+        QSGGeometry::TexturedPoint2D *vertices = node->geometry.vertexDataAsTexturedPoint2D();
+        const QPointF center = rect.center();
+        for (int i = 0; i < outline.size(); ++i) {
+            texturePoint(center, vertices++);
+            texturePoint(outline.at(i), vertices++);
+            texturePoint(outline.at((i + 1) % outline.size()), vertices++);
+        }
+
+        node->markDirty(QSGNode::DirtyGeometry);
+        m_geometryDirty = false;
+    }
+
+    return node;
+}
+
+void ThumbnailImageItem::geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChange(newGeometry, oldGeometry);
+    if (newGeometry.size() != oldGeometry.size()) {
+        updatePaintedRect();
+        update();
+    }
+}
+
+/**
+   @brief 根据填充模式计算图片绘制区域和对应的图片区域
+ */
+void ThumbnailImageItem::updatePaintedRect()
+{
+    QRectF destRect = boundingRect();
+    QRectF sourceRect(0, 0, 1, 1);
+
+    if (!m_image.isNull() && !destRect.isEmpty()) {
+        switch (m_fillMode) {
+        case PreserveAspectFit: {
+            QSizeF scaled = m_image.size();
+            scaled.scale(boundingRect().size(), Qt::KeepAspectRatio);
+            destRect = QRectF(QPointF(0, 0), scaled);
+            destRect.moveCenter(boundingRect().center());
+            break;
+        }
+        case PreserveAspectCrop: {
+            QSizeF scaled = m_image.size();
+            scaled.scale(boundingRect().size(), Qt::KeepAspectRatioByExpanding);
+            const qreal w = boundingRect().width() / scaled.width();
+            const qreal h = boundingRect().height() / scaled.height();
+            sourceRect = QRectF((1 - w) / 2, (1 - h) / 2, w, h);
+            break;
+        }
+        case Stretch:
+        default:
+            break;
+        }
+    }
+
+    m_sourceRect = sourceRect;
+    m_geometryDirty = true;
+    if (destRect != m_paintedRect) {
+        bool widthChanged = !qFuzzyCompare(destRect.width(), m_paintedRect.width());
+        bool heightChanged = !qFuzzyCompare(destRect.height(), m_paintedRect.height());
+        m_paintedRect = destRect;
+        if (widthChanged) {
+            Q_EMIT paintedWidthChanged();
+        }
+        if (heightChanged) {
+            Q_EMIT paintedHeightChanged();
+        }
+    }
+}
@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef THUMBNAILIMAGEITEM_H
+#define THUMBNAILIMAGEITEM_H
+
+#include <QImage>
+#include <QQuickItem>
+
+class ThumbnailImageItem : public QQuickItem
+{
+    Q_OBJECT
+
+    Q_PROPERTY(QImage image READ image WRITE setImage NOTIFY imageChanged RESET resetImage)
+    Q_PROPERTY(qreal radius READ radius WRITE setRadius NOTIFY radiusChanged)
+    Q_PROPERTY(int nativeWidth READ nativeWidth NOTIFY nativeWidthChanged)
+    Q_PROPERTY(int nativeHeight READ nativeHeight NOTIFY nativeHeightChanged)
+    Q_PROPERTY(int paintedWidth READ paintedWidth NOTIFY paintedWidthChanged)
+    Q_PROPERTY(int paintedHeight READ paintedHeight NOTIFY paintedHeightChanged)
+    Q_PROPERTY(FillMode fillMode READ fillMode WRITE setFillMode NOTIFY fillModeChanged)
+    Q_PROPERTY(bool null READ isNull NOTIFY nullChanged)
+
+public:
+    enum FillMode {
+        Stretch,            // the image is scaled to fit
+        PreserveAspectFit,  // the image is scaled uniformly to fit without cropping
+        PreserveAspectCrop, // the image is scaled uniformly to fill, cropping if necessary
+    };
+    Q_ENUM(FillMode)
+
+    explicit ThumbnailImageItem(QQuickItem *parent = nullptr);
+    ~ThumbnailImageItem() override;
+
+    void setImage(const QImage &image);
+    QImage image() const;
+    void resetImage();
+
+    qreal radius() const;
+    void setRadius(qreal radius);
+
+    int nativeWidth() const;
+    int nativeHeight() const;
+
+    int paintedWidth() const;
+    int paintedHeight() const;
+
+    FillMode fillMode() const;
+    void setFillMode(FillMode mode);
+
+    bool isNull() const;
+
+Q_SIGNALS:
+    void imageChanged();
+    void radiusChanged();
+    void nativeWidthChanged();
+    void nativeHeightChanged();
+    void paintedWidthChanged();
+    void paintedHeightChanged();
+    void fillModeChanged();
+    void nullChanged();
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+    void geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+
+private:
+    void updatePaintedRect();
+
+private:
+    QImage m_image;
+    qreal m_radius = 0;
+    FillMode m_fillMode = Stretch;
+    QRectF m_paintedRect;   // 图片在组件中的绘制区域
+    QRectF m_sourceRect;    // 绘制区域对应的图片区域，单位为归一化坐标
+    bool m_textureDirty = false;
+    bool m_geometryDirty = false;
+};
+
+#endif  // THUMBNAILIMAGEITEM_H
@@ -8,6 +8,8 @@
 #include "unionimage/baseutils.h"
 #include "imagedatamodel.h"
 #include "globalstatus.h"
+#include "utils/classifyscheduler.h"
+#include "utils/perfmetrics.h"
 
 #include <QDebug>
 #include <QIcon>
@@ -28,6 +30,13 @@ ThumbnailModel::ThumbnailModel(QObject *parent)
 
     // 图片数据服务有图片加载成功，通知model刷新界面
     connect(ImageDataService::instance(), &ImageDataService::gotImage, this, &ThumbnailModel::showPreview, Qt::ConnectionType::QueuedConnection);
+
+    // 滚动时节流上报可见区域，快速滑动时也能周期性地更新加载优先级
+    m_visibleHintTimer = new QTimer(this);
+    m_visibleHintTimer->setSingleShot(true);
+    m_visibleHintTimer->setInterval(50);
+    connect(m_visibleHintTimer, &QTimer::timeout, this, &ThumbnailModel::updateVisibleHint);
+    connect(this, &ThumbnailModel::srcModelReseted, this, &ThumbnailModel::scheduleVisibleHint);
 }
 
 ThumbnailModel::~ThumbnailModel()
@@ -57,9 +66,10 @@ void ThumbnailModel::setContainImages(bool value)
 void ThumbnailModel::showPreview(const QString &path)
 {
     // qDebug() << "ThumbnailModel::showPreview - Entry";
+    ALBUM_TRACE_SCOPE(logThumbnail, "model.showPreview");
     int idx = indexForFilePath(path);
     if (idx != -1) {
-        qDebug() << "Showing preview for path:" << path << "at index:" << idx;
+        qCDebug(logThumbnail) << "Showing preview for path:" << path << "at index:" << idx;
         dataChanged(index(idx, 0, QModelIndex()), index(idx, 0, QModelIndex()));
     }
 }
@@ -79,6 +89,68 @@ void ThumbnailModel::changeSelection(const QItemSelection &selected, const QItem
     // qDebug() << "ThumbnailModel::changeSelection - Exit";
 }
 
+void ThumbnailModel::scheduleVisibleHint()
+{
+    // 滚动浏览期间暂停后台分类
+    ClassifyScheduler::instance()->notifyActivity();
+
+    // 节流而非防抖：滑动过程中每个间隔至少上报一次
+    if (!m_visibleHintTimer->isActive())
+        m_visibleHintTimer->start();
+}
+
+void ThumbnailModel::updateVisibleHint()
+{
+    if (!m_viewAdapter || !m_viewAdapter->model())
+        return;
+
+    // 隐藏的视图不参与加载优先级竞争
+    QObject *view = m_viewAdapter->adapterView();
+    if (view && !view->property("visible").toBool())
+        return;
+
+    const QRect area = m_viewAdapter->visibleArea();
+    const QSize cellSize = m_viewAdapter->adapterCellSize();
+    if (area.isEmpty() || cellSize.width() <= 0 || cellSize.height() <= 0)
+        return;
+
+    QAbstractItemModel *viewModel = m_viewAdapter->model();
+    const int count = viewModel->rowCount();
+    if (count <= 0)
+        return;
+
+    // 根据网格布局计算可见行范围，行号为视图模型（Positioner）中的行号
+    const int perStripe = qMax(1, area.width() / cellSize.width());
+    const int firstRow = qMax(0, area.top() / cellSize.height()) * perStripe;
+    const int lastRow = qMin(count - 1, (area.bottom() / cellSize.height() + 1) * perStripe - 1);
+    if (firstRow > lastRow)
+        return;
+
+    // 按滚动方向向外预加载一屏
+    const bool scrollUp = area.top() < m_lastVisibleArea.top();
+    m_lastVisibleArea = area;
+    const int prefetchCount = lastRow - firstRow + 1;
+
+    auto pathAt = [viewModel](int row) {
+        return viewModel->index(row, 0).data(Roles::FilePathRole).toString();
+    };
+
+    QStringList visiblePaths;
+    for (int row = firstRow; row <= lastRow; row++)
+        visiblePaths.append(pathAt(row));
+
+    QStringList prefetchPaths;
+    if (scrollUp) {
+        for (int row = firstRow - 1; row >= qMax(0, firstRow - prefetchCount); row--)
+            prefetchPaths.append(pathAt(row));
+    } else {
+        for (int row = lastRow + 1; row <= qMin(count - 1, lastRow + prefetchCount); row++)
+            prefetchPaths.append(pathAt(row));
+    }
+
+    ImageDataService::instance()->setVisibleHint(visiblePaths, prefetchPaths, modelType() == Types::RecentlyDeleted);
+}
+
 QByteArray ThumbnailModel::sortRoleName() const
 {
     // qDebug() << "ThumbnailModel::sortRoleName - Entry";
@@ -197,8 +269,16 @@ void ThumbnailModel::setViewAdapter(QObject *adapter)
         qDebug() << "Setting view adapter from" << m_viewAdapter << "to" << adapter;
         ItemViewAdapter *abstractViewAdapter = dynamic_cast<ItemViewAdapter *>(adapter);
 
+        if (m_viewAdapter)
+            disconnect(m_viewAdapter.data(), nullptr, this, nullptr);
+
         m_viewAdapter = abstractViewAdapter;
 
+        if (m_viewAdapter) {
+            connect(m_viewAdapter.data(), &ItemViewAdapter::adapterVisibleAreaChanged, this, &ThumbnailModel::scheduleVisibleHint);
+            connect(m_viewAdapter.data(), &ItemViewAdapter::adapterCellSizeChanged, this, &ThumbnailModel::scheduleVisibleHint);
+        }
+
         Q_EMIT viewAdapterChanged();
     }
     // qDebug() << "ThumbnailModel::setViewAdapter - Exit";
@@ -375,9 +455,19 @@ void ThumbnailModel::unpinSelection()
     m_pinnedSelection = QItemSelection();
 }
 
+/**
+   @brief 分页加载的数据源（如最近删除）在全选或获取全部路径前加载剩余分页
+ */
+void ThumbnailModel::fetchAll()
+{
+    while (canFetchMore(QModelIndex()))
+        fetchMore(QModelIndex());
+}
+
 void ThumbnailModel::selectAll()
 {
     // qDebug() << "ThumbnailModel::selectAll - Entry";
+    fetchAll();
     setRangeSelected(0, rowCount() - 1);
 }
 
@@ -399,6 +489,7 @@ int ThumbnailModel::sourceIndex(const int &indexValue)
 QJsonArray ThumbnailModel::allUrls()
 {
     qDebug() << "ThumbnailModel::allUrls - Entry";
+    fetchAll();
     QJsonArray arr;
     for (int row = 0; row < rowCount(); row++)
         arr.append(QJsonValue(data(index(row, 0), Roles::UrlRole).toString()));
@@ -410,6 +501,7 @@ QJsonArray ThumbnailModel::allUrls()
 QStringList ThumbnailModel::allPictureUrls()
 {
     qDebug() << "ThumbnailModel::allPictureUrls - Entry";
+    fetchAll();
     QStringList pictureUrls;
     for (int row = 0; row < rowCount(); row++) {
         QModelIndex idx = index(row, 0);
@@ -425,6 +517,7 @@ QStringList ThumbnailModel::allPictureUrls()
 QJsonArray ThumbnailModel::allPaths()
 {
     qDebug() << "ThumbnailModel::allPaths - Entry";
+    fetchAll();
     QJsonArray arr;
     for (int row = 0; row < rowCount(); row++)
         arr.append(QJsonValue(data(index(row, 0), Roles::FilePathRole).toString()));
@@ -91,6 +91,8 @@ protected Q_SLOTS:
     void setContainImages(bool);
     void showPreview(const QString &path);
     void changeSelection(const QItemSelection &selected, const QItemSelection &deselected);
+    void scheduleVisibleHint();
+    void updateVisibleHint();
 
 signals:
     void containImagesChanged();
@@ -103,6 +105,7 @@ signals:
 private:
     void setStatus(Status status);
     QVariantList selectUrlsVariantList();
+    void fetchAll();
 
 private:
     QByteArray m_sortRoleName;
@@ -114,6 +117,9 @@ private:
     QPointer<ItemViewAdapter> m_viewAdapter;
 
     QTimer *m_previewTimer;
+    // 可见区域提示节流定时器
+    QTimer *m_visibleHintTimer;
+    QRect m_lastVisibleArea;
     QSize m_screenshotSize;
     bool m_containImages;
 };
@@ -0,0 +1,172 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "timelinesectionmodel.h"
+#include "dbmanager/dbmanager.h"
+#include "albumControl.h"
+
+#include <QDebug>
+
+// 0:全部 1:图片 2:视频
+static ItemType itemTypeFromFilter(int filterType)
+{
+    if (filterType == 1) {
+        return ItemTypePic;
+    } else if (filterType == 2) {
+        return ItemTypeVideo;
+    }
+    return ItemTypeNull;
+}
+
+TimelineSectionModel::TimelineSectionModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+QHash<int, QByteArray> TimelineSectionModel::roleNames() const
+{
+    auto hash = QAbstractItemModel::roleNames();
+    hash.insert(TitleRole, "title");
+    hash.insert(ItemCountRole, "itemCount");
+    return hash;
+}
+
+QVariant TimelineSectionModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_sections.size()) {
+        return {};
+    }
+
+    const Section &section = m_sections.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+    case TitleRole:
+        return section.title;
+    case ItemCountRole:
+        return section.itemCount;
+    default:
+        break;
+    }
+
+    return {};
+}
+
+int TimelineSectionModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return m_sections.size();
+}
+
+Types::TimelineSectionType TimelineSectionModel::sectionType() const
+{
+    return m_sectionType;
+}
+
+void TimelineSectionModel::setSectionType(Types::TimelineSectionType type)
+{
+    if (m_sectionType != type) {
+        m_sectionType = type;
+        emit sectionTypeChanged();
+    }
+}
+
+int TimelineSectionModel::filterType() const
+{
+    return m_filterType;
+}
+
+void TimelineSectionModel::setFilterType(int filterType)
+{
+    if (m_filterType != filterType) {
+        m_filterType = filterType;
+        emit filterTypeChanged();
+    }
+}
+
+int TimelineSectionModel::albumId() const
+{
+    return m_albumId;
+}
+
+void TimelineSectionModel::setAlbumId(int albumId)
+{
+    if (m_albumId != albumId) {
+        m_albumId = albumId;
+        emit albumIdChanged();
+    }
+}
+
+int TimelineSectionModel::count() const
+{
+    return m_sections.size();
+}
+
+int TimelineSectionModel::totalCount() const
+{
+    return m_totalCount;
+}
+
+void TimelineSectionModel::loadData()
+{
+    qDebug() << "TimelineSectionModel::loadData - sectionType:" << m_sectionType << "filterType:" << m_filterType;
+    QList<QPair<QString, DBImgInfoList>> sections;
+    switch (m_sectionType) {
+    case Types::SectionAlbum: {
+        DBImgInfoList infos = DBManager::instance()->getInfosByAlbum(m_albumId, false, itemTypeFromFilter(m_filterType));
+        if (!infos.isEmpty()) {
+            sections.append(qMakePair(DBManager::instance()->getAlbumNameFromUID(m_albumId), infos));
+        }
+        break;
+    }
+    case Types::SectionTrash: {
+        DBImgInfoList infos = AlbumControl::instance()->getTrashInfos(m_filterType);
+        if (!infos.isEmpty()) {
+            sections.append(qMakePair(QObject::tr("Trash"), infos));
+        }
+        break;
+    }
+    default:
+        sections = AlbumControl::instance()->getTimelineSections(static_cast<AlbumControl::TimeLineEnum>(m_sectionType), m_filterType);
+        break;
+    }
+
+    beginResetModel();
+    m_sections.clear();
+    m_sections.reserve(sections.size());
+    m_totalCount = 0;
+    for (const auto &section : sections) {
+        const int itemCount = static_cast<int>(section.second.size());
+        m_sections.append({section.first, itemCount});
+        m_totalCount += itemCount;
+    }
+    endResetModel();
+    emit countChanged();
+}
+
+void TimelineSectionModel::clear()
+{
+    beginResetModel();
+    m_sections.clear();
+    m_totalCount = 0;
+    endResetModel();
+    emit countChanged();
+}
+
+QString TimelineSectionModel::titleAt(int section) const
+{
+    if (section < 0 || section >= m_sections.size()) {
+        return QString();
+    }
+    return m_sections.at(section).title;
+}
+
+int TimelineSectionModel::itemCountAt(int section) const
+{
+    if (section < 0 || section >= m_sections.size()) {
+        return 0;
+    }
+    return m_sections.at(section).itemCount;
+}
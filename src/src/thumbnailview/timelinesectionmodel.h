@@ -0,0 +1,81 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef TIMELINESECTIONMODEL_H
+#define TIMELINESECTIONMODEL_H
+
+#include "types.h"
+
+#include <QAbstractListModel>
+#include <QVector>
+
+/**
+ * @brief 时间线/相册/最近删除的分组模型，每行对应一个分组，
+ *        只保存分组标题和数量，分组内的数据由各分组的 ImageDataModel 自行加载
+ */
+class TimelineSectionModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(Types::TimelineSectionType sectionType READ sectionType WRITE setSectionType NOTIFY sectionTypeChanged)
+    Q_PROPERTY(int filterType READ filterType WRITE setFilterType NOTIFY filterTypeChanged)
+    Q_PROPERTY(int albumId READ albumId WRITE setAlbumId NOTIFY albumIdChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(int totalCount READ totalCount NOTIFY countChanged)
+
+public:
+    enum SectionRoles {
+        TitleRole = Qt::UserRole + 1,
+        ItemCountRole,
+    };
+    Q_ENUM(SectionRoles)
+
+    explicit TimelineSectionModel(QObject *parent = nullptr);
+
+    QHash<int, QByteArray> roleNames() const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    Types::TimelineSectionType sectionType() const;
+    void setSectionType(Types::TimelineSectionType type);
+
+    // 0:全部 1:图片 2:视频
+    int filterType() const;
+    void setFilterType(int filterType);
+
+    // 仅 SectionAlbum 使用
+    int albumId() const;
+    void setAlbumId(int albumId);
+
+    int count() const;
+    int totalCount() const;
+
+    // 重新加载分组数据
+    Q_INVOKABLE void loadData();
+    Q_INVOKABLE void clear();
+
+    Q_INVOKABLE QString titleAt(int section) const;
+    Q_INVOKABLE int itemCountAt(int section) const;
+
+signals:
+    void sectionTypeChanged();
+    void filterTypeChanged();
+    void albumIdChanged();
+    void countChanged();
+
+private:
+    struct Section
+    {
+        QString title;
+        int itemCount{0};
+    };
+
+    Types::TimelineSectionType m_sectionType{Types::SectionAll};
+    int m_filterType{0};
+    int m_albumId{-1};
+
+    QVector<Section> m_sections;
+    int m_totalCount{0};
+};
+
+#endif // TIMELINESECTIONMODEL_H
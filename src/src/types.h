@@ -27,6 +27,7 @@ class Types : public QObject
 
     Q_ENUMS(MenuItemId)
     Q_ENUMS(WidgetViewType)
+    Q_ENUMS(TimelineSectionType)
 public:
     explicit Types(QObject *parent = nullptr);
     ~Types() override;
@@ -165,6 +166,17 @@ public:
         WidgetDayView,          // 日视图 QWidget控件
         WidgetImportedView      // 已导入视图 QWidget控件
     };
+
+    // 分组模型类型枚举，前五项与 AlbumControl::TimeLineEnum 取值一致
+    enum TimelineSectionType {
+        SectionAll = 0,         // 创建时间线
+        SectionYear,            // 年
+        SectionMonth,           // 月
+        SectionDay,             // 日
+        SectionImport,          // 已导入时间线
+        SectionAlbum,           // 单个相册，只有一个分组
+        SectionTrash            // 最近删除，只有一个分组
+    };
 };
 
 #endif  // TYPES_H
@@ -18,6 +18,8 @@
 #include <QMimeDatabase>
 #include <QtSvg/QSvgRenderer>
 #include <QDir>
+#include <QFile>
+#include <QSaveFile>
 #include <QDebug>
 #include <QtGlobal>
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
@@ -25,6 +27,7 @@
 #endif
 
 #include "unionimage/imageutils.h"
+#include "utils/perfmetrics.h"
 
 #include <cstring>
 
@@ -42,9 +45,9 @@ const QString DATETIME_FORMAT_EXIF = "yyyy:MM:dd HH:mm";
  */
 static QImage convertToSRgbColorSpace(const QImage &image)
 {
-    qDebug() << "convertToSRgbColorSpace - Function entry";
+    qCDebug(logDecode) << "convertToSRgbColorSpace - Function entry";
     if (image.isNull()) {
-        qDebug() << "convertToSRgbColorSpace - Branch: image is null, function exit";
+        qCDebug(logDecode) << "convertToSRgbColorSpace - Branch: image is null, function exit";
         return image;
     }
 
@@ -52,23 +55,23 @@ static QImage convertToSRgbColorSpace(const QImage &image)
 
     bool needsConversion = false;
     if (image.colorSpace().isValid()) {
-        qDebug() << "Image has color space:" << image.colorSpace().description();
+        qCDebug(logDecode) << "Image has color space:" << image.colorSpace().description();
 
         if (image.colorSpace() != srgbColorSpace) {
             needsConversion = true;
-            qDebug() << "Converting color space from" << image.colorSpace().description()
+            qCDebug(logDecode) << "Converting color space from" << image.colorSpace().description()
                                     << "to sRGB";
         }
     } else {
-        qDebug() << "Image has no valid color space, checking format for potential CMYK";
+        qCDebug(logDecode) << "Image has no valid color space, checking format for potential CMYK";
         if (image.format() == QImage::Format_CMYK8888) {
             needsConversion = true;
-            qDebug() << "CMYK format detected, attempting conversion";
+            qCDebug(logDecode) << "CMYK format detected, attempting conversion";
         }
     }
 
     if (!needsConversion) {
-        qDebug() << "No color space conversion needed";
+        qCDebug(logDecode) << "No color space conversion needed";
         return image;
     }
 
@@ -77,16 +80,16 @@ static QImage convertToSRgbColorSpace(const QImage &image)
     try {
         convertedImage = image.convertedToColorSpace(srgbColorSpace);
         if (!convertedImage.isNull()) {
-            qDebug() << "Color space conversion method 1 (convertedToColorSpace) succeeded";
+            qCDebug(logDecode) << "Color space conversion method 1 (convertedToColorSpace) succeeded";
         } else {
-            qDebug() << "Color space conversion method 1 failed";
+            qCDebug(logDecode) << "Color space conversion method 1 failed";
         }
     } catch (...) {
-        qDebug() << "Color space conversion method 1 threw exception";
+        qCDebug(logDecode) << "Color space conversion method 1 threw exception";
     }
 
     if (convertedImage.isNull()) {
-        qDebug() << "Trying color space conversion method 2: manual color space setting";
+        qCDebug(logDecode) << "Trying color space conversion method 2: manual color space setting";
 
         convertedImage = image.copy();
         convertedImage.setColorSpace(srgbColorSpace);
@@ -98,17 +101,17 @@ static QImage convertToSRgbColorSpace(const QImage &image)
         }
 
         if (!convertedImage.isNull()) {
-            qDebug() << "Color space conversion method 2 succeeded";
+            qCDebug(logDecode) << "Color space conversion method 2 succeeded";
         }
     }
 
     if (convertedImage.isNull()) {
-        qDebug() << "Trying color space conversion method 3: basic format conversion";
+        qCDebug(logDecode) << "Trying color space conversion method 3: basic format conversion";
         convertedImage = image.convertToFormat(QImage::Format_RGB888);
         convertedImage.setColorSpace(srgbColorSpace);
 
         if (!convertedImage.isNull()) {
-            qDebug() << "Color space conversion method 3 succeeded";
+            qCDebug(logDecode) << "Color space conversion method 3 succeeded";
         }
     }
 
@@ -117,7 +120,7 @@ static QImage convertToSRgbColorSpace(const QImage &image)
         return image;
     }
 
-    qDebug() << "convertToSRgbColorSpace - Function exit, returning converted image";
+    qCDebug(logDecode) << "convertToSRgbColorSpace - Function exit, returning converted image";
     return convertedImage;
 }
 #endif
@@ -130,7 +133,7 @@ class UnionImage_Private
 public:
     UnionImage_Private()
     {
-        qDebug() << "Initializing UnionImage_Private with supported formats";
+        qCDebug(logDecode) << "Initializing UnionImage_Private with supported formats";
         /*
          * 由于原设计方案采用多个key对应一个value的方案，在判断可读可写的过程中是通过value去找key因此造成了多种情况而在下方变量中未将key，写完整因此补全
          * */
@@ -207,13 +210,13 @@ public:
                    << "XPM"
                    << "ICO"
                    << "ICNS";
-        qDebug() << "Initialized with" << m_qtSupported.size() << "supported formats," 
+        qCDebug(logDecode) << "Initialized with" << m_qtSupported.size() << "supported formats," 
                  << m_canSave.size() << "saveable formats, and" 
                  << m_qtrotate.size() << "rotatable formats";
     }
     ~UnionImage_Private()
     {
-        qDebug() << "Destroying UnionImage_Private";
+        qCDebug(logDecode) << "Destroying UnionImage_Private";
     }
     QStringList m_qtSupported;
     QHash<QString, int> m_movie_formats;
@@ -230,25 +233,25 @@ static UnionImage_Private union_image_private;
  */
 UNIONIMAGESHARED_EXPORT QImage noneQImage()
 {
-    qDebug() << "Creating empty QImage";
+    qCDebug(logDecode) << "Creating empty QImage";
     static QImage none(0, 0, QImage::Format_Invalid);
     return none;
 }
 
 UNIONIMAGESHARED_EXPORT const QStringList unionImageSupportFormat()
 {
-    qDebug() << "Getting supported image formats";
+    qCDebug(logDecode) << "Getting supported image formats";
     static QStringList res;
     if (res.empty()) {
         QStringList list = union_image_private.m_qtSupported;
         res.append(list);
-        qDebug() << "Found" << res.size() << "supported formats";
+        qCDebug(logDecode) << "Found" << res.size() << "supported formats";
     }
     return res;
 }
 UNIONIMAGESHARED_EXPORT const QStringList videoFiletypes()
 {
-    qDebug() << "Getting supported video file types";
+    qCDebug(logDecode) << "Getting supported video file types";
     const QStringList m_videoFiletypes = {"avs2"/*支持avs2视频格式*/, "3g2", "3ga", "3gp", "3gp2"
                                           , "3gpp", "amv", "asf", "asx", "avf", "avi", "bdm"
                                           , "bdmv", "bik", "clpi", "cpi", "dat", "divx", "drc"
@@ -264,19 +267,19 @@ UNIONIMAGESHARED_EXPORT const QStringList videoFiletypes()
                                           , "tp", "trp", "ts", "tts", "txd", "vcd", "vdr", "vob"
                                           , "vp8", "vro", "webm", "wm", "wmv", "wtv", "xesc", "xspf"
                                          };
-    qDebug() << "Found" << m_videoFiletypes.size() << "supported video formats";
+    qCDebug(logDecode) << "Found" << m_videoFiletypes.size() << "supported video formats";
     return m_videoFiletypes;
 }
 
 UNIONIMAGESHARED_EXPORT const QStringList supportStaticFormat()
 {
-    qDebug() << "Getting supported static formats";
+    qCDebug(logDecode) << "Getting supported static formats";
     return (union_image_private.m_qtSupported);
 }
 
 UNIONIMAGESHARED_EXPORT const QStringList supportMovieFormat()
 {
-    qDebug() << "Getting supported movie formats";
+    qCDebug(logDecode) << "Getting supported movie formats";
     return (union_image_private.m_movie_formats.keys());
 }
 
@@ -289,7 +292,7 @@ UNIONIMAGESHARED_EXPORT const QStringList supportMovieFormat()
  */
 UNIONIMAGESHARED_EXPORT QString size2Human(const qlonglong bytes)
 {
-    qDebug() << "Converting size to human readable format:" << bytes << "bytes";
+    qCDebug(logDecode) << "Converting size to human readable format:" << bytes << "bytes";
     qlonglong kb = 1024;
     QString result;
     if (bytes < kb) {
@@ -317,7 +320,7 @@ UNIONIMAGESHARED_EXPORT QString size2Human(const qlonglong bytes)
             result = vs + " GB";
         }
     }
-    qDebug() << "Converted size:" << result;
+    qCDebug(logDecode) << "Converted size:" << result;
     return result;
 }
 
@@ -330,30 +333,30 @@ UNIONIMAGESHARED_EXPORT QString size2Human(const qlonglong bytes)
  */
 UNIONIMAGESHARED_EXPORT const QString getFileFormat(const QString &path)
 {
-    qDebug() << "Getting file format for:" << path;
+    qCDebug(logDecode) << "Getting file format for:" << path;
     QFileInfo fi(path);
     QString suffix = fi.suffix();
-    qDebug() << "File format:" << suffix;
+    qCDebug(logDecode) << "File format:" << suffix;
     return suffix;
 }
 
 UNIONIMAGESHARED_EXPORT bool canSave(const QString &path)
 {
-    qDebug() << "Checking if file can be saved:" << path;
+    qCDebug(logDecode) << "Checking if file can be saved:" << path;
     QImageReader r(path);
     if (r.imageCount() > 1) {
-        qDebug() << "File has multiple images, cannot save";
+        qCDebug(logDecode) << "File has multiple images, cannot save";
         return false;
     }
     QFileInfo info(path);
     bool canSave = union_image_private.m_canSave.contains(info.suffix().toUpper());
-    qDebug() << "File can be saved:" << canSave;
+    qCDebug(logDecode) << "File can be saved:" << canSave;
     return canSave;
 }
 
 UNIONIMAGESHARED_EXPORT QString unionImageVersion()
 {
-    qDebug() << "Getting UnionImage version";
+    qCDebug(logDecode) << "Getting UnionImage version";
     QString ver;
     ver.append("UnionImage Version:");
     ver.append("0.0.4");
@@ -363,7 +366,7 @@ UNIONIMAGESHARED_EXPORT QString unionImageVersion()
 
 UNIONIMAGESHARED_EXPORT bool creatNewImage(QImage &res, int width, int height, int depth, SupportType type)
 {
-    qDebug() << "Creating new image with dimensions:" << width << "x" << height << "depth:" << depth;
+    qCDebug(logDecode) << "Creating new image with dimensions:" << width << "x" << height << "depth:" << depth;
     Q_UNUSED(type);
     if (depth == 8) {
         res = QImage(width, height, QImage::Format_RGB888);
@@ -372,14 +375,15 @@ UNIONIMAGESHARED_EXPORT bool creatNewImage(QImage &res, int width, int height, i
     } else {
         res = QImage(width, height, QImage::Format_RGB32);
     }
-    qDebug() << "Created new image with format:" << res.format();
+    qCDebug(logDecode) << "Created new image with format:" << res.format();
     return true;
 }
 
 QString PrivateDetectImageFormat(const QString &filepath);
 UNIONIMAGESHARED_EXPORT bool loadStaticImageFromFile(const QString &path, QImage &res, QString &errorMsg, const QString &format_bar)
 {
-    qDebug() << "Loading static image from file:" << path;
+    ALBUM_TRACE_SCOPE(logDecode, "image.decode");
+    qCDebug(logDecode) << "Loading static image from file:" << path;
     QFileInfo file_info(path);
     if (file_info.size() == 0) {
         qWarning() << "File is empty:" << path;
@@ -406,24 +410,24 @@ UNIONIMAGESHARED_EXPORT bool loadStaticImageFromFile(const QString &path, QImage
         
         // 增加内存限制，支持加载大图片
         reader.setAllocationLimit(2048);
-        qDebug() << "Set QImageReader allocation limit to 2048MB";
+        qCDebug(logDecode) << "Set QImageReader allocation limit to 2048MB";
         
         QSize originalSize = reader.size();
         const int maxDimension = 4096;
         if (originalSize.width() > maxDimension || originalSize.height() > maxDimension) {
-            qDebug() << "Large image detected (" << originalSize.width() << "x" << originalSize.height()
+            qCDebug(logDecode) << "Large image detected (" << originalSize.width() << "x" << originalSize.height()
                                   << "), scaling down to max dimension:" << maxDimension;
             
             QSize scaledSize = originalSize;
             scaledSize.scale(maxDimension, maxDimension, Qt::KeepAspectRatio);
             reader.setScaledSize(scaledSize);
-            qDebug() << "Image scaled to:" << scaledSize;
+            qCDebug(logDecode) << "Image scaled to:" << scaledSize;
         }
         
         if (reader.imageCount() > 0 || file_suffix_upper != "ICNS") {
             res_qt = reader.read();
             if (res_qt.isNull()) {
-                qDebug() << "Failed to read image with QImageReader, trying alternative method";
+                qCDebug(logDecode) << "Failed to read image with QImageReader, trying alternative method";
                 QString format = PrivateDetectImageFormat(path);
                 QImageReader readerF(path, format.toLatin1());
                 QImage try_res;
@@ -460,7 +464,7 @@ UNIONIMAGESHARED_EXPORT bool loadStaticImageFromFile(const QString &path, QImage
             res = QImage();
             return false;
         }
-        qDebug() << "Successfully loaded image from file";
+        qCDebug(logDecode) << "Successfully loaded image from file";
         return true;
     }
     qWarning() << "Unsupported file format:" << file_suffix_upper;
@@ -469,7 +473,7 @@ UNIONIMAGESHARED_EXPORT bool loadStaticImageFromFile(const QString &path, QImage
 
 UNIONIMAGESHARED_EXPORT QString detectImageFormat(const QString &path)
 {
-    qDebug() << "Detecting image format for:" << path;
+    qCDebug(logDecode) << "Detecting image format for:" << path;
     QFile file(path);
     if (!file.open(QIODevice::ReadOnly)) {
         qWarning() << "Failed to open file for format detection:" << path;
@@ -563,13 +567,13 @@ UNIONIMAGESHARED_EXPORT QString detectImageFormat(const QString &path)
 
 UNIONIMAGESHARED_EXPORT bool isNoneQImage(const QImage &qi)
 {
-    qDebug() << "Checking if image is none QImage";
+    qCDebug(logDecode) << "Checking if image is none QImage";
     return (qi == noneQImage());
 }
 
 UNIONIMAGESHARED_EXPORT bool rotateImage(int angel, QImage &image)
 {
-    qDebug() << "Rotating image by" << angel << "degrees";
+    qCDebug(logDecode) << "Rotating image by" << angel << "degrees";
     if (angel % 90 != 0) {
         qWarning() << "Invalid rotation angle:" << angel;
         return false;
@@ -583,7 +587,7 @@ UNIONIMAGESHARED_EXPORT bool rotateImage(int angel, QImage &image)
         QTransform rotatematrix;
         rotatematrix.rotate(angel);
         image = image_copy.transformed(rotatematrix, Qt::SmoothTransformation);
-        qDebug() << "Successfully rotated image";
+        qCDebug(logDecode) << "Successfully rotated image";
         return true;
     }
     qWarning() << "Failed to create image copy for rotation";
@@ -598,7 +602,7 @@ UNIONIMAGESHARED_EXPORT bool rotateImage(int angel, QImage &image)
  */
 QImage adjustImageToRealPosition(const QImage &image, int orientation)
 {
-    qDebug() << "Adjusting image to real position with orientation:" << orientation;
+    qCDebug(logDecode) << "Adjusting image to real position with orientation:" << orientation;
     QImage result = image;
 
     switch (orientation) {
@@ -630,13 +634,244 @@ QImage adjustImageToRealPosition(const QImage &image, int orientation)
         break;
     };
 
-    qDebug() << "Successfully adjusted image position";
+    qCDebug(logDecode) << "Successfully adjusted image position";
     return result;
 }
 
+/**
+ * @brief JPEG 文件中 EXIF 方向标记的位置信息
+ */
+struct JpegOrientationInfo {
+    bool hasExif = false;       // 是否包含 EXIF APP1 段
+    qint64 valueOffset = -1;    // 方向标记值在文件中的偏移，-1 表示未找到
+    bool littleEndian = false;  // EXIF 字节序
+    int orientation = 1;        // 当前方向标记
+    qint64 insertOffset = 2;    // 无 EXIF 时新段的插入位置(SOI 或 JFIF APP0 之后)
+};
+
+static quint16 readExifUInt16(const char *data, bool littleEndian)
+{
+    const uchar *p = reinterpret_cast<const uchar *>(data);
+    return littleEndian ? quint16(p[0] | (p[1] << 8)) : quint16((p[0] << 8) | p[1]);
+}
+
+static quint32 readExifUInt32(const char *data, bool littleEndian)
+{
+    const uchar *p = reinterpret_cast<const uchar *>(data);
+    return littleEndian ? quint32(p[0] | (p[1] << 8) | (p[2] << 16) | (quint32(p[3]) << 24))
+                        : quint32((quint32(p[0]) << 24) | (p[1] << 16) | (p[2] << 8) | p[3]);
+}
+
+/**
+ * @brief 在 TIFF 数据中查找偏移 \a ifdOffset 处 IFD 的标签 \a tag
+ * 偏移均来自文件内容，全部按 qint64 与剩余长度比较，避免 quint32 相加回绕后越界读取
+ * @return 条目相对 TIFF 头的偏移，未找到或越界时返回 -1
+ */
+static qint64 findExifIfdEntry(const char *tiff, qint64 tiffSize, qint64 ifdOffset, quint16 tag, bool littleEndian)
+{
+    if (tiffSize < 2 || ifdOffset < 0 || ifdOffset > tiffSize - 2) {
+        return -1;
+    }
+    const qint64 count = readExifUInt16(tiff + ifdOffset, littleEndian);
+    // 条目数超出剩余数据时只遍历完整的条目
+    const qint64 available = (tiffSize - ifdOffset - 2) / 12;
+    const qint64 entries = qMin(count, available);
+    for (qint64 i = 0; i < entries; ++i) {
+        const qint64 entry = ifdOffset + 2 + i * 12;
+        if (readExifUInt16(tiff + entry, littleEndian) == tag) {
+            return entry;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief 仅解析 JPEG 文件头部的标记段，查找 EXIF 中 IFD0 的方向标记(0x0112)，不解码图像数据
+ * @return 文件为合法 JPEG 时返回 true
+ */
+static bool readJpegOrientation(QFile &file, JpegOrientationInfo &info)
+{
+    if (!file.seek(0) || file.read(2) != QByteArray("\xFF\xD8", 2)) {
+        return false;
+    }
+
+    bool firstSegment = true;
+    while (!file.atEnd()) {
+        char marker[2];
+        if (file.read(marker, 2) != 2 || uchar(marker[0]) != 0xFF) {
+            return true;
+        }
+        // 跳过填充字节
+        while (uchar(marker[1]) == 0xFF) {
+            if (!file.getChar(&marker[1])) {
+                return true;
+            }
+        }
+
+        const uchar type = uchar(marker[1]);
+        // 到达图像数据或文件结束，之后不会再有 EXIF 段
+        if (type == 0xDA || type == 0xD9) {
+            return true;
+        }
+        if (type == 0x01 || (type >= 0xD0 && type <= 0xD7)) {
+            continue;
+        }
+
+        char lengthData[2];
+        if (file.read(lengthData, 2) != 2) {
+            return true;
+        }
+        const quint16 length = readExifUInt16(lengthData, false);
+        if (length < 2) {
+            return true;
+        }
+        const qint64 segmentStart = file.pos();
+        const qint64 segmentEnd = segmentStart + length - 2;
+
+        if (firstSegment && type == 0xE0) {
+            // JFIF APP0 必须紧跟 SOI，新增的 EXIF 段放在其后
+            info.insertOffset = segmentEnd;
+        }
+        firstSegment = false;
+
+        if (type == 0xE1 && length >= 16) {
+            const QByteArray segment = file.read(length - 2);
+            // 文件截断时读到的数据可能不足 TIFF 头
+            if (segment.size() >= 14 && segment.startsWith(QByteArray("Exif\0\0", 6))) {
+                info.hasExif = true;
+
+                const char *tiff = segment.constData() + 6;
+                const qint64 tiffSize = segment.size() - 6;
+                if (tiff[0] == 'I' && tiff[1] == 'I') {
+                    info.littleEndian = true;
+                } else if (!(tiff[0] == 'M' && tiff[1] == 'M')) {
+                    return true;
+                }
+                if (readExifUInt16(tiff + 2, info.littleEndian) != 42) {
+                    return true;
+                }
+
+                // 方向标记类型为 SHORT，值直接存放在条目内
+                const qint64 entry = findExifIfdEntry(tiff, tiffSize, readExifUInt32(tiff + 4, info.littleEndian),
+                                                      0x0112, info.littleEndian);
+                if (entry >= 0 && readExifUInt16(tiff + entry + 2, info.littleEndian) == 3) {
+                    info.valueOffset = segmentStart + 6 + entry + 8;
+                    info.orientation = readExifUInt16(tiff + entry + 8, info.littleEndian);
+                }
+                return true;
+            }
+        }
+
+        if (!file.seek(segmentEnd)) {
+            return true;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief 计算方向标记 \a orientation 的图片再顺时针旋转 \a angel 度后的方向标记
+ */
+static int rotatedOrientation(int orientation, int angel)
+{
+    // 顺时针旋转90度后的方向标记，下标为当前方向标记
+    static const int clockwise[9] = {1, 6, 7, 8, 5, 2, 3, 4, 1};
+    if (orientation < 1 || orientation > 8) {
+        orientation = 1;
+    }
+
+    int steps = ((angel / 90) % 4 + 4) % 4;
+    while (steps-- > 0) {
+        orientation = clockwise[orientation];
+    }
+    return orientation;
+}
+
+/**
+ * @brief 无损旋转 JPEG 文件，仅改写 EXIF 方向标记而不重新编码图像数据。
+ *  已存在方向标记时原位改写两个字节；不存在 EXIF 时插入仅包含方向标记的 EXIF 段。
+ *  EXIF 存在但无方向标记时返回 false，由调用方使用重新编码的方式处理。
+ * @param angel     旋转角度
+ * @param path      源文件路径
+ * @param savePath  保存路径，可与源文件相同
+ */
+static bool rotateJpegByOrientation(int angel, const QString &path, const QString &savePath, QString &erroMsg)
+{
+    JpegOrientationInfo info;
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly) || !readJpegOrientation(file, info)) {
+            return false;
+        }
+    }
+    if (info.hasExif && info.valueOffset < 0) {
+        return false;
+    }
+
+    const int orientation = rotatedOrientation(info.orientation, angel);
+    const bool sameFile = QFileInfo(path) == QFileInfo(savePath);
+
+    if (info.valueOffset >= 0) {
+        // 保存到其它路径时先拷贝到临时文件，改写完成后替换，避免目标文件处于中间状态
+        QString writePath = savePath;
+        if (!sameFile) {
+            writePath = savePath + ".rotating";
+            QFile::remove(writePath);
+            if (!QFile::copy(path, writePath)) {
+                erroMsg = "copy file failed, path:" + path;
+                return false;
+            }
+        }
+
+        QFile file(writePath);
+        char value[2];
+        if (info.littleEndian) {
+            value[0] = char(orientation & 0xFF);
+            value[1] = char((orientation >> 8) & 0xFF);
+        } else {
+            value[0] = char((orientation >> 8) & 0xFF);
+            value[1] = char(orientation & 0xFF);
+        }
+        bool ret = file.open(QIODevice::ReadWrite) && file.seek(info.valueOffset) && file.write(value, 2) == 2;
+        file.close();
+
+        if (!sameFile) {
+            ret = ret && (!QFile::exists(savePath) || QFile::remove(savePath)) && QFile::rename(writePath, savePath);
+            QFile::remove(writePath);
+        }
+        if (!ret) {
+            erroMsg = "write exif orientation failed, path:" + savePath;
+        }
+        return ret;
+    }
+
+    // 插入仅包含方向标记的 EXIF 段(大端序，IFD0 仅一个条目)
+    QByteArray exif("\xFF\xE1\x00\x22" "Exif\0\0" "MM\x00\x2A\x00\x00\x00\x08" "\x00\x01"
+                    "\x01\x12\x00\x03\x00\x00\x00\x01", 28);
+    exif.append(char((orientation >> 8) & 0xFF));
+    exif.append(char(orientation & 0xFF));
+    exif.append(QByteArray("\x00\x00" "\x00\x00\x00\x00", 6));
+
+    QFile source(path);
+    if (!source.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QByteArray content = source.readAll();
+    source.close();
+    content.insert(info.insertOffset, exif);
+
+    QSaveFile target(savePath);
+    if (!target.open(QIODevice::WriteOnly) || target.write(content) != content.size() || !target.commit()) {
+        erroMsg = "write rotated jpeg failed, path:" + savePath;
+        return false;
+    }
+    return true;
+}
+
 UNIONIMAGESHARED_EXPORT bool rotateImageFIle(int angel, const QString &path, QString &erroMsg, const QString &targetPath)
 {
-    qDebug() << "Rotating image file:" << path << "by" << angel << "degrees";
+    qCDebug(logDecode) << "Rotating image file:" << path << "by" << angel << "degrees";
     if (angel % 90 != 0) {
         erroMsg = "unsupported angel";
         qWarning() << "Invalid rotation angle:" << angel;
@@ -645,11 +880,11 @@ UNIONIMAGESHARED_EXPORT bool rotateImageFIle(int angel, const QString &path, QSt
 
     // 保存文件路径，若未设置则保存至原文件
     QString savePath = targetPath.isEmpty() ? path : targetPath;
-    qDebug() << "Saving rotated image to:" << savePath;
+    qCDebug(logDecode) << "Saving rotated image to:" << savePath;
 
     QString format = detectImageFormat(path);
     if (format == "SVG") {
-        qDebug() << "Rotating SVG file";
+        qCDebug(logDecode) << "Rotating SVG file";
         QImage image_copy;
         if (!loadStaticImageFromFile(path, image_copy, erroMsg)) {
             erroMsg = "rotate load QImage faild, path:" + path + "  ,format:+" + format;
@@ -679,20 +914,26 @@ UNIONIMAGESHARED_EXPORT bool rotateImageFIle(int angel, const QString &path, QSt
         rotatePainter.resetTransform();
         generator.setSize(QSize(image_copy.width(), image_copy.height()));
         rotatePainter.end();
-        qDebug() << "Successfully rotated SVG file";
+        qCDebug(logDecode) << "Successfully rotated SVG file";
         return true;
 
     } else if (union_image_private.m_qtrotate.contains(format)) {
-        //由于Qt内部不会去读图片的EXIF信息来判断当前的图像矩阵的真实位置，同时回写数据的时候会丢失全部的EXIF数据
-        int orientation = getOrientation(path);
-        QImage image_copy(path);
-        image_copy = adjustImageToRealPosition(image_copy, orientation);
+        // JPEG 优先改写 EXIF 方向标记，无需解码和重新编码，且不损失画质和 EXIF 信息
+        if ((format == "JPG" || format == "JPEG") && rotateJpegByOrientation(angel, path, savePath, erroMsg)) {
+            qCDebug(logDecode) << "Rotated JPEG losslessly by EXIF orientation";
+            return true;
+        }
+
+        //回写数据的时候会丢失全部的EXIF数据，因此按EXIF方向读取图像矩阵的真实位置后再旋转保存
+        QImageReader reader(path);
+        reader.setAutoTransform(true);
+        QImage image_copy = reader.read();
         if (!image_copy.isNull()) {
             QTransform rotatematrix;
             rotatematrix.rotate(angel);
             image_copy = image_copy.transformed(rotatematrix, Qt::SmoothTransformation);
             if (image_copy.save(savePath, format.toLatin1().data(), SAVE_QUAITY_VALUE)) {
-                qDebug() << "Successfully rotated and saved image";
+                qCDebug(logDecode) << "Successfully rotated and saved image";
                 return true;
             } else {
                 qWarning() << "Failed to save rotated image";
@@ -707,9 +948,33 @@ UNIONIMAGESHARED_EXPORT bool rotateImageFIle(int angel, const QString &path, QSt
     return false;
 }
 
+UNIONIMAGESHARED_EXPORT bool rotateImageFIleLossless(int angel, const QString &path, QString &erroMsg, bool &skipped)
+{
+    skipped = false;
+    QString format = detectImageFormat(path);
+    if (format != "JPG" && format != "JPEG") {
+        return rotateImageFIle(angel, path, erroMsg);
+    }
+
+    if (angel % 90 != 0) {
+        erroMsg = "unsupported angel";
+        qWarning() << "Invalid rotation angle:" << angel;
+        return false;
+    }
+    if (rotateJpegByOrientation(angel, path, path, erroMsg)) {
+        return true;
+    }
+    // EXIF 中没有方向标记时只能重新编码，批量旋转不降低画质，跳过该文件
+    if (erroMsg.isEmpty()) {
+        skipped = true;
+        erroMsg = "lossless rotation unavailable, path:" + path;
+    }
+    return false;
+}
+
 UNIONIMAGESHARED_EXPORT bool rotateImageFIleWithImage(int angel, QImage &img, const QString &path, QString &erroMsg)
 {
-    qDebug() << "Rotating image file with provided image:" << path << "by" << angel << "degrees";
+    qCDebug(logDecode) << "Rotating image file with provided image:" << path << "by" << angel << "degrees";
     if (angel % 90 != 0) {
         erroMsg = "unsupported angel";
         qWarning() << "Invalid rotation angle:" << angel;
@@ -725,7 +990,7 @@ UNIONIMAGESHARED_EXPORT bool rotateImageFIleWithImage(int angel, QImage &img, co
 
     QString format = detectImageFormat(path);
     if (format == "SVG") {
-        qDebug() << "Rotating SVG file with provided image";
+        qCDebug(logDecode) << "Rotating SVG file with provided image";
         QSvgGenerator generator;
         generator.setFileName(path);
         generator.setViewBox(QRect(0, 0, image_copy.width(), image_copy.height()));
@@ -749,17 +1014,17 @@ UNIONIMAGESHARED_EXPORT bool rotateImageFIleWithImage(int angel, QImage &img, co
         rotatePainter.resetTransform();
         generator.setSize(QSize(image_copy.width(), image_copy.height()));
         rotatePainter.end();
-        qDebug() << "Successfully rotated SVG file with provided image";
+        qCDebug(logDecode) << "Successfully rotated SVG file with provided image";
         return true;
     } else if (format == "JPG" || format == "JPEG") {
-        qDebug() << "Rotating JPEG file with provided image";
+        qCDebug(logDecode) << "Rotating JPEG file with provided image";
         QImage image_copy(path, "JPG");
         if (!image_copy.isNull()) {
             QPainter rotatePainter(&image_copy);
             rotatePainter.rotate(angel);
             rotatePainter.end();
             if (image_copy.save(path, "jpg", SAVE_QUAITY_VALUE)) {
-                qDebug() << "Successfully rotated and saved JPEG file";
+                qCDebug(logDecode) << "Successfully rotated and saved JPEG file";
                 return true;
             }
         }
@@ -771,7 +1036,7 @@ UNIONIMAGESHARED_EXPORT bool rotateImageFIleWithImage(int angel, QImage &img, co
 
 UNIONIMAGESHARED_EXPORT QMap<QString, QString> getAllMetaData(const QString &path)
 {
-    qDebug() << "Getting all metadata for:" << path;
+    qCDebug(logDecode) << "Getting all metadata for:" << path;
     QMap<QString, QString> admMap;
     //移除秒　　2020/6/5 DJH
     //需要转义才能读出：或者/　　2020/8/21 DJH
@@ -789,7 +1054,7 @@ UNIONIMAGESHARED_EXPORT QMap<QString, QString> getAllMetaData(const QString &pat
     
     // 增加内存限制，支持读取大图片的元数据
     reader.setAllocationLimit(2048);
-    qDebug() << "Set QImageReader allocation limit to 2048MB for metadata reading";
+    qCDebug(logDecode) << "Set QImageReader allocation limit to 2048MB for metadata reading";
     
     QSize originalSize = reader.size();
     const int maxDimension = 4096;
@@ -797,7 +1062,7 @@ UNIONIMAGESHARED_EXPORT QMap<QString, QString> getAllMetaData(const QString &pat
     int h = originalSize.height();
     
     if (originalSize.width() > maxDimension || originalSize.height() > maxDimension) {
-        qDebug() << "Large image detected for metadata reading (" << originalSize.width() << "x" << originalSize.height()
+        qCDebug(logDecode) << "Large image detected for metadata reading (" << originalSize.width() << "x" << originalSize.height()
                               << "), scaling down to max dimension:" << maxDimension;
         
         QSize scaledSize = originalSize;
@@ -810,7 +1075,7 @@ UNIONIMAGESHARED_EXPORT QMap<QString, QString> getAllMetaData(const QString &pat
         w = scaledSize.width();
         h = scaledSize.height();
 
-        qDebug() << "Image scaled for metadata to:" << scaledSize;
+        qCDebug(logDecode) << "Image scaled for metadata to:" << scaledSize;
     }
     
     admMap.insert("Dimension", QString::number(w) + "x" + QString::number(h));
@@ -823,26 +1088,117 @@ UNIONIMAGESHARED_EXPORT QMap<QString, QString> getAllMetaData(const QString &pat
     admMap.insert("FileFormat", getFileFormat(path));
     admMap.insert("FileSize", size2Human(info.size()));
 
-    qDebug() << "Found" << admMap.size() << "metadata entries";
+    qCDebug(logDecode) << "Found" << admMap.size() << "metadata entries";
     return admMap;
 }
 
 UNIONIMAGESHARED_EXPORT bool isImageSupportRotate(const QString &path)
 {
-    qDebug() << "Checking if image is support rotate:" << path;
+    qCDebug(logDecode) << "Checking if image is support rotate:" << path;
     return canSave(path) ;
 }
 
 UNIONIMAGESHARED_EXPORT int getOrientation(const QString &path)
 {
-    qDebug() << "Getting orientation for:" << path;
-    Q_UNUSED(path);
+    qCDebug(logDecode) << "Getting orientation for:" << path;
+    JpegOrientationInfo info;
+    QFile file(path);
+    if (file.open(QIODevice::ReadOnly) && readJpegOrientation(file, info)) {
+        return info.orientation;
+    }
     return 1;
 }
 
+/**
+ * @brief 读取 EXIF 子 IFD 中 ASCII 类型的时间字段，格式为 "yyyy:MM:dd hh:mm:ss"
+ */
+static QDateTime readExifAsciiDateTime(const char *tiff, qint64 tiffSize, qint64 entry, bool littleEndian)
+{
+    const quint32 count = readExifUInt32(tiff + entry + 4, littleEndian);
+    if (readExifUInt16(tiff + entry + 2, littleEndian) != 2 || count < 19) {
+        return QDateTime();
+    }
+    const qint64 offset = readExifUInt32(tiff + entry + 8, littleEndian);
+    if (tiffSize < 19 || offset > tiffSize - 19) {
+        return QDateTime();
+    }
+    return QDateTime::fromString(QString::fromLatin1(tiff + offset, 19), "yyyy:MM:dd hh:mm:ss");
+}
+
+UNIONIMAGESHARED_EXPORT bool readExifDateTime(const QByteArray &head, QDateTime &original, QDateTime &digitized)
+{
+    original = QDateTime();
+    digitized = QDateTime();
+    if (!head.startsWith(QByteArray("\xFF\xD8", 2))) {
+        return false;
+    }
+
+    // 逐段查找 APP1，数据不足时交由调用方读取完整文件
+    qint64 pos = 2;
+    while (pos + 4 <= head.size()) {
+        const uchar *p = reinterpret_cast<const uchar *>(head.constData() + pos);
+        if (p[0] != 0xFF) {
+            return true;
+        }
+        const uchar type = p[1];
+        if (type == 0xDA || type == 0xD9) {
+            return true;
+        }
+        if (type == 0xFF) {
+            ++pos;
+            continue;
+        }
+        if (type == 0x01 || (type >= 0xD0 && type <= 0xD7)) {
+            pos += 2;
+            continue;
+        }
+
+        const quint16 length = readExifUInt16(head.constData() + pos + 2, false);
+        if (length < 2) {
+            return true;
+        }
+        const qint64 segmentStart = pos + 4;
+        const qint64 segmentEnd = pos + 2 + length;
+        if (segmentEnd > head.size()) {
+            return false;
+        }
+
+        if (type == 0xE1 && length >= 16 && head.mid(segmentStart, 6) == QByteArray("Exif\0\0", 6)) {
+            const char *tiff = head.constData() + segmentStart + 6;
+            const qint64 tiffSize = segmentEnd - segmentStart - 6;
+            bool littleEndian = false;
+            if (tiff[0] == 'I' && tiff[1] == 'I') {
+                littleEndian = true;
+            } else if (!(tiff[0] == 'M' && tiff[1] == 'M')) {
+                return true;
+            }
+
+            // IFD0 中的 0x8769 指向 EXIF 子 IFD，拍摄时间在子 IFD 中
+            const qint64 exifEntry = findExifIfdEntry(tiff, tiffSize, readExifUInt32(tiff + 4, littleEndian), 0x8769, littleEndian);
+            if (exifEntry < 0) {
+                return true;
+            }
+            const qint64 exifIfd = readExifUInt32(tiff + exifEntry + 8, littleEndian);
+            const qint64 originalEntry = findExifIfdEntry(tiff, tiffSize, exifIfd, 0x9003, littleEndian);
+            if (originalEntry >= 0) {
+                original = readExifAsciiDateTime(tiff, tiffSize, originalEntry, littleEndian);
+            }
+            const qint64 digitizedEntry = findExifIfdEntry(tiff, tiffSize, exifIfd, 0x9004, littleEndian);
+            if (digitizedEntry >= 0) {
+                digitized = readExifAsciiDateTime(tiff, tiffSize, digitizedEntry, littleEndian);
+            }
+            return true;
+        }
+
+        pos = segmentEnd;
+    }
+
+    return false;
+}
+
 imageViewerSpace::ImageType getImageType(const QString &imagepath)
 {
-    qDebug() << "Getting image type for:" << imagepath;
+    qCDebug(logDecode) << "Getting image type for:" << imagepath;
     imageViewerSpace::ImageType type = imageViewerSpace::ImageType::ImageTypeBlank;
     //新增获取图片是属于静态图还是动态图还是多页图
     if (!imagepath.isEmpty()) {
@@ -880,14 +1236,14 @@ imageViewerSpace::ImageType getImageType(const QString &imagepath)
             type = imageViewerSpace::ImageTypeStatic;
         }
     }
-    qDebug() << "Image type:" << type;
+    qCDebug(logDecode) << "Image type:" << type;
     return type;
 }
 
 imageViewerSpace::PathType getPathType(const QString &imagepath)
 {
     //判断文件路径来自于哪里
-    qDebug() << "Getting path type for:" << imagepath;
+    qCDebug(logDecode) << "Getting path type for:" << imagepath;
     imageViewerSpace::PathType type = imageViewerSpace::PathType::PathTypeLOCAL;
     if (imagepath.indexOf("smb-share:server=") != -1) {
         type = imageViewerSpace::PathTypeSMB;
@@ -903,13 +1259,13 @@ imageViewerSpace::PathType getPathType(const QString &imagepath)
         type = imageViewerSpace::PathTypeRECYCLEBIN;
     }
     //todo
-    qDebug() << "Path type:" << type;
+    qCDebug(logDecode) << "Path type:" << type;
     return type;
 }
 
 QString PrivateDetectImageFormat(const QString &filepath)
 {
-    qDebug() << "Detecting image format (private) for:" << filepath;
+    qCDebug(logDecode) << "Detecting image format (private) for:" << filepath;
     QFile file(filepath);
     if (!file.open(QIODevice::ReadOnly)) {
         qWarning() << "Failed to open file for format detection:" << filepath;
@@ -1003,67 +1359,67 @@ QString PrivateDetectImageFormat(const QString &filepath)
 
 UNIONIMAGESHARED_EXPORT QString hashByString(const QString &str)
 {
-    qDebug() << "Hashing string:" << str;
+    qCDebug(logDecode) << "Hashing string:" << str;
     return Libutils::base::hashByString(str);
 }
 
 UNIONIMAGESHARED_EXPORT void getAllFileInDir(const QDir &dir, QFileInfoList &result)
 {
-    qDebug() << "Getting all files in directory:" << dir.path();
+    qCDebug(logDecode) << "Getting all files in directory:" << dir.path();
     return Libutils::image::getAllFileInDir(dir, result);
 }
 
 UNIONIMAGESHARED_EXPORT std::pair<QDateTime, bool> analyzeDateTime(const QVariant &data)
 {
-    qDebug() << "Analyzing date time:" << data;
+    qCDebug(logDecode) << "Analyzing date time:" << data;
     return Libutils::base::analyzeDateTime(data);
 }
 
 UNIONIMAGESHARED_EXPORT QString getDeleteFullPath(const QString &hash, const QString &fileName)
 {
-    qDebug() << "Getting delete full path for hash:" << hash << "fileName:" << fileName;
+    qCDebug(logDecode) << "Getting delete full path for hash:" << hash << "fileName:" << fileName;
     return Libutils::base::getDeleteFullPath(hash, fileName);
 }
 
 UNIONIMAGESHARED_EXPORT bool syncCopy(const QString &srcFileName, const QString &dstFileName)
 {
-    qDebug() << "Performing synchronous copy from:" << srcFileName << "to:" << dstFileName;
+    qCDebug(logDecode) << "Performing synchronous copy from:" << srcFileName << "to:" << dstFileName;
     return Libutils::base::syncCopy(srcFileName, dstFileName);
 }
 
 UNIONIMAGESHARED_EXPORT bool isVaultFile(const QString &path)
 {
-    qDebug() << "Checking if file is in vault:" << path;
+    qCDebug(logDecode) << "Checking if file is in vault:" << path;
     return Libutils::image::isVaultFile(path);
 }
 
 UNIONIMAGESHARED_EXPORT bool trashFile(const QString &file)
 {
-    qDebug() << "Moving file to trash:" << file;
+    qCDebug(logDecode) << "Moving file to trash:" << file;
     return Libutils::base::trashFile(file);
 }
 
 UNIONIMAGESHARED_EXPORT QFileInfoList getImagesAndVideoInfo(const QString &dir, bool recursive)
 {
-    qDebug() << "Getting images and video info from directory:" << dir << "recursive:" << recursive;
+    qCDebug(logDecode) << "Getting images and video info from directory:" << dir << "recursive:" << recursive;
     return Libutils::image::getImagesAndVideoInfo(dir, recursive);
 }
 
 UNIONIMAGESHARED_EXPORT bool isVideo(QString path)
 {
-    qDebug() << "Checking if file is video:" << path;
+    qCDebug(logDecode) << "Checking if file is video:" << path;
     return Libutils::image::isVideo(path);
 }
 
 UNIONIMAGESHARED_EXPORT bool imageSupportRead(const QString &path)
 {
-    qDebug() << "Checking if image format is supported for reading:" << path;
+    qCDebug(logDecode) << "Checking if image format is supported for reading:" << path;
     return Libutils::image::imageSupportRead(path);
 }
 
 UNIONIMAGESHARED_EXPORT void getAllDirInDir(const QDir &dir, QFileInfoList &result)
 {
-    qDebug() << "Getting all directories in:" << dir.path();
+    qCDebug(logDecode) << "Getting all directories in:" << dir.path();
     QDir root(dir);
     auto list = root.entryInfoList(QDir::AllDirs | QDir::NoDotAndDotDot);
     for (const auto &eachInfo : list) {
@@ -1072,12 +1428,12 @@ UNIONIMAGESHARED_EXPORT void getAllDirInDir(const QDir &dir, QFileInfoList &resu
             getAllDirInDir(eachInfo.absoluteFilePath(), result);
         }
     }
-    qDebug() << "Found" << result.size() << "directories";
+    qCDebug(logDecode) << "Found" << result.size() << "directories";
 }
 
 UNIONIMAGESHARED_EXPORT bool isImage(const QString &path)
 {
-    qDebug() << "Checking if file is an image:" << path;
+    qCDebug(logDecode) << "Checking if file is an image:" << path;
     bool bRet = false;
     //路径为空直接跳出
     if (!path.isEmpty()) {
@@ -1089,25 +1445,25 @@ UNIONIMAGESHARED_EXPORT bool isImage(const QString &path)
             bRet = true;
         }
     }
-    qDebug() << "File is an image:" << bRet;
+    qCDebug(logDecode) << "File is an image:" << bRet;
     return bRet;
 }
 
 UNIONIMAGESHARED_EXPORT QString localPath(const QUrl &url)
 {
-    qDebug() << "Getting local path for URL:" << url;
+    qCDebug(logDecode) << "Getting local path for URL:" << url;
     QString path = url.toLocalFile();
     if (path.isEmpty()) {
         path = url.toString().isEmpty() ? url.path() : url.toString();
     }
 
-    qDebug() << "Local path:" << path;
+    qCDebug(logDecode) << "Local path:" << path;
     return path;
 }
 
 UNIONIMAGESHARED_EXPORT QPixmap renderSVG(const QString &path, const QSize &size)
 {
-    qDebug() << "Rendering SVG file:" << path << "with size:" << size;
+    qCDebug(logDecode) << "Rendering SVG file:" << path << "with size:" << size;
     return Libutils::base::renderSVG(path, size);
 }
 
@@ -122,10 +122,23 @@ UNIONIMAGESHARED_EXPORT bool rotateImage(int angel, QImage &image);
  * @author DJH
  * 旋转图片文件，旋转成功返回true，失败返回false
  * 当不需要获取旋转图片的结果或者只有文件地址时调用该函数
+ * JPEG 文件通过改写 EXIF 方向标记无损旋转，其它格式解码旋转后重新编码
  * 失败时会将错误信息写入erroMsg
  */
 UNIONIMAGESHARED_EXPORT bool rotateImageFIle(int angel, const QString &path, QString &erroMsg, const QString &targetPath = {});
 
+/**
+ * @brief rotateImageFIleLossless
+ * @param[in]           angel
+ * @param[in]           path
+ * @param[out]          erroMsg
+ * @param[out]          skipped 需要重新编码 JPEG 才能旋转时置为 true，文件不做修改
+ * @return bool
+ * 不降低画质地原位旋转图片文件，用于批量旋转
+ * JPEG 文件仅通过改写 EXIF 方向标记旋转，其它可旋转格式均为无损编码，按 rotateImageFIle 处理
+ */
+UNIONIMAGESHARED_EXPORT bool rotateImageFIleLossless(int angel, const QString &path, QString &erroMsg, bool &skipped);
+
 /**
  * @brief rotateImageFIle
  * @param[in]           angel
@@ -183,6 +196,15 @@ UNIONIMAGESHARED_EXPORT bool canSave(const QString &path);
  */
 UNIONIMAGESHARED_EXPORT int getOrientation(const QString &path);
 
+/**
+ * @brief readExifDateTime 从 JPEG 文件头部数据中解析 EXIF 拍摄时间
+ * @param head 文件起始部分的数据，需包含完整的 EXIF APP1 段
+ * @param original 拍摄时间(DateTimeOriginal)，不存在时为无效时间
+ * @param digitized 数字化时间(DateTimeDigitized)，不存在时为无效时间
+ * @return 数据为 JPEG 且包含完整的 EXIF 段或可确定不存在 EXIF 时返回 true，否则需要读取整个文件
+ */
+UNIONIMAGESHARED_EXPORT bool readExifDateTime(const QByteArray &head, QDateTime &original, QDateTime &digitized);
+
 /**
  * @brief getImageType
  * @param path
@@ -0,0 +1,158 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "classifyscheduler.h"
+#include "classifyutils.h"
+#include "imageengine/imageenginethread.h"
+#include "dbmanager/dbmanager.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+
+#include <limits>
+
+static const int sc_IdleInterval = 3000;   // 交互结束后等待的空闲时长
+static const int sc_ActivityHold = 1500;   // 交互操作后暂停分类的时长
+
+ClassifyScheduler *ClassifyScheduler::instance()
+{
+    // 不随静态对象析构，退出时在 aboutToQuit 中停止并等待工作线程结束，此时 DBManager 仍然有效
+    static ClassifyScheduler *ins = new ClassifyScheduler;
+    return ins;
+}
+
+ClassifyScheduler::ClassifyScheduler(QObject *parent)
+    : QObject(parent)
+{
+    // 单线程低优先级执行，不与缩略图加载和导入争抢资源
+    m_pool.setMaxThreadCount(1);
+    m_pool.setThreadPriority(QThread::LowestPriority);
+    m_clock.start();
+
+    m_idleTimer = new QTimer(this);
+    m_idleTimer->setSingleShot(true);
+    m_idleTimer->setInterval(sc_IdleInterval);
+    connect(m_idleTimer, &QTimer::timeout, this, &ClassifyScheduler::onIdleTimeout);
+
+    m_retryTimer = new QTimer(this);
+    m_retryTimer->setSingleShot(true);
+    connect(m_retryTimer, &QTimer::timeout, this, &ClassifyScheduler::wakeUp);
+
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, &ClassifyScheduler::stop);
+    }
+}
+
+ClassifyScheduler::~ClassifyScheduler()
+{
+    stop();
+}
+
+/**
+   @brief 唤醒调度，分类服务不可用时忽略
+ */
+void ClassifyScheduler::wakeUp()
+{
+    if (isStopped() || !Classifyutils::GetInstance()->isDBusExist())
+        return;
+
+    if (m_running) {
+        m_pendingWake = true;
+        return;
+    }
+
+    if (!m_idleTimer->isActive())
+        m_idleTimer->start();
+}
+
+void ClassifyScheduler::notifyActivity()
+{
+    m_lastActivity = m_clock.elapsed();
+}
+
+void ClassifyScheduler::beginImport()
+{
+    m_importCount.ref();
+}
+
+void ClassifyScheduler::endImport()
+{
+    if (!m_importCount.deref()) {
+        // 导入的新图片已进入队列
+        QMetaObject::invokeMethod(this, &ClassifyScheduler::wakeUp, Qt::QueuedConnection);
+    }
+}
+
+bool ClassifyScheduler::isBusy() const
+{
+    if (m_importCount.loadRelaxed() > 0)
+        return true;
+
+    const qint64 last = m_lastActivity;
+    return last >= 0 && m_clock.elapsed() - last < sc_ActivityHold;
+}
+
+bool ClassifyScheduler::isStopped() const
+{
+    return m_stopped.loadRelaxed();
+}
+
+void ClassifyScheduler::onIdleTimeout()
+{
+    if (isStopped() || m_running)
+        return;
+
+    // 仍在交互中，推迟到空闲后再开始
+    if (isBusy()) {
+        m_idleTimer->start();
+        return;
+    }
+
+    m_running = true;
+    m_pendingWake = false;
+
+    m_retryTimer->stop();
+    ImagesClassifyThread *classifyThread = new ImagesClassifyThread;
+    connect(classifyThread, &ImagesClassifyThread::runFinished, this, &ClassifyScheduler::onTaskFinished, Qt::QueuedConnection);
+    m_pool.start(classifyThread);
+}
+
+/**
+   @brief 一轮处理结束，因忙碌中断或期间有新任务时重新等待空闲，
+    否则在最早的失败任务到达重试时间后再次调度
+ */
+void ClassifyScheduler::onTaskFinished()
+{
+    m_running = false;
+    if (isStopped())
+        return;
+
+    if (m_pendingWake || isBusy()) {
+        wakeUp();
+        return;
+    }
+
+    const qint64 retryTime = DBManager::instance()->getClassifyRetryTime();
+    if (retryTime > 0) {
+        const qint64 delay = qMax<qint64>(0, retryTime - QDateTime::currentSecsSinceEpoch()) * 1000;
+        m_retryTimer->start(static_cast<int>(qMin<qint64>(delay, std::numeric_limits<int>::max())));
+    }
+}
+
+/**
+   @brief 停止调度，通知工作线程放弃未返回的分类请求，并等待其结束，
+    保证退出时不再有线程访问 DBManager。进行中的任务在下次启动时恢复为等待
+ */
+void ClassifyScheduler::stop()
+{
+    if (m_stopped.fetchAndStoreRelaxed(1))
+        return;
+
+    m_idleTimer->stop();
+    m_retryTimer->stop();
+    m_pool.clear();
+    Q_EMIT stopRequested();
+    m_pool.waitForDone();
+}
@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef CLASSIFYSCHEDULER_H
+#define CLASSIFYSCHEDULER_H
+
+#include <QObject>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QTimer>
+
+#include <atomic>
+
+/*
+ * 后台分类调度，空闲时以低优先级分批处理数据库中的分类队列，
+ * 导入或滚动浏览期间暂停，队列状态持久化，退出后下次启动继续处理
+ */
+class ClassifyScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    static ClassifyScheduler *instance();
+
+    // 队列中有新任务时唤醒调度，空闲后开始处理
+    Q_SLOT void wakeUp();
+    // 滚动浏览等交互操作，短时间内暂停分类，线程安全
+    void notifyActivity();
+    // 导入期间暂停分类，可嵌套调用，线程安全
+    void beginImport();
+    void endImport();
+
+    bool isBusy() const;
+    bool isStopped() const;
+
+    // 一批分类结果已写入数据库，在工作线程中触发
+    Q_SIGNAL void classifyUpdated();
+    // 分类队列已全部处理完，在工作线程中触发
+    Q_SIGNAL void classifyFinished();
+    // 停止调度，工作线程以直连方式响应，尽快结束当前分类
+    Q_SIGNAL void stopRequested();
+
+private:
+    explicit ClassifyScheduler(QObject *parent = nullptr);
+    ~ClassifyScheduler() override;
+
+    void onIdleTimeout();
+    void onTaskFinished();
+    void stop();
+
+private:
+    QThreadPool m_pool;
+    QTimer *m_idleTimer { nullptr };
+    QTimer *m_retryTimer { nullptr };  // 失败任务的重试时间到达后唤醒调度
+    bool m_running { false };
+    bool m_pendingWake { false };     // 运行期间有新任务，结束后再次调度
+
+    QAtomicInt m_importCount { 0 };
+    QAtomicInt m_stopped { 0 };
+    QElapsedTimer m_clock;
+    std::atomic<qint64> m_lastActivity { -1 };   // 最近一次交互操作的时间，毫秒
+
+    Q_DISABLE_COPY(ClassifyScheduler)
+};
+
+#endif   // CLASSIFYSCHEDULER_H
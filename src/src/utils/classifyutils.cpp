@@ -3,10 +3,15 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "classifyutils.h"
-#include "unionimage/unionimage_global.h"
+#include "unionimage/baseutils.h"
+#include "dbmanager/dbmanager.h"
 
 #include <QLibrary>
 #include <QLibraryInfo>
+#include <QImageReader>
+#include <QDir>
+#include <QStandardPaths>
+#include <QTemporaryFile>
 
 const QString ImageClassifyDBusServicePath = "/usr/share/dbus-1/system-services/com.deepin.imageclassify.service";
 Classifyutils *Classifyutils::m_pInstance = nullptr;
@@ -24,9 +29,16 @@ QString Classifyutils::imageClassify(const QString &path)
         return "";
 
     QString className = m_dbus->imageClassify(path);
-    // 一些无效类型名，统一归类为其他
+    return normalizeClassName(className);
+}
+
+/**
+   @brief 一些无效类型名，统一归类为其他
+ */
+QString Classifyutils::normalizeClassName(const QString &className)
+{
     if (g_classList.indexOf(className) == -1)
-        className = "Other";
+        return "Other";
 
     return className;
 }
@@ -48,3 +60,257 @@ Classifyutils::Classifyutils()
 
     qDebug() << "dbus com.deepin.logviewer isValid true";
 }
+
+static const int sc_ClassifyInputSize = 512;  // 发送给分类服务的图片最长边
+
+ClassifyPipeline::ClassifyPipeline(QObject *parent)
+    : QObject(parent)
+{
+}
+
+ClassifyPipeline::~ClassifyPipeline()
+{
+}
+
+void ClassifyPipeline::setMaxInFlight(int count)
+{
+    m_maxInFlight = qMax(1, count);
+}
+
+void ClassifyPipeline::setCommitInterval(int count, int msec)
+{
+    m_commitCount = qMax(1, count);
+    if (m_commitTimer) {
+        m_commitTimer->setInterval(msec);
+    } else {
+        m_commitTimer = new QTimer(this);
+        m_commitTimer->setInterval(msec);
+        connect(m_commitTimer, &QTimer::timeout, this, &ClassifyPipeline::commit);
+    }
+}
+
+void ClassifyPipeline::setPauseCheck(const std::function<bool()> &check)
+{
+    m_pauseCheck = check;
+}
+
+/**
+   @brief 分类 \a infos 中未分类的图片，保持最多 m_maxInFlight 个异步请求，
+    某个请求返回后立即发起下一个，分类速度只受服务端处理能力限制
+ */
+void ClassifyPipeline::exec(const DBImgInfoList &infos)
+{
+    m_infos.clear();
+    for (const DBImgInfo &info : infos) {
+        if (info.className.isEmpty())
+            m_infos.append(info);
+    }
+    if (m_infos.isEmpty())
+        return;
+
+    if (!m_commitTimer)
+        setCommitInterval(m_commitCount, 5000);
+
+    // 对象在工作线程中创建，异步回复在本线程的事件循环中处理
+    DaemonImageClassifyInterface dbus;
+    QEventLoop loop;
+    m_dbus = &dbus;
+    m_inputDir = createInputDir();
+    m_loop = &loop;
+    m_next = 0;
+    m_inFlight = 0;
+    m_finished = 0;
+
+    qInfo() << "Classify pipeline started, count:" << m_infos.size() << "in flight:" << m_maxInFlight;
+    Q_EMIT progress(m_infos.size(), 0);
+
+    m_commitTimer->start();
+    startNext();
+    if (m_inFlight > 0 || isPaused())
+        loop.exec();
+    m_commitTimer->stop();
+    if (m_resumeTimer)
+        m_resumeTimer->stop();
+    commit();
+
+    m_dbus = nullptr;
+    if (!m_inputDir.isEmpty())
+        QDir(m_inputDir).removeRecursively();
+    m_inputDir.clear();
+    m_loop = nullptr;
+    m_infos.clear();
+    qInfo() << "Classify pipeline finished, classified:" << m_finished;
+}
+
+void ClassifyPipeline::stop()
+{
+    if (m_stopped.fetchAndStoreRelaxed(1))
+        return;
+
+    // 不等待进行中的请求返回，分类服务无响应时退出不受 D-Bus 超时影响
+    QMetaObject::invokeMethod(this, [this]() {
+        if (m_loop)
+            m_loop->quit();
+    }, Qt::QueuedConnection);
+}
+
+/**
+   @brief 补足进行中的请求，不支持分类的图片直接记录结果
+ */
+void ClassifyPipeline::startNext()
+{
+    // 暂停期间定时检查，恢复后继续发起请求
+    if (isPaused()) {
+        if (!m_resumeTimer) {
+            m_resumeTimer = new QTimer(this);
+            m_resumeTimer->setSingleShot(true);
+            m_resumeTimer->setInterval(500);
+            connect(m_resumeTimer, &QTimer::timeout, this, &ClassifyPipeline::startNext);
+        }
+        if (!m_resumeTimer->isActive())
+            m_resumeTimer->start();
+    }
+
+    while (m_inFlight < m_maxInFlight && m_next < m_infos.size() && !m_stopped.loadRelaxed() && !isPaused()) {
+        const int index = m_next++;
+        DBImgInfo &info = m_infos[index];
+
+        QFileInfo srcfi(info.filePath);
+        if (!srcfi.exists() || !srcfi.isReadable()) {
+            m_failed.append(info);
+            ++m_finished;
+            continue;
+        }
+        if (!Libutils::base::isSupportClassify(info.filePath)) {
+            info.className = "Other";
+            m_results.append(info);
+            ++m_finished;
+            continue;
+        }
+
+        const QString inputPath = prepareInput(info.filePath);
+        auto *watcher = new QDBusPendingCallWatcher(m_dbus->imageClassify(inputPath), this);
+        m_calls.insert(watcher, qMakePair(index, inputPath != info.filePath ? inputPath : QString()));
+        connect(watcher, &QDBusPendingCallWatcher::finished, this, &ClassifyPipeline::onCallFinished);
+        ++m_inFlight;
+    }
+
+    if (m_results.size() + m_failed.size() >= m_commitCount)
+        commit();
+
+    if (0 == m_inFlight && m_loop && !isPaused())
+        m_loop->quit();
+}
+
+/**
+   @return 是否处于暂停状态，已停止或已全部发起时不再暂停
+ */
+bool ClassifyPipeline::isPaused() const
+{
+    if (!m_pauseCheck || m_stopped.loadRelaxed() || m_next >= m_infos.size())
+        return false;
+
+    return m_pauseCheck();
+}
+
+void ClassifyPipeline::onCallFinished(QDBusPendingCallWatcher *watcher)
+{
+    const QPair<int, QString> call = m_calls.take(watcher);
+    QDBusPendingReply<QString> reply = *watcher;
+    watcher->deleteLater();
+    --m_inFlight;
+
+    DBImgInfo &info = m_infos[call.first];
+    if (!call.second.isEmpty())
+        QFile::remove(call.second);
+
+    // 分类服务无法读取私有目录中缩小后的图片时，改用原图重试，之后不再缩小输入
+    if (reply.isError() && !call.second.isEmpty() && !m_stopped.loadRelaxed()) {
+        qWarning() << "Classify staged input failed, retry with original:" << info.filePath << reply.error().message();
+        m_stageInput = false;
+        auto *retry = new QDBusPendingCallWatcher(m_dbus->imageClassify(info.filePath), this);
+        m_calls.insert(retry, qMakePair(call.first, QString()));
+        connect(retry, &QDBusPendingCallWatcher::finished, this, &ClassifyPipeline::onCallFinished);
+        ++m_inFlight;
+        return;
+    }
+
+    if (reply.isError()) {
+        // 服务异常时不写入结果，由调用方决定是否重试
+        qWarning() << "Classify failed:" << info.filePath << reply.error().message();
+        m_failed.append(info);
+    } else {
+        info.className = Classifyutils::normalizeClassName(reply.value());
+        m_results.append(info);
+    }
+    ++m_finished;
+
+    Q_EMIT progress(m_infos.size(), m_finished);
+    startNext();
+}
+
+/**
+   @brief 提交累计的分类结果
+ */
+void ClassifyPipeline::commit()
+{
+    if (!m_results.isEmpty()) {
+        DBManager::instance()->updateClassName2DB(m_results);
+        Q_EMIT batchCommitted(m_results);
+        m_results.clear();
+    }
+
+    if (!m_failed.isEmpty()) {
+        Q_EMIT batchFailed(m_failed);
+        m_failed.clear();
+    }
+}
+
+/**
+   @return 返回缩小后输入图片的存放目录，创建失败时返回空字符串。
+    目录位于当前用户的缓存目录下，仅所有者可访问（0700），其它用户无法列出或读取缩小后的图片。
+    分类服务无权读取时请求失败，由 onCallFinished 改用原图重试
+ */
+QString ClassifyPipeline::createInputDir()
+{
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/classify_input";
+    // 清理上次异常退出遗留的文件
+    QDir(dir).removeRecursively();
+    if (!QDir().mkpath(dir)
+            || !QFile::setPermissions(dir, QFile::ReadOwner | QFile::WriteOwner | QFile::ExeOwner)) {
+        qWarning() << "Failed to create classify input dir:" << dir;
+        return QString();
+    }
+    return dir;
+}
+
+/**
+   @return 返回发送给分类服务的图片路径，大图预先缩小到模型输入尺寸附近，减少服务端解码开销
+ */
+QString ClassifyPipeline::prepareInput(const QString &path)
+{
+    if (m_inputDir.isEmpty() || !m_stageInput)
+        return path;
+
+    QImageReader reader(path);
+    const QSize size = reader.size();
+    if (!size.isValid() || qMax(size.width(), size.height()) <= sc_ClassifyInputSize * 2)
+        return path;
+
+    reader.setAutoTransform(true);
+    reader.setScaledSize(size.scaled(sc_ClassifyInputSize, sc_ClassifyInputSize, Qt::KeepAspectRatio));
+    QImage image = reader.read();
+    if (image.isNull())
+        return path;
+
+    // 分类请求返回后由 onCallFinished 删除
+    QTemporaryFile file(m_inputDir + "/XXXXXX.jpg");
+    file.setAutoRemove(false);
+    if (!file.open() || !image.save(&file, "JPG", 90)
+            || !file.setPermissions(QFile::ReadOwner | QFile::WriteOwner)) {
+        file.remove();
+        return path;
+    }
+
+    return file.fileName();
+}
@@ -5,7 +5,13 @@
 #ifndef CLASSIFYUTILS_H
 #define CLASSIFYUTILS_H
 
+#include "unionimage/unionimage_global.h"
+
 #include <QtDBus/QtDBus>
+#include <QEventLoop>
+#include <QTimer>
+
+#include <functional>
 /*
  * Proxy class for interface com.deepin.logviewer
  */
@@ -61,6 +67,7 @@ public:
     static Classifyutils *GetInstance();
     QString imageClassify(const QString &path);
     bool isDBusExist();
+    static QString normalizeClassName(const QString &className);
 
 private:
     static Classifyutils *m_pInstance;
@@ -70,4 +77,66 @@ private:
     DaemonImageClassifyInterface *m_dbus { nullptr };
 };
 
+/*
+ * 图片分类流水线，同时保持多个异步 D-Bus 请求，结果按批次写入数据库，
+ * 中途退出时已提交的结果不会丢失，未分类的图片在下次启动时继续处理
+ */
+class ClassifyPipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ClassifyPipeline(QObject *parent = nullptr);
+    ~ClassifyPipeline() override;
+
+    // 同时进行的分类请求数
+    void setMaxInFlight(int count);
+    // 每累计 count 个结果或间隔 msec 毫秒提交一次
+    void setCommitInterval(int count, int msec);
+    // 返回 true 时暂停发起新请求，进行中的请求照常完成
+    void setPauseCheck(const std::function<bool()> &check);
+
+    // 执行分类直至全部完成或被停止，在工作线程中调用，内部运行事件循环
+    void exec(const DBImgInfoList &infos);
+    // 线程安全，停止后不再发起新请求并立即结束 exec，已返回的结果仍会提交，
+    // 未返回的请求放弃，对应任务保持进行中状态，下次启动时恢复为等待
+    void stop();
+
+Q_SIGNALS:
+    void progress(int total, int finished);
+    // 一批结果已写入数据库
+    void batchCommitted(const DBImgInfoList &infos);
+    // 分类请求出错或文件无法读取的图片，未写入数据库
+    void batchFailed(const DBImgInfoList &infos);
+
+private:
+    void startNext();
+    void onCallFinished(QDBusPendingCallWatcher *watcher);
+    void commit();
+    bool isPaused() const;
+    static QString createInputDir();
+    QString prepareInput(const QString &path);
+
+private:
+    DaemonImageClassifyInterface *m_dbus { nullptr };
+    QEventLoop *m_loop { nullptr };
+    QTimer *m_commitTimer { nullptr };
+    QTimer *m_resumeTimer { nullptr };
+    std::function<bool()> m_pauseCheck;
+    QString m_inputDir;   // 缩小后的输入图片目录，为空时直接发送原图路径
+    bool m_stageInput { true };   // 分类服务无法读取缩小后的图片时置为 false，之后直接发送原图路径
+
+    int m_maxInFlight { 4 };
+    int m_commitCount { 100 };
+    QAtomicInt m_stopped { 0 };
+
+    DBImgInfoList m_infos;
+    int m_next { 0 };
+    int m_inFlight { 0 };
+    int m_finished { 0 };
+    QHash<QDBusPendingCallWatcher *, QPair<int, QString>> m_calls;  // 请求对应的图片下标及临时输入文件
+    DBImgInfoList m_results;                                         // 未提交的结果
+    DBImgInfoList m_failed;                                          // 未提交的失败项
+};
+
 #endif   // CLASSIFYUTILS_H
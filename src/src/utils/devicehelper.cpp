@@ -116,6 +116,19 @@ QString DeviceHelper::getDeviceIdByMountPoint(const QString &mnp)
     return QString("");
 }
 
+QString DeviceHelper::getFileSystemUuidByMountPoint(const QString &mnp)
+{
+    const QString deviceId = getDeviceIdByMountPoint(mnp);
+    if (deviceId.isEmpty())
+        return QString();
+
+    const QVariantMap deviceInfo = m_mapDevicesInfos.value(deviceId);
+    if (static_cast<DeviceType>(deviceInfo.value("DeviceType").toInt()) != DeviceType::kBlockDevice)
+        return QString();
+
+    return deviceInfo.value("IdUUID").toString();
+}
+
 void DeviceHelper::loadAllDeviceInfos()
 {
     qDebug() << "Loading all device information";
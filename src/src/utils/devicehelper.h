@@ -33,6 +33,9 @@ public:
     // 根据挂载点获取设备Id
     QString getDeviceIdByMountPoint(const QString &mnp);
 
+    // 根据挂载点获取块设备文件系统UUID，协议设备或未找到时返回空
+    QString getFileSystemUuidByMountPoint(const QString &mnp);
+
     // 获取所有设备Id,包括块设备和协议设备
     QStringList getAllDeviceIds();
 
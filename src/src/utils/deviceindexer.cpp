@@ -0,0 +1,308 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "deviceindexer.h"
+#include "unionimage/unionimage.h"
+#include "devicehelper.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QMimeDatabase>
+#include <QMutex>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QWaitCondition>
+
+static const int sc_ScanWorkerCount = 4;      // 单个设备的并行遍历线程数
+static const int sc_PostBatchSize = 500;      // 单个目录文件过多时，每发现一批即通知
+static const quint32 sc_CacheMagic = 0x44494458;   // "DIDX"
+static const qint32 sc_CacheVersion = 2;
+
+/*
+ * 单个设备的扫描任务，待遍历目录由各工作线程共享
+ */
+class DeviceScanTask
+{
+public:
+    QString devicePath;
+    QString cacheKey;               // 缓存使用的设备标识，在主线程中获取
+    QAtomicInt canceled { 0 };
+    QAtomicInt workers { 0 };       // 未退出的工作线程数
+
+    QMutex mutex;
+    QWaitCondition cond;
+    QStringList pendingDirs;        // 待遍历的目录
+    int busyWorkers { 0 };          // 正在遍历目录的线程数
+    DeviceIndexer::FileTypeMap files;
+};
+
+DeviceIndexer *DeviceIndexer::instance()
+{
+    static DeviceIndexer ins;
+    return &ins;
+}
+
+DeviceIndexer::DeviceIndexer(QObject *parent)
+    : QObject(parent)
+{
+    // 允许两个设备同时扫描
+    m_pool.setMaxThreadCount(sc_ScanWorkerCount * 2);
+}
+
+DeviceIndexer::~DeviceIndexer()
+{
+    for (auto task : std::as_const(m_tasks)) {
+        task->canceled.storeRelaxed(1);
+        QMutexLocker locker(&task->mutex);
+        task->cond.wakeAll();
+    }
+    m_pool.waitForDone();
+}
+
+void DeviceIndexer::startScan(const QString &devicePath)
+{
+    if (devicePath.isEmpty() || m_tasks.contains(devicePath))
+        return;
+
+    qInfo() << "Start scanning device:" << devicePath;
+    auto task = QSharedPointer<DeviceScanTask>::create();
+    task->devicePath = devicePath;
+    task->cacheKey = deviceKey(devicePath);
+    task->pendingDirs << devicePath;
+    task->workers.storeRelaxed(sc_ScanWorkerCount);
+    m_tasks.insert(devicePath, task);
+
+    for (int i = 0; i < sc_ScanWorkerCount; ++i) {
+        m_pool.start([this, task]() { runWorker(task); });
+    }
+}
+
+void DeviceIndexer::cancelScan(const QString &devicePath)
+{
+    auto task = m_tasks.take(devicePath);
+    if (task.isNull())
+        return;
+
+    qInfo() << "Cancel scanning device:" << devicePath;
+    task->canceled.storeRelaxed(1);
+    QMutexLocker locker(&task->mutex);
+    task->cond.wakeAll();
+}
+
+bool DeviceIndexer::isScanning(const QString &devicePath) const
+{
+    return m_tasks.contains(devicePath);
+}
+
+/**
+   @brief 工作线程每次取出一个目录遍历，子目录放回共享队列，所有线程空闲且队列为空时扫描结束
+ */
+void DeviceIndexer::runWorker(const QSharedPointer<DeviceScanTask> &task)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    forever {
+        QString dirPath;
+        {
+            QMutexLocker locker(&task->mutex);
+            while (task->pendingDirs.isEmpty() && task->busyWorkers > 0 && !task->canceled.loadRelaxed()) {
+                task->cond.wait(&task->mutex);
+            }
+            if (task->canceled.loadRelaxed() || task->pendingDirs.isEmpty()) {
+                task->cond.wakeAll();
+                break;
+            }
+            dirPath = task->pendingDirs.takeLast();
+            ++task->busyWorkers;
+        }
+
+        QStringList subDirs;
+        FileTypeMap found;
+        QDirIterator it(dirPath, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
+        while (it.hasNext() && !task->canceled.loadRelaxed()) {
+            it.next();
+            const QFileInfo info = it.fileInfo();
+            if (info.isDir()) {
+                // 不跟随目录链接，与原有遍历行为一致，避免循环
+                if (!info.isSymLink())
+                    subDirs << info.filePath();
+                continue;
+            }
+
+            const ItemType type = classifyFile(info.filePath());
+            if (ItemTypeNull == type)
+                continue;
+
+            found.insert(info.filePath(), type);
+            if (found.size() >= sc_PostBatchSize) {
+                postFiles(task, found);
+                found.clear();
+            }
+        }
+
+        {
+            QMutexLocker locker(&task->mutex);
+            task->pendingDirs << subDirs;
+            --task->busyWorkers;
+            task->cond.wakeAll();
+        }
+        if (!found.isEmpty())
+            postFiles(task, found);
+    }
+
+    // 最后退出的线程负责收尾
+    if (!task->workers.deref()) {
+        if (!task->canceled.loadRelaxed()) {
+            qInfo() << "Device scan finished:" << task->devicePath << "files:" << task->files.size() << "cost:" << timer.elapsed() << "ms";
+            saveListing(task->cacheKey, task->devicePath, task->files);
+        }
+        QMetaObject::invokeMethod(this, [this, task]() { onWorkerFinished(task); }, Qt::QueuedConnection);
+    }
+}
+
+void DeviceIndexer::postFiles(const QSharedPointer<DeviceScanTask> &task, const FileTypeMap &files)
+{
+    {
+        QMutexLocker locker(&task->mutex);
+        task->files.insert(files);
+    }
+
+    QMetaObject::invokeMethod(this, [this, task, files]() {
+        if (m_tasks.value(task->devicePath) == task)
+            Q_EMIT filesFound(task->devicePath, files);
+    }, Qt::QueuedConnection);
+}
+
+void DeviceIndexer::onWorkerFinished(const QSharedPointer<DeviceScanTask> &task)
+{
+    if (m_tasks.value(task->devicePath) != task)
+        return;
+
+    m_tasks.remove(task->devicePath);
+    Q_EMIT scanFinished(task->devicePath, task->files);
+}
+
+/**
+   @return 文件类型，仅在扩展名同时属于图片和视频或可能是其它文件时读取文件内容判断
+ */
+ItemType DeviceIndexer::classifyFile(const QString &filePath)
+{
+    static const QHash<QString, ItemType> s_suffixTypes = []() {
+        QHash<QString, ItemType> types;
+        for (const QString &suffix : LibUnionImage_NameSpace::videoFiletypes()) {
+            types.insert(suffix.toLower(), ItemTypeVideo);
+        }
+        for (const QString &suffix : LibUnionImage_NameSpace::unionImageSupportFormat()) {
+            const QString lower = suffix.toLower();
+            // 同时属于图片和视频的扩展名需要读取内容判断
+            types.insert(lower, types.contains(lower) ? ItemTypeNull : ItemTypePic);
+        }
+        // ts 文件可能是翻译文件
+        types.insert("ts", ItemTypeNull);
+        return types;
+    }();
+
+    const int dot = filePath.lastIndexOf('.');
+    if (dot < 0 || dot < filePath.lastIndexOf('/'))
+        return ItemTypeNull;
+
+    const QString suffix = filePath.mid(dot + 1).toLower();
+    auto itr = s_suffixTypes.constFind(suffix);
+    if (itr == s_suffixTypes.constEnd())
+        return ItemTypeNull;
+    if (ItemTypeNull != itr.value())
+        return itr.value();
+
+    const QString mimeName = QMimeDatabase().mimeTypeForFile(filePath, QMimeDatabase::MatchContent).name();
+    if (mimeName.startsWith("image/") || mimeName.startsWith("video/x-mng"))
+        return ItemTypePic;
+    if (mimeName.startsWith("video/"))
+        return ItemTypeVideo;
+    // 内容无法识别时，非 ts 文件按图片扩展名处理
+    return "ts" == suffix ? ItemTypeNull : ItemTypePic;
+}
+
+/**
+   @return 设备缓存标识，U盘等块设备使用文件系统 UUID，卷标相同或挂载路径变化时仍能区分；
+    手机等协议设备的挂载路径中包含设备序列号，直接使用挂载路径
+ */
+QString DeviceIndexer::deviceKey(const QString &devicePath)
+{
+    const QString uuid = DeviceHelper::instance()->getFileSystemUuidByMountPoint(devicePath);
+    return uuid.isEmpty() ? devicePath : "uuid:" + uuid;
+}
+
+/**
+   @return 设备文件列表的缓存路径
+ */
+QString DeviceIndexer::cacheFilePath(const QString &key)
+{
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/device_index";
+    const QByteArray hash = QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Md5).toHex();
+    return dir + "/" + QString::fromLatin1(hash) + ".dat";
+}
+
+DeviceIndexer::FileTypeMap DeviceIndexer::cachedListing(const QString &devicePath) const
+{
+    FileTypeMap files;
+    const QString key = deviceKey(devicePath);
+    QFile file(cacheFilePath(key));
+    if (!file.open(QIODevice::ReadOnly))
+        return files;
+
+    QDataStream stream(&file);
+    quint32 magic = 0;
+    qint32 version = 0;
+    QString savedKey;
+    qint32 count = 0;
+    stream >> magic >> version >> savedKey >> count;
+    if (sc_CacheMagic != magic || sc_CacheVersion != version || savedKey != key || count < 0) {
+        return files;
+    }
+
+    // 保存的是相对路径，挂载路径变化时拼接到当前挂载路径下
+    const QString prefix = devicePath.endsWith('/') ? devicePath : devicePath + '/';
+    for (qint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        QString relativePath;
+        qint32 type = 0;
+        stream >> relativePath >> type;
+        if (ItemTypePic == type || ItemTypeVideo == type)
+            files.insert(prefix + relativePath, static_cast<ItemType>(type));
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        qWarning() << "Device listing cache corrupted:" << devicePath;
+        files.clear();
+    }
+    return files;
+}
+
+void DeviceIndexer::saveListing(const QString &key, const QString &devicePath, const FileTypeMap &files)
+{
+    const QString filePath = cacheFilePath(key);
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to save device listing:" << filePath << file.errorString();
+        return;
+    }
+
+    const QString prefix = devicePath.endsWith('/') ? devicePath : devicePath + '/';
+    QDataStream stream(&file);
+    stream << sc_CacheMagic << sc_CacheVersion << key << qint32(files.size());
+    for (auto itr = files.constBegin(); itr != files.constEnd(); ++itr) {
+        const QString relativePath = itr.key().startsWith(prefix) ? itr.key().mid(prefix.size()) : itr.key();
+        stream << relativePath << qint32(itr.value());
+    }
+
+    if (!file.commit()) {
+        qWarning() << "Failed to commit device listing:" << filePath << file.errorString();
+    }
+}
@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DEVICEINDEXER_H
+#define DEVICEINDEXER_H
+
+#include "unionimage/unionimage_global.h"
+
+#include <QObject>
+#include <QMap>
+#include <QHash>
+#include <QSharedPointer>
+#include <QThreadPool>
+
+class DeviceScanTask;
+
+/*
+ * 外部设备（手机、U盘）图片视频索引，多线程并行遍历目录，按扩展名判断文件类型，
+ * 扫描过程中分批通知已发现的文件，支持卸载时取消，完整结果按设备缓存供下次插入时使用
+ */
+class DeviceIndexer : public QObject
+{
+    Q_OBJECT
+
+public:
+    using FileTypeMap = QMap<QString, ItemType>;
+
+    static DeviceIndexer *instance();
+
+    // 开始扫描设备，已在扫描中时忽略
+    void startScan(const QString &devicePath);
+    // 取消扫描，设备卸载时调用，不再发送该设备的信号
+    void cancelScan(const QString &devicePath);
+    bool isScanning(const QString &devicePath) const;
+
+    // 上次完整扫描缓存的文件列表，可能已过期
+    FileTypeMap cachedListing(const QString &devicePath) const;
+
+    // 按扩展名判断文件类型，仅对有歧义的扩展名读取文件内容，不支持的文件返回 ItemTypeNull
+    static ItemType classifyFile(const QString &filePath);
+
+Q_SIGNALS:
+    // 扫描过程中新发现的文件
+    void filesFound(const QString &devicePath, const DeviceIndexer::FileTypeMap &files);
+    // 扫描完成，\a files 为设备上的全部文件
+    void scanFinished(const QString &devicePath, const DeviceIndexer::FileTypeMap &files);
+
+private:
+    explicit DeviceIndexer(QObject *parent = nullptr);
+    ~DeviceIndexer() override;
+
+    void runWorker(const QSharedPointer<DeviceScanTask> &task);
+    void postFiles(const QSharedPointer<DeviceScanTask> &task, const FileTypeMap &files);
+    void onWorkerFinished(const QSharedPointer<DeviceScanTask> &task);
+
+    static QString deviceKey(const QString &devicePath);
+    static QString cacheFilePath(const QString &key);
+    static void saveListing(const QString &key, const QString &devicePath, const FileTypeMap &files);
+
+private:
+    QThreadPool m_pool;
+    QHash<QString, QSharedPointer<DeviceScanTask>> m_tasks;   // 扫描中的设备，仅在主线程访问
+
+    Q_DISABLE_COPY(DeviceIndexer)
+};
+
+#endif   // DEVICEINDEXER_H
@@ -0,0 +1,239 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "perfmetrics.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonDocument>
+#include <QDateTime>
+#include <QDebug>
+
+Q_LOGGING_CATEGORY(logThumbnail, "org.deepin.album.thumbnail", QtInfoMsg)
+Q_LOGGING_CATEGORY(logDecode, "org.deepin.album.decode", QtInfoMsg)
+Q_LOGGING_CATEGORY(logCache, "org.deepin.album.cache", QtInfoMsg)
+Q_LOGGING_CATEGORY(logDatabase, "org.deepin.album.database", QtInfoMsg)
+Q_LOGGING_CATEGORY(logMonitor, "org.deepin.album.monitor", QtInfoMsg)
+
+static const int sc_DefaultDumpInterval = 10;   // 定期输出间隔，秒
+
+static void updateMax(std::atomic<qint64> &target, qint64 value)
+{
+    qint64 old = target.load(std::memory_order_relaxed);
+    while (value > old && !target.compare_exchange_weak(old, value, std::memory_order_relaxed)) {
+    }
+}
+
+void PerfGauge::set(qint64 v)
+{
+    current.store(v, std::memory_order_relaxed);
+    updateMax(peak, v);
+}
+
+QJsonObject PerfGauge::toJson() const
+{
+    return QJsonObject {
+        {"current", current.load(std::memory_order_relaxed)},
+        {"peak", peak.load(std::memory_order_relaxed)},
+    };
+}
+
+void PerfGauge::reset()
+{
+    peak.store(current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+/**
+   @brief 记录一次耗时 \a us（微秒），第 i 个桶统计 [2^(i-1), 2^i) 微秒
+ */
+void PerfHistogram::record(qint64 us)
+{
+    if (us < 0) {
+        us = 0;
+    }
+    int bucket = 0;
+    for (qint64 v = us; v > 0 && bucket < BucketCount - 1; v >>= 1) {
+        ++bucket;
+    }
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(us, std::memory_order_relaxed);
+    updateMax(max, us);
+}
+
+/**
+   @return 按桶估算的百分位值，取所在桶的上界
+ */
+qint64 PerfHistogram::percentile(double ratio, qint64 total) const
+{
+    const qint64 target = qMax<qint64>(1, static_cast<qint64>(total * ratio + 0.5));
+    qint64 seen = 0;
+    for (int i = 0; i < BucketCount; ++i) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= target) {
+            return i == 0 ? 0 : (qint64(1) << i) - 1;
+        }
+    }
+    return max.load(std::memory_order_relaxed);
+}
+
+QJsonObject PerfHistogram::toJson() const
+{
+    const qint64 total = count.load(std::memory_order_relaxed);
+    QJsonObject obj {
+        {"count", total},
+        {"sumUs", sum.load(std::memory_order_relaxed)},
+        {"maxUs", max.load(std::memory_order_relaxed)},
+    };
+    if (total > 0) {
+        obj.insert("meanUs", static_cast<double>(sum.load(std::memory_order_relaxed)) / total);
+        obj.insert("p50Us", percentile(0.5, total));
+        obj.insert("p95Us", percentile(0.95, total));
+        obj.insert("p99Us", percentile(0.99, total));
+    }
+    return obj;
+}
+
+void PerfHistogram::reset()
+{
+    for (auto &bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+    max.store(0, std::memory_order_relaxed);
+}
+
+PerfMetrics::PerfMetrics(QObject *parent)
+    : QObject(parent)
+{
+    uptime.start();
+    // 可能在工作线程中首次创建，定时器及 D-Bus 接口需要在主线程中工作
+    if (QCoreApplication::instance() && thread() != QCoreApplication::instance()->thread()) {
+        moveToThread(QCoreApplication::instance()->thread());
+    }
+}
+
+PerfMetrics *PerfMetrics::instance()
+{
+    static PerfMetrics ins;
+    return &ins;
+}
+
+PerfCounter *PerfMetrics::counter(const char *name)
+{
+    QMutexLocker _locker(&mutex);
+    auto &item = counters[name];
+    if (!item) {
+        item.reset(new PerfCounter);
+    }
+    return item.get();
+}
+
+PerfGauge *PerfMetrics::gauge(const char *name)
+{
+    QMutexLocker _locker(&mutex);
+    auto &item = gauges[name];
+    if (!item) {
+        item.reset(new PerfGauge);
+    }
+    return item.get();
+}
+
+PerfHistogram *PerfMetrics::histogram(const char *name)
+{
+    QMutexLocker _locker(&mutex);
+    auto &item = histograms[name];
+    if (!item) {
+        item.reset(new PerfHistogram);
+    }
+    return item.get();
+}
+
+/**
+   @return 当前全部指标的快照
+ */
+QJsonObject PerfMetrics::snapshot() const
+{
+    QMutexLocker _locker(&mutex);
+    QJsonObject counterObj;
+    for (const auto &item : counters) {
+        counterObj.insert(QString::fromStdString(item.first), item.second->get());
+    }
+    QJsonObject gaugeObj;
+    for (const auto &item : gauges) {
+        gaugeObj.insert(QString::fromStdString(item.first), item.second->toJson());
+    }
+    QJsonObject histogramObj;
+    for (const auto &item : histograms) {
+        histogramObj.insert(QString::fromStdString(item.first), item.second->toJson());
+    }
+
+    return QJsonObject {
+        {"pid", QCoreApplication::applicationPid()},
+        {"timestamp", QDateTime::currentDateTime().toString(Qt::ISODateWithMs)},
+        {"uptimeMs", uptime.elapsed()},
+        {"counters", counterObj},
+        {"gauges", gaugeObj},
+        {"histograms", histogramObj},
+    };
+}
+
+QByteArray PerfMetrics::snapshotJson() const
+{
+    return QJsonDocument(snapshot()).toJson(QJsonDocument::Indented);
+}
+
+/**
+   @brief 将快照写入文件 \a path ，先写临时文件再重命名，读取方不会看到不完整的内容
+ */
+bool PerfMetrics::dumpTo(const QString &path) const
+{
+    const QString tempPath = path + ".tmp";
+    QFile file(tempPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Failed to write metrics snapshot:" << path;
+        return false;
+    }
+    file.write(snapshotJson());
+    file.close();
+    QFile::remove(path);
+    return QFile::rename(tempPath, path);
+}
+
+/**
+   @brief 清零计数器和直方图，瞬时值保留当前值
+ */
+void PerfMetrics::reset()
+{
+    QMutexLocker _locker(&mutex);
+    for (auto &item : counters) {
+        item.second->reset();
+    }
+    for (auto &item : gauges) {
+        item.second->reset();
+    }
+    for (auto &item : histograms) {
+        item.second->reset();
+    }
+}
+
+/**
+   @brief 每隔 \a intervalSec 秒将快照写入 \a path ，\a intervalSec 不大于 0 时使用默认间隔
+ */
+void PerfMetrics::startPeriodicDump(const QString &path, int intervalSec)
+{
+    if (path.isEmpty()) {
+        return;
+    }
+    if (!dumpTimer) {
+        dumpTimer = new QTimer(this);
+    }
+    dumpTimer->disconnect();
+    connect(dumpTimer, &QTimer::timeout, this, [this, path]() {
+        dumpTo(path);
+    });
+    dumpTimer->start((intervalSec > 0 ? intervalSec : sc_DefaultDumpInterval) * 1000);
+    qInfo() << "Metrics snapshot will be written to" << path << "every" << dumpTimer->interval() / 1000 << "s";
+}
@@ -0,0 +1,201 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PERFMETRICS_H
+#define PERFMETRICS_H
+
+#include "perftrace.h"
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QLoggingCategory>
+#include <QMutex>
+#include <QTimer>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+
+// 热点路径日志分类，调试输出默认关闭，通过 QT_LOGGING_RULES="org.deepin.album.*.debug=true" 打开
+Q_DECLARE_LOGGING_CATEGORY(logThumbnail)
+Q_DECLARE_LOGGING_CATEGORY(logDecode)
+Q_DECLARE_LOGGING_CATEGORY(logCache)
+Q_DECLARE_LOGGING_CATEGORY(logDatabase)
+Q_DECLARE_LOGGING_CATEGORY(logMonitor)
+
+/**
+ * @brief 计数器，只做原子累加
+ */
+class PerfCounter
+{
+public:
+    void add(qint64 n = 1)
+    {
+        value.fetch_add(n, std::memory_order_relaxed);
+    }
+    qint64 get() const
+    {
+        return value.load(std::memory_order_relaxed);
+    }
+    void reset()
+    {
+        value.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<qint64> value{0};
+};
+
+/**
+ * @brief 瞬时值，同时记录出现过的最大值，用于队列长度等
+ */
+class PerfGauge
+{
+public:
+    void set(qint64 v);
+    QJsonObject toJson() const;
+    void reset();
+
+private:
+    std::atomic<qint64> current{0};
+    std::atomic<qint64> peak{0};
+};
+
+/**
+ * @brief 耗时直方图，单位微秒，按 2 的幂分桶，记录时不加锁
+ */
+class PerfHistogram
+{
+public:
+    enum { BucketCount = 32 };
+
+    void record(qint64 us);
+    QJsonObject toJson() const;
+    void reset();
+
+private:
+    qint64 percentile(double ratio, qint64 total) const;
+
+    std::atomic<qint64> buckets[BucketCount] = {};
+    std::atomic<qint64> count{0};
+    std::atomic<qint64> sum{0};
+    std::atomic<qint64> max{0};
+};
+
+/**
+ * @brief 性能指标注册表。
+ *      指标按名称注册，首次使用时创建且不会销毁，调用处通过宏缓存指针，记录时不再查表。
+ *      快照以 JSON 形式通过 D-Bus 调试接口（MetricsAdaptor）提供，设置环境变量 DEEPIN_ALBUM_METRICS_DUMP
+ *      为文件路径时按 DEEPIN_ALBUM_METRICS_INTERVAL 秒（默认 10 秒）定期写入该文件。
+ * @note 编译时关闭 ENABLE_PERF_METRICS 后，下方宏均展开为空，不产生任何开销。
+ */
+class PerfMetrics : public QObject
+{
+    Q_OBJECT
+public:
+    static PerfMetrics *instance();
+
+    PerfCounter *counter(const char *name);
+    PerfGauge *gauge(const char *name);
+    PerfHistogram *histogram(const char *name);
+
+    QJsonObject snapshot() const;
+    QByteArray snapshotJson() const;
+    bool dumpTo(const QString &path) const;
+    void reset();
+
+    void startPeriodicDump(const QString &path, int intervalSec);
+
+private:
+    explicit PerfMetrics(QObject *parent = nullptr);
+
+private:
+    mutable QMutex mutex;
+    std::map<std::string, std::unique_ptr<PerfCounter>> counters;
+    std::map<std::string, std::unique_ptr<PerfGauge>> gauges;
+    std::map<std::string, std::unique_ptr<PerfHistogram>> histograms;
+    QElapsedTimer uptime;
+    QTimer *dumpTimer = nullptr;
+};
+
+/**
+ * @brief 作用域计时，析构时记录耗时到直方图，开启追踪时同时记录区间（PerfTrace），
+ *      对应分类开启调试输出时同时打印
+ */
+class PerfScope
+{
+public:
+    PerfScope(PerfHistogram *histogram, const QLoggingCategory &category, const char *name)
+        : m_histogram(histogram)
+        , m_category(category)
+        , m_name(name)
+    {
+        m_timer.start();
+    }
+
+    ~PerfScope()
+    {
+        const qint64 ns = m_timer.nsecsElapsed();
+        const qint64 us = ns / 1000;
+        m_histogram->record(us);
+        if (Q_UNLIKELY(PerfTrace::isEnabled())) {
+            PerfTrace::instance()->addSpan(m_category.categoryName(), m_name, ns);
+        }
+        if (m_category.isDebugEnabled()) {
+            QMessageLogger().debug(m_category) << m_name << "took" << us << "us";
+        }
+    }
+
+private:
+    Q_DISABLE_COPY(PerfScope)
+
+    PerfHistogram *m_histogram;
+    const QLoggingCategory &m_category;
+    const char *m_name;
+    QElapsedTimer m_timer;
+};
+
+#define ALBUM_PERF_CONCAT_IMPL(a, b) a##b
+#define ALBUM_PERF_CONCAT(a, b) ALBUM_PERF_CONCAT_IMPL(a, b)
+
+#ifdef ENABLE_PERF_METRICS
+
+// 对当前作用域计时，name 需为字符串常量
+#define ALBUM_TRACE_SCOPE(category, name)                                                                                  \
+    static PerfHistogram *const ALBUM_PERF_CONCAT(_perfHistogram, __LINE__) = PerfMetrics::instance()->histogram(name); \
+    const PerfScope ALBUM_PERF_CONCAT(_perfScope, __LINE__)(ALBUM_PERF_CONCAT(_perfHistogram, __LINE__), category(), name)
+
+#define ALBUM_COUNTER_ADD(name, n)                                                          \
+    do {                                                                                    \
+        static PerfCounter *const _perfCounter = PerfMetrics::instance()->counter(name);    \
+        _perfCounter->add(n);                                                               \
+    } while (0)
+
+#define ALBUM_COUNTER_INC(name) ALBUM_COUNTER_ADD(name, 1)
+
+#define ALBUM_GAUGE_SET(name, value)                                                    \
+    do {                                                                                \
+        static PerfGauge *const _perfGauge = PerfMetrics::instance()->gauge(name);      \
+        _perfGauge->set(value);                                                         \
+    } while (0)
+
+#define ALBUM_HISTOGRAM_RECORD(name, us)                                                        \
+    do {                                                                                        \
+        static PerfHistogram *const _perfHistogram = PerfMetrics::instance()->histogram(name);  \
+        _perfHistogram->record(us);                                                             \
+    } while (0)
+
+#else
+
+#define ALBUM_TRACE_SCOPE(category, name) do {} while (0)
+#define ALBUM_COUNTER_ADD(name, n) do {} while (0)
+#define ALBUM_COUNTER_INC(name) do {} while (0)
+#define ALBUM_GAUGE_SET(name, value) do {} while (0)
+#define ALBUM_HISTOGRAM_RECORD(name, us) do {} while (0)
+
+#endif  // ENABLE_PERF_METRICS
+
+#endif  // PERFMETRICS_H
@@ -0,0 +1,191 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "perftrace.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QThread>
+#include <QDebug>
+
+#include <chrono>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static const size_t sc_MaxSpans = 1000000;       // 区间数上限，约 40 MiB，超出后丢弃
+static const size_t sc_ReserveSpans = 64 * 1024;
+
+std::atomic<bool> PerfTrace::s_enabled{false};
+
+// 线程号及登记时的记录批次，线程首次产生区间时登记线程名
+static thread_local qint64 t_tid = 0;
+static thread_local int t_generation = -1;
+
+static QByteArray jsonString(const QString &text)
+{
+    // 借助 QJsonDocument 转义，仅用于线程名等少量字符串
+    QByteArray array = QJsonDocument(QJsonArray {text}).toJson(QJsonDocument::Compact);
+    return array.mid(1, array.size() - 2);
+}
+
+PerfTrace::PerfTrace()
+{
+}
+
+PerfTrace *PerfTrace::instance()
+{
+    static PerfTrace ins;
+    return &ins;
+}
+
+qint64 PerfTrace::nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+   @brief 开始记录，结束时写入 \a path ，已在记录中时返回 false
+ */
+bool PerfTrace::start(const QString &path)
+{
+    if (path.isEmpty()) {
+        return false;
+    }
+
+    QMutexLocker _locker(&mutex);
+    if (isEnabled()) {
+        qWarning() << "Trace already running, output:" << m_path;
+        return false;
+    }
+    m_path = path;
+    m_spans.clear();
+    m_spans.reserve(sc_ReserveSpans);
+    m_threadNames.clear();
+    m_dropped = 0;
+    ++m_generation;
+    m_originNs = nowNs();
+    s_enabled.store(true, std::memory_order_relaxed);
+    qInfo() << "Trace started, output:" << path;
+    return true;
+}
+
+/**
+   @brief 停止记录并写入文件
+   @return 未在记录或写入失败时返回 false
+ */
+bool PerfTrace::stop()
+{
+    if (!s_enabled.exchange(false)) {
+        return false;
+    }
+
+    QMutexLocker _locker(&mutex);
+    const bool ok = write(m_path);
+    if (ok) {
+        qInfo() << "Trace written:" << m_path << m_spans.size() << "spans," << m_dropped << "dropped";
+    }
+    std::vector<Span>().swap(m_spans);
+    m_threadNames.clear();
+    return ok;
+}
+
+QString PerfTrace::outputPath() const
+{
+    QMutexLocker _locker(&mutex);
+    return m_path;
+}
+
+/**
+   @brief 记录一个刚刚结束、持续 \a durationNs 纳秒的区间，由 PerfScope 在开启记录时调用
+ */
+void PerfTrace::addSpan(const char *category, const char *name, qint64 durationNs)
+{
+    // 先取结束时间，不把等锁的时间算进区间
+    const qint64 endNs = nowNs();
+
+    QMutexLocker _locker(&mutex);
+    if (!isEnabled()) {
+        return;
+    }
+    if (m_spans.size() >= sc_MaxSpans) {
+        ++m_dropped;
+        return;
+    }
+    const qint64 tid = registerThread();
+    // 开始记录之前进入的区间从记录起点算起
+    const qint64 beginNs = qMax(m_originNs, endNs - durationNs);
+    m_spans.push_back({category, name, beginNs - m_originNs, endNs - beginNs, tid});
+}
+
+/**
+   @return 当前线程的系统线程号，与 top、perf 中显示的一致；本批次首次出现时登记线程名
+ */
+qint64 PerfTrace::registerThread()
+{
+    if (t_tid == 0) {
+        t_tid = static_cast<qint64>(syscall(SYS_gettid));
+    }
+    if (t_generation != m_generation) {
+        t_generation = m_generation;
+        QThread *thread = QThread::currentThread();
+        QString name = thread ? thread->objectName() : QString();
+        if (name.isEmpty()) {
+            const bool isMain = QCoreApplication::instance() && thread == QCoreApplication::instance()->thread();
+            name = isMain ? QString("GUI") : QString("Thread %1").arg(t_tid);
+        }
+        m_threadNames.insert(t_tid, name);
+    }
+    return t_tid;
+}
+
+/**
+   @brief 按 Chrome trace 格式写入 \a path ，区间使用完整事件（ph 为 X，含开始时间与时长），
+    线程名使用元数据事件。区间数量可能很大，逐条拼接而不构造 QJsonArray
+ */
+bool PerfTrace::write(const QString &path) const
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Failed to write trace:" << path;
+        return false;
+    }
+
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+    QByteArray out;
+    out.reserve(4 * 1024 * 1024);
+    out += "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedSpans\":" + QByteArray::number(m_dropped) + "},\"traceEvents\":[\n";
+    out += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" + pid + ",\"args\":{\"name\":"
+           + jsonString(QCoreApplication::applicationName()) + "}}";
+    for (auto it = m_threadNames.cbegin(); it != m_threadNames.cend(); ++it) {
+        out += ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid + ",\"tid\":" + QByteArray::number(it.key())
+               + ",\"args\":{\"name\":" + jsonString(it.value()) + "}}";
+    }
+
+    for (const Span &span : m_spans) {
+        // 区间名与分类名均为代码中的字符串常量，无需转义
+        out += ",\n{\"name\":\"";
+        out += span.name;
+        out += "\",\"cat\":\"";
+        out += span.category;
+        out += "\",\"ph\":\"X\",\"ts\":";
+        out += QByteArray::number(span.beginNs / 1000.0, 'f', 3);
+        out += ",\"dur\":";
+        out += QByteArray::number(span.durationNs / 1000.0, 'f', 3);
+        out += ",\"pid\":";
+        out += pid;
+        out += ",\"tid\":";
+        out += QByteArray::number(span.tid);
+        out += "}";
+
+        if (out.size() > 3 * 1024 * 1024) {
+            file.write(out);
+            out.clear();
+        }
+    }
+    out += "\n]}\n";
+    file.write(out);
+    return file.error() == QFileDevice::NoError;
+}
@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PERFTRACE_H
+#define PERFTRACE_H
+
+#include <QMap>
+#include <QMutex>
+#include <QString>
+
+#include <atomic>
+#include <vector>
+
+/**
+ * @brief 按需开启的耗时区间追踪，输出 Chrome trace 格式的 JSON 文件，可直接在 Perfetto（ui.perfetto.dev）
+ *      或 chrome://tracing 中打开。
+ *      区间由 ALBUM_TRACE_SCOPE 埋点产生，记录名称、分类、起止时间及线程号，用于分析卡顿时耗时
+ *      落在缩略图读取线程、数据库锁、视频解析还是界面线程上。
+ *      启动时设置环境变量 DEEPIN_ALBUM_TRACE 为输出文件路径即开始记录，退出时写入；
+ *      运行中也可通过 D-Bus 调试接口（MetricsAdaptor）的 startTrace / stopTrace 开关。
+ * @note 未开启时埋点处仅多一次原子读取和分支判断。
+ */
+class PerfTrace
+{
+public:
+    static PerfTrace *instance();
+
+    // 是否正在记录，埋点处的唯一判断
+    static bool isEnabled()
+    {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+
+    bool start(const QString &path);
+    bool stop();
+    QString outputPath() const;
+
+    void addSpan(const char *category, const char *name, qint64 durationNs);
+
+private:
+    PerfTrace();
+    Q_DISABLE_COPY(PerfTrace)
+
+    struct Span {
+        const char *category;   // 分类名与区间名均为静态字符串，仅保存指针
+        const char *name;
+        qint64 beginNs;
+        qint64 durationNs;
+        qint64 tid;
+    };
+
+    static qint64 nowNs();
+    qint64 registerThread();
+    bool write(const QString &path) const;
+
+private:
+    static std::atomic<bool> s_enabled;
+
+    mutable QMutex mutex;
+    QString m_path;
+    qint64 m_originNs = 0;              // 时间基准，记录开始的时刻
+    std::vector<Span> m_spans;
+    QMap<qint64, QString> m_threadNames;
+    qint64 m_dropped = 0;               // 超出上限被丢弃的区间数
+    int m_generation = 0;               // 每次开始记录时递增，用于重新登记线程名
+};
+
+#endif  // PERFTRACE_H
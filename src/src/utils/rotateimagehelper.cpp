@@ -11,6 +11,8 @@
 #include <QFutureWatcher>
 #include <QTemporaryDir>
 #include <QtConcurrent>
+#include <QThreadPool>
+#include <QTimer>
 
 class RotateImageHelperData
 {
@@ -25,11 +27,24 @@ public:
     QMutex queueMutex;
     QQueue<QPair<QString, int>> processQueue;  // 待处理的图片队列
     QTemporaryDir cacheDir;                    // 临时文件目录
+
+    // 批量旋转任务
+    QThreadPool batchPool;                     // 批量旋转线程池，限制并发数
+    QMutex batchMutex;
+    QHash<QString, int> batchPending;          // 待处理的文件及累计旋转角度
+    QSet<QString> batchRunning;                // 正在处理的文件，同一文件不会并发处理
+    int batchFinished = 0;                     // 以下字段仅在主线程访问
+    int batchTotal = 0;
+    QStringList batchProcessed;                // 已处理文件
+    QStringList batchSucceeded;                // 旋转成功的文件
+    QStringList batchSkipped;                  // 为保持画质跳过的文件
 };
 
 RotateImageHelperData::RotateImageHelperData() 
 {
     qDebug() << "Initializing RotateImageHelperData";
+    // 旋转主要为文件读写，并发数不宜过高
+    batchPool.setMaxThreadCount(qBound(2, QThread::idealThreadCount() / 2, 4));
 }
 
 /**
@@ -50,6 +65,11 @@ RotateImageHelper::RotateImageHelper(QObject *parent)
             data->cacheDir.remove();
             qDebug() << "Rotation tasks completed and cache directory removed";
         }
+        if (data) {
+            // 未开始的批量任务不再处理，等待处理中的文件写入完成
+            data->batchPool.clear();
+            data->batchPool.waitForDone();
+        }
     });
 }
 
@@ -114,6 +134,127 @@ void RotateImageHelper::rotateImageFile(const QString &path, int angle)
     }
 }
 
+/**
+   @brief 批量旋转文件 \a paths 共 \a angle 度，文件在线程池中并发处理，
+    每个文件处理完成后发送进度信号，全部结束后统一发送结束信号，由接收方批量刷新缓存
+ */
+void RotateImageHelper::rotateImageFiles(const QStringList &paths, int angle)
+{
+    qDebug() << "Requesting batch rotation, count:" << paths.size() << "angle:" << angle;
+    angle = angle % 360;
+    if (0 == angle || paths.isEmpty()) {
+        qDebug() << "Skipping batch rotation - nothing to do";
+        return;
+    }
+
+    checkDataValid();
+
+    for (const QString &path : paths) {
+        if (path.isEmpty()) {
+            continue;
+        }
+
+        // 特殊位置不执行写入操作
+        imageViewerSpace::PathType pathType = LibUnionImage_NameSpace::getPathType(path);
+        if (pathType == imageViewerSpace::PathTypeMTP || pathType == imageViewerSpace::PathTypePTP ||
+            pathType == imageViewerSpace::PathTypeAPPLE || pathType == imageViewerSpace::PathTypeSAFEBOX ||
+            pathType == imageViewerSpace::PathTypeRECYCLEBIN) {
+            qDebug() << "Skipping rotation - unsupported path type:" << pathType << path;
+            continue;
+        }
+
+        QMutexLocker locker(&(data->batchMutex));
+        auto iter = data->batchPending.find(path);
+        if (iter != data->batchPending.end()) {
+            // 尚未处理，合并旋转角度
+            iter.value() = (iter.value() + angle) % 360;
+            continue;
+        }
+
+        data->batchPending.insert(path, angle);
+        ++data->batchTotal;
+        Q_EMIT recordRotateImage(path);
+
+        // 文件正在处理时，由处理线程继续处理新的旋转角度
+        if (!data->batchRunning.contains(path)) {
+            data->batchRunning.insert(path);
+            locker.unlock();
+            data->batchPool.start([this, path]() { runBatchRotateTask(path); });
+        }
+    }
+}
+
+/**
+   @brief 在线程池中处理文件 \a path 的旋转，处理期间新增的旋转请求将在同一线程中继续处理
+ */
+void RotateImageHelper::runBatchRotateTask(const QString &path)
+{
+    forever {
+        QMutexLocker locker(&(data->batchMutex));
+        if (!data->batchPending.contains(path)) {
+            data->batchRunning.remove(path);
+            break;
+        }
+        int angle = data->batchPending.take(path);
+        locker.unlock();
+
+        // 批量旋转不重新编码 JPEG，无法无损旋转的文件跳过
+        QString errorMsg;
+        bool skipped = false;
+        bool ret = (0 == angle) || LibUnionImage_NameSpace::rotateImageFIleLossless(angle, path, errorMsg, skipped);
+        if (skipped) {
+            qInfo() << "Batch rotation skipped for" << path << "to keep image quality";
+        } else if (!ret) {
+            qWarning() << "Batch rotation failed for" << path << "error:" << errorMsg;
+        }
+
+        QMetaObject::invokeMethod(this, [this, path, ret, skipped]() { onBatchRotateFinished(path, ret, skipped); }, Qt::QueuedConnection);
+    }
+}
+
+/**
+   @brief 主线程中记录文件 \a path 的处理结果，全部处理完成后统一清除旋转状态并通知外部
+ */
+void RotateImageHelper::onBatchRotateFinished(const QString &path, bool ret, bool skipped)
+{
+    ++data->batchFinished;
+    data->batchProcessed.append(path);
+    if (ret && !data->batchSucceeded.contains(path)) {
+        data->batchSucceeded.append(path);
+    }
+    if (skipped && !data->batchSkipped.contains(path)) {
+        data->batchSkipped.append(path);
+    }
+    Q_EMIT batchRotateProgress(path, ret, data->batchFinished, data->batchTotal);
+
+    if (data->batchFinished < data->batchTotal) {
+        return;
+    }
+
+    qInfo() << "Batch rotation finished, succeeded:" << data->batchSucceeded.size()
+            << "skipped:" << data->batchSkipped.size() << "total:" << data->batchTotal;
+    // 文件变更通知可能滞后，延后清除旋转状态，防止监控触发逐个刷新
+    QStringList processed = data->batchProcessed;
+    QTimer::singleShot(100, this, [this, processed]() {
+        for (const QString &file : processed) {
+            Q_EMIT clearRotateStatus(file);
+        }
+    });
+
+    QStringList succeeded = data->batchSucceeded;
+    QStringList skippedPaths = data->batchSkipped;
+    data->batchFinished = 0;
+    data->batchTotal = 0;
+    data->batchProcessed.clear();
+    data->batchSucceeded.clear();
+    data->batchSkipped.clear();
+
+    if (!skippedPaths.isEmpty()) {
+        Q_EMIT batchRotateSkipped(skippedPaths);
+    }
+    Q_EMIT batchRotateFinished(succeeded);
+}
+
 /**
    @brief 用于重置旋转记录信息，不会影响在处理中的文件
  */
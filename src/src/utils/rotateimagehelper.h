@@ -16,9 +16,16 @@ public:
     static RotateImageHelper *instance();
 
     Q_SLOT void rotateImageFile(const QString &path, int angle);
+    Q_SLOT void rotateImageFiles(const QStringList &paths, int angle);
     Q_SLOT void resetRotateState();
 
     Q_SIGNAL void rotateImageFinished(const QString &path, bool ret);
+    // 批量旋转进度，每处理完一个文件触发
+    Q_SIGNAL void batchRotateProgress(const QString &path, bool ret, int finished, int total);
+    // 批量旋转中为保持画质未处理的文件，在 batchRotateFinished 之前触发
+    Q_SIGNAL void batchRotateSkipped(const QStringList &paths);
+    // 批量旋转全部结束，\a paths 为旋转成功的文件
+    Q_SIGNAL void batchRotateFinished(const QStringList &paths);
 
     static bool rotateImageImpl(const QString &cachePath, const QString &path, int angle);
 
@@ -27,6 +34,8 @@ private:
     virtual ~RotateImageHelper() = default;
 
     void enqueueRotateTask(const QString &path, int angle);
+    void runBatchRotateTask(const QString &path);
+    void onBatchRotateFinished(const QString &path, bool ret, bool skipped);
     void checkDataValid();
     // internal 用于异步处理图片旋转状态
     Q_SIGNAL void recordRotateImage(const QString &targetPath);
@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "trashexpiryscheduler.h"
+#include "classifyscheduler.h"
+#include "imageengine/imageenginethread.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+
+static const int sc_StartDelay = 30 * 1000;            // 启动后首次清理的延迟
+static const int sc_PurgeInterval = 60 * 60 * 1000;    // 定时清理间隔
+static const int sc_BusyRetry = 5000;                  // 忙碌时推迟的时长
+
+TrashExpiryScheduler *TrashExpiryScheduler::instance()
+{
+    static TrashExpiryScheduler ins;
+    return &ins;
+}
+
+TrashExpiryScheduler::TrashExpiryScheduler(QObject *parent)
+    : QObject(parent)
+{
+    // 单线程低优先级执行，不影响界面加载
+    m_pool.setMaxThreadCount(1);
+    m_pool.setThreadPriority(QThread::LowestPriority);
+
+    m_timer = new QTimer(this);
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &TrashExpiryScheduler::onTimeout);
+
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, &TrashExpiryScheduler::stop);
+    }
+}
+
+TrashExpiryScheduler::~TrashExpiryScheduler()
+{
+    stop();
+}
+
+void TrashExpiryScheduler::start()
+{
+    if (isStopped() || m_running || m_timer->isActive())
+        return;
+
+    m_timer->start(sc_StartDelay);
+}
+
+bool TrashExpiryScheduler::isStopped() const
+{
+    return m_stopped.loadRelaxed();
+}
+
+void TrashExpiryScheduler::onTimeout()
+{
+    if (isStopped() || m_running)
+        return;
+
+    // 导入或浏览中，推迟到空闲后再清理
+    if (ClassifyScheduler::instance()->isBusy()) {
+        m_timer->start(sc_BusyRetry);
+        return;
+    }
+
+    m_running = true;
+    PurgeExpiredTrashThread *purgeThread = new PurgeExpiredTrashThread;
+    connect(purgeThread, &PurgeExpiredTrashThread::runFinished, this, &TrashExpiryScheduler::onTaskFinished, Qt::QueuedConnection);
+    m_pool.start(purgeThread);
+}
+
+/**
+   @brief 一轮清理结束，因忙碌中断时尽快继续，否则等待下一个周期
+ */
+void TrashExpiryScheduler::onTaskFinished()
+{
+    m_running = false;
+    if (isStopped())
+        return;
+
+    m_timer->start(ClassifyScheduler::instance()->isBusy() ? sc_BusyRetry : sc_PurgeInterval);
+}
+
+void TrashExpiryScheduler::stop()
+{
+    if (m_stopped.fetchAndStoreRelaxed(1))
+        return;
+
+    m_timer->stop();
+    m_pool.waitForDone();
+}
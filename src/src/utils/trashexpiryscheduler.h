@@ -0,0 +1,48 @@
+// SPDX-FileCopyrightText: 2025 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef TRASHEXPIRYSCHEDULER_H
+#define TRASHEXPIRYSCHEDULER_H
+
+#include <QObject>
+#include <QAtomicInt>
+#include <QThreadPool>
+#include <QTimer>
+
+/*
+ * 最近删除到期清理调度，定时在空闲时分批删除已到期的备份文件和数据库记录，
+ * 打开最近删除时不再同步清理
+ */
+class TrashExpiryScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    static TrashExpiryScheduler *instance();
+
+    // 启动定时清理，启动后稍作延迟执行第一次
+    void start();
+    bool isStopped() const;
+
+    // 一轮清理结束，\a count 为删除的记录数，在工作线程中触发
+    Q_SIGNAL void trashPurged(int count);
+
+private:
+    explicit TrashExpiryScheduler(QObject *parent = nullptr);
+    ~TrashExpiryScheduler() override;
+
+    void onTimeout();
+    void onTaskFinished();
+    void stop();
+
+private:
+    QThreadPool m_pool;
+    QTimer *m_timer { nullptr };
+    bool m_running { false };
+    QAtomicInt m_stopped { 0 };
+
+    Q_DISABLE_COPY(TrashExpiryScheduler)
+};
+
+#endif   // TRASHEXPIRYSCHEDULER_H
@@ -36,6 +36,7 @@ DWIDGET_USE_NAMESPACE
 
 //#include "imageengineapi.h"
 #include "imageengine/imagedataservice.h"
+#include "imagedata/imagescaler.h"
 //#include "signalmanager.h"
 namespace {
 const QString IMAGE_DEFAULTTYPE = "All pics";
@@ -187,7 +188,7 @@ void ThumbnailDelegate::drawImgAndVideo(QPainter *painter, const QStyleOptionVie
                 painter->drawPixmap(pixmapRect, m_damagePixmap);
             }
         } else {
-            painter->drawPixmap(pixmapRect, QPixmap::fromImage(img));
+            painter->drawPixmap(pixmapRect, scaledPixmap(img, pixmapRect.size(), painter->device()->devicePixelRatioF()));
         }
     }
 
@@ -368,6 +369,24 @@ QRect ThumbnailDelegate::updatePaintedRect(const QRectF &boundingRect, const QIm
     return destRect.toRect();
 }
 
+QPixmap ThumbnailDelegate::scaledPixmap(const QImage &image, const QSize &size, qreal ratio) const
+{
+    const QSize target = size * ratio;
+    if (target.isEmpty() || image.size() == target) {
+        return QPixmap::fromImage(image);
+    }
+
+    // 缩略图内容变化时 cacheKey 随之变化，旧的缩放结果自然失效
+    const QString key = QString("thumbnail_delegate_%1_%2x%3").arg(image.cacheKey()).arg(target.width()).arg(target.height());
+    QPixmap pixmap;
+    if (!QPixmapCache::find(key, &pixmap)) {
+        pixmap = QPixmap::fromImage(ImageScaler::scaled(image, target));
+        QPixmapCache::insert(key, pixmap);
+    }
+    pixmap.setDevicePixelRatio(ratio);
+    return pixmap;
+}
+
 bool ThumbnailDelegate::editorEvent(QEvent *event, QAbstractItemModel *model, const QStyleOptionViewItem &option, const QModelIndex &index)
 {
     // qDebug() << "ThumbnailDelegate::editorEvent - Function entry, event type:" << event->type() << "index:" << index;
@@ -61,6 +61,8 @@ signals:
 private:
     DBImgInfo itemData(const QModelIndex &index) const;
     QRect updatePaintedRect(const QRectF &boundingRect, const QImage& image) const;
+    // 获取缩放到绘制区域大小的缩略图，避免每次绘制时由画笔缩放
+    QPixmap scaledPixmap(const QImage &image, const QSize &size, qreal ratio) const;
 public:
     QString m_imageTypeStr;
 
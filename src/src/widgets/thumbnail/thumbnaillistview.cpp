@@ -104,6 +104,11 @@ ThumbnailListView::ThumbnailListView(ThumbnailDelegate::DelegateType type, int U
     m_scrollTimer->setSingleShot(true);
     connect(m_scrollTimer, &QTimer::timeout, this, &ThumbnailListView::onScrollTimerOut);
 
+    m_visibleHintTimer = new QTimer(this);
+    m_visibleHintTimer->setInterval(50);
+    m_visibleHintTimer->setSingleShot(true);
+    connect(m_visibleHintTimer, &QTimer::timeout, this, &ThumbnailListView::updateVisibleHint);
+
     m_importTimer = new QTimer(this);
     connect(m_importTimer, &QTimer::timeout, this, [this]() {
         this->update();
@@ -1261,6 +1266,9 @@ void ThumbnailListView::resizeEvent(QResizeEvent *e)
 
     resizeEventF();
     this->verticalScrollBar()->setFixedHeight(this->height());
+    if (m_visibleHintTimer) {
+        m_visibleHintTimer->start();
+    }
     // qDebug() << "ThumbnailListView::resizeEvent - Exit: resize completed";
 }
 
@@ -2207,9 +2215,72 @@ void ThumbnailListView::onScrollbarValueChanged(int value)
     }
 
     flushTopTimeLine(8); //滑完了要刷新顶部
+
+    //节流上报可见区域，滑动过程中也能持续调整缩略图加载优先级
+    if (!m_visibleHintTimer->isActive()) {
+        m_visibleHintTimer->start();
+    }
     qDebug() << "ThumbnailListView::onScrollbarValueChanged - Exit";
 }
 
+void ThumbnailListView::updateVisibleHint()
+{
+    const int count = m_model->rowCount();
+    if (!isVisible() || count == 0) {
+        return;
+    }
+
+    const QRect viewRect = viewport()->rect();
+
+    //IconMode下各项的纵向位置单调递增，二分查找第一个底边进入视口的项
+    int low = 0;
+    int high = count - 1;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (visualRect(m_model->index(mid, 0)).bottom() < viewRect.top()) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    const int firstRow = low;
+    int lastRow = firstRow;
+    while (lastRow + 1 < count && visualRect(m_model->index(lastRow + 1, 0)).top() <= viewRect.bottom()) {
+        lastRow++;
+    }
+
+    //按滚动方向向外预加载一屏
+    const int scrollValue = verticalScrollBar()->value();
+    const bool scrollUp = scrollValue < m_lastScrollValue;
+    m_lastScrollValue = scrollValue;
+    const int prefetchCount = lastRow - firstRow + 1;
+
+    auto appendPath = [this](int row, QStringList &paths) {
+        DBImgInfo data = m_model->index(row, 0).data(Qt::DisplayRole).value<DBImgInfo>();
+        if (data.itemType == ItemTypePic || data.itemType == ItemTypeVideo) {
+            paths.append(data.filePath);
+        }
+    };
+
+    QStringList visiblePaths;
+    for (int row = firstRow; row <= lastRow; row++) {
+        appendPath(row, visiblePaths);
+    }
+
+    QStringList prefetchPaths;
+    if (scrollUp) {
+        for (int row = firstRow - 1; row >= qMax(0, firstRow - prefetchCount); row--) {
+            appendPath(row, prefetchPaths);
+        }
+    } else {
+        for (int row = lastRow + 1; row <= qMin(count - 1, lastRow + prefetchCount); row++) {
+            appendPath(row, prefetchPaths);
+        }
+    }
+
+    ImageDataService::instance()->setVisibleHint(visiblePaths, prefetchPaths, COMMON_STR_TRASH == m_imageType);
+}
+
 void ThumbnailListView::flushTopTimeLine(int offset)
 {
     qDebug() << "Flushing top timeline with offset:" << offset;
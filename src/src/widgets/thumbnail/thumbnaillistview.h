@@ -206,6 +206,7 @@ private:
     void initMenuAction();
     DMenu *createAlbumMenu();
     void flushTopTimeLine(int offset); //刷新顶部的时间线显示
+    void updateVisibleHint(); //向缩略图加载队列提示当前可见项
     void resizeEvent(QResizeEvent *e) override;
     bool eventFilter(QObject *obj, QEvent *e) override;
     //获取当前index所属时间线的时间和数量
@@ -265,6 +266,8 @@ public:
     bool m_animationEnable = false;//标题上滑动画是否可执行
     QPropertyAnimation *m_animation = nullptr;
     QTimer *m_scrollTimer = nullptr;
+    QTimer *m_visibleHintTimer = nullptr; //可见区域提示节流定时器
+    int m_lastScrollValue = 0;
     int m_height = 0;
     int m_onePicWidth = 0;
     bool m_isSelectAllBtn = false; //平板下，是否选中所有,默认未选定
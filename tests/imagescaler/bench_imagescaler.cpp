@@ -0,0 +1,241 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "imagedata/imagescaler.h"
+
+#include <QtTest>
+#include <QPainter>
+#include <QLinearGradient>
+
+// 缩略图边长，与 imagedataservice.cpp 中网格缩略图使用的 THUMBNAIL_MAX_SIZE 一致
+static const int sc_ThumbnailSize = 180;
+
+/**
+ * @brief 缩放模块与 QImage::scaled 的性能对比。
+ *      样例覆盖相机照片（JPEG 解码得到的 RGB32）、带透明通道的截图（PNG 解码得到的 ARGB32）及已缩小的派生图，
+ *      分别测量缩略图裁剪模式、完整显示模式下 Qt 原流程与缩放模块的耗时。
+ *      裁剪模式的原流程使用 Qt::FastTransformation，耗时更低但画质不可比，对比时需同时参考 accuracy 的结果。
+ *      运行 bench_imagescaler -tickcounter 或 -iterations N 可得到更稳定的数据。
+ */
+class BenchImageScaler : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void clipToSquare_data();
+    void clipToSquare();
+    void fitToEdge_data();
+    void fitToEdge();
+
+    void accuracy_data();
+    void accuracy();
+
+private:
+    static QImage makeImage(const QSize &size, QImage::Format format);
+    static QImage legacyClipToRect(const QImage &src);
+    static void addRows();
+};
+
+void BenchImageScaler::initTestCase()
+{
+    qInfo() << "Image scaler kernels:" << ImageScaler::instructionSet();
+}
+
+/**
+   @return 生成带渐变和细线条的测试图，细节足够让不同滤波器的结果产生差异
+ */
+QImage BenchImageScaler::makeImage(const QSize &size, QImage::Format format)
+{
+    QImage image(size, format);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    QLinearGradient gradient(0, 0, size.width(), size.height());
+    gradient.setColorAt(0, QColor(255, 80, 20, 255));
+    gradient.setColorAt(0.5, QColor(30, 160, 90, 200));
+    gradient.setColorAt(1, QColor(20, 40, 220, 255));
+    painter.fillRect(image.rect(), gradient);
+    painter.setPen(QPen(Qt::white, 1));
+    for (int x = 0; x < size.width(); x += 7) {
+        painter.drawLine(x, 0, size.width() - x, size.height());
+    }
+    painter.end();
+    return image;
+}
+
+/**
+   @brief 替换前 ReadThumbnailManager::clipToRect 的实现：先按短边快速缩放，宽高相差 10% 以上时再复制中间的方形区域
+ */
+QImage BenchImageScaler::legacyClipToRect(const QImage &src)
+{
+    auto tImg = src;
+
+    if (!tImg.isNull() && 0 != tImg.height() && 0 != tImg.width() && (tImg.height() / tImg.width()) < 10 && (tImg.width() / tImg.height()) < 10) {
+        bool cache_exist = false;
+        if (tImg.height() != sc_ThumbnailSize && tImg.width() != sc_ThumbnailSize) {
+            if (tImg.height() >= tImg.width()) {
+                cache_exist = true;
+                tImg = tImg.scaledToWidth(sc_ThumbnailSize, Qt::FastTransformation);
+            } else if (tImg.height() <= tImg.width()) {
+                cache_exist = true;
+                tImg = tImg.scaledToHeight(sc_ThumbnailSize, Qt::FastTransformation);
+            }
+        }
+        if (!cache_exist) {
+            if ((static_cast<float>(tImg.height()) / (static_cast<float>(tImg.width()))) > 3) {
+                tImg = tImg.scaledToWidth(sc_ThumbnailSize, Qt::FastTransformation);
+            } else {
+                tImg = tImg.scaledToHeight(sc_ThumbnailSize, Qt::FastTransformation);
+            }
+        }
+    }
+
+    if (!tImg.isNull()) {
+        int width = tImg.width();
+        int height = tImg.height();
+        if (qAbs((width - height) * 10 / width) >= 1) {
+            QRect rect = tImg.rect();
+            int x = rect.x() + width / 2;
+            int y = rect.y() + height / 2;
+            if (width > height) {
+                x = x - height / 2;
+                y = 0;
+                tImg = tImg.copy(x, y, height, height);
+            } else {
+                y = y - width / 2;
+                x = 0;
+                tImg = tImg.copy(x, y, width, width);
+            }
+        }
+    }
+
+    return tImg;
+}
+
+void BenchImageScaler::addRows()
+{
+    QTest::addColumn<QSize>("size");
+    QTest::addColumn<int>("format");
+    QTest::addColumn<int>("method");
+
+    struct Sample {
+        const char *name;
+        QSize size;
+        QImage::Format format;
+    };
+    const Sample samples[] = {
+        {"photo-12mp", QSize(4000, 3000), QImage::Format_RGB32},
+        {"photo-24mp-portrait", QSize(4000, 6000), QImage::Format_RGB32},
+        {"screenshot-alpha", QSize(1920, 1080), QImage::Format_ARGB32},
+        {"derivative-1024", QSize(1024, 768), QImage::Format_RGB32},
+    };
+    const char *methods[] = {"qt", "area", "lanczos"};
+
+    for (const Sample &sample : samples) {
+        for (int method = 0; method < 3; ++method) {
+            QTest::newRow(QByteArray(sample.name) + "/" + methods[method]) << sample.size << static_cast<int>(sample.format) << method;
+        }
+    }
+}
+
+void BenchImageScaler::clipToSquare_data()
+{
+    addRows();
+}
+
+void BenchImageScaler::clipToSquare()
+{
+    QFETCH(QSize, size);
+    QFETCH(int, format);
+    QFETCH(int, method);
+
+    const QImage src = makeImage(size, static_cast<QImage::Format>(format));
+    QImage result;
+    if (method == 0) {
+        // 原流程：先按短边快速缩放（最近邻）再复制中间的方形区域
+        QBENCHMARK {
+            result = legacyClipToRect(src);
+        }
+    } else {
+        const ImageScaler::Filter filter = method == 1 ? ImageScaler::AreaAverage : ImageScaler::Lanczos3;
+        const int side = qMin(size.width(), size.height());
+        const QRectF rect((size.width() - side) / 2.0, (size.height() - side) / 2.0, side, side);
+        QBENCHMARK {
+            result = ImageScaler::cropScaled(src, rect, QSize(sc_ThumbnailSize, sc_ThumbnailSize), filter);
+        }
+    }
+    QCOMPARE(result.size(), QSize(sc_ThumbnailSize, sc_ThumbnailSize));
+}
+
+void BenchImageScaler::fitToEdge_data()
+{
+    addRows();
+}
+
+void BenchImageScaler::fitToEdge()
+{
+    QFETCH(QSize, size);
+    QFETCH(int, format);
+    QFETCH(int, method);
+
+    const QImage src = makeImage(size, static_cast<QImage::Format>(format));
+    const QSize target = size.scaled(sc_ThumbnailSize, sc_ThumbnailSize, Qt::KeepAspectRatio);
+    QImage result;
+    if (method == 0) {
+        // 原流程：整张原图转换为 RGBA8888 后再缩放
+        QBENCHMARK {
+            result = src.convertToFormat(QImage::Format_RGBA8888).scaled(target, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        }
+    } else {
+        const ImageScaler::Filter filter = method == 1 ? ImageScaler::AreaAverage : ImageScaler::Lanczos3;
+        QBENCHMARK {
+            result = ImageScaler::scaled(src, target, filter, QImage::Format_RGBA8888);
+        }
+    }
+    QCOMPARE(result.size(), target);
+    QCOMPARE(result.format(), QImage::Format_RGBA8888);
+}
+
+void BenchImageScaler::accuracy_data()
+{
+    QTest::addColumn<int>("format");
+    QTest::addColumn<int>("filter");
+
+    QTest::newRow("rgb32/area") << static_cast<int>(QImage::Format_RGB32) << static_cast<int>(ImageScaler::AreaAverage);
+    QTest::newRow("rgb32/lanczos") << static_cast<int>(QImage::Format_RGB32) << static_cast<int>(ImageScaler::Lanczos3);
+    QTest::newRow("argb32/area") << static_cast<int>(QImage::Format_ARGB32) << static_cast<int>(ImageScaler::AreaAverage);
+    QTest::newRow("rgb888/area") << static_cast<int>(QImage::Format_RGB888) << static_cast<int>(ImageScaler::AreaAverage);
+}
+
+/**
+   @brief 与 Qt 平滑缩放的结果逐像素比较，平均误差应很小，确认通道顺序与预乘处理正确
+ */
+void BenchImageScaler::accuracy()
+{
+    QFETCH(int, format);
+    QFETCH(int, filter);
+
+    const QImage src = makeImage(QSize(1600, 1200), static_cast<QImage::Format>(format));
+    const QSize target(400, 300);
+    const QImage expected = src.scaled(target, Qt::IgnoreAspectRatio, Qt::SmoothTransformation).convertToFormat(QImage::Format_RGBA8888);
+    const QImage actual = ImageScaler::scaled(src, target, static_cast<ImageScaler::Filter>(filter), QImage::Format_RGBA8888);
+    QCOMPARE(actual.size(), target);
+
+    qint64 diff = 0;
+    for (int y = 0; y < target.height(); ++y) {
+        const uchar *a = expected.constScanLine(y);
+        const uchar *b = actual.constScanLine(y);
+        for (int x = 0; x < target.width() * 4; ++x) {
+            diff += qAbs(a[x] - b[x]);
+        }
+    }
+    const double mean = static_cast<double>(diff) / (target.width() * target.height() * 4);
+    QVERIFY2(mean < 6.0, qPrintable(QString("mean channel difference %1").arg(mean)));
+}
+
+QTEST_GUILESS_MAIN(BenchImageScaler)
+
+#include "bench_imagescaler.moc"
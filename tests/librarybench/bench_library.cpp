@@ -0,0 +1,437 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "syntheticlibrary.h"
+#include "albumControl.h"
+#include "configsetter.h"
+#include "dbmanager/dbmanager.h"
+#include "fileMonitor/fileinotify.h"
+#include "imagedata/imagescaler.h"
+#include "imageengine/imagedataservice.h"
+#include "imageengine/imageenginethread.h"
+#include "utils/perfmetrics.h"
+
+#include <QtTest>
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QLoggingCategory>
+#include <QSysInfo>
+
+#include <algorithm>
+#include <cstdlib>
+#include <unistd.h>
+
+static const int sc_DefaultIterations = 20;
+static const int sc_WaitTimeoutMs = 10 * 60 * 1000;
+static const int sc_InotifyTimeoutMs = 10 * 1000;
+
+static double median(QVector<double> samples)
+{
+    if (samples.isEmpty()) {
+        return 0;
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples.at(samples.size() / 2);
+}
+
+/**
+ * @brief 图库性能基准：在合成图库上测量导入、缩略图加载、数据库查询及目录监控的耗时。
+ *      每项结果同时通过 QTest::setBenchmarkResult 输出，并汇总写入 JSON 文件（ALBUM_BENCH_JSON，
+ *      默认为当前目录下的 bench_library.json），便于在不同提交之间比较。
+ *      查询类指标重复 ALBUM_BENCH_ITERATIONS 次，记录最小值、中位数、p95 等统计值。
+ * @note 数据库、缩略图目录均位于 HOME 下，程序启动时会切换到临时 HOME 重新执行，不会影响用户的相册数据。
+ */
+class BenchLibrary : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void importThroughput();
+    void thumbnailCold();
+    void thumbnailWarm();
+    void queryTimeline();
+    void queryAlbum();
+    void querySearch();
+    void fileInotifyReaction();
+
+private:
+    template<typename Func>
+    QVector<double> sample(Func func) const;
+    double loadThumbnails(const QStringList &paths, bool cold);
+    void ensureQueryData();
+
+    void addSamples(const QString &name, const QVector<double> &samples);
+    void addValue(const QString &name, const QString &unit, double value);
+
+private:
+    SyntheticLibrary::Config m_config;
+    QScopedPointer<SyntheticLibrary> m_library;
+    int m_iterations = sc_DefaultIterations;
+    int m_albumUID = -1;
+    bool m_queryDataReady = false;
+    QJsonArray m_results;
+};
+
+void BenchLibrary::initTestCase()
+{
+    m_config = SyntheticLibrary::Config::fromEnvironment();
+    bool ok = false;
+    const int iterations = qEnvironmentVariableIntValue("ALBUM_BENCH_ITERATIONS", &ok);
+    if (ok && iterations > 0) {
+        m_iterations = iterations;
+    }
+
+    LibConfigSetter::instance()->loadConfig(imageViewerSpace::ImgViewerTypeAlbum);
+
+    QElapsedTimer timer;
+    timer.start();
+    m_library.reset(new SyntheticLibrary(QDir::homePath() + "/Pictures/bench-library", m_config));
+    QVERIFY(m_library->generate());
+    addValue("library.generate", "ms", timer.elapsed());
+    addValue("library.bytes", "bytes", m_library->totalBytes());
+}
+
+void BenchLibrary::cleanupTestCase()
+{
+    QJsonObject root {
+        {"schema", 1},
+        {"benchmark", "deepin-album-library"},
+        {"timestamp", QDateTime::currentDateTimeUtc().toString(Qt::ISODate)},
+        {"qt", qVersion()},
+        {"kernel", QSysInfo::kernelVersion()},
+        {"cpu", QSysInfo::currentCpuArchitecture()},
+        {"threads", QThread::idealThreadCount()},
+        {"scalerKernels", ImageScaler::instructionSet()},
+        {"iterations", m_iterations},
+        {"config", m_config.toJson()},
+        {"results", m_results},
+        // 整个运行期间应用内部埋点的累计值，便于定位结果变化来自哪一层
+        {"metrics", PerfMetrics::instance()->snapshot()},
+    };
+
+    const QString path = qEnvironmentVariable("ALBUM_BENCH_JSON", QDir(qEnvironmentVariable("ALBUM_BENCH_CWD", QDir::currentPath())).filePath("bench_library.json"));
+    QFile file(path);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        file.write(QJsonDocument(root).toJson());
+        qInfo() << "Benchmark results written to" << path;
+    } else {
+        qWarning() << "Failed to write benchmark results:" << path;
+    }
+
+    ImageDataService::instance()->stopFlushThumbnail();
+    ImageDataService::instance()->waitFlushThumbnailFinish();
+
+    // 只清理本程序创建的临时 HOME
+    const QString home = QDir::homePath();
+    if (qEnvironmentVariableIsSet("ALBUM_BENCH_ISOLATED") && !qEnvironmentVariableIsSet("ALBUM_BENCH_KEEP")
+            && home.startsWith(QDir::tempPath() + "/album-bench-")) {
+        QDir(home).removeRecursively();
+    }
+}
+
+/**
+   @brief 导入吞吐：通过 ImportImagesThread 导入整个合成图库目录，包含目录遍历、元数据解析及写库
+ */
+void BenchLibrary::importThroughput()
+{
+    ImportImagesThread *thread = new ImportImagesThread;
+    thread->setData(QStringList() << m_library->root(), -1);
+    thread->setNotifyUI(false);
+
+    QEventLoop loop;
+    connect(thread, &ImportImagesThread::runFinished, &loop, &QEventLoop::quit);
+    QTimer::singleShot(sc_WaitTimeoutMs, &loop, &QEventLoop::quit);
+
+    QElapsedTimer timer;
+    timer.start();
+    QThreadPool::globalInstance()->start(thread);
+    loop.exec();
+    const double elapsed = timer.nsecsElapsed() / 1e6;
+
+    const int files = m_library->imagePaths().size() + m_library->videoPaths().size();
+    const int imported = DBManager::instance()->getImgsCount();
+    QCOMPARE(imported, m_library->imagePaths().size());
+
+    addValue("import.total", "ms", elapsed);
+    addValue("import.throughput", "files/s", files / (elapsed / 1000.0));
+    QTest::setBenchmarkResult(elapsed, QTest::WalltimeMilliseconds);
+}
+
+/**
+   @brief 冷启动缩略图吞吐：删除内存缓存、缩略图文件及派生图后重新生成
+ */
+void BenchLibrary::thumbnailCold()
+{
+    const double elapsed = loadThumbnails(m_library->imagePaths(), true);
+    QVERIFY(elapsed >= 0);
+    addValue("thumbnail.cold.total", "ms", elapsed);
+    addValue("thumbnail.cold.throughput", "images/s", m_library->imagePaths().size() / (elapsed / 1000.0));
+    QTest::setBenchmarkResult(elapsed, QTest::WalltimeMilliseconds);
+}
+
+/**
+   @brief 热缓存缩略图吞吐：缩略图均已生成，内存缓存容量内的直接命中，其余读取缩略图文件
+ */
+void BenchLibrary::thumbnailWarm()
+{
+    const double elapsed = loadThumbnails(m_library->imagePaths(), false);
+    QVERIFY(elapsed >= 0);
+    addValue("thumbnail.warm.total", "ms", elapsed);
+    addValue("thumbnail.warm.throughput", "images/s", m_library->imagePaths().size() / qMax(elapsed / 1000.0, 1e-6));
+    QTest::setBenchmarkResult(elapsed, QTest::WalltimeMilliseconds);
+}
+
+void BenchLibrary::queryTimeline()
+{
+    ensureQueryData();
+    DBManager *db = DBManager::instance();
+
+    const QStringList days = db->getDays();
+    QVERIFY(!days.isEmpty());
+    const QString day = days.at(days.size() / 2);
+
+    addSamples("query.timeline.days", sample([db]() { db->getDays(); }));
+    addSamples("query.timeline.months", sample([db]() { db->getMonths(); }));
+    addSamples("query.timeline.infosByDay", sample([db, day]() { db->getInfosByDay(day); }));
+    addSamples("query.timeline.dayCount", sample([db, day]() { db->getDayCount(day); }));
+    addSamples("query.timeline.allInfosSorted", sample([db]() { db->getAllInfosSort(); }));
+
+    const QVector<double> sections = sample([]() { AlbumControl::instance()->getTimelineSections(AlbumControl::Day); });
+    addSamples("query.timeline.daySections", sections);
+    QTest::setBenchmarkResult(median(sections), QTest::WalltimeMilliseconds);
+}
+
+void BenchLibrary::queryAlbum()
+{
+    ensureQueryData();
+    DBManager *db = DBManager::instance();
+    const int uid = m_albumUID;
+    QVERIFY(uid > 0);
+
+    const QVector<double> infos = sample([db, uid]() { db->getInfosByAlbum(uid, false); });
+    addSamples("query.album.infos", infos);
+    addSamples("query.album.paths", sample([db, uid]() { db->getPathsByAlbum(uid); }));
+    addSamples("query.album.count", sample([db, uid]() { db->getItemsCountByAlbum(uid, ItemTypeNull); }));
+    addSamples("query.album.names", sample([db]() { db->getAllAlbumNames(); }));
+    QTest::setBenchmarkResult(median(infos), QTest::WalltimeMilliseconds);
+}
+
+void BenchLibrary::querySearch()
+{
+    ensureQueryData();
+    DBManager *db = DBManager::instance();
+
+    const QVector<double> keyword = sample([db]() { db->getInfosForKeyword("beach"); });
+    addSamples("query.search.keyword", keyword);
+    addSamples("query.search.miss", sample([db]() { db->getInfosForKeyword("no-such-keyword"); }));
+    addSamples("query.search.album", sample([db, this]() { db->getInfosForKeyword(m_albumUID, "city"); }));
+    QTest::setBenchmarkResult(median(keyword), QTest::WalltimeMilliseconds);
+}
+
+/**
+   @brief 目录监控反应时间：从写入新文件到 FileInotify 发出 sigMonitorChanged 的耗时，包含其内部的合并延时
+ */
+void BenchLibrary::fileInotifyReaction()
+{
+    const QString dir = m_library->root() + "/watched";
+    QVERIFY(QDir().mkpath(dir));
+
+    FileInotify inotify;
+    QStringList added;
+    QEventLoop loop;
+    connect(&inotify, &FileInotify::sigMonitorChanged, &loop, [&](QStringList fileAdd, QStringList, QString, int) {
+        added << fileAdd;
+        loop.quit();
+    });
+    inotify.addWather(QStringList() << dir, "bench", -1);
+
+    // 等待添加监控时的首次扫描结束
+    QTest::qWait(2000);
+    added.clear();
+
+    const QImage image(64, 64, QImage::Format_RGB32);
+    QVector<double> samples;
+    for (int i = 0; i < qMin(m_iterations, 10); ++i) {
+        const QString path = QString("%1/new_%2.jpg").arg(dir).arg(i);
+        QElapsedTimer timer;
+        timer.start();
+        QVERIFY(image.save(path, "jpg"));
+
+        QTimer::singleShot(sc_InotifyTimeoutMs, &loop, &QEventLoop::quit);
+        while (!added.contains(path) && timer.elapsed() < sc_InotifyTimeoutMs) {
+            loop.exec();
+        }
+        QVERIFY2(added.contains(path), qPrintable("No change notification for " + path));
+        samples << timer.nsecsElapsed() / 1e6;
+        added.clear();
+    }
+
+    addSamples("inotify.reaction", samples);
+    QTest::setBenchmarkResult(median(samples), QTest::WalltimeMilliseconds);
+}
+
+/**
+   @return 重复执行 \a func 并返回每次的耗时（毫秒），首次执行作为预热不计入
+ */
+template<typename Func>
+QVector<double> BenchLibrary::sample(Func func) const
+{
+    func();
+    QVector<double> samples;
+    samples.reserve(m_iterations);
+    for (int i = 0; i < m_iterations; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+        func();
+        samples << timer.nsecsElapsed() / 1e6;
+    }
+    return samples;
+}
+
+/**
+   @return 通过 ImageDataService 加载 \a paths 的缩略图直到全部就绪的耗时（毫秒），超时返回 -1。
+    \a cold 为 true 时先清除内存缓存及缩略图文件
+ */
+double BenchLibrary::loadThumbnails(const QStringList &paths, bool cold)
+{
+    ImageDataService *service = ImageDataService::instance();
+    QSet<QString> pending(paths.begin(), paths.end());
+
+    QEventLoop loop;
+    connect(service, &ImageDataService::gotImage, &loop, [&](const QString &path) {
+        pending.remove(path);
+        if (pending.isEmpty()) {
+            loop.quit();
+        }
+    });
+    QTimer::singleShot(sc_WaitTimeoutMs, &loop, &QEventLoop::quit);
+
+    QElapsedTimer timer;
+    timer.start();
+    if (cold) {
+        service->reloadThumbnails(paths);
+    } else {
+        for (const QString &path : paths) {
+            if (!service->getThumnailImageByPathRealTime(path, false).isNull()) {
+                pending.remove(path);
+            }
+        }
+    }
+    if (!pending.isEmpty()) {
+        loop.exec();
+    }
+    const double elapsed = timer.nsecsElapsed() / 1e6;
+
+    if (!pending.isEmpty()) {
+        qWarning() << "Thumbnail loading timed out," << pending.size() << "images pending";
+        return -1;
+    }
+    return elapsed;
+}
+
+/**
+   @brief 写入查询测试用的合成记录，并用其中三分之一建立自定义相册
+ */
+void BenchLibrary::ensureQueryData()
+{
+    if (m_queryDataReady) {
+        return;
+    }
+    m_queryDataReady = true;
+
+    const DBImgInfoList records = m_library->syntheticRecords();
+    QElapsedTimer timer;
+    timer.start();
+    DBManager::instance()->insertImgInfos(records);
+    addValue("db.insertRecords", "ms", timer.nsecsElapsed() / 1e6);
+
+    QStringList albumPaths;
+    for (int i = 0; i < records.size(); i += 3) {
+        albumPaths << records.at(i).filePath;
+    }
+    timer.restart();
+    m_albumUID = DBManager::instance()->createAlbum("bench-album", albumPaths);
+    addValue("db.createAlbum", "ms", timer.nsecsElapsed() / 1e6);
+}
+
+void BenchLibrary::addSamples(const QString &name, const QVector<double> &samples)
+{
+    if (samples.isEmpty()) {
+        return;
+    }
+
+    QVector<double> sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0;
+    for (double value : sorted) {
+        sum += value;
+    }
+    const int p95 = qMin(static_cast<int>(sorted.size()) - 1, static_cast<int>(sorted.size() * 0.95));
+
+    m_results.append(QJsonObject {
+        {"name", name},
+        {"unit", "ms"},
+        {"samples", static_cast<int>(sorted.size())},
+        {"min", sorted.first()},
+        {"median", sorted.at(sorted.size() / 2)},
+        {"p95", sorted.at(p95)},
+        {"mean", sum / sorted.size()},
+        {"max", sorted.last()},
+    });
+    qInfo().noquote() << QString("%1: median %2 ms, p95 %3 ms").arg(name).arg(sorted.at(sorted.size() / 2), 0, 'f', 3).arg(sorted.at(p95), 0, 'f', 3);
+}
+
+void BenchLibrary::addValue(const QString &name, const QString &unit, double value)
+{
+    m_results.append(QJsonObject {
+        {"name", name},
+        {"unit", unit},
+        {"value", value},
+    });
+    qInfo().noquote() << QString("%1: %2 %3").arg(name).arg(value, 0, 'f', 3).arg(unit);
+}
+
+int main(int argc, char *argv[])
+{
+    // 相册的数据库和缩略图路径在静态初始化时由 HOME 决定，需在新进程中生效
+    if (!qEnvironmentVariableIsSet("ALBUM_BENCH_ISOLATED")) {
+        QByteArray home = QDir::tempPath().toLocal8Bit() + "/album-bench-XXXXXX";
+        if (!mkdtemp(home.data())) {
+            qCritical() << "Failed to create temporary HOME";
+            return 1;
+        }
+        qputenv("ALBUM_BENCH_CWD", QDir::currentPath().toLocal8Bit());
+        qputenv("ALBUM_BENCH_ISOLATED", "1");
+        qputenv("HOME", home);
+        qputenv("XDG_DATA_HOME", home + "/.local/share");
+        qputenv("XDG_CACHE_HOME", home + "/.cache");
+        qputenv("XDG_CONFIG_HOME", home + "/.config");
+        qputenv("XDG_PICTURES_DIR", home + "/Pictures");
+        execv("/proc/self/exe", argv);
+        qCritical() << "Failed to restart benchmark with temporary HOME";
+        return 1;
+    }
+
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    // 调试日志量很大，会明显影响计时
+    if (!qEnvironmentVariableIsSet("ALBUM_BENCH_VERBOSE")) {
+        QLoggingCategory::setFilterRules("*.debug=false");
+    }
+
+    QApplication app(argc, argv);
+    app.setOrganizationName("deepin");
+    app.setApplicationName("deepin-album");
+
+    BenchLibrary bench;
+    return QTest::qExec(&bench, argc, argv);
+}
+
+#include "bench_library.moc"
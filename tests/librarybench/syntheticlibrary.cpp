@@ -0,0 +1,249 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "syntheticlibrary.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageWriter>
+#include <QLinearGradient>
+#include <QPainter>
+#include <QDebug>
+
+static const int sc_JpegQuality = 90;
+
+static int envInt(const char *name, int defaultValue)
+{
+    bool ok = false;
+    const int value = qEnvironmentVariableIntValue(name, &ok);
+    return ok ? value : defaultValue;
+}
+
+/**
+   @return 从环境变量读取配置，未设置的项使用默认值：
+    ALBUM_BENCH_IMAGES、ALBUM_BENCH_VIDEOS、ALBUM_BENCH_DEPTH、ALBUM_BENCH_FANOUT、
+    ALBUM_BENCH_DB_ROWS、ALBUM_BENCH_SCALE、ALBUM_BENCH_SEED
+ */
+SyntheticLibrary::Config SyntheticLibrary::Config::fromEnvironment()
+{
+    Config config;
+    config.images = qMax(0, envInt("ALBUM_BENCH_IMAGES", config.images));
+    config.videos = qMax(0, envInt("ALBUM_BENCH_VIDEOS", config.videos));
+    config.depth = qMax(0, envInt("ALBUM_BENCH_DEPTH", config.depth));
+    config.fanout = qMax(1, envInt("ALBUM_BENCH_FANOUT", config.fanout));
+    config.dbRows = qMax(0, envInt("ALBUM_BENCH_DB_ROWS", config.dbRows));
+    config.seed = static_cast<quint32>(envInt("ALBUM_BENCH_SEED", static_cast<int>(config.seed)));
+
+    bool ok = false;
+    const double scale = qEnvironmentVariable("ALBUM_BENCH_SCALE").toDouble(&ok);
+    if (ok && scale > 0) {
+        config.scale = scale;
+    }
+    return config;
+}
+
+QJsonObject SyntheticLibrary::Config::toJson() const
+{
+    return QJsonObject {
+        {"images", images},
+        {"videos", videos},
+        {"depth", depth},
+        {"fanout", fanout},
+        {"dbRows", dbRows},
+        {"scale", scale},
+        {"seed", static_cast<qint64>(seed)},
+    };
+}
+
+SyntheticLibrary::SyntheticLibrary(const QString &root, const Config &config)
+    : m_root(root)
+    , m_config(config)
+{
+}
+
+/**
+   @brief 生成目录树和全部文件，已存在的同名文件会被覆盖
+ */
+bool SyntheticLibrary::generate()
+{
+    // 尺寸对应常见来源：手机/相机横拍、竖拍、HEIC 原生尺寸、屏幕截图及小图
+    const Profile profiles[] = {
+        {"jpeg-landscape", QSize(4000, 3000), "jpg", false},
+        {"jpeg-portrait", QSize(3000, 4000), "jpg", false},
+        {"heic-like", QSize(4032, 3024), "jpg", false},
+        {"png-screenshot", QSize(1920, 1080), "png", true},
+        {"jpeg-small", QSize(800, 600), "jpg", false},
+    };
+    const int profileCount = static_cast<int>(sizeof(profiles) / sizeof(profiles[0]));
+
+    m_directories.clear();
+    m_imagePaths.clear();
+    m_videoPaths.clear();
+    m_totalBytes = 0;
+
+    if (!QDir().mkpath(m_root)) {
+        qWarning() << "Failed to create synthetic library root:" << m_root;
+        return false;
+    }
+    m_directories << m_root;
+    buildDirectories(m_root, 1);
+
+    QRandomGenerator rng(m_config.seed);
+    for (int i = 0; i < m_config.images; ++i) {
+        const Profile &profile = profiles[i % profileCount];
+        const QString dir = m_directories.at(i % m_directories.size());
+        const QString path = QString("%1/%2_%3.%4").arg(dir).arg(profile.name).arg(i, 5, 10, QChar('0')).arg(profile.format);
+
+        const QImage image = render(profile, rng);
+        QImageWriter writer(path, profile.format);
+        writer.setQuality(sc_JpegQuality);
+        if (!writer.write(image)) {
+            qWarning() << "Failed to write synthetic image:" << path << writer.errorString();
+            return false;
+        }
+        m_imagePaths << path;
+        m_totalBytes += QFileInfo(path).size();
+    }
+
+    for (int i = 0; i < m_config.videos; ++i) {
+        const QString dir = m_directories.at((i * 7 + 3) % m_directories.size());
+        const QString path = QString("%1/clip_%2.mp4").arg(dir).arg(i, 5, 10, QChar('0'));
+        if (!writeVideoStub(path, rng)) {
+            return false;
+        }
+        m_videoPaths << path;
+        m_totalBytes += QFileInfo(path).size();
+    }
+
+    qInfo() << "Synthetic library generated:" << m_imagePaths.size() << "images," << m_videoPaths.size() << "videos,"
+            << m_directories.size() << "directories," << m_totalBytes / 1024 << "KiB";
+    return true;
+}
+
+QString SyntheticLibrary::root() const
+{
+    return m_root;
+}
+
+QStringList SyntheticLibrary::directories() const
+{
+    return m_directories;
+}
+
+QStringList SyntheticLibrary::imagePaths() const
+{
+    return m_imagePaths;
+}
+
+QStringList SyntheticLibrary::videoPaths() const
+{
+    return m_videoPaths;
+}
+
+qint64 SyntheticLibrary::totalBytes() const
+{
+    return m_totalBytes;
+}
+
+/**
+   @return 用于数据库查询测试的记录，文件并不实际存在。拍摄时间分布在十年内，约一成为视频，
+    文件名中含有可供搜索的关键字
+ */
+DBImgInfoList SyntheticLibrary::syntheticRecords() const
+{
+    static const char *const sc_Keywords[] = {"beach", "family", "city", "forest", "party", "travel", "snow", "food"};
+    const int keywordCount = static_cast<int>(sizeof(sc_Keywords) / sizeof(sc_Keywords[0]));
+
+    DBImgInfoList infos;
+    infos.reserve(m_config.dbRows);
+    QRandomGenerator rng(m_config.seed ^ 0x5eed);
+    const QDateTime base(QDate(2015, 1, 1), QTime(0, 0));
+    const qint64 span = 10LL * 365 * 24 * 3600;
+    for (int i = 0; i < m_config.dbRows; ++i) {
+        DBImgInfo info;
+        const QDateTime time = base.addSecs(static_cast<qint64>(rng.bounded(1.0) * span));
+        const bool video = rng.bounded(10) == 0;
+        info.filePath = QString("%1/records/%2/%3_%4.%5")
+                            .arg(m_root)
+                            .arg(time.toString("yyyy/MM"))
+                            .arg(sc_Keywords[i % keywordCount])
+                            .arg(i, 6, 10, QChar('0'))
+                            .arg(video ? "mp4" : "jpg");
+        info.time = time;
+        info.changeTime = time;
+        info.importTime = time.addDays(rng.bounded(30));
+        info.itemType = video ? ItemTypeVideo : ItemTypePic;
+        infos << info;
+    }
+    return infos;
+}
+
+void SyntheticLibrary::buildDirectories(const QString &parent, int level)
+{
+    if (level > m_config.depth) {
+        return;
+    }
+    for (int i = 0; i < m_config.fanout; ++i) {
+        const QString dir = QString("%1/level%2_%3").arg(parent).arg(level).arg(i);
+        QDir().mkpath(dir);
+        m_directories << dir;
+        buildDirectories(dir, level + 1);
+    }
+}
+
+/**
+   @return 按 \a profile 绘制的测试图：渐变背景加随机色块和细线，JPEG 压缩后的大小接近真实照片
+ */
+QImage SyntheticLibrary::render(const Profile &profile, QRandomGenerator &rng) const
+{
+    const QSize size(qMax(16, qRound(profile.size.width() * m_config.scale)),
+                     qMax(16, qRound(profile.size.height() * m_config.scale)));
+    QImage image(size, profile.alpha ? QImage::Format_ARGB32 : QImage::Format_RGB32);
+    image.fill(Qt::transparent);
+
+    auto randomColor = [&rng](int alpha) {
+        return QColor(rng.bounded(256), rng.bounded(256), rng.bounded(256), alpha);
+    };
+
+    QPainter painter(&image);
+    QLinearGradient gradient(0, 0, size.width(), size.height());
+    gradient.setColorAt(0, randomColor(255));
+    gradient.setColorAt(1, randomColor(profile.alpha ? 160 : 255));
+    painter.fillRect(image.rect(), gradient);
+
+    for (int i = 0; i < 48; ++i) {
+        const QRect rect(rng.bounded(size.width()), rng.bounded(size.height()),
+                         rng.bounded(size.width() / 4 + 1), rng.bounded(size.height() / 4 + 1));
+        painter.fillRect(rect, randomColor(profile.alpha ? rng.bounded(256) : 255));
+    }
+    painter.setPen(QPen(randomColor(255), 1));
+    for (int x = 0; x < size.width(); x += 5) {
+        painter.drawLine(x, 0, size.width() - x, size.height());
+    }
+    painter.end();
+    return image;
+}
+
+/**
+   @brief 写入视频占位文件：MP4 的 ftyp 头加随机数据，后缀能被识别为视频但无法解码
+ */
+bool SyntheticLibrary::writeVideoStub(const QString &path, QRandomGenerator &rng)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Failed to write video stub:" << path;
+        return false;
+    }
+
+    static const char sc_FtypBox[] = {0, 0, 0, 24, 'f', 't', 'y', 'p', 'i', 's', 'o', 'm', 0, 0, 2, 0,
+                                      'i', 's', 'o', 'm', 'm', 'p', '4', '1'};
+    file.write(sc_FtypBox, sizeof(sc_FtypBox));
+    QByteArray payload(64 * 1024, Qt::Uninitialized);
+    for (char &byte : payload) {
+        byte = static_cast<char>(rng.bounded(256));
+    }
+    file.write(payload);
+    return true;
+}
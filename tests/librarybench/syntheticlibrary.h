@@ -0,0 +1,70 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SYNTHETICLIBRARY_H
+#define SYNTHETICLIBRARY_H
+
+#include "unionimage/unionimage_global.h"
+
+#include <QJsonObject>
+#include <QStringList>
+#include <QRandomGenerator>
+
+/**
+ * @brief 可复现的合成图库。
+ *      按配置在 root 下生成多层目录树，目录中按固定比例放置相机照片、竖拍照片、HEIC 尺寸照片（以 JPEG 保存）、
+ *      带透明通道的截图及视频占位文件。相同的种子生成的目录结构、文件名、尺寸和像素内容完全一致，
+ *      不同运行之间的结果可以直接比较。
+ * @note 视频为仅含 ftyp 头的占位文件，不能被解码：导入时走视频解析失败的路径，数据库查询使用 syntheticRecords 生成的视频记录。
+ */
+class SyntheticLibrary
+{
+public:
+    struct Config {
+        int images = 120;       // 图片数量
+        int videos = 12;        // 视频占位文件数量
+        int depth = 3;          // 目录层数
+        int fanout = 3;         // 每层子目录数
+        int dbRows = 20000;     // 查询测试额外写入数据库的记录数
+        double scale = 1.0;     // 图片尺寸缩放系数，用于在较慢的机器上缩短生成时间
+        quint32 seed = 42;      // 随机种子
+
+        static Config fromEnvironment();
+        QJsonObject toJson() const;
+    };
+
+    SyntheticLibrary(const QString &root, const Config &config);
+
+    bool generate();
+
+    QString root() const;
+    QStringList directories() const;
+    QStringList imagePaths() const;
+    QStringList videoPaths() const;
+    qint64 totalBytes() const;
+
+    DBImgInfoList syntheticRecords() const;
+
+private:
+    struct Profile {
+        const char *name;
+        QSize size;
+        const char *format;
+        bool alpha;
+    };
+
+    void buildDirectories(const QString &parent, int level);
+    QImage render(const Profile &profile, QRandomGenerator &rng) const;
+    static bool writeVideoStub(const QString &path, QRandomGenerator &rng);
+
+private:
+    QString m_root;
+    Config m_config;
+    QStringList m_directories;
+    QStringList m_imagePaths;
+    QStringList m_videoPaths;
+    qint64 m_totalBytes = 0;
+};
+
+#endif  // SYNTHETICLIBRARY_H